@@ -1,6 +1,7 @@
 // app/main.cpp
 
 #include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -19,6 +20,7 @@
 #include "model/Sequential.hpp"
 #include "optimizers/Adam.hpp"
 #include "optimizers/SGD.hpp"
+#include "utils/Dataset.hpp"
 #include <omp.h>
 
 // --- DECLARACIÓN ANTICIPADA ---
@@ -63,14 +65,15 @@ int main() {
     */
 
     // --- 2. Cargar Datos ---
-    auto [X_train, y_train] = loadMnist("data/fashion_train.csv", 1.0f, 3); // Entrenamos con 20%
-    auto [X_test, y_test] = loadMnist("data/fashion_test.csv", 1.0f, 3);
+    // Se proyecta la versión binaria (uint8) de cada CSV; se genera en la primera ejecución.
+    MappedDataset trainData = openMnistDataset("data/fashion_train.csv", 3);
+    MappedDataset testData = openMnistDataset("data/fashion_test.csv", 3);
 
     // --- 3. Compilar y Entrenar ---
     model.compile<SGD, CrossEntropy>(0.002f);
 
     std::cout << "\n--- Iniciando Entrenamiento de la CNN ---\n" << std::endl;
-    model.train(X_train, y_train, 20, 8, X_test, y_test);
+    model.train(trainData, 20, 8, testData);
     std::cout << "\n--- Entrenamiento Finalizado ---\n" << std::endl;
 
     // --- 4. Guardar el Modelo Entrenado ---
@@ -108,7 +111,7 @@ int main() {
 
     // Evaluamos el modelo cargado para confirmar que funciona
     std::cout << "\n--- Evaluando modelo CARGADO en el conjunto de prueba ---" << std::endl;
-    auto [finalLoss, finalAccuracy] = loadedModel.evaluate(X_test, y_test);
+    auto [finalLoss, finalAccuracy] = loadedModel.evaluate(testData);
 
     std::cout << "========================================" << std::endl;
     std::cout << "  Rendimiento del Modelo Cargado" << std::endl;
@@ -117,14 +120,30 @@ int main() {
     std::cout << "  Precision (Accuracy) en Test: " << finalAccuracy * 100.0f << "%" << std::endl;
     std::cout << "========================================" << std::endl;
 
+    // --- 6. Inferencia int8: calibrar con datos de entrenamiento y comparar con float ---
+    auto start = std::chrono::steady_clock::now();
+    loadedModel.evaluate(testData);
+    const double floatSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    loadedModel.quantizeInt8(trainData);
+    start = std::chrono::steady_clock::now();
+    auto [int8Loss, int8Accuracy] = loadedModel.evaluate(testData);
+    const double int8Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "  Inferencia float: " << floatSeconds * 1000.0 << " ms, int8: " << int8Seconds * 1000.0 << " ms"
+              << std::endl;
+    std::cout << "  Precision int8: " << int8Accuracy * 100.0f << "% (diferencia "
+              << (int8Accuracy - finalAccuracy) * 100.0f << " puntos, perdida " << int8Loss << ")" << std::endl;
+
     // ==  NUEVO: Predecir y dibujar algunas muestras al azar ==
 
     // Inicializamos el generador de números aleatorios para elegir índices
     srand(static_cast<unsigned int>(time(0)));
     // Probamos 5 imágenes aleatorias del conjunto de prueba
     for (int i = 0; i < 1; ++i) {
-      size_t randomIndex = rand() % X_test.getShape()[0];
-      predictAndDraw(loadedModel, X_test, y_test, randomIndex);
+      size_t randomIndex = rand() % testData.size();
+      auto [X_sample, y_sample] = testData.getBatch(&randomIndex, 1);
+      predictAndDraw(loadedModel, X_sample, y_sample, 0);
     }
 
   } catch (const std::exception &e) {
@@ -0,0 +1,230 @@
+#include "Benchmark.hpp"
+#include "core/Allocator.hpp"
+
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <regex>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace {
+struct Registered {
+  std::string name;
+  std::function<void(BenchmarkState &)> body;
+};
+
+struct Result {
+  std::string name;
+  int threads;
+  size_t iterations;
+  double secondsPerIteration;
+  double gflops; ///< 0 si el benchmark no declara flops.
+  double bytesPerSecond;
+};
+
+struct Options {
+  std::string filter = ".*";
+  std::vector<int> threads;
+  double minTime = 0.2;
+  std::string jsonPath;
+};
+
+std::vector<Registered> &registry() {
+  static std::vector<Registered> benchmarks;
+  return benchmarks;
+}
+
+int maxThreads() {
+#ifdef _OPENMP
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+void setThreads(int threads) {
+#ifdef _OPENMP
+  omp_set_num_threads(threads);
+#else
+  (void)threads;
+#endif
+}
+
+/** @brief Por defecto: potencias de dos hasta el máximo de hilos, y el máximo. */
+std::vector<int> defaultThreads() {
+  std::vector<int> threads;
+  const int limit = maxThreads();
+  for (int t = 1; t < limit; t *= 2)
+    threads.push_back(t);
+  threads.push_back(limit);
+  return threads;
+}
+
+std::vector<int> parseThreads(const std::string &list) {
+  std::vector<int> threads;
+  std::stringstream ss(list);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    const int t = std::stoi(item);
+    if (t <= 0)
+      throw std::invalid_argument("--threads: el número de hilos debe ser positivo.");
+    threads.push_back(t);
+  }
+  return threads;
+}
+
+Options parseOptions(int argc, char **argv) {
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    auto value = [&](const std::string &flag) -> const char * {
+      return arg.rfind(flag, 0) == 0 ? arg.c_str() + flag.size() : nullptr;
+    };
+    if (const char *v = value("--filter="))
+      options.filter = v;
+    else if (const char *v = value("--threads="))
+      options.threads = parseThreads(v);
+    else if (const char *v = value("--min_time="))
+      options.minTime = std::stod(v);
+    else if (const char *v = value("--json="))
+      options.jsonPath = v;
+    else
+      throw std::invalid_argument("Argumento desconocido: " + arg +
+                                  "\nUso: bench [--filter=<regex>] [--threads=1,2,4] [--min_time=<s>] [--json=<archivo>]");
+  }
+  if (options.threads.empty())
+    options.threads = defaultThreads();
+  return options;
+}
+
+/**
+ * @brief Aumenta (como mucho x10) las iteraciones hasta que una ejecución dura al menos `minTime`.
+ * @details Antes se ejecuta una iteración de calentamiento (cachés, páginas, pool del
+ *          asignador) que no se informa.
+ */
+Result measure(const Registered &benchmark, int threads, double minTime) {
+  BenchmarkState warmup(1);
+  benchmark.body(warmup);
+
+  size_t iterations = 1;
+  while (true) {
+    BenchmarkState state(iterations);
+    benchmark.body(state);
+    const double elapsed = state.seconds();
+    if (elapsed >= minTime || iterations >= 1000000000) {
+      Result result{benchmark.name, threads, iterations, elapsed / iterations, 0.0, 0.0};
+      if (elapsed > 0.0) {
+        result.gflops = state.flopsPerIteration() * iterations / elapsed * 1e-9;
+        result.bytesPerSecond = state.bytesPerIteration() * iterations / elapsed;
+      }
+      return result;
+    }
+    const double target = elapsed > 0.0 ? minTime * 1.4 / elapsed * iterations : 10.0 * iterations;
+    iterations = std::max(iterations + 1, std::min(static_cast<size_t>(target), 10 * iterations));
+  }
+}
+
+std::string formatTime(double seconds) {
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(seconds < 1e-3 ? 2 : 3);
+  if (seconds < 1e-3)
+    out << seconds * 1e6 << " us";
+  else
+    out << seconds * 1e3 << " ms";
+  return out.str();
+}
+
+std::string jsonEscape(const std::string &text) {
+  std::string escaped;
+  for (char c : text) {
+    if (c == '"' || c == '\\')
+      escaped += '\\';
+    escaped += c;
+  }
+  return escaped;
+}
+
+void writeJson(const std::string &path, const std::vector<Result> &results, const char *executable) {
+  std::ofstream out(path);
+  if (!out)
+    throw std::runtime_error("No se pudo abrir el archivo JSON: " + path);
+
+  const std::time_t now = std::time(nullptr);
+  char date[32];
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+  out << "{\n  \"context\": {\n";
+  out << "    \"date\": \"" << date << "\",\n";
+  out << "    \"executable\": \"" << jsonEscape(executable) << "\",\n";
+  out << "    \"max_threads\": " << maxThreads() << ",\n";
+  out << "    \"allocator\": \"" << getAllocator()->name() << "\"\n";
+  out << "  },\n  \"benchmarks\": [\n";
+  out << std::setprecision(6);
+  for (size_t i = 0; i < results.size(); ++i) {
+    const Result &r = results[i];
+    out << "    {\"name\": \"" << jsonEscape(r.name) << "\", \"threads\": " << r.threads
+        << ", \"iterations\": " << r.iterations << ", \"real_time_ns\": " << r.secondsPerIteration * 1e9
+        << ", \"gflops\": " << r.gflops << ", \"bytes_per_second\": " << r.bytesPerSecond << "}"
+        << (i + 1 < results.size() ? "," : "") << "\n";
+  }
+  out << "  ]\n}\n";
+}
+} // namespace
+
+void registerBenchmark(const std::string &name, std::function<void(BenchmarkState &)> body) {
+  registry().push_back({name, std::move(body)});
+}
+
+int runBenchmarks(int argc, char **argv) {
+  try {
+    const Options options = parseOptions(argc, argv);
+    const std::regex filter(options.filter);
+    const int initialThreads = maxThreads();
+
+    std::cout << "Asignador: " << getAllocator()->name()
+              << ", hilos máximos: " << maxThreads() << "\n\n";
+    std::cout << std::left << std::setw(60) << "Benchmark" << std::right << std::setw(8) << "Hilos" << std::setw(14)
+              << "Tiempo" << std::setw(12) << "Iter" << std::setw(12) << "GFLOP/s" << std::setw(12) << "GB/s" << "\n";
+    std::cout << std::string(118, '-') << "\n";
+
+    std::vector<Result> results;
+    for (const Registered &benchmark : registry()) {
+      if (!std::regex_search(benchmark.name, filter))
+        continue;
+      for (int threads : options.threads) {
+        setThreads(threads);
+        const Result r = measure(benchmark, threads, options.minTime);
+        results.push_back(r);
+        std::cout << std::left << std::setw(60) << r.name << std::right << std::setw(8) << r.threads << std::setw(14)
+                  << formatTime(r.secondsPerIteration) << std::setw(12) << r.iterations << std::fixed
+                  << std::setprecision(2) << std::setw(12) << r.gflops << std::setw(12) << r.bytesPerSecond * 1e-9
+                  << std::defaultfloat << std::endl;
+      }
+    }
+    setThreads(initialThreads);
+
+    if (!options.jsonPath.empty()) {
+      writeJson(options.jsonPath, results, argv[0]);
+      std::cout << "\nResultados guardados en: " << options.jsonPath << std::endl;
+    }
+  } catch (const std::exception &e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  registerTensorBenchmarks();
+  registerLayerBenchmarks();
+  return runBenchmarks(argc, argv);
+}
@@ -0,0 +1,79 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+
+/**
+ * @file Benchmark.hpp
+ * @brief Mini arnés de microbenchmarks al estilo de Google Benchmark.
+ *
+ * Cada benchmark es una función que prepara sus datos y luego repite la operación
+ * medida dentro de `while (state.keepRunning())`. El ejecutor elige el número de
+ * iteraciones hasta superar un tiempo mínimo y repite cada caso para cada número
+ * de hilos de OpenMP pedido. Con el trabajo declarado por iteración (flops y bytes)
+ * se informan GFLOP/s y bytes/s, en una tabla y opcionalmente en JSON.
+ *
+ * Uso: bench [--filter=<regex>] [--threads=1,2,4] [--min_time=<segundos>] [--json=<archivo>]
+ */
+
+/**
+ * @class BenchmarkState
+ * @brief Cuenta las iteraciones de un benchmark y mide su duración.
+ */
+class BenchmarkState {
+public:
+  explicit BenchmarkState(size_t iterations) : maxIterations(iterations) {}
+
+  /**
+   * @brief Devuelve `true` mientras queden iteraciones.
+   * @details El cronómetro arranca en la primera llamada, de modo que la preparación
+   *          previa al bucle no se mide.
+   */
+  bool keepRunning() {
+    if (!started) {
+      started = true;
+      start = std::chrono::steady_clock::now();
+    }
+    if (done < maxIterations) {
+      ++done;
+      return true;
+    }
+    end = std::chrono::steady_clock::now();
+    return false;
+  }
+
+  /** @brief Trabajo de una iteración, para calcular GFLOP/s y bytes/s. */
+  void setFlops(double flopsPerIteration) { flops = flopsPerIteration; }
+  void setBytes(double bytesPerIteration) { bytes = bytesPerIteration; }
+
+  size_t iterations() const { return done; }
+  double flopsPerIteration() const { return flops; }
+  double bytesPerIteration() const { return bytes; }
+  double seconds() const { return std::chrono::duration<double>(end - start).count(); }
+
+private:
+  size_t maxIterations;
+  size_t done = 0;
+  bool started = false;
+  double flops = 0.0;
+  double bytes = 0.0;
+  std::chrono::steady_clock::time_point start, end;
+};
+
+/** @brief Registra un benchmark. Los nombres siguen la forma "operación/variante/forma". */
+void registerBenchmark(const std::string &name, std::function<void(BenchmarkState &)> body);
+
+/** @brief Ejecuta los benchmarks registrados según los argumentos de la línea de comandos. */
+int runBenchmarks(int argc, char **argv);
+
+/** @brief Impide que el compilador elimine un cálculo cuyo resultado no se usa. */
+template <typename T> inline void doNotOptimize(const T &value) { asm volatile("" : : "r,m"(value) : "memory"); }
+
+/** @brief Registro de los benchmarks de cada archivo. */
+void registerTensorBenchmarks();
+void registerLayerBenchmarks();
+
+#endif // BENCHMARK_HPP
@@ -0,0 +1,150 @@
+#include "Benchmark.hpp"
+#include "layers/Conv2D.hpp"
+#include "layers/Pooling2D.hpp"
+#include "optimizers/Adam.hpp"
+
+/**
+ * @file LayerBenchmarks.cpp
+ * @brief Benchmarks de capas (forward y backward) y del optimizador Adam.
+ *
+ * Los flops de Conv2D son los de la convolución directa; im2col y col2im no añaden
+ * flops pero sí tráfico de memoria, que es justo lo que estos benchmarks permiten ver.
+ */
+
+namespace {
+Tensor randomTensor(const std::vector<size_t> &shape) {
+  Tensor t(shape);
+  t.randomize(-1.0f, 1.0f);
+  return t;
+}
+
+std::string imageName(size_t batch, size_t channels, size_t size) {
+  return std::to_string(batch) + "x" + std::to_string(channels) + "x" + std::to_string(size) + "x" +
+         std::to_string(size);
+}
+
+/**
+ * @brief Conv2D con padding "same" y stride 1 sobre {B, Cin, S, S}.
+ * @details Forward: 2*B*Cout*S*S*Cin*K*K flops, medido con cada algoritmo aplicable y con
+ *          Auto tras `autotune` (flops nominales de la convolución directa, también para Winograd
+ *          y para la inferencia int8).
+ *          Backward: el doble, dE/dW y dE/dX (GEMM + col2im).
+ */
+void convBenchmarks(size_t batch, size_t inChannels, size_t outChannels, size_t size, size_t kernel) {
+  const double flops = 2.0 * batch * outChannels * size * size * inChannels * kernel * kernel;
+  const double bytes = 4.0 * (batch * (inChannels + outChannels) * size * size + outChannels * inChannels * kernel * kernel);
+  const std::string shape = imageName(batch, inChannels, size) + "/" + std::to_string(outChannels) + "k" + std::to_string(kernel);
+
+  std::vector<Conv2D::Algorithm> algorithms = {Conv2D::Algorithm::Auto, Conv2D::Algorithm::Im2col,
+                                               Conv2D::Algorithm::Direct};
+  if (kernel == 3)
+    algorithms.push_back(Conv2D::Algorithm::Winograd);
+  for (Conv2D::Algorithm algorithm : algorithms) {
+    registerBenchmark("Conv2D/forward/" + Conv2D::algorithmName(algorithm) + "/" + shape, [=](BenchmarkState &state) {
+      Conv2D conv(inChannels, outChannels, kernel, 1, kernel / 2);
+      conv.setAlgorithm(algorithm);
+      Tensor x = randomTensor({batch, inChannels, size, size});
+      conv.autotune(x); // Con Auto, los candidatos se miden fuera de la medición.
+      conv.forward(x, true);
+      while (state.keepRunning())
+        doNotOptimize(conv.forward(x, true));
+      state.setFlops(flops);
+      state.setBytes(bytes);
+    });
+  }
+  registerBenchmark("Conv2D/forward/int8/" + shape, [=](BenchmarkState &state) {
+    Conv2D conv(inChannels, outChannels, kernel, 1, kernel / 2);
+    Tensor x = randomTensor({batch, inChannels, size, size});
+    conv.setInt8Mode(Int8Mode::Calibrate);
+    conv.forward(x, false);
+    conv.setInt8Mode(Int8Mode::Quantized);
+    while (state.keepRunning())
+      doNotOptimize(conv.forward(x, false));
+    state.setFlops(flops);
+    state.setBytes(bytes);
+  });
+  registerBenchmark("Conv2D/backward/" + shape, [=](BenchmarkState &state) {
+    Conv2D conv(inChannels, outChannels, kernel, 1, kernel / 2);
+    Tensor x = randomTensor({batch, inChannels, size, size});
+    Tensor dy = randomTensor({batch, outChannels, size, size});
+    conv.forward(x, true);
+    while (state.keepRunning())
+      doNotOptimize(conv.backward(dy));
+    state.setFlops(2.0 * flops);
+    state.setBytes(2.0 * bytes);
+  });
+}
+
+/**
+ * @brief Pooling 2x2 (stride 2) sobre {B, C, S, S}.
+ * @details Forward: una comparación o suma por elemento de entrada; lee la entrada y
+ *          escribe la salida (y los índices del máximo). Backward: reparte el gradiente.
+ */
+void poolingBenchmarks(size_t batch, size_t channels, size_t size, Pooling2D::PoolType type) {
+  const double inputs = static_cast<double>(batch) * channels * size * size;
+  const std::string shape = (type == Pooling2D::PoolType::Max ? "max/" : "average/") + imageName(batch, channels, size);
+
+  registerBenchmark("Pooling2D/forward/" + shape, [=](BenchmarkState &state) {
+    Pooling2D pool(2, type);
+    Tensor x = randomTensor({batch, channels, size, size});
+    while (state.keepRunning())
+      doNotOptimize(pool.forward(x, true));
+    state.setFlops(inputs);
+    state.setBytes(4.0 * inputs * 1.5);
+  });
+  registerBenchmark("Pooling2D/backward/" + shape, [=](BenchmarkState &state) {
+    Pooling2D pool(2, type);
+    Tensor x = randomTensor({batch, channels, size, size});
+    Tensor dy = randomTensor({batch, channels, size / 2, size / 2});
+    pool.forward(x, true);
+    while (state.keepRunning())
+      doNotOptimize(pool.backward(dy));
+    state.setFlops(inputs);
+    state.setBytes(4.0 * inputs * 1.5);
+  });
+}
+
+/**
+ * @brief Adam sobre un conjunto de matrices {rows, cols}.
+ * @details ~14 flops por parámetro; lee parámetro, gradiente, m y v y escribe
+ *          parámetro, m y v (28 bytes por parámetro).
+ */
+void adamBenchmark(size_t tensors, size_t rows, size_t cols) {
+  const double count = static_cast<double>(tensors) * rows * cols;
+  const std::string name = "Adam/update/" + std::to_string(tensors) + "x" + std::to_string(rows) + "x" + std::to_string(cols);
+  registerBenchmark(name, [=](BenchmarkState &state) {
+    std::vector<Tensor> params, grads;
+    for (size_t i = 0; i < tensors; ++i) {
+      params.push_back(randomTensor({rows, cols}));
+      grads.push_back(randomTensor({rows, cols}));
+    }
+    std::vector<Tensor *> paramPtrs, gradPtrs;
+    for (size_t i = 0; i < tensors; ++i) {
+      paramPtrs.push_back(&params[i]);
+      gradPtrs.push_back(&grads[i]);
+    }
+    Adam adam;
+    adam.update(paramPtrs, gradPtrs); // Reserva los momentos fuera de la medición.
+    while (state.keepRunning())
+      adam.update(paramPtrs, gradPtrs);
+    state.setFlops(14.0 * count);
+    state.setBytes(28.0 * count);
+  });
+}
+} // namespace
+
+void registerLayerBenchmarks() {
+  // Las dos convoluciones de app/main.cpp y una más ancha.
+  convBenchmarks(32, 3, 16, 28, 3);
+  convBenchmarks(32, 16, 4, 14, 3);
+  convBenchmarks(8, 64, 64, 32, 3);
+
+  for (auto type : {Pooling2D::PoolType::Max, Pooling2D::PoolType::Average}) {
+    poolingBenchmarks(32, 16, 28, type);
+    poolingBenchmarks(8, 64, 32, type);
+  }
+
+  // Parámetros del MLP de app/main.cpp (~110K) y un conjunto grande (~4M).
+  adamBenchmark(1, 784, 128);
+  adamBenchmark(16, 512, 512);
+}
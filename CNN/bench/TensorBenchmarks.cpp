@@ -0,0 +1,43 @@
+#include "Benchmark.hpp"
+#include "core/Tensor.hpp"
+
+/**
+ * @file TensorBenchmarks.cpp
+ * @brief Benchmarks de las operaciones de Tensor (GEMM).
+ *
+ * Además de matrices cuadradas se miden las formas que genera im2col en la red de
+ * app/main.cpp (lote de 32 imágenes de 28x28): pesos {Cout, Cin*K*K} por la matriz
+ * de columnas {Cin*K*K, B*H*W}.
+ */
+
+namespace {
+Tensor randomTensor(const std::vector<size_t> &shape) {
+  Tensor t(shape);
+  t.randomize(-1.0f, 1.0f);
+  return t;
+}
+
+/** @brief C{m, n} = A{m, k} * B{k, n}. */
+void gemmBenchmark(size_t m, size_t k, size_t n) {
+  const std::string name = "matrixMultiply/" + std::to_string(m) + "x" + std::to_string(k) + "x" + std::to_string(n);
+  registerBenchmark(name, [=](BenchmarkState &state) {
+    Tensor a = randomTensor({m, k});
+    Tensor b = randomTensor({k, n});
+    while (state.keepRunning())
+      doNotOptimize(matrixMultiply(a, b));
+    state.setFlops(2.0 * m * k * n);
+    state.setBytes(4.0 * (m * k + k * n + m * n));
+  });
+}
+} // namespace
+
+void registerTensorBenchmarks() {
+  for (size_t n : {64, 128, 256, 512})
+    gemmBenchmark(n, n, n);
+  // Forward de las dos convoluciones: {16, 27} x {27, 32*28*28} y {4, 144} x {144, 32*14*14}.
+  gemmBenchmark(16, 27, 25088);
+  gemmBenchmark(4, 144, 6272);
+  // Capas densas: {B, 784} x {784, 128} y {B, 196} x {196, 16}.
+  gemmBenchmark(32, 784, 128);
+  gemmBenchmark(32, 196, 16);
+}
@@ -48,6 +48,11 @@ public:
    */
   std::string getName() const override { return "ReLU"; }
 
+  std::unique_ptr<Layer> clone() const override { return std::make_unique<ReLU>(*this); }
+
+  /** @brief Una comparación por elemento. */
+  double getFlops(const std::vector<size_t> &inputShape) const override;
+
 private:
   /**
    * @brief Almacena el tensor de entrada del forward pass.
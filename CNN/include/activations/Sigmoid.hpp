@@ -48,6 +48,11 @@ public:
    */
   std::string getName() const override { return "Sigmoid"; }
 
+  std::unique_ptr<Layer> clone() const override { return std::make_unique<Sigmoid>(*this); }
+
+  /** @brief ~4 FLOPs por elemento (exponencial, suma y división). */
+  double getFlops(const std::vector<size_t> &inputShape) const override;
+
 private:
   /**
    * @brief Almacena la salida del forward pass.
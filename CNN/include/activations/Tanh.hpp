@@ -15,6 +15,11 @@ public:
 
   std::string getName() const override { return "Tanh"; }
 
+  std::unique_ptr<Layer> clone() const override { return std::make_unique<Tanh>(*this); }
+
+  // ~4 FLOPs por elemento (tanh cuenta como una sola operación).
+  double getFlops(const std::vector<size_t> &inputShape) const override;
+
 private:
   // Similar a Sigmoid, guardamos la salida para calcular la derivada eficientemente.
   // f'(x) = 1 - tanh^2(x) = 1 - f(x)^2
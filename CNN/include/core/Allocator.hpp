@@ -0,0 +1,131 @@
+#ifndef ALLOCATOR_HPP
+#define ALLOCATOR_HPP
+
+#include <cstddef>
+#include <memory>
+
+/**
+ * @file Allocator.hpp
+ * @brief Asignadores de memoria para los datos de los tensores.
+ *
+ * Cada "Owning Tensor" pide su bloque al asignador activo y lo devuelve cuando se
+ * destruye el último tensor o vista que lo comparte. Todos los bloques están alineados
+ * a 64 bytes (una línea de caché).
+ *
+ * Implementaciones:
+ *  - SystemAllocator: una reserva del sistema por tensor (comportamiento original).
+ *  - PoolAllocator: clases de tamaño con listas libres; cada mini-batch reutiliza los
+ *    bloques que liberó el anterior, sin malloc/free ni fallos de página.
+ * La variable de entorno CNN_ALLOCATOR (system, pool) elige el asignador por defecto.
+ */
+
+/** @brief Contadores de un asignador (en bytes, salvo las cuentas de llamadas). */
+struct AllocatorStats {
+  size_t allocations = 0;       ///< Llamadas a allocate().
+  size_t systemAllocations = 0; ///< De ellas, las que pidieron memoria al sistema.
+  size_t bytesAllocated = 0;    ///< Total entregado por allocate() (acumulado).
+  size_t bytesInUse = 0;        ///< Memoria entregada a tensores vivos.
+  size_t bytesCached = 0;       ///< Memoria en listas libres, lista para reutilizar.
+  size_t peakBytesInUse = 0;    ///< Máximo de bytesInUse.
+};
+
+/**
+ * @class Allocator
+ * @brief Interfaz de los asignadores de memoria de los tensores.
+ */
+class Allocator {
+public:
+  virtual ~Allocator() = default;
+
+  /** @brief Reserva `count` floats sin inicializar, alineados a 64 bytes. */
+  virtual float *allocate(size_t count) = 0;
+
+  /** @brief Devuelve un bloque obtenido con allocate(count). */
+  virtual void deallocate(float *ptr, size_t count) = 0;
+
+  /**
+   * @brief Marca el final de un paso de entrenamiento (un mini-batch).
+   * @details El pool libera aquí la memoria cacheada que no se reutilizó durante el paso.
+   */
+  virtual void resetStep() {}
+
+  /** @brief Devuelve los contadores del asignador. */
+  virtual AllocatorStats stats() const = 0;
+
+  /** @brief Devuelve el nombre del asignador ("system" o "pool"). */
+  virtual const char *name() const = 0;
+
+  /**
+   * @brief Reinicia el pico a max(floor, bytesInUse) y devuelve el pico anterior.
+   * @details Permite medir el pico de memoria de un intervalo; el Profiler lo usa por capa.
+   */
+  virtual size_t resetPeak(size_t floor) = 0;
+};
+
+/**
+ * @class SystemAllocator
+ * @brief Reserva y libera cada bloque directamente con el sistema.
+ */
+class SystemAllocator : public Allocator {
+public:
+  SystemAllocator();
+  ~SystemAllocator() override;
+
+  float *allocate(size_t count) override;
+  void deallocate(float *ptr, size_t count) override;
+  AllocatorStats stats() const override;
+  const char *name() const override { return "system"; }
+  size_t resetPeak(size_t floor) override;
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> impl;
+};
+
+/**
+ * @class PoolAllocator
+ * @brief Pool por clases de tamaño (cuatro clases por potencia de dos, desperdicio < 25%).
+ * @details Es seguro entre hilos: cada hilo reserva y libera en sus propias listas libres y
+ *          solo acude a un pool compartido cuando la suya está vacía o llena, así que los hilos
+ *          de OpenMP no se disputan un único mutex. En resetStep() devuelve al sistema, por cada
+ *          lista, tantos bloques como el mínimo de bloques libres observado durante el paso: esos
+ *          bloques no se necesitaron, así que la memoria cacheada queda acotada por el pico de un paso.
+ */
+class PoolAllocator : public Allocator {
+public:
+  PoolAllocator();
+  ~PoolAllocator() override;
+
+  float *allocate(size_t count) override;
+  void deallocate(float *ptr, size_t count) override;
+  void resetStep() override;
+  AllocatorStats stats() const override;
+  const char *name() const override { return "pool"; }
+  size_t resetPeak(size_t floor) override;
+
+  /** @brief Libera toda la memoria cacheada. */
+  void trim();
+
+private:
+  struct Impl;
+  std::shared_ptr<Impl> impl; ///< Compartido con las cachés de cada hilo, que pueden terminar después.
+};
+
+/**
+ * @brief Devuelve el asignador usado por los nuevos tensores.
+ * @details Los bloques ya reservados siempre vuelven al asignador que los creó, por lo que
+ *          se puede cambiar con setAllocator() en cualquier momento.
+ */
+const std::shared_ptr<Allocator> &getAllocator();
+
+/** @brief Cambia el asignador activo. */
+void setAllocator(std::shared_ptr<Allocator> allocator);
+
+/**
+ * @brief Reserva el bloque de datos de un tensor; al liberarse vuelve a su asignador.
+ * @param count Número de floats.
+ * @param zeroFill Si es true, el bloque se inicializa a cero.
+ */
+std::shared_ptr<float[]> allocateStorage(size_t count, bool zeroFill);
+
+#endif // ALLOCATOR_HPP
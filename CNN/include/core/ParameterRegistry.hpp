@@ -0,0 +1,78 @@
+#ifndef PARAMETERREGISTRY_HPP
+#define PARAMETERREGISTRY_HPP
+
+#include "core/Tensor.hpp"
+#include <vector>
+
+/**
+ * @class ParameterRegistry
+ * @brief Coloca los parámetros de un modelo, y sus gradientes, en dos buffers planos.
+ *
+ * Los valores de cada parámetro se copian a un tramo de un único bloque alineado, los de su
+ * gradiente al tramo equivalente de otro, y los tensores de la lista pasan a ser vistas de
+ * esos tramos. Los optimizadores pueden entonces recorrer parámetros, gradientes y momentos
+ * con un único bucle vectorizado sobre todo el modelo (ver `Optimizer::update(ParameterRegistry &)`).
+ *
+ * Cada tramo empieza en un múltiplo de 64 bytes. El relleno entre tramos vale cero en los
+ * dos buffers y la regla de SGD o de Adam lo deja en cero.
+ *
+ * Las capas siguen usando sus tensores como siempre, con una condición: el backward debe
+ * escribir sus gradientes sobre los tensores existentes (`Tensor::copyFrom`) en lugar de
+ * reasignarlos, o el registro dejaría de verlos.
+ */
+class ParameterRegistry {
+public:
+  /** @brief Registro vacío. */
+  ParameterRegistry() = default;
+
+  /**
+   * @brief Reubica los parámetros y gradientes dados en los buffers planos.
+   * @details Los tensores que comparten memoria se mueven juntos y conservan sus posiciones
+   *          relativas, así que registrar de nuevo un modelo ya registrado mantiene la
+   *          disposición.
+   * @param parameters Parámetros entrenables del modelo.
+   * @param gradients Gradiente de cada parámetro, en el mismo orden y con la misma forma.
+   * @throws std::invalid_argument Si las listas no encajan o si los gradientes no comparten
+   *         memoria del mismo modo que sus parámetros.
+   */
+  ParameterRegistry(const std::vector<Tensor *> &parameters, const std::vector<Tensor *> &gradients);
+
+  /** @return Número de floats de cada buffer, relleno incluido. */
+  size_t size() const { return this->parameterBuffer.getSize(); }
+
+  /** @return Inicio del buffer de parámetros. */
+  float *parameterData() { return this->parameterBuffer.getData(); }
+
+  /** @return Inicio del buffer de gradientes, con la misma disposición que el de parámetros. */
+  float *gradientData() { return this->gradientBuffer.getData(); }
+
+  /** @return Los parámetros registrados. */
+  const std::vector<Tensor *> &getParameters() const { return this->parameters; }
+
+  /** @return Los gradientes registrados. */
+  const std::vector<Tensor *> &getGradients() const { return this->gradients; }
+
+private:
+  /**
+   * @brief Tensores que comparten memoria y su extensión [begin, end) dentro de ella.
+   */
+  struct Group {
+    std::vector<size_t> members;
+    size_t begin;
+    size_t end;
+    size_t start = 0; ///< Posición del tramo en el buffer plano.
+  };
+
+  /** @brief Agrupa los tensores por bloque de memoria, en orden de primera aparición. */
+  static std::vector<Group> groupByStorage(const std::vector<Tensor *> &tensors);
+
+  /** @brief Copia la extensión del grupo a su tramo y rehace sus tensores como vistas de él. */
+  static void relocate(const Group &group, const std::vector<Tensor *> &tensors, Tensor &buffer);
+
+  std::vector<Tensor *> parameters;
+  std::vector<Tensor *> gradients;
+  Tensor parameterBuffer; ///< {size()}
+  Tensor gradientBuffer;  ///< {size()}
+};
+
+#endif // PARAMETERREGISTRY_HPP
@@ -0,0 +1,98 @@
+#ifndef QUANTIZATION_HPP
+#define QUANTIZATION_HPP
+
+#include "core/Tensor.hpp"
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @file Quantization.hpp
+ * @brief Inferencia cuantizada a int8 (post-training quantization) de Dense y Conv2D.
+ *
+ * - Pesos: int8 simétricos con una escala por canal de salida, `max|W[:, j]| / 127`.
+ * - Activaciones de entrada: uint8 con punto cero 128 y una escala fija por capa, obtenida
+ *   del rango `max|x|` observado durante la calibración (`x ≈ escala * (q - 128)`).
+ * - Producto acumulado en int32 (con `vpdpbusd` si la CPU tiene AVX-512 VNNI), corregido por
+ *   el punto cero y devuelto a float con el bias ya sumado.
+ *
+ * Los pesos en float se conservan: la versión int8 es una copia generada a partir de ellos
+ * (por ejemplo, después de `loadModel`), así que el formato de `saveModel` no cambia.
+ */
+
+/**
+ * @class QuantizedMatrix
+ * @brief Matriz de pesos B {k, n} cuantizada por columnas y empaquetada para `qgemm`.
+ */
+class QuantizedMatrix {
+public:
+  QuantizedMatrix() = default;
+
+  /**
+   * @brief Cuantiza B (con strides `rsB`, `csB`) columna a columna.
+   * @param inputScale Escala de las activaciones que multiplicarán a B.
+   * @param bias n floats que se suman a la salida (puede ser nulo).
+   */
+  QuantizedMatrix(const float *b, size_t k, size_t n, size_t rsB, size_t csB, float inputScale, const float *bias);
+
+  size_t rows() const { return k; }
+  size_t cols() const { return n; }
+
+private:
+  friend void qgemm(size_t m, const float *a, size_t rsA, size_t csA, const QuantizedMatrix &b, float *c, size_t rsC);
+
+  size_t k = 0;
+  size_t n = 0;
+  size_t kQuads = 0;                   ///< Grupos de 4 valores de k (el producto int8 consume 4 a la vez).
+  float invInputScale = 0.0f;
+  std::vector<int8_t> panels;          ///< Paneles de 16 columnas: [n / 16][k / 4][16][4].
+  std::vector<int32_t> zeroCorrection; ///< 128 * sum(Bq[:, j]): lo que aporta el punto cero de la entrada.
+  std::vector<float> outputScale;      ///< inputScale * escala de la columna j.
+  std::vector<float> bias;
+};
+
+/**
+ * @brief C (m x n) = A (m x k) * B + bias, cuantizando A a uint8 por bloques de filas.
+ * @details C debe tener filas contiguas (stride de fila `rsC`). Se paraleliza por bloques de
+ *          filas salvo dentro de una región paralela de OpenMP.
+ */
+void qgemm(size_t m, const float *a, size_t rsA, size_t csA, const QuantizedMatrix &b, float *c, size_t rsC);
+
+/**
+ * @brief Modo de ejecución int8 de una capa.
+ */
+enum class Int8Mode {
+  Off,       ///< Forward en float.
+  Calibrate, ///< Forward en float registrando el rango de las entradas.
+  Quantized  ///< Inferencia (`isTraining = false`) en int8; el entrenamiento sigue en float.
+};
+
+/**
+ * @class Int8Linear
+ * @brief Estado int8 de una transformación `Y = X * W + b` (Dense, Conv2D vía im2col).
+ */
+class Int8Linear {
+public:
+  Int8Mode getMode() const { return mode; }
+  bool isQuantized() const { return mode == Int8Mode::Quantized; }
+
+  /**
+   * @brief Cambia de modo.
+   * @details `Calibrate` reinicia el rango observado; `Quantized` cuantiza W {k, n} y b {1, n}
+   *          con ese rango (lanza si la capa no vio ninguna entrada); `Off` libera la copia int8.
+   */
+  void setMode(Int8Mode newMode, const Tensor &weights, const Tensor &bias);
+
+  /** @brief En modo `Calibrate` acumula `max|x|` de la entrada; en los demás no hace nada. */
+  void observe(const Tensor &input);
+
+  /** @brief output {filas, n} (contiguo) = input {filas, k} * W + b, en int8. */
+  void forward(const Tensor &input, Tensor &output) const;
+
+private:
+  Int8Mode mode = Int8Mode::Off;
+  float absMax = 0.0f;
+  QuantizedMatrix matrix;
+};
+
+#endif // QUANTIZATION_HPP
@@ -43,6 +43,13 @@ public:
    */
   Tensor(const std::vector<size_t> &shape, const std::vector<float> &data);
 
+  /**
+   * @brief Crea un "Owning Tensor" sin inicializar sus datos.
+   * @details Solo para buffers que se van a sobrescribir por completo (salidas de matrixMultiply,
+   *          activaciones, copias). Evita el relleno con ceros del constructor normal.
+   */
+  static Tensor uninitialized(const std::vector<size_t> &shape);
+
   // --- Constructores y asignaciones de copia/movimiento (bajo coste) ---
   Tensor(const Tensor &other) = default;
   Tensor(Tensor &&other) noexcept = default;
@@ -79,9 +86,50 @@ public:
    */
   Tensor slice(size_t start, size_t count) const;
 
-  /** @brief Devuelve un nuevo tensor que es la transpuesta del original (para 2D). */
+  /**
+   * @brief Vista de `count` posiciones a partir de `start` a lo largo de un eje cualquiera.
+   * @details No copia datos: conserva los strides y desplaza el offset. Si el eje no es el
+   *          primero, la vista deja de ser contigua (ej. las columnas de una matriz).
+   */
+  Tensor slice(size_t axis, size_t start, size_t count) const;
+
+  /**
+   * @brief Cambia la forma sin cambiar el número de elementos.
+   * @details Si el tensor es contiguo devuelve una vista (sin copia); si no, copia primero
+   *          los datos con `contiguous()`.
+   */
+  Tensor reshape(const std::vector<size_t> &newShape) const;
+
+  /**
+   * @brief Vista con dos dimensiones intercambiadas (intercambia forma y strides, sin copia).
+   * @details `matrixMultiply` y los operadores de acceso respetan los strides, así que la
+   *          vista transpuesta se puede usar directamente como operando.
+   */
+  Tensor transpose(size_t dim1, size_t dim2) const;
+
+  /** @brief Transpuesta de una matriz (tensor 2D) como vista; equivale a `transpose(0, 1)`. */
   Tensor transpose() const;
 
+  /**
+   * @brief Vista que repite `count` veces un eje de tamaño 1 con stride 0 (broadcast), sin copia.
+   * @details Todas las posiciones del eje leen los mismos datos; ej. una imagen en gris
+   *          {N, 1, H, W} vista como {N, 3, H, W}. La vista no es contigua: `contiguous()`
+   *          materializa las copias y no se debe escribir a través de ella.
+   */
+  Tensor expand(size_t axis, size_t count) const;
+
+  /** @brief Indica si el eje repite los mismos datos (stride 0 y tamaño mayor que 1), como tras `expand`. */
+  bool isBroadcast(size_t axis) const { return axis < shape.size() && shape[axis] > 1 && strides[axis] == 0; }
+
+  /**
+   * @brief Devuelve el tensor con sus datos contiguos en memoria (row-major).
+   * @details Si ya lo está, devuelve una vista del mismo bloque sin copiar.
+   */
+  Tensor contiguous() const;
+
+  /** @brief Indica si los elementos están en orden row-major sin huecos (los strides son los de la forma). */
+  bool isContiguous() const;
+
   /** @brief Devuelve un nuevo tensor con el cuadrado de cada elemento. */
   Tensor square() const;
 
@@ -99,6 +147,14 @@ public:
    */
   void addBroadcast(const Tensor &other);
 
+  /**
+   * @brief Copia los valores de `source` sobre la memoria de este tensor.
+   * @details A diferencia de la asignación, el tensor sigue apuntando al mismo bloque, así
+   *          que las vistas que lo compartan (ej. las de `ParameterRegistry`) ven el cambio.
+   *          Este tensor debe ser contiguo y ambos deben tener la misma forma.
+   */
+  void copyFrom(const Tensor &source);
+
   // --- Métodos de Inicialización (solo para "Owning Tensors") ---
 
   /** @brief Rellena el tensor con un valor escalar. */
@@ -118,6 +174,9 @@ public:
   /** @brief Devuelve los strides del tensor. */
   const std::vector<size_t> &getStrides() const { return strides; }
 
+  /** @brief Desplazamiento de la vista dentro del bloque (`getData() + getDataOffset()` es el elemento 0). */
+  size_t getDataOffset() const { return dataOffset; }
+
   /** @brief Devuelve un puntero de solo lectura al inicio del bloque de datos subyacente. */
   const float *getData() const;
 
@@ -128,6 +187,9 @@ public:
   std::string shapeToString() const;
 
 private:
+  /// Reubica parámetros y gradientes como vistas de sus buffers planos.
+  friend class ParameterRegistry;
+
   /**
    * @brief Constructor privado para crear vistas (slices).
    * @param dataPtr Puntero compartido al bloque de datos original.
@@ -135,7 +197,7 @@ private:
    * @param strides Los strides del tensor original (se reutilizan).
    * @param offset El desplazamiento en elementos desde el inicio del `dataPtr`.
    */
-  Tensor(std::shared_ptr<std::vector<float>> dataPtr, const std::vector<size_t> &shape, const std::vector<size_t> &strides,
+  Tensor(std::shared_ptr<float[]> dataPtr, const std::vector<size_t> &shape, const std::vector<size_t> &strides,
          size_t offset);
 
   /** @brief Calcula los strides basándose en la forma del tensor. */
@@ -145,11 +207,12 @@ private:
   template <typename... Args> size_t getFlatIndex(Args... args) const;
 
   // --- Miembros ---
-  std::shared_ptr<std::vector<float>> dataPtr; ///< Puntero compartido a los datos. Permite vistas eficientes.
-  std::vector<size_t> shape;                   ///< Dimensiones de este tensor/vista (ej: {N, C, H, W}).
-  std::vector<size_t> strides;                 ///< Pasos en memoria para cada dimensión. Clave para el acceso.
-  size_t dataOffset;                           ///< Desplazamiento desde el inicio de `dataPtr` para esta vista.
-  size_t totalSize;                            ///< Número total de elementos en esta vista/tensor.
+  std::shared_ptr<float[]> dataPtr; ///< Puntero compartido a los datos. Permite vistas eficientes.
+  std::vector<size_t> shape;        ///< Dimensiones de este tensor/vista (ej: {N, C, H, W}).
+  std::vector<size_t> strides;      ///< Pasos en memoria para cada dimensión. Clave para el acceso.
+  size_t dataOffset;                ///< Desplazamiento desde el inicio de `dataPtr` para esta vista.
+  size_t totalSize;                 ///< Número total de elementos en esta vista/tensor.
+  size_t storageSize;               ///< Número de floats del bloque `dataPtr` completo.
 };
 
 // --- Funciones Libres ---
@@ -165,7 +228,7 @@ inline float &Tensor::operator()(size_t i) {
   if (shape.size() != 1 || i >= shape[0])
     throw std::out_of_range("Acceso 1D fuera de rango.");
 #endif
-  return (*dataPtr)[dataOffset + i * strides[0]];
+  return dataPtr[dataOffset + i * strides[0]];
 }
 
 inline const float &Tensor::operator()(size_t i) const {
@@ -173,7 +236,7 @@ inline const float &Tensor::operator()(size_t i) const {
   if (shape.size() != 1 || i >= shape[0])
     throw std::out_of_range("Acceso 1D fuera de rango.");
 #endif
-  return (*dataPtr)[dataOffset + i * strides[0]];
+  return dataPtr[dataOffset + i * strides[0]];
 }
 
 // --- Implementación de acceso optimizado para 2D ---
@@ -182,7 +245,7 @@ inline float &Tensor::operator()(size_t i, size_t j) {
   if (shape.size() != 2 || i >= shape[0] || j >= shape[1])
     throw std::out_of_range("Acceso 2D fuera de rango.");
 #endif
-  return (*dataPtr)[dataOffset + i * strides[0] + j * strides[1]];
+  return dataPtr[dataOffset + i * strides[0] + j * strides[1]];
 }
 
 inline const float &Tensor::operator()(size_t i, size_t j) const {
@@ -190,7 +253,7 @@ inline const float &Tensor::operator()(size_t i, size_t j) const {
   if (shape.size() != 2 || i >= shape[0] || j >= shape[1])
     throw std::out_of_range("Acceso 2D fuera de rango.");
 #endif
-  return (*dataPtr)[dataOffset + i * strides[0] + j * strides[1]];
+  return dataPtr[dataOffset + i * strides[0] + j * strides[1]];
 }
 
 // --- Implementación de acceso optimizado para 4D ---
@@ -199,7 +262,7 @@ inline float &Tensor::operator()(size_t b, size_t c, size_t h, size_t w) {
   if (shape.size() != 4 || b >= shape[0] || c >= shape[1] || h >= shape[2] || w >= shape[3])
     throw std::out_of_range("Acceso 4D fuera de rango.");
 #endif
-  return (*dataPtr)[dataOffset + b * strides[0] + c * strides[1] + h * strides[2] + w * strides[3]];
+  return dataPtr[dataOffset + b * strides[0] + c * strides[1] + h * strides[2] + w * strides[3]];
 }
 
 inline const float &Tensor::operator()(size_t b, size_t c, size_t h, size_t w) const {
@@ -207,7 +270,7 @@ inline const float &Tensor::operator()(size_t b, size_t c, size_t h, size_t w) c
   if (shape.size() != 4 || b >= shape[0] || c >= shape[1] || h >= shape[2] || w >= shape[3])
     throw std::out_of_range("Acceso 4D fuera de rango.");
 #endif
-  return (*dataPtr)[dataOffset + b * strides[0] + c * strides[1] + h * strides[2] + w * strides[3]];
+  return dataPtr[dataOffset + b * strides[0] + c * strides[1] + h * strides[2] + w * strides[3]];
 }
 
 // --- Implementación de templates ---
@@ -229,8 +292,8 @@ template <typename... Args> size_t Tensor::getFlatIndex(Args... args) const {
   return index;
 }
 
-template <typename... Args> float &Tensor::operator()(Args... args) { return (*dataPtr)[getFlatIndex(args...)]; }
+template <typename... Args> float &Tensor::operator()(Args... args) { return dataPtr[getFlatIndex(args...)]; }
 
-template <typename... Args> const float &Tensor::operator()(Args... args) const { return (*dataPtr)[getFlatIndex(args...)]; }
+template <typename... Args> const float &Tensor::operator()(Args... args) const { return dataPtr[getFlatIndex(args...)]; }
 
 #endif // TENSOR_HPP
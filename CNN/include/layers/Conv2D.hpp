@@ -2,6 +2,8 @@
 #define CONV2D_HPP
 
 #include "layers/Layer.hpp"
+#include <map>
+#include <string>
 
 /**
  * @class Conv2D
@@ -11,12 +13,40 @@
  * para producir mapas de características (feature maps). La convolución es una
  * operación clave para detectar patrones locales como bordes, texturas o formas.
  *
- * La implementación utiliza la técnica 'im2col' (image-to-column) para transformar
- * la operación de convolución en una multiplicación de matrices de alta eficiencia,
- * lo que permite aprovechar las optimizaciones de GEMM (General Matrix Multiply).
+ * El forward dispone de tres algoritmos (ver `Conv2D::Algorithm`):
+ * - 'im2col' (image-to-column): transforma la convolución en una multiplicación de
+ *   matrices; la matriz de columnas ocupa K*K veces la entrada.
+ * - Directo: recorre la entrada con relleno y acumula bloques de 8 canales de salida
+ *   (pesos empaquetados en formato NCHWc), sin matriz intermedia.
+ * - Winograd F(2x2, 3x3): solo para kernels 3x3 con stride 1. Cada tesela de salida 2x2
+ *   se calcula con 16 productos en lugar de 36, a cambio de transformar entrada y pesos.
+ *
+ * Con `Algorithm::Auto` (por defecto) el algoritmo sale de una regla fija según la forma
+ * de la capa (ver `heuristicAlgorithm`), así que el forward no mide nada y el resultado es
+ * siempre el mismo. `autotune` (o `Sequential::autotune`) mide los candidatos sobre una
+ * entrada de ejemplo y guarda el más rápido para esa forma; es un paso explícito de
+ * calentamiento que no forma parte del entrenamiento. La variable de entorno
+ * `CNN_CONV_ALGO` (im2col, direct, winograd o auto) fija el algoritmo inicial de todas las
+ * capas. El backward usa siempre im2col.
+ *
+ * Si la entrada repite un mismo plano en todos sus canales (eje de canales con stride 0, ver
+ * `Tensor::expand`), la convolución se calcula sobre ese único plano con los pesos sumados
+ * sobre los canales de entrada: el resultado es el mismo y el forward hace inChannels veces
+ * menos operaciones.
+ *
+ * En modo int8 (`setInt8Mode`) el forward de inferencia usa siempre im2col con el producto
+ * cuantizado, sea cual sea el algoritmo configurado.
  */
 class Conv2D : public Layer {
 public:
+  /** @brief Algoritmo usado en el forward. */
+  enum class Algorithm {
+    Auto,    ///< Regla fija por forma, o lo medido por `autotune` para esa forma de entrada.
+    Im2col,  ///< im2col + multiplicación de matrices.
+    Direct,  ///< Convolución directa con bloques de canales de salida.
+    Winograd ///< Winograd F(2x2, 3x3); si la capa no es 3x3 con stride 1 se usa Direct.
+  };
+
   /**
    * @brief Constructor de la capa Conv2D.
    * @param inChannels Número de canales en el tensor de entrada (ej. 1 para escala de grises, 3 para RGB).
@@ -29,8 +59,8 @@ public:
 
   /**
    * @brief Realiza el paso hacia adelante de la convolución.
-   * @details Utiliza `im2col` para remodelar la entrada, luego realiza una
-   *          multiplicación de matrices con los pesos y finalmente añade el bias.
+   * @details Calcula la convolución con el algoritmo seleccionado (im2col, directo o
+   *          Winograd) y finalmente añade el bias.
    * @param input Tensor de entrada de forma {Batch, inChannels, Height, Width}.
    * @param isTraining Si es `true`, almacena datos necesarios para el backward pass.
    * @return Tensor de salida (mapas de características) de forma {Batch, outChannels, outHeight, outWidth}.
@@ -64,6 +94,51 @@ public:
 
   std::string getName() const override { return "Conv2D"; }
 
+  /** @brief Copia que comparte los pesos y el bias y tiene sus propios gradientes. */
+  std::unique_ptr<Layer> clone() const override;
+
+  /** @brief Fija el algoritmo del forward y descarta las elecciones del autoajuste. */
+  void setAlgorithm(Algorithm algorithm);
+
+  /**
+   * @brief Algoritmo que usará el forward para la forma de entrada dada.
+   * @details El configurado o, si es Auto, el medido por `autotune` para esa forma o, si no
+   *          se ha medido, el de la regla fija. Nunca devuelve `Algorithm::Auto`.
+   */
+  Algorithm getAlgorithm(const std::vector<size_t> &inputShape) const;
+
+  /**
+   * @brief Mide los algoritmos aplicables sobre `input` y guarda el más rápido para su forma.
+   * @details Solo en modo Auto; con otro algoritmo configurado no hace nada. Ejecuta cada
+   *          candidato dos veces (la primera calienta cachés y el pool de memoria). Si la
+   *          entrada repite canales, se mide y se guarda para su plano único {B, 1, H, W}.
+   * @param input Entrada de ejemplo {B, inChannels, H, W}, con la forma que tendrá en el forward.
+   * @override
+   */
+  void autotune(const Tensor &input) override;
+
+  /**
+   * @brief Descarta la caché de `channelSummedWeights()`.
+   * @override
+   */
+  void parametersUpdated() override;
+
+  /** @brief Nombre del algoritmo ("auto", "im2col", "direct" o "winograd"). */
+  static std::string algorithmName(Algorithm algorithm);
+
+  /** @brief FLOPs de la convolución directa: 2 * B * outC * outH * outW * inC * K * K, más el bias. */
+  double getFlops(const std::vector<size_t> &inputShape) const override;
+
+  /**
+   * @brief Calibración y cuantización int8 de la convolución.
+   * @details Cuantiza los filtros como matriz {inC*K*K, outC} y también sus pesos sumados
+   *          sobre los canales, que son los que se aplican a una entrada con canales repetidos.
+   */
+  void setInt8Mode(Int8Mode mode) override;
+
+  /** @brief Forma de la salida {B, outC, outH, outW} para una entrada {B, inC, H, W}. */
+  std::vector<size_t> getOutputShape(const std::vector<size_t> &inputShape) const;
+
 private:
   // --- Hiperparámetros de la capa ---
   size_t inChannels;
@@ -80,16 +155,63 @@ private:
   Tensor weightGradients; ///< Gradientes de los pesos.
   Tensor biasGradients;   ///< Gradientes de los biases.
 
+  // --- Selección de algoritmo ---
+  Algorithm algorithm;                                       ///< Algoritmo configurado.
+  std::map<std::vector<size_t>, Algorithm> tunedAlgorithms; ///< Elección de `autotune` por forma de entrada.
+
   // --- Estado para el backward pass ---
   Tensor im2colMatrix;            ///< Matriz generada por `im2col` en el forward pass. Se reutiliza en el backward.
+  bool im2colValid = false;       ///< `im2colMatrix` corresponde a `lastInput` (el forward usó im2col).
+  Tensor lastInput;               ///< Entrada del último forward de entrenamiento (comparte memoria).
   std::vector<size_t> inputShape; ///< Forma del tensor de entrada, necesaria para `col2im`.
+  bool broadcastInput = false;    ///< `lastInput` es el plano único {B, 1, H, W} de una entrada con canales repetidos.
+
+  // --- Inferencia int8 ---
+  Int8Linear int8;       ///< Filtros `weights` cuantizados.
+  Int8Linear int8Summed; ///< Filtros `channelSummedWeights()` cuantizados (entrada con canales repetidos).
+
+  // --- Caché de los pesos sumados sobre los canales ---
+  mutable Tensor summedWeights;            ///< Último resultado de `channelSummedWeights()`.
+  mutable bool summedWeightsValid = false; ///< `summedWeights` corresponde a los pesos actuales.
+
+  // --- Algoritmos del forward ---
+  // Reciben los filtros {outC, C, K, K} que se aplican a una entrada de C canales: `weights`,
+  // o `channelSummedWeights()` sobre el plano único de una entrada con canales repetidos.
+
+  /**
+   * @brief Algoritmo de Auto sin medir, según la forma de la capa y de su salida.
+   * @param outH Altura de la salida.
+   * @param outW Anchura de la salida.
+   */
+  Algorithm heuristicAlgorithm(size_t outH, size_t outW) const;
+
+  /** @brief Ejecuta el forward (bias incluido) con un algoritmo concreto. */
+  Tensor forwardWith(Algorithm algorithm, const Tensor &input, const Tensor &filters, size_t outH, size_t outW);
+
+  /** @brief im2col + GEMM. Resultado {B, outC, outH, outW}. */
+  Tensor forwardIm2col(const Tensor &input, const Tensor &filters, size_t outH, size_t outW);
+
+  /** @brief Convolución directa sobre la entrada con relleno. */
+  Tensor forwardDirect(const Tensor &input, const Tensor &filters, size_t outH, size_t outW) const;
+
+  /** @brief Winograd F(2x2, 3x3). Requiere kernel 3x3 y stride 1. */
+  Tensor forwardWinograd(const Tensor &input, const Tensor &filters, size_t outH, size_t outW) const;
+
+  /** @brief Producto int8 de los parches de la entrada por los filtros cuantizados en `linear`. */
+  Tensor forwardInt8(const Tensor &input, const Int8Linear &linear, size_t outH, size_t outW) const;
+
+  /** @brief Pesos sumados sobre los canales de entrada: {outC, 1, K, K}, desde la caché si es válida. */
+  Tensor channelSummedWeights() const;
+
+  /** @brief Winograd es aplicable a esta capa. */
+  bool supportsWinograd() const { return kernelSize == 3 && stride == 1; }
 
   // --- Funciones de utilidad para la convolución ---
 
   /**
    * @brief Transforma los parches de la imagen de entrada en columnas de una matriz.
    * @details Es la clave para convertir la convolución en una multiplicación de matrices.
-   * @param input Tensor de entrada (con padding si es necesario).
+   * @param input Tensor de entrada {B, C, H, W}; la matriz tiene C*K*K filas.
    * @param outH Altura de la salida calculada.
    * @param outW Anchura de la salida calculada.
    */
@@ -97,9 +219,10 @@ private:
 
   /**
    * @brief Transforma las columnas de una matriz de gradientes de vuelta a una "imagen" de gradientes.
-   * @details Es la operación inversa de `im2col` y se usa para calcular dE/dX.
+   * @details Es la operación inversa de `im2col` y se usa para calcular dE/dX. Se paraleliza
+   *          sobre los píxeles de la imagen (sin atómicas) y es determinista.
    * @param colMatrix Matriz de columnas (gradientes) que se va a transformar.
-   * @param outputImage Tensor de destino donde se acumulan los gradientes de la "imagen".
+   * @param outputImage Tensor de destino; cada píxel se sobrescribe con la suma de sus gradientes.
    */
   void col2im(const Tensor &colMatrix, Tensor &outputImage);
 };
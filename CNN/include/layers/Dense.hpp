@@ -67,6 +67,21 @@ public:
    */
   std::string getName() const override { return "Dense"; }
 
+  /** @brief Copia que comparte los pesos y el bias y tiene sus propios gradientes. */
+  std::unique_ptr<Layer> clone() const override;
+
+  /** @brief FLOPs del forward: GEMM (2 * filas * entrada * salida) más el bias. */
+  double getFlops(const std::vector<size_t> &inputShape) const override;
+
+  /**
+   * @brief Calibración y cuantización int8 de `output = input * weights + bias`.
+   * @details En modo `Quantized` el forward de inferencia usa una copia int8 de los pesos.
+   */
+  void setInt8Mode(Int8Mode mode) override { this->int8.setMode(mode, this->weights, this->bias); }
+
+  /** @brief Número de neuronas (columnas de la salida). */
+  size_t getOutputSize() const { return weights.getShape()[1]; }
+
 private:
   // Parámetros entrenables
   Tensor weights; ///< Matriz de pesos de la capa, de forma {input_size, output_size}.
@@ -78,6 +93,8 @@ private:
 
   // Estado necesario para el backward pass
   Tensor inputTensor; ///< Copia de la entrada del forward pass, necesaria para calcular gradientes.
+
+  Int8Linear int8; ///< Rango calibrado de la entrada y pesos cuantizados.
 };
 
 #endif // DENSE_HPP
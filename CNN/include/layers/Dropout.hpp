@@ -53,6 +53,11 @@ public:
    */
   std::string getName() const override { return "Dropout"; }
 
+  std::unique_ptr<Layer> clone() const override { return std::make_unique<Dropout>(*this); }
+
+  /** @brief Una multiplicación por elemento (máscara y escala ya combinadas). */
+  double getFlops(const std::vector<size_t> &inputShape) const override;
+
 private:
   float rate;         ///< La probabilidad de que una unidad sea puesta a cero.
   float scale;        ///< Factor de escala para las unidades restantes (1.0 / (1.0 - rate)).
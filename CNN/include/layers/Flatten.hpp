@@ -22,10 +22,10 @@ public:
   /**
    * @brief Aplana el tensor de entrada.
    * @details Almacena la forma de entrada para el paso hacia atrás y luego
-   *          remodela la entrada a (batch_size, flattened_features).
+   *          remodela la entrada a (batch_size, flattened_features) con `Tensor::reshape`.
    * @param input El tensor de entrada (ej. de forma {B, C, H, W}).
    * @param isTraining Ignorado, ya que el comportamiento es el mismo.
-   * @return Un nuevo tensor aplanado de forma {B, C*H*W}.
+   * @return Una vista aplanada de forma {B, C*H*W} (sin copia si la entrada es contigua).
    * @override
    */
   Tensor forward(const Tensor &input, bool isTraining) override;
@@ -47,6 +47,8 @@ public:
    */
   std::string getName() const override { return "Flatten"; }
 
+  std::unique_ptr<Layer> clone() const override { return std::make_unique<Flatten>(*this); }
+
 private:
   /** @brief Almacena la forma de la entrada durante el forward pass.
    *         Es necesario para poder reconstruir la forma en el backward pass.
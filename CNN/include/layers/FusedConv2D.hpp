@@ -0,0 +1,82 @@
+#ifndef FUSEDCONV2D_HPP
+#define FUSEDCONV2D_HPP
+
+#include "layers/Conv2D.hpp"
+#include "layers/Pooling2D.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @class FusedConv2D
+ * @brief Bloque Conv2D → ReLU → MaxPooling (el pooling es opcional) ejecutado como una capa.
+ *
+ * La crea la pasada de fusión de `Sequential::compile` a partir de las capas originales,
+ * de las que toma la propiedad: los parámetros siguen siendo los de la Conv2D (mismos
+ * punteros y mismo orden), así que el optimizador y la serialización no notan el cambio.
+ *
+ * Tras la convolución, un único recorrido aplica ReLU y el max-pooling y escribe la salida
+ * final. Para el backward solo se guarda un byte por salida: la posición del máximo en su
+ * ventana, o `BLOCKED` si el máximo no era positivo (ReLU anula el gradiente). Sin pooling,
+ * el byte es la máscara de ReLU. Las capas separadas guardaban la entrada completa de ReLU
+ * y los índices del pooling en floats, y recorrían la activación dos veces más.
+ */
+class FusedConv2D : public Layer {
+public:
+  /**
+   * @brief Construye el bloque.
+   * @param conv La convolución del bloque.
+   * @param pool Max pooling con ventanas no solapadas (stride == poolSize), o nullptr.
+   */
+  FusedConv2D(std::unique_ptr<Conv2D> conv, std::unique_ptr<Pooling2D> pool);
+
+  /** @brief El pooling se puede fusionar: max pooling sin solapamiento y ventana de menos de 255 posiciones. */
+  static bool canFusePool(const Pooling2D &pool);
+
+  /**
+   * @brief Convolución y, en una sola pasada, ReLU y max pooling.
+   * @param input Tensor de entrada de forma {Batch, inChannels, Height, Width}.
+   * @param isTraining Si es `true`, guarda las posiciones de los máximos para el backward.
+   * @return Tensor {Batch, outChannels, Height', Width'} (reducido por el pooling, si lo hay).
+   * @override
+   */
+  Tensor forward(const Tensor &input, bool isTraining) override;
+
+  /**
+   * @brief Lleva el gradiente a la posición del máximo de cada ventana (si estaba activa)
+   *        y continúa con el backward de la convolución.
+   * @override
+   */
+  Tensor backward(const Tensor &outputGradient) override;
+
+  std::vector<Tensor *> getParameters() override { return conv->getParameters(); }
+  std::vector<Tensor *> getGradients() override { return conv->getGradients(); }
+
+  void setInt8Mode(Int8Mode mode) override { conv->setInt8Mode(mode); }
+
+  void autotune(const Tensor &input) override { conv->autotune(input); }
+
+  void parametersUpdated() override { conv->parametersUpdated(); }
+
+  /** @brief Nombres de las capas fusionadas, ej. "Conv2D+ReLU+MaxPooling". */
+  std::string getName() const override;
+
+  std::unique_ptr<Layer> clone() const override;
+
+  /** @brief FLOPs de la convolución más una comparación por elemento de su salida. */
+  double getFlops(const std::vector<size_t> &inputShape) const override;
+
+private:
+  /// Marca de las salidas cuyo gradiente bloquea ReLU.
+  static constexpr uint8_t BLOCKED = 0xFF;
+
+  std::unique_ptr<Conv2D> conv;
+  std::unique_ptr<Pooling2D> pool; ///< nullptr si el bloque es solo Conv2D → ReLU.
+
+  // --- Estado para el backward pass ---
+  std::vector<uint8_t> argmax;        ///< Un byte por salida: posición del máximo en la ventana, o BLOCKED.
+  std::vector<size_t> convOutputShape; ///< Forma de la salida de la convolución (antes del pooling).
+};
+
+#endif // FUSEDCONV2D_HPP
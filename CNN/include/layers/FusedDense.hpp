@@ -0,0 +1,56 @@
+#ifndef FUSEDDENSE_HPP
+#define FUSEDDENSE_HPP
+
+#include "layers/Dense.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @class FusedDense
+ * @brief Bloque Dense → ReLU ejecutado como una capa.
+ *
+ * Lo crea la pasada de fusión de `Sequential::compile`. ReLU se aplica en el sitio sobre la
+ * salida recién calculada de la Dense (sin otro tensor de salida) y, para el backward, se
+ * guarda una máscara de un byte por elemento en lugar de una copia de la entrada de ReLU.
+ * Los parámetros son los de la Dense original.
+ */
+class FusedDense : public Layer {
+public:
+  /** @param dense La capa densa del bloque (el bloque toma su propiedad). */
+  explicit FusedDense(std::unique_ptr<Dense> dense);
+
+  /**
+   * @brief `max(0, input * weights + bias)`.
+   * @param input Tensor de entrada de forma {batch_size, input_size}.
+   * @param isTraining Si es `true`, guarda la máscara de ReLU.
+   * @return Tensor de salida de forma {batch_size, output_size}.
+   * @override
+   */
+  Tensor forward(const Tensor &input, bool isTraining) override;
+
+  /** @brief Aplica la máscara de ReLU al gradiente y continúa con el backward de la Dense. */
+  Tensor backward(const Tensor &outputGradient) override;
+
+  std::vector<Tensor *> getParameters() override { return dense->getParameters(); }
+  std::vector<Tensor *> getGradients() override { return dense->getGradients(); }
+
+  void setInt8Mode(Int8Mode mode) override { dense->setInt8Mode(mode); }
+
+  /** @return El string "Dense+ReLU". */
+  std::string getName() const override { return dense->getName() + "+ReLU"; }
+
+  std::unique_ptr<Layer> clone() const override {
+    return std::make_unique<FusedDense>(std::unique_ptr<Dense>(static_cast<Dense *>(dense->clone().release())));
+  }
+
+  /** @brief FLOPs de la Dense más una comparación por salida. */
+  double getFlops(const std::vector<size_t> &inputShape) const override;
+
+private:
+  std::unique_ptr<Dense> dense;
+  std::vector<uint8_t> activeMask; ///< 1 si la salida era positiva (el gradiente pasa).
+};
+
+#endif // FUSEDDENSE_HPP
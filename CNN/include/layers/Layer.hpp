@@ -1,7 +1,9 @@
 #ifndef LAYER_HPP
 #define LAYER_HPP
 
+#include "core/Quantization.hpp"
 #include "core/Tensor.hpp"
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -32,7 +34,9 @@ public:
    * @brief Realiza el paso hacia atrás (backward pass) o retropropagación.
    * @details Calcula el gradiente de la pérdida con respecto a la entrada de esta capa
    * (para pasarlo a la capa anterior) y calcula los gradientes de los parámetros
-   * internos de la capa (si los tiene, ej. pesos y bias).
+   * internos de la capa (si los tiene, ej. pesos y bias). Los gradientes se escriben
+   * sobre los tensores que devuelve `getGradients()`, sin reasignarlos, porque pueden
+   * ser vistas de un `ParameterRegistry`.
    * @param outputGradient El gradiente de la función de pérdida con respecto a la
    *        salida de esta capa (dE/dY).
    * @return El gradiente de la función de pérdida con respecto a la entrada de esta
@@ -64,6 +68,59 @@ public:
    * @return Un string con el nombre de la capa (ej. "Dense", "Conv2D").
    */
   virtual std::string getName() const = 0;
+
+  /**
+   * @brief Copia de la capa para una réplica del paralelismo de datos de `Sequential`.
+   * @details La copia tiene los mismos hiperparámetros y comparte los tensores de
+   *          parámetros con la original (Tensor comparte su memoria al copiarse), pero
+   *          recibe gradientes propios, porque el backward escribe sobre ellos. El estado
+   *          del backward se reasigna en cada paso. Las capas que no lo implementan
+   *          devuelven nullptr.
+   */
+  virtual std::unique_ptr<Layer> clone() const { return nullptr; }
+
+  /**
+   * @brief FLOPs aproximados del forward para una entrada con la forma dada.
+   * @details Solo los usa el Profiler, que estima el backward como el doble. Las capas
+   *          que no los estiman devuelven 0.
+   * @param inputShape Forma del tensor de entrada.
+   */
+  virtual double getFlops(const std::vector<size_t> & /*inputShape*/) const { return 0.0; }
+
+  /**
+   * @brief Cambia el modo de ejecución int8 de la capa (ver `Int8Mode`).
+   * @details Solo lo implementan las capas con una versión cuantizada (Dense, Conv2D y las
+   *          capas fusionadas que las contienen); el resto lo ignora.
+   */
+  virtual void setInt8Mode(Int8Mode /*mode*/) {}
+
+  /**
+   * @brief Ajusta la capa a la forma de `input` midiendo sus alternativas de cálculo.
+   * @details Es un paso explícito de calentamiento (ver `Sequential::autotune`); el forward
+   *          nunca mide nada. Solo lo implementan las capas con varios algoritmos (Conv2D y
+   *          las capas fusionadas que la contienen); el resto lo ignora.
+   * @param input Entrada de ejemplo con la forma que tendrá en el forward.
+   */
+  virtual void autotune(const Tensor & /*input*/) {}
+
+  /**
+   * @brief Avisa de que los parámetros han cambiado desde fuera de la capa.
+   * @details Lo llaman `Sequential::train` después de cada paso del optimizador y `loadModel`
+   *          tras escribir los pesos. Las capas que guardan datos derivados de sus parámetros
+   *          (ej. los pesos sumados de Conv2D) los descartan aquí; el resto lo ignora. Quien
+   *          modifique los parámetros por otra vía (ej. a través de `getParameters()`) debe
+   *          llamarlo también.
+   */
+  virtual void parametersUpdated() {}
+
+protected:
+  /** @brief Número de elementos de una forma, como double para las cuentas de FLOPs. */
+  static double countElements(const std::vector<size_t> &shape) {
+    double count = 1.0;
+    for (size_t dim : shape)
+      count *= static_cast<double>(dim);
+    return count;
+  }
 };
 
 #endif // LAYER_HPP
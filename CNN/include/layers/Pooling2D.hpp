@@ -59,6 +59,16 @@ public:
    */
   std::string getName() const override;
 
+  std::unique_ptr<Layer> clone() const override { return std::make_unique<Pooling2D>(*this); }
+
+  /** @brief Una comparación (o suma) por elemento de cada ventana. */
+  double getFlops(const std::vector<size_t> &inputShape) const override;
+
+  // --- Getters (usados por la fusión de capas de Sequential) ---
+  PoolType getType() const { return type; }
+  size_t getPoolSize() const { return poolSize; }
+  size_t getStride() const { return stride; }
+
 private:
   PoolType type;   ///< El tipo de pooling (Max o Average).
   size_t poolSize; ///< Tamaño de la ventana de pooling.
@@ -45,6 +45,8 @@ public:
    */
   Tensor backward(const Tensor &yPred, const Tensor &yTrue) override;
 
+  std::unique_ptr<Loss> clone() const override { return std::make_unique<CrossEntropy>(*this); }
+
 private:
   /**
    * @brief Almacena las probabilidades calculadas por Softmax en `calculate()`.
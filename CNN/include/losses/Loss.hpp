@@ -2,6 +2,7 @@
 #define LOSS_HPP
 
 #include "core/Tensor.hpp"
+#include <memory>
 
 /**
  * @class Loss
@@ -44,6 +45,13 @@ public:
    *         inicial de la retropropagación.
    */
   virtual Tensor backward(const Tensor &yPred, const Tensor &yTrue) = 0;
+
+  /**
+   * @brief Copia de la pérdida para una réplica del paralelismo de datos de `Sequential`
+   *        (cada réplica necesita la suya, porque `backward` usa lo guardado en `calculate`).
+   * @return nullptr si la pérdida no lo implementa.
+   */
+  virtual std::unique_ptr<Loss> clone() const { return nullptr; }
 };
 
 #endif // LOSS_HPP
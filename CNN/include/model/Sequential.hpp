@@ -1,9 +1,11 @@
 #ifndef SEQUENTIAL_HPP
 #define SEQUENTIAL_HPP
 
+#include "core/ParameterRegistry.hpp"
 #include "layers/Layer.hpp"
 #include "losses/Loss.hpp"
 #include "optimizers/Optimizer.hpp"
+#include "utils/Dataset.hpp"
 
 #include <memory>  // Para std::unique_ptr
 #include <utility> // Para std::pair, std::forward
@@ -45,7 +47,9 @@ public:
 
   /**
    * @brief Configura el modelo para el entrenamiento.
-   * @details Especifica el optimizador y la función de pérdida que se usarán.
+   * @details Especifica el optimizador y la función de pérdida que se usarán y, si la
+   *          fusión está activa, sustituye las secuencias Conv2D → ReLU (→ MaxPooling) y
+   *          Dense → ReLU por capas fusionadas (ver `setLayerFusion`).
    * @tparam OptimizerType El tipo del optimizador (ej. SGD, Adam).
    * @tparam LossType El tipo de la función de pérdida (ej. CrossEntropy).
    * @tparam Args Los tipos de los argumentos del constructor del optimizador.
@@ -69,6 +73,17 @@ public:
   void train(const Tensor &X_train, const Tensor &y_train, int epochs, size_t batchSize, const Tensor &X_val,
              const Tensor &y_val);
 
+  /**
+   * @brief Entrena el modelo pidiendo los mini-batches a un Dataset.
+   * @details Mismo bucle que la versión con tensores; permite entrenar, por ejemplo,
+   *          sobre un `MappedDataset` sin cargar el conjunto completo en floats.
+   * @param trainData Datos de entrenamiento (se recorren en orden).
+   * @param epochs El número de épocas.
+   * @param batchSize El número de muestras por mini-batch.
+   * @param valData Datos de validación, evaluados al final de cada época.
+   */
+  void train(const Dataset &trainData, int epochs, size_t batchSize, const Dataset &valData);
+
   /**
    * @brief Evalúa el rendimiento del modelo en un conjunto de datos.
    * @details Calcula la pérdida y la precisión del modelo en los datos proporcionados
@@ -79,6 +94,9 @@ public:
    */
   std::pair<float, float> evaluate(const Tensor &X, const Tensor &y);
 
+  /** @brief Igual que `evaluate(X, y)`, sobre un Dataset. */
+  std::pair<float, float> evaluate(const Dataset &data);
+
   /**
    * @brief Genera predicciones para un conjunto de datos de entrada.
    * @details Realiza un único paso hacia adelante a través de toda la red.
@@ -87,6 +105,39 @@ public:
    */
   Tensor predict(const Tensor &input);
 
+  /**
+   * @brief Cuantización int8 posterior al entrenamiento (post-training quantization).
+   * @details Ejecuta `predict` sobre las primeras `numSamples` muestras de `calibration`
+   *          registrando el rango de la entrada de cada Dense y Conv2D, y después cuantiza
+   *          sus pesos a int8 con una escala por canal de salida. A partir de ahí `predict` y
+   *          `evaluate` usan el producto int8; el entrenamiento sigue en float. Se llama
+   *          después de `compile` y de `loadModel`: los pesos en float no cambian.
+   * @param calibration Datos representativos de la entrada (ej. una parte del entrenamiento).
+   * @param numSamples Número de muestras de calibración.
+   * @param batchSize Muestras por batch durante la calibración.
+   */
+  void quantizeInt8(const Dataset &calibration, size_t numSamples = 1024, size_t batchSize = 64);
+
+  /** @brief Fija el modo int8 de todas las capas; `Int8Mode::Off` vuelve a la inferencia en float. */
+  void setInt8Mode(Int8Mode mode);
+
+  /**
+   * @brief Elige el algoritmo de cada Conv2D midiendo los candidatos sobre `sample`.
+   * @details Paso opcional de calentamiento, tras `compile` (que fusiona las capas) y antes de
+   *          `train`. Sin él las convoluciones usan la regla fija por forma de Conv2D; con él
+   *          usan lo medido aquí para la forma de `sample`, así que conviene pasar un batch
+   *          del tamaño del entrenamiento.
+   * @param sample Batch de ejemplo {B, C, H, W}.
+   */
+  void autotune(const Tensor &sample);
+
+  /**
+   * @brief Avisa a todas las capas (y a sus réplicas) de que los parámetros han cambiado.
+   * @details `train` lo llama tras cada paso del optimizador y `loadModel` tras cargar los
+   *          pesos; hay que llamarlo si se modifican los parámetros por otra vía.
+   */
+  void parametersUpdated();
+
   /**
    * @brief Recopila los punteros a los parámetros de todas las capas.
    * @details Usado internamente para pasar los parámetros al optimizador.
@@ -94,13 +145,79 @@ public:
    */
   std::vector<Tensor *> getParameters();
 
+  /**
+   * @brief Activa o desactiva la fusión de capas en `compile` (activa por defecto).
+   * @details Las capas fusionadas dan los mismos resultados y exponen los mismos
+   *          parámetros en el mismo orden; solo cambian la memoria y el número de capas.
+   *          Debe llamarse antes de `compile`.
+   */
+  void setLayerFusion(bool enabled) { this->layerFusion = enabled; }
+
+  /**
+   * @brief Número de mini-batches que el DataLoader prepara por adelantado en su hilo
+   *        durante `train` y `evaluate` (2 por defecto; 0 los arma en el hilo principal).
+   */
+  void setPrefetchBatches(size_t batches) { this->prefetchBatches = batches; }
+
+  /**
+   * @brief Entrenamiento con paralelismo de datos: número de réplicas del modelo (1 por
+   *        defecto, desactivado).
+   * @details `train` reparte cada mini-batch en partes fijas, una por réplica, y cada réplica
+   *          hace su forward y backward en su propio hilo con las operaciones en serie. Los
+   *          gradientes se suman en un árbol de orden fijo y el optimizador da un único paso,
+   *          así que el resultado no depende del reparto de los hilos (con un algoritmo de
+   *          Conv2D fijo: el autoajuste elige por tiempos, y Dropout usa semillas aleatorias).
+   *          Las réplicas comparten los parámetros con el modelo (ver `Layer::clone`).
+   *          Conviene con modelos pequeños, cuyas regiones OpenMP por operación son muy cortas.
+   */
+  void setDataParallelReplicas(size_t replicas) { this->dataParallelReplicas = replicas; }
+
 private:
+  /**
+   * @brief Copia de las capas y de la pérdida que usa cada réplica distinta del modelo.
+   */
+  struct Replica {
+    std::vector<std::unique_ptr<Layer>> layers;
+    std::unique_ptr<Loss> loss;
+  };
+
+  /** @brief Crea las réplicas 1..R-1 a partir de las capas actuales (la réplica 0 es el modelo). */
+  void buildReplicas();
+
+  /**
+   * @brief Forward y backward de un mini-batch repartido entre las réplicas; deja la suma de
+   *        los gradientes en las capas del modelo.
+   * @return La pérdida del mini-batch y el número de aciertos.
+   */
+  std::pair<float, size_t> dataParallelStep(const Tensor &X_batch, const Tensor &y_batch);
+
+  /**
+   * @brief Pasada de fusión: reemplaza Conv2D → ReLU → MaxPooling por `FusedConv2D`
+   *        (también sin el pooling) y Dense → ReLU por `FusedDense`.
+   */
+  void fuseLayers();
+
+  /// Si `compile` aplica la pasada de fusión.
+  bool layerFusion = true;
+
+  /// Batches preparados por adelantado por el DataLoader.
+  size_t prefetchBatches = 2;
+
+  /// Réplicas del paralelismo de datos (1 = desactivado).
+  size_t dataParallelReplicas = 1;
+
+  /// Réplicas 1..R-1; se crean al empezar `train`.
+  std::vector<Replica> replicas;
+
   /// La pila de capas que componen el modelo.
   std::vector<std::unique_ptr<Layer>> layers;
 
   /// El optimizador que actualizará los pesos del modelo.
   std::unique_ptr<Optimizer> optimizer;
 
+  /// Parámetros y gradientes de las capas en buffers planos; se rehace al empezar `train`.
+  ParameterRegistry parameters;
+
   /// La función de pérdida que medirá el error del modelo.
   std::unique_ptr<Loss> loss;
 };
@@ -120,6 +237,11 @@ template <typename OptimizerType, typename LossType, typename... Args> void Sequ
 
   // Crea la función de pérdida. Se asume que no tiene argumentos por ahora.
   this->loss = std::make_unique<LossType>();
+
+  // Fusiona las secuencias de capas que tienen un kernel combinado.
+  if (this->layerFusion) {
+    this->fuseLayers();
+  }
 }
 
 #endif // SEQUENTIAL_HPP
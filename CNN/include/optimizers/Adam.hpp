@@ -39,6 +39,16 @@ public:
    */
   void update(std::vector<Tensor *> &parameters, const std::vector<Tensor *> &gradients) override;
 
+  /**
+   * @brief Paso de Adam sobre los buffers planos del registro.
+   * @details Los momentos se guardan en dos buffers con la misma disposición que el
+   *          registro y se recorren junto a parámetros y gradientes en un único bucle.
+   *          Este estado es independiente del de la versión por tensores: un mismo Adam
+   *          debe usar siempre una de las dos.
+   * @override
+   */
+  void update(ParameterRegistry &registry) override;
+
 private:
   // --- Hiperparámetros ---
   float beta1;
@@ -53,6 +63,9 @@ private:
 
   // Flag para la inicialización diferida de los tensores de momento.
   bool initialized;
+
+  Tensor flatM; ///< Primer momento de la versión sobre el registro (se crea en la primera llamada).
+  Tensor flatV; ///< Segundo momento de la versión sobre el registro.
 };
 
 #endif // ADAM_HPP
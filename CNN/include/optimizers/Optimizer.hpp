@@ -1,6 +1,7 @@
 #ifndef OPTIMIZER_HPP
 #define OPTIMIZER_HPP
 
+#include "core/ParameterRegistry.hpp"
 #include "core/Tensor.hpp"
 #include <vector>
 
@@ -39,6 +40,14 @@ public:
    */
   virtual void update(std::vector<Tensor *> &parameters, const std::vector<Tensor *> &gradients) = 0;
 
+  /**
+   * @brief Paso de optimización sobre todos los parámetros de un registro a la vez.
+   * @details Recorre los buffers planos de parámetros y gradientes con un único bucle
+   *          paralelo y vectorizado, en lugar de uno por tensor.
+   * @param registry Registro con los parámetros y gradientes del modelo.
+   */
+  virtual void update(ParameterRegistry &registry) = 0;
+
 protected:
   /** @brief La tasa de aprendizaje (learning rate) para el algoritmo. */
   float learningRate;
@@ -33,6 +33,12 @@ public:
    * @override
    */
   void update(std::vector<Tensor *> &parameters, const std::vector<Tensor *> &gradients) override;
+
+  /**
+   * @brief Paso de SGD sobre los buffers planos del registro.
+   * @override
+   */
+  void update(ParameterRegistry &registry) override;
 };
 
 #endif // SGD_HPP
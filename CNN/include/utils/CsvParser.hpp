@@ -0,0 +1,44 @@
+#ifndef CSVPARSER_HPP
+#define CSVPARSER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @struct MnistCsv
+ * @brief Filas de un CSV tipo MNIST ya parseadas, en el orden del archivo.
+ */
+struct MnistCsv {
+  size_t numSamples = 0;
+  size_t pixelsPerSample = 0;
+  std::vector<int32_t> labels; ///< Una etiqueta por muestra.
+  std::vector<uint8_t> pixels; ///< numSamples * pixelsPerSample valores en [0, 255].
+  size_t skippedRows = 0;      ///< Filas elegidas pero mal formadas (se descartan).
+};
+
+/**
+ * @brief Parser de CSV paralelo por bloques para filas "etiqueta,p0,...,p783" de enteros.
+ * @details El archivo se proyecta con mmap y se divide en bloques que terminan en fin de
+ *          línea. Los hilos de OpenMP primero cuentan las filas de sus bloques (solo buscan
+ *          los '\n'); con el total se eligen las filas a guardar y se reservan los buffers
+ *          finales una sola vez. Después cada hilo parsea con `std::from_chars` únicamente
+ *          las filas elegidas, directamente en su posición de salida: las descartadas por
+ *          el muestreo nunca se convierten.
+ *
+ *          Las filas con otro número de píxeles, valores fuera de [0, 255] o etiquetas
+ *          fuera de [0, numClasses) se descartan y se cuentan en `skippedRows`.
+ *
+ * @param filePath La ruta al archivo .csv (la primera línea es la cabecera).
+ * @param sampleFraction La fracción de filas a guardar (de 0.0 a 1.0).
+ * @param randomSample Si es `true`, las filas guardadas son un subconjunto aleatorio
+ *        uniforme de floor(total * sampleFraction) filas; si no, las primeras.
+ * @param pixelsPerSample El número de píxeles por fila.
+ * @param numClasses El número de clases (las etiquetas válidas son 0..numClasses-1).
+ * @throws std::runtime_error si el archivo no se puede abrir.
+ */
+MnistCsv parseMnistCsv(const std::string &filePath, float sampleFraction = 1.0f, bool randomSample = true,
+                       size_t pixelsPerSample = 784, int numClasses = 10);
+
+#endif // CSVPARSER_HPP
@@ -0,0 +1,114 @@
+#ifndef DATALOADER_HPP
+#define DATALOADER_HPP
+
+#include "utils/Dataset.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @class SpscRing
+ * @brief Cola circular de capacidad fija para un productor y un consumidor, sin locks.
+ * @details `tail` solo lo escribe el productor y `head` solo el consumidor; el par
+ *          release/acquire sobre cada índice publica también el contenido del slot.
+ * @tparam T Tipo de los elementos (se mueven, no se copian).
+ */
+template <typename T> class SpscRing {
+public:
+  /** @param capacity Número máximo de elementos en la cola. */
+  explicit SpscRing(size_t capacity) : slots(capacity + 1) {}
+
+  /**
+   * @brief Mueve `value` a la cola si hay sitio.
+   * @return `false` si la cola está llena (en ese caso `value` no se modifica).
+   */
+  bool tryPush(T &value) {
+    const size_t tailIndex = tail.load(std::memory_order_relaxed);
+    const size_t next = (tailIndex + 1) % slots.size();
+    if (next == head.load(std::memory_order_acquire)) {
+      return false;
+    }
+    slots[tailIndex] = std::move(value);
+    tail.store(next, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Saca el elemento más antiguo.
+   * @return `false` si la cola está vacía.
+   */
+  bool tryPop(T &value) {
+    const size_t headIndex = head.load(std::memory_order_relaxed);
+    if (headIndex == tail.load(std::memory_order_acquire)) {
+      return false;
+    }
+    value = std::move(slots[headIndex]);
+    head.store((headIndex + 1) % slots.size(), std::memory_order_release);
+    return true;
+  }
+
+private:
+  std::vector<T> slots; ///< Un slot más que la capacidad, para distinguir llena de vacía.
+  alignas(64) std::atomic<size_t> head{0};
+  alignas(64) std::atomic<size_t> tail{0};
+};
+
+/**
+ * @class DataLoader
+ * @brief Recorre un Dataset en un orden dado preparando los mini-batches en segundo plano.
+ *
+ * Un hilo propio pide cada batch a `Dataset::getBatch` (vistas o copias con `memcpy`) y lo
+ * deja en un `SpscRing`, con hasta `prefetch` batches listos mientras se entrena el
+ * actual. Ese hilo usa un solo hilo de OpenMP para no competir con los de cálculo. Con
+ * `prefetch = 0` no se crea el hilo y `next` arma cada batch en el momento.
+ *
+ * Si `getBatch` lanza una excepción en el hilo de fondo, `next` la relanza.
+ * El Dataset debe vivir más que el DataLoader.
+ */
+class DataLoader {
+public:
+  /**
+   * @param dataset El conjunto de datos.
+   * @param order Índices de las muestras en el orden en que se recorren.
+   * @param batchSize El número de muestras por batch (el último puede ser menor).
+   * @param prefetch El número de batches preparados por adelantado.
+   */
+  DataLoader(const Dataset &dataset, std::vector<size_t> order, size_t batchSize, size_t prefetch = 2);
+
+  /** @brief Detiene el hilo de fondo (aunque queden batches sin consumir). */
+  ~DataLoader();
+
+  DataLoader(const DataLoader &) = delete;
+  DataLoader &operator=(const DataLoader &) = delete;
+
+  /**
+   * @brief Espera al siguiente batch.
+   * @param batch Recibe el par {X, y}.
+   * @return `false` cuando ya se entregaron todos los batches.
+   */
+  bool next(std::pair<Tensor, Tensor> &batch);
+
+  size_t numBatches() const { return totalBatches; }
+
+private:
+  std::pair<Tensor, Tensor> makeBatch(size_t index) const;
+  void produce();
+
+  const Dataset &dataset;
+  std::vector<size_t> order;
+  size_t batchSize;
+  size_t totalBatches;
+  size_t consumed = 0;
+
+  SpscRing<std::pair<Tensor, Tensor>> ring;
+  std::atomic<bool> stopping{false};
+  std::atomic<bool> failed{false};
+  std::exception_ptr error; ///< Se publica junto con `failed` (release/acquire).
+  std::thread worker;
+};
+
+#endif // DATALOADER_HPP
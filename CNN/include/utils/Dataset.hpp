@@ -0,0 +1,140 @@
+#ifndef DATASET_HPP
+#define DATASET_HPP
+
+#include "core/Tensor.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @file Dataset.hpp
+ * @brief Conjuntos de datos de los que `Sequential` pide mini-batches por índices.
+ *
+ * Además de los tensores en memoria (`TensorDataset`), se puede entrenar directamente
+ * sobre un archivo binario proyectado con mmap (`MappedDataset`), que guarda los píxeles
+ * como uint8. El binario se genera una sola vez a partir del CSV con
+ * `convertCsvToBinary` (o automáticamente con `openMnistDataset`).
+ */
+
+/**
+ * @class Dataset
+ * @brief Interfaz común: número de muestras y ensamblado de un batch.
+ */
+class Dataset {
+public:
+  virtual ~Dataset() = default;
+
+  /** @brief Número de muestras del conjunto. */
+  virtual size_t size() const = 0;
+
+  /**
+   * @brief Arma un batch con las muestras `indices[0..count)`.
+   * @return Un par {X, y}: X de forma {count, C, H, W} e y en one-hot {count, numClasses}.
+   * @throws std::out_of_range si algún índice no existe.
+   */
+  virtual std::pair<Tensor, Tensor> getBatch(const size_t *indices, size_t count) const = 0;
+};
+
+/**
+ * @class TensorDataset
+ * @brief Dataset sobre un par {X, y} ya cargado (ej. el de `loadMnist`), sin copiarlo.
+ */
+class TensorDataset : public Dataset {
+public:
+  /**
+   * @param X Tensor de datos; su primera dimensión es la de las muestras.
+   * @param y Etiquetas {N, numClasses}.
+   */
+  TensorDataset(const Tensor &X, const Tensor &y);
+
+  size_t size() const override { return X.getShape()[0]; }
+
+  /**
+   * @brief Con índices consecutivos devuelve vistas de X e y (sin copia); si no, copia
+   *        cada muestra con `memcpy`.
+   */
+  std::pair<Tensor, Tensor> getBatch(const size_t *indices, size_t count) const override;
+
+private:
+  /** @brief Vuelve a repetir (stride 0) los ejes que el constructor guardó con tamaño 1. */
+  Tensor expandBatch(Tensor batch) const;
+
+  Tensor X; ///< Contiguo, para poder copiar cada muestra como un bloque; sin los ejes repetidos.
+  Tensor y;
+  std::vector<size_t> sampleShape; ///< Forma original de X (con los ejes repetidos).
+};
+
+/**
+ * @class MappedDataset
+ * @brief Dataset binario (formato de `convertCsvToBinary`) proyectado en memoria con mmap.
+ *
+ * Los píxeles se quedan en el archivo como uint8: el conjunto ocupa la cuarta parte que en
+ * float, solo se cargan las páginas que se leen y abrirlo no cuesta nada más que el mmap.
+ * La normalización a [0, 1] y el one-hot se hacen al armar cada batch; con 3 canales el
+ * gris se repite como vista (stride 0), sin copiarlo.
+ */
+class MappedDataset : public Dataset {
+public:
+  /**
+   * @brief Proyecta un archivo binario.
+   * @param binPath Ruta al archivo generado por `convertCsvToBinary`.
+   * @param channels Canales de las imágenes de los batches (1, o 3 repitiendo el gris).
+   * @throws std::runtime_error si el archivo no existe o su cabecera no es válida.
+   */
+  explicit MappedDataset(const std::string &binPath, int channels = 1);
+  ~MappedDataset();
+
+  MappedDataset(const MappedDataset &) = delete;
+  MappedDataset &operator=(const MappedDataset &) = delete;
+  MappedDataset(MappedDataset &&other) noexcept;
+  MappedDataset &operator=(MappedDataset &&other) noexcept;
+
+  size_t size() const override { return numSamples; }
+  std::pair<Tensor, Tensor> getBatch(const size_t *indices, size_t count) const override;
+
+  size_t getNumClasses() const { return numClasses; }
+
+  /** @brief Etiqueta de la muestra `index`. */
+  int label(size_t index) const { return labels[index]; }
+
+  /** @brief Píxeles (sin normalizar) de la muestra `index`: rows * cols bytes. */
+  const uint8_t *pixels(size_t index) const { return pixelData + index * rows * cols; }
+
+private:
+  void unmap();
+
+  void *mapping = nullptr;
+  size_t mappingSize = 0;
+  size_t numSamples = 0;
+  size_t rows = 0;
+  size_t cols = 0;
+  size_t numClasses = 0;
+  size_t channels = 1;
+  const int32_t *labels = nullptr;
+  const uint8_t *pixelData = nullptr;
+};
+
+/**
+ * @brief Convierte un CSV tipo MNIST (etiqueta + 784 píxeles por fila) al formato binario.
+ * @details Formato del archivo:
+ *          - Cabecera de 64 bytes: "FMNISTU8", versión, clases, muestras, filas, columnas y
+ *            los desplazamientos de etiquetas y píxeles.
+ *          - Etiquetas: un int32 por muestra.
+ *          - Píxeles: uint8, 784 por muestra, empezando en un múltiplo de 64 bytes.
+ *          Las filas mal formadas se descartan con una advertencia.
+ * @return El número de muestras escritas.
+ */
+size_t convertCsvToBinary(const std::string &csvPath, const std::string &binPath);
+
+/**
+ * @brief Abre la versión binaria de un CSV ("<nombre>.u8.bin", junto al CSV).
+ * @details La genera la primera vez o cuando el CSV es más reciente que el binario.
+ * @param csvPath Ruta al archivo .csv original.
+ * @param channels Canales de las imágenes de los batches (1 o 3).
+ */
+MappedDataset openMnistDataset(const std::string &csvPath, int channels = 1);
+
+#endif // DATASET_HPP
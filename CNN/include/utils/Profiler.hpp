@@ -0,0 +1,143 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include "layers/Layer.hpp"
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file Profiler.hpp
+ * @brief Perfilado por capa: tiempo de forward y backward, FLOPs, memoria pedida al
+ *        asignador y pico de memoria de tensores vivos.
+ *
+ * La instrumentación se escribe con las macros `PROFILE_FORWARD`, `PROFILE_BACKWARD` y
+ * `PROFILE_SCOPE`, que solo miden si se compila con `CNN_PROFILING` (opción de CMake
+ * `CNN_ENABLE_PROFILING`). Sin ella se reducen a la llamada original a la capa.
+ *
+ * Con el perfilado compilado, la medición se activa con `Profiler::instance().start()` o
+ * con la variable de entorno `CNN_PROFILE=<archivo.json>`; en ese caso, al terminar el
+ * programa se escribe la traza en formato Chrome trace-event (chrome://tracing o
+ * ui.perfetto.dev) y se imprime la tabla resumen.
+ *
+ * Los ámbitos se abren desde el hilo principal, fuera de regiones paralelas, y se anidan:
+ * el nombre de cada evento es la ruta de ámbitos abiertos (ej. "train_step/3:Conv2D").
+ */
+
+/** @brief Una medición completada. */
+struct ProfileEvent {
+  std::string name;      ///< Ruta del ámbito.
+  const char *phase;     ///< "forward", "backward" o "step".
+  double startUs;        ///< Inicio desde start(), en microsegundos.
+  double durationUs;     ///< Duración en microsegundos.
+  double flops;          ///< FLOPs estimados (0 si no se conocen).
+  size_t bytesAllocated; ///< Memoria entregada por el asignador dentro del ámbito.
+  size_t peakBytes;      ///< Pico de memoria en uso por tensores dentro del ámbito.
+  size_t depth;          ///< Nivel de anidamiento (0 = ámbito exterior).
+};
+
+/**
+ * @class Profiler
+ * @brief Registro global de mediciones por capa.
+ */
+class Profiler {
+public:
+  /** @brief Única instancia. Lee `CNN_PROFILE` la primera vez que se usa. */
+  static Profiler &instance();
+
+  /** @brief Borra los eventos anteriores y empieza a registrar. */
+  void start();
+
+  /** @brief Deja de registrar (los eventos se conservan). */
+  void stop();
+
+  bool isEnabled() const { return enabled; }
+  const std::vector<ProfileEvent> &getEvents() const { return events; }
+
+  /** @brief Escribe los eventos en formato Chrome trace-event (eventos completos, "ph": "X"). */
+  void writeChromeTrace(const std::string &path) const;
+
+  /** @brief Imprime una tabla por ámbito y fase, ordenada por tiempo total. */
+  void printSummary(std::ostream &out) const;
+
+  // --- Uso interno de ProfileScope ---
+  size_t enter(const std::string &label);
+  void leave(ProfileEvent event);
+  double nowUs() const;
+  void setForwardFlops(const Layer *layer, double flops) { forwardFlops[layer] = flops; }
+  double getForwardFlops(const Layer *layer) const;
+
+private:
+  Profiler();
+  ~Profiler();
+  Profiler(const Profiler &) = delete;
+  Profiler &operator=(const Profiler &) = delete;
+
+  bool enabled = false;
+  double origin = 0.0;                                    ///< Instante de start() (µs de steady_clock).
+  std::vector<std::string> stack;                         ///< Rutas de los ámbitos abiertos.
+  std::vector<ProfileEvent> events;                       ///< Mediciones en orden de finalización.
+  std::string exitTracePath;                              ///< Traza a escribir al salir (CNN_PROFILE).
+  std::unordered_map<const Layer *, double> forwardFlops; ///< FLOPs del último forward de cada capa.
+};
+
+/**
+ * @class ProfileScope
+ * @brief Ámbito medido (RAII). Registra un evento al destruirse si el Profiler estaba
+ *        activo al construirse.
+ */
+class ProfileScope {
+public:
+  ProfileScope(const std::string &label, const char *phase, double flops = 0.0);
+
+  /** @brief Forward de una capa; los FLOPs se piden a `layer.getFlops(input.getShape())`. */
+  ProfileScope(const std::string &label, const Layer &layer, const Tensor &input);
+
+  /**
+   * @brief Backward de una capa.
+   * @details Se estima en el doble de FLOPs que su último forward (gradiente de la entrada
+   *          y de los pesos).
+   */
+  ProfileScope(const std::string &label, const Layer &layer);
+
+  ~ProfileScope();
+
+  ProfileScope(const ProfileScope &) = delete;
+  ProfileScope &operator=(const ProfileScope &) = delete;
+
+private:
+  void begin(const std::string &label, const char *phase, double flops);
+
+  bool active = false;
+  ProfileEvent event;
+  size_t bytesAllocatedAtStart = 0;
+  size_t peakBeforeScope = 0;
+};
+
+#ifdef CNN_PROFILING
+inline Tensor profiledForward(const std::string &label, Layer &layer, const Tensor &input, bool isTraining) {
+  ProfileScope scope(label, layer, input);
+  return layer.forward(input, isTraining);
+}
+
+inline Tensor profiledBackward(const std::string &label, Layer &layer, const Tensor &outputGradient) {
+  ProfileScope scope(label, layer);
+  return layer.backward(outputGradient);
+}
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+/// Llamadas a una capa medidas como un ámbito con nombre `label`.
+#define PROFILE_FORWARD(label, layer, input, isTraining) profiledForward(label, layer, input, isTraining)
+#define PROFILE_BACKWARD(label, layer, outputGradient) profiledBackward(label, layer, outputGradient)
+/// Mide el resto del bloque actual; `phase` es un literal ("step", "forward"...).
+#define PROFILE_SCOPE(label, phase) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(label, phase)
+#else
+#define PROFILE_FORWARD(label, layer, input, isTraining) (layer).forward(input, isTraining)
+#define PROFILE_BACKWARD(label, layer, outputGradient) (layer).backward(outputGradient)
+#define PROFILE_SCOPE(label, phase)
+#endif
+
+#endif // PROFILER_HPP
@@ -35,6 +35,13 @@ run_app() {
   echo "--- Ejecución finalizada ---"
 }
 
+run_bench() {
+  echo "--- Ejecutando los microbenchmarks ---"
+  # Los argumentos extra se pasan al ejecutable (ej: ./run.sh bench --filter=Conv2D).
+  ./${BUILD_DIR}/bin/bench --json=bench.json "$@"
+  echo "--- Benchmarks finalizados ---"
+}
+
 clean_build() {
   echo "--- Limpiando el directorio de compilación ---"
   if [ -d "${BUILD_DIR}" ]; then
@@ -52,6 +59,14 @@ if [ "$1" == "clean" ]; then
   exit 0
 fi
 
+# Con "bench", se compila y se ejecutan los microbenchmarks (resultados en bench.json).
+if [ "$1" == "bench" ]; then
+  shift
+  build_project
+  run_bench "$@"
+  exit 0
+fi
+
 # Flujo por defecto: compilar y luego ejecutar.
 build_project
 run_app
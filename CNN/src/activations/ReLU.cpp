@@ -22,7 +22,7 @@ Tensor ReLU::forward(const Tensor &input, bool isTraining) {
     this->inputTensor = input;
   }
 
-  Tensor result(input.getShape());
+  Tensor result = Tensor::uninitialized(input.getShape());
   const auto &shape = input.getShape();
 
   // Especialización para las formas más comunes (2D para Dense, 4D para Conv)
@@ -62,7 +62,7 @@ Tensor ReLU::backward(const Tensor &outputGradient) {
   // - d(ReLU)/dx = 0 si x <= 0
   // Por la regla de la cadena, el gradiente de entrada es el gradiente de
   // salida multiplicado por esta derivada.
-  Tensor inputGradient(this->inputTensor.getShape());
+  Tensor inputGradient = Tensor::uninitialized(this->inputTensor.getShape());
   const auto &shape = this->inputTensor.getShape();
 
   if (shape.size() == 2) {
@@ -90,3 +90,5 @@ Tensor ReLU::backward(const Tensor &outputGradient) {
 
   return inputGradient;
 }
+
+double ReLU::getFlops(const std::vector<size_t> &inputShape) const { return countElements(inputShape); }
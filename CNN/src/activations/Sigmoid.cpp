@@ -16,7 +16,7 @@ Sigmoid::Sigmoid() {}
  * @brief Aplica la función de activación sigmoide: f(x) = 1 / (1 + exp(-x)).
  */
 Tensor Sigmoid::forward(const Tensor &input, bool isTraining) {
-  Tensor result(input.getShape());
+  Tensor result = Tensor::uninitialized(input.getShape());
   const auto &shape = input.getShape();
 
   // Especialización para formas 2D y 4D.
@@ -58,7 +58,7 @@ Tensor Sigmoid::backward(const Tensor &outputGradient) {
   // La derivada del sigmoide es: f'(x) = f(x) * (1 - f(x))
   // donde f(x) es el valor de la salida del sigmoide.
   // Por la regla de la cadena: dE/dX = dE/dY * f'(x)
-  Tensor inputGradient(this->outputTensor.getShape());
+  Tensor inputGradient = Tensor::uninitialized(this->outputTensor.getShape());
   const auto &shape = this->outputTensor.getShape();
 
   if (shape.size() == 2) {
@@ -89,3 +89,5 @@ Tensor Sigmoid::backward(const Tensor &outputGradient) {
 
   return inputGradient;
 }
+
+double Sigmoid::getFlops(const std::vector<size_t> &inputShape) const { return 4.0 * countElements(inputShape); }
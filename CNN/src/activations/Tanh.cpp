@@ -6,7 +6,7 @@
 Tanh::Tanh() {}
 
 Tensor Tanh::forward(const Tensor &input, bool isTraining) {
-  Tensor result(input.getShape());
+  Tensor result = Tensor::uninitialized(input.getShape());
   const auto &shape = input.getShape();
 
   if (shape.size() == 4) {
@@ -39,7 +39,7 @@ Tensor Tanh::forward(const Tensor &input, bool isTraining) {
 }
 
 Tensor Tanh::backward(const Tensor &outputGradient) {
-  Tensor inputGradient(this->outputTensor.getShape());
+  Tensor inputGradient = Tensor::uninitialized(this->outputTensor.getShape());
   const auto &shape = this->outputTensor.getShape();
 
   if (shape.size() == 4) {
@@ -68,3 +68,5 @@ Tensor Tanh::backward(const Tensor &outputGradient) {
 
   return inputGradient;
 }
+
+double Tanh::getFlops(const std::vector<size_t> &inputShape) const { return 4.0 * countElements(inputShape); }
@@ -0,0 +1,369 @@
+#include "core/Allocator.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+constexpr std::align_val_t ALIGNMENT{64};
+
+float *systemAllocate(size_t count) { return static_cast<float *>(::operator new(count * sizeof(float), ALIGNMENT)); }
+
+void systemDeallocate(float *ptr) { ::operator delete(ptr, ALIGNMENT); }
+
+/**
+ * @brief Redondea `count` a su clase de tamaño.
+ * @details Múltiplo de 1/8 de la siguiente potencia de dos (cuatro clases entre dos potencias
+ *          consecutivas) y como mínimo 64 bytes.
+ */
+size_t sizeClass(size_t count) {
+  constexpr size_t MIN_FLOATS = 16;
+  if (count <= MIN_FLOATS)
+    return MIN_FLOATS;
+  size_t top = MIN_FLOATS;
+  while (top < count)
+    top <<= 1;
+  const size_t step = std::max(MIN_FLOATS, top / 8);
+  return (count + step - 1) / step * step;
+}
+
+size_t resetPeakOf(AllocatorStats &stats, size_t floor) {
+  const size_t previous = stats.peakBytesInUse;
+  stats.peakBytesInUse = std::max(floor, stats.bytesInUse);
+  return previous;
+}
+
+void recordAllocation(AllocatorStats &stats, size_t bytes) {
+  stats.allocations++;
+  stats.bytesAllocated += bytes;
+  stats.bytesInUse += bytes;
+  stats.peakBytesInUse = std::max(stats.peakBytesInUse, stats.bytesInUse);
+}
+
+/** @brief Asignador inicial según CNN_ALLOCATOR (por defecto, el pool). */
+std::shared_ptr<Allocator> makeDefaultAllocator() {
+  const char *env = std::getenv("CNN_ALLOCATOR");
+  if (env && std::string(env) == "system")
+    return std::make_shared<SystemAllocator>();
+  return std::make_shared<PoolAllocator>();
+}
+
+std::shared_ptr<Allocator> &activeAllocator() {
+  static std::shared_ptr<Allocator> allocator = makeDefaultAllocator();
+  return allocator;
+}
+} // namespace
+
+// --- Implementación de SystemAllocator ---
+
+struct SystemAllocator::Impl {
+  mutable std::mutex mutex;
+  AllocatorStats stats;
+};
+
+SystemAllocator::SystemAllocator() : impl(std::make_unique<Impl>()) {}
+SystemAllocator::~SystemAllocator() = default;
+
+float *SystemAllocator::allocate(size_t count) {
+  float *ptr = systemAllocate(std::max<size_t>(count, 1));
+  std::lock_guard<std::mutex> lock(impl->mutex);
+  recordAllocation(impl->stats, count * sizeof(float));
+  impl->stats.systemAllocations++;
+  return ptr;
+}
+
+void SystemAllocator::deallocate(float *ptr, size_t count) {
+  systemDeallocate(ptr);
+  std::lock_guard<std::mutex> lock(impl->mutex);
+  impl->stats.bytesInUse -= count * sizeof(float);
+}
+
+AllocatorStats SystemAllocator::stats() const {
+  std::lock_guard<std::mutex> lock(impl->mutex);
+  return impl->stats;
+}
+
+size_t SystemAllocator::resetPeak(size_t floor) {
+  std::lock_guard<std::mutex> lock(impl->mutex);
+  return resetPeakOf(impl->stats, floor);
+}
+
+// --- Implementación de PoolAllocator ---
+
+namespace {
+/** @brief Lista libre de una clase de tamaño. */
+struct FreeList {
+  std::vector<float *> blocks;
+  size_t lowWater = 0; ///< Mínimo de blocks.size() desde el último resetStep().
+
+  /** @brief Saca el último bloque de la lista (no puede estar vacía). */
+  float *pop() {
+    float *ptr = this->blocks.back();
+    this->blocks.pop_back();
+    this->lowWater = std::min(this->lowWater, this->blocks.size());
+    return ptr;
+  }
+};
+
+/// Listas libres por clase; clave: tamaño de la clase en floats.
+using FreeLists = std::unordered_map<size_t, FreeList>;
+
+/// Memoria que puede guardar la caché de un hilo por cada clase de tamaño.
+constexpr size_t THREAD_CACHE_BYTES = size_t(1) << 20;
+
+/**
+ * @brief Número de bloques de la clase que caben en la caché de un hilo (al menos uno).
+ * @details Los bloques grandes son pocos y caros de usar, así que pasar por el pool
+ *          compartido no se nota; los pequeños son los que se piden miles de veces por paso.
+ */
+size_t threadCacheLimit(size_t classSize) {
+  return std::max<size_t>(1, THREAD_CACHE_BYTES / (classSize * sizeof(float)));
+}
+
+/**
+ * @brief Se marca al destruir las cachés del hilo.
+ * @details Es trivialmente destructible, así que se puede consultar durante toda la salida del hilo.
+ */
+thread_local bool threadCachesDestroyed = false;
+
+/**
+ * @brief Devuelve al sistema los bloques que no se usaron desde el último resetStep().
+ * @return Bytes liberados.
+ */
+size_t releaseUnused(FreeLists &lists) {
+  size_t released = 0;
+  for (auto &[classSize, list] : lists) {
+    // Los `lowWater` bloques más antiguos no se usaron en todo el paso.
+    const size_t unused = std::min(list.lowWater, list.blocks.size());
+    for (size_t i = 0; i < unused; ++i) {
+      systemDeallocate(list.blocks[i]);
+    }
+    list.blocks.erase(list.blocks.begin(), list.blocks.begin() + unused);
+    list.lowWater = list.blocks.size();
+    released += unused * classSize * sizeof(float);
+  }
+  return released;
+}
+
+/** @brief Devuelve al sistema todos los bloques de las listas. */
+void releaseAll(FreeLists &lists) {
+  for (auto &[classSize, list] : lists) {
+    for (float *ptr : list.blocks) {
+      systemDeallocate(ptr);
+    }
+    list.blocks.clear();
+    list.lowWater = 0;
+  }
+}
+} // namespace
+
+/**
+ * @brief Estado del pool: un pool compartido y una caché de listas libres por hilo.
+ * @details Cada hilo reserva y libera en su ThreadCache, protegida por un mutex que solo se
+ *          disputa cuando otro hilo llama a resetStep(), trim() o stats(). Si la caché del hilo
+ *          no tiene un bloque de la clase se acude al pool compartido y, si tampoco, al sistema;
+ *          al liberar, lo que no cabe en la caché del hilo va al pool compartido. Así un bloque
+ *          que reserva un hilo y libera otro (ej. el hilo de precarga de lotes) vuelve a estar
+ *          disponible para todos.
+ *
+ *          Orden de los mutex: primero el del pool y después el de una caché, nunca al revés.
+ */
+struct PoolAllocator::Impl : std::enable_shared_from_this<PoolAllocator::Impl> {
+  /** @brief Listas libres y contadores de un hilo. */
+  struct ThreadCache {
+    std::shared_ptr<Impl> pool; ///< Mantiene vivo el pool mientras el hilo tenga caché.
+    std::mutex mutex;
+    FreeLists lists;
+    size_t allocations = 0;
+    size_t bytesAllocated = 0;
+    size_t bytesCached = 0;
+
+    explicit ThreadCache(std::shared_ptr<Impl> owner) : pool(std::move(owner)) {}
+
+    /** @brief Al terminar el hilo sus bloques y contadores pasan al pool compartido. */
+    ~ThreadCache() {
+      std::lock_guard<std::mutex> poolLock(this->pool->mutex);
+      for (auto &[classSize, list] : this->lists) {
+        FreeList &shared = this->pool->lists[classSize];
+        shared.blocks.insert(shared.blocks.end(), list.blocks.begin(), list.blocks.end());
+      }
+      this->pool->bytesCached += this->bytesCached;
+      this->pool->retiredAllocations += this->allocations;
+      this->pool->retiredBytesAllocated += this->bytesAllocated;
+      auto &caches = this->pool->caches;
+      caches.erase(std::find(caches.begin(), caches.end(), this));
+    }
+  };
+
+  /** @brief Cachés del hilo actual, una por pool. */
+  struct ThreadCaches {
+    /// Las cachés retienen su pool, así que la dirección de un pool vivo no se reutiliza.
+    std::unordered_map<const Impl *, std::unique_ptr<ThreadCache>> byPool;
+    ~ThreadCaches() { threadCachesDestroyed = true; }
+  };
+
+  mutable std::mutex mutex; ///< Protege todo lo que sigue salvo los contadores atómicos.
+  FreeLists lists;          ///< Pool compartido.
+  std::vector<ThreadCache *> caches;
+  size_t bytesCached = 0;
+  size_t systemAllocations = 0;
+  size_t retiredAllocations = 0; ///< Contadores de los hilos ya terminados.
+  size_t retiredBytesAllocated = 0;
+
+  std::atomic<size_t> bytesInUse{0};     ///< Compartido por todos los hilos.
+  std::atomic<size_t> peakBytesInUse{0}; ///< Máximo de bytesInUse.
+
+  ~Impl() { releaseAll(this->lists); }
+
+  /**
+   * @brief Caché del hilo actual, creada en su primera reserva o liberación.
+   * @return nullptr si el hilo ya está terminando y destruyó sus cachés (ej. tensores
+   *         estáticos liberados al salir); entonces se usa directamente el pool compartido.
+   */
+  ThreadCache *localCache() {
+    if (threadCachesDestroyed) {
+      return nullptr;
+    }
+    thread_local ThreadCaches threadCaches;
+    std::unique_ptr<ThreadCache> &cache = threadCaches.byPool[this];
+    if (!cache) {
+      cache = std::make_unique<ThreadCache>(shared_from_this());
+      std::lock_guard<std::mutex> lock(this->mutex);
+      this->caches.push_back(cache.get());
+    }
+    return cache.get();
+  }
+
+  /** @brief Suma `bytes` a la memoria en uso y actualiza el pico. */
+  void addInUse(size_t bytes) {
+    const size_t inUse = this->bytesInUse.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    size_t peak = this->peakBytesInUse.load(std::memory_order_relaxed);
+    while (inUse > peak && !this->peakBytesInUse.compare_exchange_weak(peak, inUse, std::memory_order_relaxed)) {
+    }
+  }
+};
+
+PoolAllocator::PoolAllocator() : impl(std::make_shared<Impl>()) {}
+
+PoolAllocator::~PoolAllocator() { trim(); }
+
+float *PoolAllocator::allocate(size_t count) {
+  const size_t classSize = sizeClass(count);
+  const size_t bytes = classSize * sizeof(float);
+  this->impl->addInUse(bytes);
+  Impl::ThreadCache *cache = this->impl->localCache();
+  if (cache) {
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    cache->allocations++;
+    cache->bytesAllocated += bytes;
+    FreeList &list = cache->lists[classSize];
+    if (!list.blocks.empty()) {
+      cache->bytesCached -= bytes;
+      return list.pop();
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(this->impl->mutex);
+    if (!cache) {
+      this->impl->retiredAllocations++;
+      this->impl->retiredBytesAllocated += bytes;
+    }
+    FreeList &list = this->impl->lists[classSize];
+    if (!list.blocks.empty()) {
+      this->impl->bytesCached -= bytes;
+      return list.pop();
+    }
+    this->impl->systemAllocations++;
+  }
+  return systemAllocate(classSize);
+}
+
+void PoolAllocator::deallocate(float *ptr, size_t count) {
+  const size_t classSize = sizeClass(count);
+  const size_t bytes = classSize * sizeof(float);
+  this->impl->bytesInUse.fetch_sub(bytes, std::memory_order_relaxed);
+  Impl::ThreadCache *cache = this->impl->localCache();
+  if (cache) {
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    FreeList &list = cache->lists[classSize];
+    if (list.blocks.size() < threadCacheLimit(classSize)) {
+      list.blocks.push_back(ptr);
+      cache->bytesCached += bytes;
+      return;
+    }
+  }
+  std::lock_guard<std::mutex> lock(this->impl->mutex);
+  this->impl->lists[classSize].blocks.push_back(ptr);
+  this->impl->bytesCached += bytes;
+}
+
+void PoolAllocator::resetStep() {
+  std::lock_guard<std::mutex> lock(this->impl->mutex);
+  this->impl->bytesCached -= releaseUnused(this->impl->lists);
+  for (Impl::ThreadCache *cache : this->impl->caches) {
+    std::lock_guard<std::mutex> cacheLock(cache->mutex);
+    cache->bytesCached -= releaseUnused(cache->lists);
+  }
+}
+
+void PoolAllocator::trim() {
+  std::lock_guard<std::mutex> lock(this->impl->mutex);
+  releaseAll(this->impl->lists);
+  this->impl->bytesCached = 0;
+  for (Impl::ThreadCache *cache : this->impl->caches) {
+    std::lock_guard<std::mutex> cacheLock(cache->mutex);
+    releaseAll(cache->lists);
+    cache->bytesCached = 0;
+  }
+}
+
+AllocatorStats PoolAllocator::stats() const {
+  std::lock_guard<std::mutex> lock(this->impl->mutex);
+  AllocatorStats stats;
+  stats.allocations = this->impl->retiredAllocations;
+  stats.bytesAllocated = this->impl->retiredBytesAllocated;
+  stats.systemAllocations = this->impl->systemAllocations;
+  stats.bytesCached = this->impl->bytesCached;
+  for (Impl::ThreadCache *cache : this->impl->caches) {
+    std::lock_guard<std::mutex> cacheLock(cache->mutex);
+    stats.allocations += cache->allocations;
+    stats.bytesAllocated += cache->bytesAllocated;
+    stats.bytesCached += cache->bytesCached;
+  }
+  stats.bytesInUse = this->impl->bytesInUse.load(std::memory_order_relaxed);
+  stats.peakBytesInUse = this->impl->peakBytesInUse.load(std::memory_order_relaxed);
+  return stats;
+}
+
+size_t PoolAllocator::resetPeak(size_t floor) {
+  const size_t inUse = this->impl->bytesInUse.load(std::memory_order_relaxed);
+  return this->impl->peakBytesInUse.exchange(std::max(floor, inUse), std::memory_order_relaxed);
+}
+
+// --- Asignador activo ---
+
+const std::shared_ptr<Allocator> &getAllocator() { return activeAllocator(); }
+
+void setAllocator(std::shared_ptr<Allocator> allocator) {
+  if (!allocator) {
+    throw std::invalid_argument("setAllocator: el asignador no puede ser nulo.");
+  }
+  activeAllocator() = std::move(allocator);
+}
+
+std::shared_ptr<float[]> allocateStorage(size_t count, bool zeroFill) {
+  // El deleter guarda una referencia al asignador: el bloque vuelve a quien lo creó
+  // aunque mientras tanto se haya cambiado el asignador activo.
+  std::shared_ptr<Allocator> allocator = getAllocator();
+  float *ptr = allocator->allocate(count);
+  if (zeroFill && count > 0)
+    std::memset(ptr, 0, count * sizeof(float));
+  return std::shared_ptr<float[]>(ptr, [allocator, count](float *p) { allocator->deallocate(p, count); });
+}
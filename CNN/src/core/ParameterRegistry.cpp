@@ -0,0 +1,111 @@
+#include "core/ParameterRegistry.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+/// Alineación de cada tramo en floats (64 bytes, la del asignador).
+static constexpr size_t ALIGNMENT = 16;
+
+/**
+ * @brief Posición siguiente al último elemento que alcanza el tensor dentro de su bloque.
+ */
+static size_t tensorEnd(const Tensor &tensor) {
+  if (tensor.getSize() == 0) {
+    return tensor.getDataOffset();
+  }
+  size_t last = tensor.getDataOffset();
+  for (size_t d = 0; d < tensor.getShape().size(); ++d) {
+    last += (tensor.getShape()[d] - 1) * tensor.getStrides()[d];
+  }
+  return last + 1;
+}
+
+std::vector<ParameterRegistry::Group> ParameterRegistry::groupByStorage(const std::vector<Tensor *> &tensors) {
+  std::vector<Group> groups;
+  std::unordered_map<const float *, size_t> index;
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    const Tensor &tensor = *tensors[i];
+    auto [it, inserted] = index.emplace(tensor.getData(), groups.size());
+    if (inserted) {
+      groups.push_back({{}, tensor.getDataOffset(), tensorEnd(tensor)});
+    }
+    Group &group = groups[it->second];
+    group.members.push_back(i);
+    group.begin = std::min(group.begin, tensor.getDataOffset());
+    group.end = std::max(group.end, tensorEnd(tensor));
+  }
+  return groups;
+}
+
+/**
+ * @details El puntero de cada vista comparte la propiedad del buffer completo pero apunta al
+ *          inicio del tramo, de modo que `getData()` sigue siendo el inicio del bloque propio
+ *          del tensor para el código que lo usa sin desplazamiento (ej. `saveModel`).
+ */
+void ParameterRegistry::relocate(const Group &group, const std::vector<Tensor *> &tensors, Tensor &buffer) {
+  const Tensor &first = *tensors[group.members.front()];
+  std::copy(first.getData() + group.begin, first.getData() + group.end, buffer.getData() + group.start);
+  const std::shared_ptr<float[]> segment(buffer.dataPtr, buffer.getData() + group.start);
+  for (size_t i : group.members) {
+    Tensor &tensor = *tensors[i];
+    Tensor view(segment, tensor.shape, tensor.strides, tensor.dataOffset - group.begin);
+    view.storageSize = group.end - group.begin;
+    tensor = std::move(view);
+  }
+}
+
+/**
+ * @brief Construye los dos buffers y reubica los tensores.
+ */
+ParameterRegistry::ParameterRegistry(const std::vector<Tensor *> &parameters, const std::vector<Tensor *> &gradients)
+    : parameters(parameters), gradients(gradients) {
+  if (parameters.size() != gradients.size()) {
+    throw std::invalid_argument("ParameterRegistry: el número de parámetros y gradientes no coincide.");
+  }
+  for (size_t i = 0; i < parameters.size(); ++i) {
+    if (parameters[i]->getShape() != gradients[i]->getShape()) {
+      throw std::invalid_argument("ParameterRegistry: el parámetro " + std::to_string(i) + " tiene forma " +
+                                  parameters[i]->shapeToString() + " y su gradiente " +
+                                  gradients[i]->shapeToString() + ".");
+    }
+  }
+
+  std::vector<Group> groups = groupByStorage(parameters);
+  std::vector<Group> gradientGroups = groupByStorage(gradients);
+  if (groups.size() != gradientGroups.size()) {
+    throw std::invalid_argument("ParameterRegistry: los gradientes no comparten memoria como sus parámetros.");
+  }
+
+  // El gradiente de cada tensor debe ocupar en su grupo la misma posición que el parámetro.
+  size_t total = 0;
+  for (size_t g = 0; g < groups.size(); ++g) {
+    Group &group = groups[g];
+    Group &gradientGroup = gradientGroups[g];
+    bool sameLayout =
+        group.members == gradientGroup.members && group.end - group.begin == gradientGroup.end - gradientGroup.begin;
+    for (size_t k = 0; sameLayout && k < group.members.size(); ++k) {
+      const Tensor &param = *parameters[group.members[k]];
+      const Tensor &grad = *gradients[group.members[k]];
+      sameLayout = param.getStrides() == grad.getStrides() &&
+                   param.getDataOffset() - group.begin == grad.getDataOffset() - gradientGroup.begin;
+    }
+    if (!sameLayout) {
+      throw std::invalid_argument("ParameterRegistry: los gradientes no comparten memoria como sus parámetros.");
+    }
+
+    group.start = total;
+    gradientGroup.start = total;
+    total += (group.end - group.begin + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+  }
+
+  // Los buffers nacen a cero, así que el relleno entre tramos también.
+  this->parameterBuffer = Tensor({total});
+  this->gradientBuffer = Tensor({total});
+  for (size_t g = 0; g < groups.size(); ++g) {
+    relocate(groups[g], parameters, this->parameterBuffer);
+    relocate(gradientGroups[g], gradients, this->gradientBuffer);
+  }
+}
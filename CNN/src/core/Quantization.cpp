@@ -0,0 +1,277 @@
+#include "core/Quantization.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CNN_HAS_VNNI_KERNEL 1
+#endif
+
+namespace {
+/// Filas del tile de C que acumula el microkernel.
+constexpr size_t MR = 6;
+/// Columnas del tile de C (16 int32: un registro AVX-512).
+constexpr size_t NR = 16;
+/// Filas de A por tarea: el bloque cuantizado (MC x k bytes) se queda en caché mientras se
+/// recorren todos los paneles de B.
+constexpr size_t MC = 72;
+/// Punto cero de las activaciones uint8.
+constexpr int32_t ZERO_POINT = 128;
+
+/**
+ * @brief Redondea `t` al entero más cercano (al par en los empates) y lo recorta a [-127, 127].
+ * @details Sumar 1.5 * 2^23 deja el entero en los bits bajos de la mantisa y, como los bits de
+ *          un float crecen con su valor, el recorte se hace en enteros. Sin comparaciones de
+ *          floats el compilador vectoriza los bucles que lo usan.
+ */
+inline int32_t roundClamped(float t) {
+  const float shifted = t + 12582912.0f;
+  int32_t bits;
+  std::memcpy(&bits, &shifted, sizeof(bits));
+  return std::min(std::max(bits - 0x4B400000, -127), 127);
+}
+
+/** @brief Posición del elemento k = p de la línea `lane` en un panel de `width` líneas. */
+inline size_t quadIndex(size_t p, size_t lane, size_t width) { return ((p >> 2) * width + lane) * 4 + (p & 3); }
+
+/**
+ * @brief Escribe en C el tile `mr x nr` a partir de los acumuladores int32.
+ * @details `C = (acc - 128 * sum(Bq[:, j])) * escala[j] + bias[j]`.
+ */
+inline void storeTile(const int32_t (&acc)[MR][NR], const int32_t *zeroCorrection, const float *scale,
+                      const float *bias, float *c, size_t rsC, size_t mr, size_t nr) {
+  for (size_t r = 0; r < mr; ++r) {
+    for (size_t j = 0; j < nr; ++j) {
+      c[r * rsC + j] = static_cast<float>(acc[r][j] - zeroCorrection[j]) * scale[j] + bias[j];
+    }
+  }
+}
+
+/**
+ * @brief Microkernel genérico u8 x s8: tile MR x NR de C en acumuladores int32.
+ * @param a Panel de A: `a[(q * MR + r) * 4 + t]` es el elemento k = 4q + t de la fila r.
+ * @param b Panel de B: `b[(q * NR + j) * 4 + t]` es el elemento k = 4q + t de la columna j.
+ */
+void microKernelGeneric(size_t kQuads, const uint8_t *a, const int8_t *b, const int32_t *zeroCorrection,
+                        const float *scale, const float *bias, float *c, size_t rsC, size_t mr, size_t nr) {
+  int32_t acc[MR][NR] = {};
+  for (size_t q = 0; q < kQuads; ++q) {
+    const uint8_t *ap = a + q * MR * 4;
+    const int8_t *bp = b + q * NR * 4;
+    for (size_t r = 0; r < MR; ++r) {
+      for (size_t j = 0; j < NR; ++j) {
+        int32_t sum = 0;
+        for (size_t t = 0; t < 4; ++t) {
+          sum += static_cast<int32_t>(ap[r * 4 + t]) * static_cast<int32_t>(bp[j * 4 + t]);
+        }
+        acc[r][j] += sum;
+      }
+    }
+  }
+  storeTile(acc, zeroCorrection, scale, bias, c, rsC, mr, nr);
+}
+
+#ifdef CNN_HAS_VNNI_KERNEL
+// Los intrínsecos de immintrin.h parten de registros sin inicializar a propósito.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+/**
+ * @brief Microkernel con AVX-512 VNNI.
+ * @details Por cada grupo de 4 k, un registro con los 16 x 4 bytes de B y, por fila, los 4
+ *          bytes de A difundidos: `vpdpbusd` multiplica u8 x s8 y suma los 4 productos en
+ *          int32. El epílogo aplica corrección, escala y bias con una máscara de columnas.
+ */
+__attribute__((target("avx512f,avx512vnni"))) void
+microKernelVnni(size_t kQuads, const uint8_t *a, const int8_t *b, const int32_t *zeroCorrection, const float *scale,
+                const float *bias, float *c, size_t rsC, size_t mr, size_t nr) {
+  __m512i acc[MR];
+  for (size_t r = 0; r < MR; ++r) {
+    acc[r] = _mm512_setzero_si512();
+  }
+  for (size_t q = 0; q < kQuads; ++q) {
+    const __m512i bv = _mm512_loadu_si512(b + q * NR * 4);
+    const uint8_t *ap = a + q * MR * 4;
+    for (size_t r = 0; r < MR; ++r) {
+      int quad;
+      std::memcpy(&quad, ap + r * 4, sizeof(quad));
+      acc[r] = _mm512_dpbusd_epi32(acc[r], _mm512_set1_epi32(quad), bv);
+    }
+  }
+
+  const __mmask16 mask = static_cast<__mmask16>((1u << nr) - 1u);
+  const __m512i correction = _mm512_maskz_loadu_epi32(mask, zeroCorrection);
+  const __m512 scaleV = _mm512_maskz_loadu_ps(mask, scale);
+  const __m512 biasV = _mm512_maskz_loadu_ps(mask, bias);
+  for (size_t r = 0; r < mr; ++r) {
+    const __m512 value = _mm512_fmadd_ps(_mm512_cvtepi32_ps(_mm512_sub_epi32(acc[r], correction)), scaleV, biasV);
+    _mm512_mask_storeu_ps(c + r * rsC, mask, value);
+  }
+}
+#pragma GCC diagnostic pop
+#endif
+
+using MicroKernel = void (*)(size_t, const uint8_t *, const int8_t *, const int32_t *, const float *, const float *,
+                             float *, size_t, size_t, size_t);
+
+/** @brief Microkernel para esta CPU (se decide una vez). */
+MicroKernel selectMicroKernel() {
+#ifdef CNN_HAS_VNNI_KERNEL
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vnni")) {
+    return microKernelVnni;
+  }
+#endif
+  return microKernelGeneric;
+}
+
+/**
+ * @brief Cuantiza un bloque mc x k de A a uint8 en paneles de MR filas.
+ * @details Cada fila se cuantiza entera en `row` (bucle vectorizable) y luego se reparte en
+ *          grupos de 4 bytes. Las filas y los k de relleno quedan en el punto cero, que la
+ *          corrección de la salida anula.
+ */
+void packA(size_t mc, size_t k, size_t kQuads, const float *a, size_t rsA, size_t csA, float invScale, uint8_t *row,
+           uint8_t *dst) {
+  std::fill(dst, dst + (mc + MR - 1) / MR * MR * kQuads * 4, static_cast<uint8_t>(ZERO_POINT));
+  std::fill(row + k, row + kQuads * 4, static_cast<uint8_t>(ZERO_POINT));
+  for (size_t i = 0; i < mc; ++i) {
+    const float *src = a + i * rsA;
+    for (size_t p = 0; p < k; ++p) {
+      row[p] = static_cast<uint8_t>(roundClamped(src[p * csA] * invScale) + ZERO_POINT);
+    }
+    uint8_t *panel = dst + (i / MR) * MR * kQuads * 4 + (i % MR) * 4;
+    for (size_t q = 0; q < kQuads; ++q) {
+      std::memcpy(panel + q * MR * 4, row + q * 4, 4);
+    }
+  }
+}
+
+bool inParallelRegion() {
+#ifdef _OPENMP
+  return omp_in_parallel() != 0;
+#else
+  return false;
+#endif
+}
+} // namespace
+
+/**
+ * @brief Cuantiza y empaqueta B en paneles de NR columnas.
+ * @details Una columna de ceros conserva escala 1 (cualquier escala la deja en ceros).
+ */
+QuantizedMatrix::QuantizedMatrix(const float *b, size_t k, size_t n, size_t rsB, size_t csB, float inputScale,
+                                 const float *bias)
+    : k(k), n(n), kQuads((k + 3) / 4), invInputScale(1.0f / inputScale) {
+  const size_t nPanels = (n + NR - 1) / NR;
+  this->panels.assign(nPanels * NR * this->kQuads * 4, 0);
+  this->zeroCorrection.assign(n, 0);
+  this->outputScale.assign(n, 0.0f);
+  this->bias.assign(n, 0.0f);
+
+  for (size_t j = 0; j < n; ++j) {
+    float colMax = 0.0f;
+    for (size_t p = 0; p < k; ++p) {
+      colMax = std::max(colMax, std::fabs(b[p * rsB + j * csB]));
+    }
+    const float scale = colMax > 0.0f ? colMax / 127.0f : 1.0f;
+
+    int8_t *panel = this->panels.data() + (j / NR) * NR * this->kQuads * 4;
+    int32_t colSum = 0;
+    for (size_t p = 0; p < k; ++p) {
+      const int32_t q = roundClamped(b[p * rsB + j * csB] / scale);
+      panel[quadIndex(p, j % NR, NR)] = static_cast<int8_t>(q);
+      colSum += q;
+    }
+    this->zeroCorrection[j] = ZERO_POINT * colSum;
+    this->outputScale[j] = inputScale * scale;
+    if (bias) {
+      this->bias[j] = bias[j];
+    }
+  }
+}
+
+/**
+ * @brief GEMM cuantizado por bloques de MC filas de A.
+ * @details Cada tarea cuantiza su bloque de A una sola vez y lo multiplica por todos los
+ *          paneles de B.
+ */
+void qgemm(size_t m, const float *a, size_t rsA, size_t csA, const QuantizedMatrix &b, float *c, size_t rsC) {
+  static const MicroKernel kernel = selectMicroKernel();
+  const size_t n = b.n;
+  const size_t kQuads = b.kQuads;
+  const size_t nPanels = (n + NR - 1) / NR;
+  const size_t mBlocks = (m + MC - 1) / MC;
+
+#pragma omp parallel for schedule(static) if (mBlocks > 1 && !inParallelRegion())
+  for (size_t ib = 0; ib < mBlocks; ++ib) {
+    static thread_local std::vector<uint8_t> packedA;
+    static thread_local std::vector<uint8_t> row;
+    const size_t ic = ib * MC;
+    const size_t mc = std::min(MC, m - ic);
+    const size_t mcPadded = (mc + MR - 1) / MR * MR;
+    if (packedA.size() < mcPadded * kQuads * 4) {
+      packedA.resize(mcPadded * kQuads * 4);
+    }
+    if (row.size() < kQuads * 4) {
+      row.resize(kQuads * 4);
+    }
+    packA(mc, b.k, kQuads, a + ic * rsA, rsA, csA, b.invInputScale, row.data(), packedA.data());
+
+    for (size_t jp = 0; jp < nPanels; ++jp) {
+      const size_t j0 = jp * NR;
+      const int8_t *bPanel = b.panels.data() + jp * NR * kQuads * 4;
+      for (size_t ir = 0; ir < mc; ir += MR) {
+        kernel(kQuads, packedA.data() + ir * kQuads * 4, bPanel, b.zeroCorrection.data() + j0,
+               b.outputScale.data() + j0, b.bias.data() + j0, c + (ic + ir) * rsC + j0, rsC, std::min(MR, mc - ir),
+               std::min(NR, n - j0));
+      }
+    }
+  }
+}
+
+void Int8Linear::setMode(Int8Mode newMode, const Tensor &weights, const Tensor &bias) {
+  if (newMode == Int8Mode::Quantized) {
+    if (this->absMax <= 0.0f) {
+      throw std::runtime_error("Int8Linear: no hay rango de entrada; calibra la capa antes de cuantizarla.");
+    }
+    const auto &shape = weights.getShape();
+    const auto &strides = weights.getStrides();
+    this->matrix = QuantizedMatrix(weights.getData() + weights.getDataOffset(), shape[0], shape[1], strides[0],
+                                   strides[1], this->absMax / 127.0f, bias.getData() + bias.getDataOffset());
+  } else {
+    this->matrix = QuantizedMatrix();
+    if (newMode == Int8Mode::Calibrate) {
+      this->absMax = 0.0f;
+    }
+  }
+  this->mode = newMode;
+}
+
+void Int8Linear::observe(const Tensor &input) {
+  if (this->mode != Int8Mode::Calibrate) {
+    return;
+  }
+  const Tensor dense = input.isContiguous() ? input : input.contiguous();
+  const float *data = dense.getData() + dense.getDataOffset();
+  const size_t size = dense.getSize();
+  float localMax = 0.0f;
+#pragma omp parallel for reduction(max : localMax) if (size > 65536)
+  for (size_t i = 0; i < size; ++i) {
+    localMax = std::max(localMax, std::fabs(data[i]));
+  }
+  this->absMax = std::max(this->absMax, localMax);
+}
+
+void Int8Linear::forward(const Tensor &input, Tensor &output) const {
+  const auto &strides = input.getStrides();
+  qgemm(input.getShape()[0], input.getData() + input.getDataOffset(), strides[0], strides[1], this->matrix,
+        output.getData() + output.getDataOffset(), this->matrix.cols());
+}
@@ -1,4 +1,5 @@
 #include "core/Tensor.hpp"
+#include "core/Allocator.hpp"
 
 #include <algorithm>
 #include <numeric>
@@ -31,18 +32,32 @@ void Tensor::computeStrides() {
 // --- Implementación de Constructores ---
 
 /** @brief Constructor por defecto: crea un tensor nulo. */
-Tensor::Tensor() : dataOffset(0), totalSize(0) {}
+Tensor::Tensor() : dataOffset(0), totalSize(0), storageSize(0) {}
 
 /**
  * @brief Constructor de un "Owning Tensor" (propietario).
- * @details Crea la memoria para los datos y la inicializa a cero.
+ * @details Pide la memoria al asignador activo y la inicializa a cero.
  */
 Tensor::Tensor(const std::vector<size_t> &newShape) : shape(newShape), dataOffset(0) {
   totalSize = std::accumulate(shape.begin(), shape.end(), 1, std::multiplies<size_t>());
-  dataPtr = std::make_shared<std::vector<float>>(totalSize, 0.0f);
+  storageSize = totalSize;
+  dataPtr = allocateStorage(totalSize, true);
   computeStrides();
 }
 
+/**
+ * @brief Crea un "Owning Tensor" cuyos datos no se inicializan.
+ */
+Tensor Tensor::uninitialized(const std::vector<size_t> &newShape) {
+  Tensor result;
+  result.shape = newShape;
+  result.totalSize = std::accumulate(newShape.begin(), newShape.end(), 1, std::multiplies<size_t>());
+  result.storageSize = result.totalSize;
+  result.dataPtr = allocateStorage(result.totalSize, false);
+  result.computeStrides();
+  return result;
+}
+
 /**
  * @brief Constructor de un "Owning Tensor" con datos iniciales.
  */
@@ -51,7 +66,9 @@ Tensor::Tensor(const std::vector<size_t> &newShape, const std::vector<float> &in
   if (totalSize != initialData.size()) {
     throw std::invalid_argument("El tamaño de los datos iniciales no coincide con la forma del tensor.");
   }
-  dataPtr = std::make_shared<std::vector<float>>(initialData);
+  storageSize = totalSize;
+  dataPtr = allocateStorage(totalSize, false);
+  std::copy(initialData.begin(), initialData.end(), dataPtr.get());
   computeStrides();
 }
 
@@ -59,9 +76,9 @@ Tensor::Tensor(const std::vector<size_t> &newShape, const std::vector<float> &in
  * @brief Constructor privado para crear vistas (slices).
  * @details Reutiliza el puntero de datos y los strides del tensor original.
  */
-Tensor::Tensor(std::shared_ptr<std::vector<float>> ptr, const std::vector<size_t> &newShape,
+Tensor::Tensor(std::shared_ptr<float[]> ptr, const std::vector<size_t> &newShape,
                const std::vector<size_t> &originalStrides, size_t offset)
-    : dataPtr(ptr), shape(newShape), strides(originalStrides), dataOffset(offset) {
+    : dataPtr(ptr), shape(newShape), strides(originalStrides), dataOffset(offset), storageSize(0) {
   totalSize = std::accumulate(shape.begin(), shape.end(), 1, std::multiplies<size_t>());
 }
 
@@ -74,41 +91,152 @@ Tensor Tensor::slice(size_t start, size_t count) const {
   if (shape.empty()) {
     throw std::runtime_error("No se puede hacer slice de un tensor vacío.");
   }
-  if (start + count > shape[0]) {
-    throw std::out_of_range("Slice fuera de los límites de la primera dimensión.");
+  return slice(0, start, count);
+}
+
+/**
+ * @brief Vista a lo largo de cualquier eje.
+ */
+Tensor Tensor::slice(size_t axis, size_t start, size_t count) const {
+  if (axis >= shape.size()) {
+    throw std::out_of_range("Eje de slice fuera de rango.");
+  }
+  if (start + count > shape[axis]) {
+    throw std::out_of_range("Slice fuera de los límites de la dimensión " + std::to_string(axis) + ".");
   }
 
   std::vector<size_t> newShape = shape;
-  newShape[0] = count;
-  // El nuevo offset es el offset actual más el desplazamiento del slice.
-  size_t newOffset = dataOffset + start * strides[0];
+  newShape[axis] = count;
+  Tensor view(this->dataPtr, newShape, this->strides, dataOffset + start * strides[axis]);
+  view.storageSize = this->storageSize;
+  return view;
+}
+
+/**
+ * @brief Reinterpreta la forma. Sin copia si el tensor es contiguo.
+ */
+Tensor Tensor::reshape(const std::vector<size_t> &newShape) const {
+  const size_t newTotalSize = std::accumulate(newShape.begin(), newShape.end(), size_t{1}, std::multiplies<size_t>());
+  if (newTotalSize != this->totalSize) {
+    throw std::invalid_argument("reshape: " + shapeToString() + " no tiene el mismo número de elementos que la forma pedida.");
+  }
+  if (!isContiguous()) {
+    return contiguous().reshape(newShape);
+  }
+  Tensor view(this->dataPtr, newShape, {}, this->dataOffset);
+  view.computeStrides();
+  view.storageSize = this->storageSize;
+  return view;
+}
 
-  // Llama al constructor privado para crear la vista.
-  return Tensor(this->dataPtr, newShape, this->strides, newOffset);
+/**
+ * @brief Intercambia dos dimensiones (forma y strides). No copia datos.
+ */
+Tensor Tensor::transpose(size_t dim1, size_t dim2) const {
+  if (dim1 >= shape.size() || dim2 >= shape.size()) {
+    throw std::out_of_range("Ejes de transpose fuera de rango para " + shapeToString() + ".");
+  }
+  std::vector<size_t> newShape = this->shape;
+  std::vector<size_t> newStrides = this->strides;
+  std::swap(newShape[dim1], newShape[dim2]);
+  std::swap(newStrides[dim1], newStrides[dim2]);
+  Tensor view(this->dataPtr, newShape, newStrides, this->dataOffset);
+  view.storageSize = this->storageSize;
+  return view;
 }
 
 /**
- * @brief Devuelve la transpuesta de una matriz (tensor 2D).
+ * @brief Devuelve la transpuesta de una matriz (tensor 2D) como vista.
  */
 Tensor Tensor::transpose() const {
   if (shape.size() != 2) {
     throw std::runtime_error("Transpose solo implementado para tensores 2D.");
   }
-  Tensor result({shape[1], shape[0]});
+  return transpose(0, 1);
+}
+
+/**
+ * @brief Repite un eje de tamaño 1 con stride 0. No copia datos.
+ */
+Tensor Tensor::expand(size_t axis, size_t count) const {
+  if (axis >= shape.size() || shape[axis] != 1) {
+    throw std::invalid_argument("expand: el eje " + std::to_string(axis) + " de " + shapeToString() +
+                                " debe existir y tener tamaño 1.");
+  }
+  std::vector<size_t> newShape = this->shape;
+  std::vector<size_t> newStrides = this->strides;
+  newShape[axis] = count;
+  newStrides[axis] = 0;
+  Tensor view(this->dataPtr, newShape, newStrides, this->dataOffset);
+  view.storageSize = this->storageSize;
+  return view;
+}
+
+/**
+ * @brief Copia los datos en orden row-major si la vista no es contigua.
+ */
+Tensor Tensor::contiguous() const {
+  if (isContiguous()) {
+    return *this;
+  }
+
+  Tensor result = Tensor::uninitialized(this->shape);
+  float *out = result.getData();
+  if (shape.size() == 2) {
+#pragma omp parallel for
+    for (size_t i = 0; i < shape[0]; ++i) {
+      for (size_t j = 0; j < shape[1]; ++j) {
+        out[i * shape[1] + j] = (*this)(i, j);
+      }
+    }
+  } else if (shape.size() == 4) {
 #pragma omp parallel for collapse(2)
-  for (size_t i = 0; i < shape[0]; ++i) {
-    for (size_t j = 0; j < shape[1]; ++j) {
-      result(j, i) = (*this)(i, j); // Usa los operadores () para acceso seguro a strides/offsets.
+    for (size_t b = 0; b < shape[0]; ++b) {
+      for (size_t c = 0; c < shape[1]; ++c) {
+        float *plane = out + (b * shape[1] + c) * shape[2] * shape[3];
+        for (size_t h = 0; h < shape[2]; ++h) {
+          for (size_t w = 0; w < shape[3]; ++w) {
+            plane[h * shape[3] + w] = (*this)(b, c, h, w);
+          }
+        }
+      }
+    }
+  } else {
+    // Caso general: descompone cada índice plano en índices por dimensión.
+#pragma omp parallel for
+    for (size_t flat = 0; flat < totalSize; ++flat) {
+      size_t remaining = flat;
+      size_t offset = dataOffset;
+      for (size_t d = shape.size(); d-- > 0;) {
+        offset += (remaining % shape[d]) * strides[d];
+        remaining /= shape[d];
+      }
+      out[flat] = dataPtr[offset];
     }
   }
   return result;
 }
 
+/**
+ * @brief Comprueba si los strides son los row-major de la forma.
+ * @details Las dimensiones de tamaño 1 no importan: su stride nunca se usa.
+ */
+bool Tensor::isContiguous() const {
+  size_t expected = 1;
+  for (size_t d = shape.size(); d-- > 0;) {
+    if (shape[d] != 1 && strides[d] != expected) {
+      return false;
+    }
+    expected *= shape[d];
+  }
+  return true;
+}
+
 /**
  * @brief Devuelve un nuevo tensor con el cuadrado de cada elemento.
  */
 Tensor Tensor::square() const {
-  Tensor result(this->shape); // Crea un tensor del mismo tamaño.
+  Tensor result = Tensor::uninitialized(this->shape); // Se sobrescribe por completo.
   const auto &current_shape = this->getShape();
 
   if (current_shape.size() == 2) {
@@ -232,34 +360,50 @@ void Tensor::addBroadcast(const Tensor &other) {
   }
 }
 
+/**
+ * @brief Copia elemento a elemento sin reasignar el bloque de datos.
+ */
+void Tensor::copyFrom(const Tensor &source) {
+  if (source.shape != this->shape) {
+    throw std::runtime_error("copyFrom: la forma " + source.shapeToString() + " no coincide con " +
+                             this->shapeToString() + ".");
+  }
+  if (!this->isContiguous()) {
+    throw std::runtime_error("copyFrom solo se puede usar sobre tensores contiguos.");
+  }
+  const Tensor contiguousSource = source.contiguous();
+  const float *src = contiguousSource.dataPtr.get() + contiguousSource.dataOffset;
+  std::copy(src, src + this->totalSize, this->dataPtr.get() + this->dataOffset);
+}
+
 // --- Implementación de Getters y Utilidades ---
 
 /** @brief Devuelve un puntero de escritura. Lanza excepción si es una vista compleja. */
 float *Tensor::getData() {
-  if (dataOffset != 0 || totalSize != dataPtr->size()) {
+  if (dataOffset != 0 || totalSize != storageSize) {
     // Advertencia: getData() en una vista puede ser ambiguo. El puntero apunta al inicio
     // del bloque de memoria COMPLETO, no al inicio de la vista. Se permite pero con cuidado.
   }
-  return dataPtr->data();
+  return dataPtr.get();
 }
 
 /** @brief Devuelve un puntero de solo lectura. */
-const float *Tensor::getData() const { return dataPtr->data(); }
+const float *Tensor::getData() const { return dataPtr.get(); }
 
 /** @brief Rellena el tensor con un valor (solo para "Owning Tensors"). */
 void Tensor::fill(float value) {
-  if (dataOffset != 0 || totalSize != dataPtr->size()) {
+  if (dataOffset != 0 || totalSize != storageSize) {
     throw std::runtime_error("fill() solo se puede usar en tensores dueños, no en vistas complejas.");
   }
 #pragma omp parallel for
   for (size_t i = 0; i < totalSize; ++i) {
-    (*dataPtr)[i] = value;
+    dataPtr[i] = value;
   }
 }
 
 /** @brief Rellena con valores aleatorios (solo para "Owning Tensors"). */
 void Tensor::randomize(float min, float max) {
-  if (dataOffset != 0 || totalSize != dataPtr->size()) {
+  if (dataOffset != 0 || totalSize != storageSize) {
     throw std::runtime_error("randomize() solo se puede usar en tensores dueños, no en vistas complejas.");
   }
   std::random_device rd;
@@ -267,7 +411,7 @@ void Tensor::randomize(float min, float max) {
   std::uniform_real_distribution<float> dis(min, max);
 
   // std::generate es una buena opción para rellenar contenedores.
-  std::generate(dataPtr->begin(), dataPtr->end(), [&]() { return dis(gen); });
+  std::generate(dataPtr.get(), dataPtr.get() + totalSize, [&]() { return dis(gen); });
 }
 
 /** @brief Convierte la forma del tensor a un string legible. */
@@ -305,7 +449,7 @@ Tensor matrixMultiply(const Tensor &a, const Tensor &b) {
   const size_t n = aShape[1];
   const size_t p = bShape[1];
 
-  Tensor result({m, p}); // Tensor dueño para el resultado.
+  Tensor result = Tensor::uninitialized({m, p}); // Tensor dueño para el resultado.
 
 // Se paraleliza el bucle más externo para distribuir el trabajo por filas del resultado.
 #pragma omp parallel for
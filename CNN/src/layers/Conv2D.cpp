@@ -1,6 +1,9 @@
 #include "layers/Conv2D.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cstdlib>
 #include <stdexcept>
 #include <vector>
 
@@ -9,6 +12,90 @@
 #include <omp.h>
 #endif
 
+namespace {
+/// Canales de salida por bloque en la convolución directa (formato NCHWc de los pesos).
+constexpr size_t OC_BLOCK = 8;
+/// Píxeles de salida contiguos que acumula cada iteración de la convolución directa.
+constexpr size_t OW_TILE = 8;
+/// Teselas por bloque en los productos de Winograd (la fila de salida cabe en L1).
+constexpr size_t WINOGRAD_TILE_BLOCK = 512;
+
+/** @brief Algoritmo inicial de las capas según CNN_CONV_ALGO (por defecto, Auto). */
+Conv2D::Algorithm defaultAlgorithm() {
+  const char *env = std::getenv("CNN_CONV_ALGO");
+  const std::string name = env ? env : "";
+  if (name == "im2col")
+    return Conv2D::Algorithm::Im2col;
+  if (name == "direct")
+    return Conv2D::Algorithm::Direct;
+  if (name == "winograd")
+    return Conv2D::Algorithm::Winograd;
+  return Conv2D::Algorithm::Auto;
+}
+
+/**
+ * @brief Copia la entrada {B, C, H, W} en un tensor {B, C, paddedH, paddedW} con ceros
+ *        alrededor; el píxel (0, 0) queda en (padding, padding).
+ */
+Tensor padInput(const Tensor &input, size_t padding, size_t paddedH, size_t paddedW) {
+  const size_t batchSize = input.getShape()[0];
+  const size_t channels = input.getShape()[1];
+  const size_t inH = input.getShape()[2];
+  const size_t inW = input.getShape()[3];
+  Tensor padded({batchSize, channels, paddedH, paddedW});
+  float *paddedData = padded.getData();
+
+#pragma omp parallel for collapse(2)
+  for (size_t b = 0; b < batchSize; ++b) {
+    for (size_t c = 0; c < channels; ++c) {
+      float *plane = paddedData + (b * channels + c) * paddedH * paddedW;
+      for (size_t h = 0; h < inH; ++h) {
+        float *row = plane + (h + padding) * paddedW + padding;
+        for (size_t w = 0; w < inW; ++w) {
+          row[w] = input(b, c, h, w);
+        }
+      }
+    }
+  }
+  return padded;
+}
+
+/**
+ * @brief Parches de la entrada como filas: {B*outH*outW, C*K*K}.
+ * @details Es la transpuesta de la matriz de `Conv2D::im2col`; con los parches contiguos el
+ *          producto int8 cuantiza cada fila de un solo recorrido. La entrada se copia antes
+ *          con relleno, así que cada fila del kernel es una copia contigua sin comprobar bordes.
+ */
+Tensor im2row(const Tensor &input, size_t kernelSize, size_t stride, size_t padding, size_t outH, size_t outW) {
+  const size_t batchSize = input.getShape()[0];
+  const size_t channels = input.getShape()[1];
+  const size_t paddedH = input.getShape()[2] + 2 * padding;
+  const size_t paddedW = input.getShape()[3] + 2 * padding;
+  const Tensor padded = padInput(input, padding, paddedH, paddedW);
+  const float *in = padded.getData();
+  const size_t patchSize = channels * kernelSize * kernelSize;
+  Tensor rows = Tensor::uninitialized({batchSize * outH * outW, patchSize});
+  float *data = rows.getData();
+
+#pragma omp parallel for
+  for (size_t r = 0; r < batchSize * outH * outW; ++r) {
+    const size_t b = r / (outH * outW);
+    const size_t oh = (r / outW) % outH;
+    const size_t ow = r % outW;
+    float *patch = data + r * patchSize;
+    for (size_t ic = 0; ic < channels; ++ic) {
+      const float *plane = in + (b * channels + ic) * paddedH * paddedW;
+      for (size_t kh = 0; kh < kernelSize; ++kh) {
+        const float *src = plane + (oh * stride + kh) * paddedW + ow * stride;
+        std::copy(src, src + kernelSize, patch);
+        patch += kernelSize;
+      }
+    }
+  }
+  return rows;
+}
+} // namespace
+
 /**
  * @brief Constructor de la capa Conv2D.
  */
@@ -31,38 +118,239 @@ Conv2D::Conv2D(size_t inChannels, size_t outChannels, size_t kernelSize, size_t
   // Inicializar gradientes con las mismas formas, rellenos de ceros.
   this->weightGradients = Tensor(this->weights.getShape());
   this->biasGradients = Tensor(this->bias.getShape());
+
+  this->algorithm = defaultAlgorithm();
 }
 
 /**
- * @brief Realiza el paso hacia adelante de la convolución usando la técnica im2col.
+ * @brief Realiza el paso hacia adelante de la convolución con el algoritmo seleccionado.
  */
 Tensor Conv2D::forward(const Tensor &input, bool isTraining) {
+  // 1. Si todos los canales de la entrada son el mismo plano (stride 0), sum_c W[c] * x = (sum_c W[c]) * x:
+  //    se convoluciona ese plano una sola vez con los pesos sumados sobre los canales.
+  const bool broadcast = input.getShape().size() == 4 && input.isBroadcast(1);
+  const Tensor plane = broadcast ? input.slice(1, 0, 1) : input;
+  const Tensor filters = broadcast ? this->channelSummedWeights() : this->weights;
   if (isTraining) {
     this->inputShape = input.getShape();
+    this->lastInput = plane;
+    this->broadcastInput = broadcast;
   }
-  const size_t batchSize = input.getShape()[0];
   const size_t inH = input.getShape()[2];
   const size_t inW = input.getShape()[3];
 
-  // 1. Calcular dimensiones de salida
+  // 2. Calcular dimensiones de salida
   const size_t outH = (inH + 2 * padding - kernelSize) / stride + 1;
   const size_t outW = (inW + 2 * padding - kernelSize) / stride + 1;
 
-  // 2. Transformar la entrada a una matriz de columnas (im2col)
+  // 3. Inferencia int8: el mismo plano con los filtros cuantizados que le corresponden.
+  this->int8.observe(plane);
+  this->int8Summed.observe(plane);
+  if (!isTraining && this->int8.isQuantized()) {
+    this->im2colValid = false;
+    return this->forwardInt8(plane, broadcast ? this->int8Summed : this->int8, outH, outW);
+  }
+
+  // 4. Elegir el algoritmo (sin medir nada, ver `getAlgorithm`) y aplicarlo.
+  const Algorithm chosen = this->getAlgorithm(plane.getShape());
+  Tensor output = this->forwardWith(chosen, plane, filters, outH, outW);
+
+  // 5. El backward necesita la matriz de columnas de esta entrada; si el forward no la
+  //    generó, se construye allí a partir de `lastInput`.
+  this->im2colValid = isTraining && chosen == Algorithm::Im2col;
+  return output;
+}
+
+// --- Selección de algoritmo ---
+
+void Conv2D::setAlgorithm(Algorithm algorithm) {
+  this->algorithm = algorithm;
+  this->tunedAlgorithms.clear();
+}
+
+Conv2D::Algorithm Conv2D::getAlgorithm(const std::vector<size_t> &inputShape) const {
+  if (this->algorithm == Algorithm::Winograd && !this->supportsWinograd()) {
+    return Algorithm::Direct;
+  }
+  if (this->algorithm != Algorithm::Auto) {
+    return this->algorithm;
+  }
+  auto it = this->tunedAlgorithms.find(inputShape);
+  if (it != this->tunedAlgorithms.end()) {
+    return it->second;
+  }
+  const std::vector<size_t> outputShape = this->getOutputShape(inputShape);
+  return this->heuristicAlgorithm(outputShape[2], outputShape[3]);
+}
+
+/**
+ * @brief Regla fija de Auto.
+ * @details Medido con `bench` sobre las convoluciones de app/main.cpp y una de 64 canales:
+ *          Winograd es la más rápida con 3x3 y stride 1 (2-3x frente a la directa) y la
+ *          directa gana a im2col en el resto, porque im2col copia K*K veces la entrada antes
+ *          del GEMM. Con salidas de menos de 4x4 las transformadas de Winograd no compensan.
+ */
+Conv2D::Algorithm Conv2D::heuristicAlgorithm(size_t outH, size_t outW) const {
+  if (this->supportsWinograd() && outH >= 4 && outW >= 4) {
+    return Algorithm::Winograd;
+  }
+  return Algorithm::Direct;
+}
+
+std::string Conv2D::algorithmName(Algorithm algorithm) {
+  switch (algorithm) {
+  case Algorithm::Im2col:
+    return "im2col";
+  case Algorithm::Direct:
+    return "direct";
+  case Algorithm::Winograd:
+    return "winograd";
+  default:
+    return "auto";
+  }
+}
+
+/**
+ * @brief Mide los candidatos sobre la entrada de ejemplo y guarda el más rápido.
+ * @details Igual que el forward, una entrada con canales repetidos se mide sobre su plano
+ *          único con los pesos sumados, y la elección se guarda para la forma de ese plano.
+ */
+void Conv2D::autotune(const Tensor &input) {
+  if (this->algorithm != Algorithm::Auto) {
+    return;
+  }
+  const bool broadcast = input.getShape().size() == 4 && input.isBroadcast(1);
+  const Tensor plane = broadcast ? input.slice(1, 0, 1) : input;
+  const Tensor filters = broadcast ? this->channelSummedWeights() : this->weights;
+  const std::vector<size_t> outputShape = this->getOutputShape(input.getShape());
+  const size_t outH = outputShape[2];
+  const size_t outW = outputShape[3];
+
+  std::vector<Algorithm> candidates = {Algorithm::Im2col, Algorithm::Direct};
+  if (this->supportsWinograd()) {
+    candidates.push_back(Algorithm::Winograd);
+  }
+
+  Algorithm best = Algorithm::Im2col;
+  double bestSeconds = 0.0;
+  for (Algorithm candidate : candidates) {
+    double seconds = 0.0;
+    for (int run = 0; run < 2; ++run) {
+      const auto start = std::chrono::steady_clock::now();
+      this->forwardWith(candidate, plane, filters, outH, outW);
+      seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    if (candidate == candidates.front() || seconds < bestSeconds) {
+      best = candidate;
+      bestSeconds = seconds;
+    }
+  }
+  // forwardIm2col deja su matriz de columnas, que no corresponde a ningún forward de entrenamiento.
+  this->im2colValid = false;
+  this->tunedAlgorithms[plane.getShape()] = best;
+}
+
+Tensor Conv2D::forwardWith(Algorithm algorithm, const Tensor &input, const Tensor &filters, size_t outH,
+                           size_t outW) {
+  switch (algorithm) {
+  case Algorithm::Direct:
+    return this->forwardDirect(input, filters, outH, outW);
+  case Algorithm::Winograd:
+    return this->forwardWinograd(input, filters, outH, outW);
+  default:
+    return this->forwardIm2col(input, filters, outH, outW);
+  }
+}
+
+/**
+ * @brief Suma los pesos de cada filtro sobre sus canales de entrada.
+ * @details Se calcula una vez y se reutiliza hasta que `parametersUpdated` la invalida.
+ */
+Tensor Conv2D::channelSummedWeights() const {
+  if (this->summedWeightsValid) {
+    return this->summedWeights;
+  }
+  const size_t taps = this->kernelSize * this->kernelSize;
+  Tensor summed({this->outChannels, 1, this->kernelSize, this->kernelSize});
+  float *out = summed.getData();
+  const float *w = this->weights.getData() + this->weights.getDataOffset();
+  for (size_t oc = 0; oc < this->outChannels; ++oc) {
+    for (size_t ic = 0; ic < this->inChannels; ++ic) {
+      for (size_t k = 0; k < taps; ++k) {
+        out[oc * taps + k] += w[(oc * this->inChannels + ic) * taps + k];
+      }
+    }
+  }
+  this->summedWeights = summed;
+  this->summedWeightsValid = true;
+  return summed;
+}
+
+void Conv2D::parametersUpdated() { this->summedWeightsValid = false; }
+
+// --- Inferencia int8 ---
+
+/**
+ * @brief Cuantiza los filtros en la forma {C*K*K, outC} que multiplica a los parches.
+ * @details El rango de la entrada es el mismo con o sin canales repetidos, así que las dos
+ *          copias se calibran con el mismo plano.
+ */
+void Conv2D::setInt8Mode(Int8Mode mode) {
+  const size_t taps = this->kernelSize * this->kernelSize;
+  this->int8.setMode(mode, this->weights.reshape({this->outChannels, this->inChannels * taps}).transpose(),
+                     this->bias);
+  this->int8Summed.setMode(mode, this->channelSummedWeights().reshape({this->outChannels, taps}).transpose(),
+                           this->bias);
+}
+
+/**
+ * @brief Parches {B*outH*outW, C*K*K} por los filtros cuantizados, reordenado a NCHW.
+ * @details El bias ya viene sumado por el producto int8.
+ */
+Tensor Conv2D::forwardInt8(const Tensor &input, const Int8Linear &linear, size_t outH, size_t outW) const {
+  const size_t batchSize = input.getShape()[0];
+  const size_t pixels = outH * outW;
+  const Tensor patches = im2row(input, this->kernelSize, this->stride, this->padding, outH, outW);
+  Tensor product = Tensor::uninitialized({batchSize * pixels, this->outChannels});
+  linear.forward(patches, product);
+
+  Tensor output = Tensor::uninitialized({batchSize, this->outChannels, outH, outW});
+  const float *src = product.getData();
+  float *dst = output.getData();
+#pragma omp parallel for collapse(2)
+  for (size_t b = 0; b < batchSize; ++b) {
+    for (size_t oc = 0; oc < this->outChannels; ++oc) {
+      float *plane = dst + (b * this->outChannels + oc) * pixels;
+      for (size_t i = 0; i < pixels; ++i) {
+        plane[i] = src[(b * pixels + i) * this->outChannels + oc];
+      }
+    }
+  }
+  return output;
+}
+
+// --- Algoritmos del forward ---
+
+/**
+ * @brief Convolución como una única multiplicación de matrices sobre la matriz im2col.
+ */
+Tensor Conv2D::forwardIm2col(const Tensor &input, const Tensor &filters, size_t outH, size_t outW) {
+  const size_t batchSize = input.getShape()[0];
+
+  // 1. Transformar la entrada a una matriz de columnas (im2col)
   // Esta matriz se guarda como miembro (this->im2colMatrix) para reutilizarla en el backward pass.
   this->im2col(input, outH, outW);
 
-  // 3. Remodelar los pesos de los filtros para la multiplicación de matrices.
-  // De {outC, inC, kH, kW} a {outC, inC*kH*kW}
-  Tensor reshapedWeights({this->outChannels, this->inChannels * this->kernelSize * this->kernelSize});
-  std::copy(this->weights.getData(), this->weights.getData() + this->weights.getSize(), reshapedWeights.getData());
+  // 2. Ver los pesos de los filtros como matriz (vista, sin copia).
+  // De {outC, C, kH, kW} a {outC, C*kH*kW}
+  const Tensor reshapedWeights = filters.reshape({this->outChannels, this->im2colMatrix.getShape()[0]});
 
-  // 4. Realizar la convolución como una única multiplicación de matrices.
+  // 3. Realizar la convolución como una única multiplicación de matrices.
   // Resultado: {outC, B*outH*outW}
   Tensor convResult = matrixMultiply(reshapedWeights, this->im2colMatrix);
 
-  // 5. Remodelar la salida y añadir el bias.
-  Tensor output({batchSize, this->outChannels, outH, outW});
+  // 4. Remodelar la salida y añadir el bias.
+  Tensor output = Tensor::uninitialized({batchSize, this->outChannels, outH, outW});
 #pragma omp parallel for collapse(2)
   for (size_t b = 0; b < batchSize; ++b) {
     for (size_t oc = 0; oc < this->outChannels; ++oc) {
@@ -77,6 +365,223 @@ Tensor Conv2D::forward(const Tensor &input, bool isTraining) {
   return output;
 }
 
+/**
+ * @brief Convolución directa.
+ * @details Los pesos se reordenan a {outC/8, inC, K, K, 8} (NCHWc): para cada tap del
+ *          kernel, los 8 canales de salida de un bloque son contiguos y el bucle interno
+ *          acumula un bloque de 8x8 (píxeles x canales) que el compilador vectoriza. La
+ *          entrada se copia una vez con relleno, así que el bucle no comprueba bordes.
+ */
+Tensor Conv2D::forwardDirect(const Tensor &input, const Tensor &filters, size_t outH, size_t outW) const {
+  const size_t batchSize = input.getShape()[0];
+  const size_t inC = input.getShape()[1];
+  const size_t K = this->kernelSize;
+  const size_t paddedH = input.getShape()[2] + 2 * this->padding;
+  const size_t paddedW = input.getShape()[3] + 2 * this->padding;
+  const size_t ocBlocks = (this->outChannels + OC_BLOCK - 1) / OC_BLOCK;
+
+  // 1. Empaquetar los pesos; los canales que completan el último bloque quedan a cero.
+  Tensor packedWeights({ocBlocks, inC, K, K, OC_BLOCK});
+  float *packed = packedWeights.getData();
+  const float *w = filters.getData() + filters.getDataOffset();
+  for (size_t oc = 0; oc < this->outChannels; ++oc) {
+    for (size_t ic = 0; ic < inC; ++ic) {
+      for (size_t k = 0; k < K * K; ++k) {
+        packed[((oc / OC_BLOCK) * inC * K * K + ic * K * K + k) * OC_BLOCK + oc % OC_BLOCK] =
+            w[(oc * inC + ic) * K * K + k];
+      }
+    }
+  }
+
+  // 2. Entrada con relleno.
+  const Tensor padded = padInput(input, this->padding, paddedH, paddedW);
+  const float *in = padded.getData();
+
+  // 3. Cada hilo produce una fila de salida de un bloque de canales.
+  Tensor output = Tensor::uninitialized({batchSize, this->outChannels, outH, outW});
+  float *out = output.getData();
+  const float *biasData = this->bias.getData() + this->bias.getDataOffset();
+  const size_t strideStep = this->stride;
+
+#pragma omp parallel for collapse(3)
+  for (size_t b = 0; b < batchSize; ++b) {
+    for (size_t ocb = 0; ocb < ocBlocks; ++ocb) {
+      for (size_t oh = 0; oh < outH; ++oh) {
+        const size_t ocCount = std::min(OC_BLOCK, this->outChannels - ocb * OC_BLOCK);
+        const float *blockWeights = packed + ocb * inC * K * K * OC_BLOCK;
+
+        for (size_t ow0 = 0; ow0 < outW; ow0 += OW_TILE) {
+          const size_t tile = std::min(OW_TILE, outW - ow0);
+          float acc[OW_TILE][OC_BLOCK] = {};
+
+          for (size_t ic = 0; ic < inC; ++ic) {
+            const float *plane = in + (b * inC + ic) * paddedH * paddedW;
+            for (size_t kh = 0; kh < K; ++kh) {
+              const float *row = plane + (oh * strideStep + kh) * paddedW + ow0 * strideStep;
+              for (size_t kw = 0; kw < K; ++kw) {
+                const float *tap = blockWeights + ((ic * K + kh) * K + kw) * OC_BLOCK;
+                for (size_t p = 0; p < tile; ++p) {
+                  const float x = row[p * strideStep + kw];
+                  for (size_t j = 0; j < OC_BLOCK; ++j) {
+                    acc[p][j] += x * tap[j];
+                  }
+                }
+              }
+            }
+          }
+
+          for (size_t j = 0; j < ocCount; ++j) {
+            const size_t oc = ocb * OC_BLOCK + j;
+            float *outRow = out + ((b * this->outChannels + oc) * outH + oh) * outW + ow0;
+            for (size_t p = 0; p < tile; ++p) {
+              outRow[p] = acc[p][j] + biasData[oc];
+            }
+          }
+        }
+      }
+    }
+  }
+  return output;
+}
+
+/**
+ * @brief Winograd F(2x2, 3x3).
+ * @details Con T teselas de salida 2x2 (sobre todo el lote):
+ *          1. U = G g G^T: cada filtro 3x3 pasa a 4x4; U se guarda como {16, outC, inC}.
+ *          2. V = B^T d B: cada tesela de entrada 4x4 (solapadas con paso 2); {16, inC, T}.
+ *          3. M[xi] = U[xi] * V[xi] para las 16 posiciones xi: 16 productos de matrices
+ *             {outC, inC} x {inC, T}, que suman sobre los canales de entrada.
+ *          4. Y = A^T m A: cada tesela 4x4 de M da la salida 2x2; se añade el bias.
+ *          La matriz V ocupa 4 veces la entrada, frente a 9 veces de im2col.
+ */
+Tensor Conv2D::forwardWinograd(const Tensor &input, const Tensor &filters, size_t outH, size_t outW) const {
+  if (!this->supportsWinograd()) {
+    throw std::logic_error("Winograd F(2x2, 3x3) requiere kernel 3x3 y stride 1.");
+  }
+  const size_t batchSize = input.getShape()[0];
+  const size_t tilesH = (outH + 1) / 2;
+  const size_t tilesW = (outW + 1) / 2;
+  const size_t numTiles = batchSize * tilesH * tilesW;
+  const size_t inC = input.getShape()[1];
+  const size_t outC = this->outChannels;
+
+  // 1. Transformación de los pesos: U = G g G^T.
+  Tensor transformedWeights = Tensor::uninitialized({16, outC, inC});
+  float *U = transformedWeights.getData();
+  const float *w = filters.getData() + filters.getDataOffset();
+#pragma omp parallel for collapse(2)
+  for (size_t oc = 0; oc < outC; ++oc) {
+    for (size_t ic = 0; ic < inC; ++ic) {
+      const float *g = w + (oc * inC + ic) * 9;
+      float gg[4][3]; // G g
+      for (size_t j = 0; j < 3; ++j) {
+        gg[0][j] = g[j];
+        gg[1][j] = 0.5f * (g[j] + g[3 + j] + g[6 + j]);
+        gg[2][j] = 0.5f * (g[j] - g[3 + j] + g[6 + j]);
+        gg[3][j] = g[6 + j];
+      }
+      for (size_t i = 0; i < 4; ++i) {
+        const float u[4] = {gg[i][0], 0.5f * (gg[i][0] + gg[i][1] + gg[i][2]), 0.5f * (gg[i][0] - gg[i][1] + gg[i][2]),
+                            gg[i][2]};
+        for (size_t j = 0; j < 4; ++j) {
+          U[((i * 4 + j) * outC + oc) * inC + ic] = u[j];
+        }
+      }
+    }
+  }
+
+  // 2. Transformación de la entrada: V = B^T d B. El relleno cubre también la última
+  //    tesela cuando la salida tiene tamaño impar.
+  const size_t paddedH = 2 * tilesH + 2;
+  const size_t paddedW = 2 * tilesW + 2;
+  const Tensor padded = padInput(input, this->padding, paddedH, paddedW);
+  const float *in = padded.getData();
+  Tensor transformedInput = Tensor::uninitialized({16, inC, numTiles});
+  float *V = transformedInput.getData();
+#pragma omp parallel for collapse(2)
+  for (size_t b = 0; b < batchSize; ++b) {
+    for (size_t ic = 0; ic < inC; ++ic) {
+      const float *plane = in + (b * inC + ic) * paddedH * paddedW;
+      for (size_t th = 0; th < tilesH; ++th) {
+        for (size_t tw = 0; tw < tilesW; ++tw) {
+          const float *d = plane + 2 * th * paddedW + 2 * tw;
+          float bd[4][4]; // B^T d
+          for (size_t j = 0; j < 4; ++j) {
+            const float d0 = d[j], d1 = d[paddedW + j], d2 = d[2 * paddedW + j], d3 = d[3 * paddedW + j];
+            bd[0][j] = d0 - d2;
+            bd[1][j] = d1 + d2;
+            bd[2][j] = d2 - d1;
+            bd[3][j] = d1 - d3;
+          }
+          const size_t t = (b * tilesH + th) * tilesW + tw;
+          for (size_t i = 0; i < 4; ++i) {
+            const float v[4] = {bd[i][0] - bd[i][2], bd[i][1] + bd[i][2], bd[i][2] - bd[i][1], bd[i][1] - bd[i][3]};
+            for (size_t j = 0; j < 4; ++j) {
+              V[((i * 4 + j) * inC + ic) * numTiles + t] = v[j];
+            }
+          }
+        }
+      }
+    }
+  }
+
+  // 3. Productos por posición: M[xi][oc][t] = sum_ic U[xi][oc][ic] * V[xi][ic][t].
+  Tensor products({16, outC, numTiles});
+  float *M = products.getData();
+#pragma omp parallel for collapse(2)
+  for (size_t xi = 0; xi < 16; ++xi) {
+    for (size_t oc = 0; oc < outC; ++oc) {
+      float *mRow = M + (xi * outC + oc) * numTiles;
+      const float *uRow = U + (xi * outC + oc) * inC;
+      for (size_t t0 = 0; t0 < numTiles; t0 += WINOGRAD_TILE_BLOCK) {
+        const size_t t1 = std::min(t0 + WINOGRAD_TILE_BLOCK, numTiles);
+        for (size_t ic = 0; ic < inC; ++ic) {
+          const float u = uRow[ic];
+          const float *vRow = V + (xi * inC + ic) * numTiles;
+          for (size_t t = t0; t < t1; ++t) {
+            mRow[t] += u * vRow[t];
+          }
+        }
+      }
+    }
+  }
+
+  // 4. Transformación de salida: Y = A^T m A, recortando la última fila/columna si sobra.
+  Tensor output = Tensor::uninitialized({batchSize, outC, outH, outW});
+  float *out = output.getData();
+  const float *biasData = this->bias.getData() + this->bias.getDataOffset();
+#pragma omp parallel for collapse(2)
+  for (size_t b = 0; b < batchSize; ++b) {
+    for (size_t oc = 0; oc < outC; ++oc) {
+      float *outPlane = out + (b * outC + oc) * outH * outW;
+      for (size_t th = 0; th < tilesH; ++th) {
+        for (size_t tw = 0; tw < tilesW; ++tw) {
+          const size_t t = (b * tilesH + th) * tilesW + tw;
+          float m[4][4];
+          for (size_t xi = 0; xi < 16; ++xi) {
+            m[xi / 4][xi % 4] = M[(xi * outC + oc) * numTiles + t];
+          }
+          float am[2][4]; // A^T m
+          for (size_t j = 0; j < 4; ++j) {
+            am[0][j] = m[0][j] + m[1][j] + m[2][j];
+            am[1][j] = m[1][j] - m[2][j] - m[3][j];
+          }
+          for (size_t i = 0; i < 2; ++i) {
+            const size_t oh = 2 * th + i;
+            if (oh >= outH)
+              break;
+            float *outRow = outPlane + oh * outW + 2 * tw;
+            outRow[0] = am[i][0] + am[i][1] + am[i][2] + biasData[oc];
+            if (2 * tw + 1 < outW)
+              outRow[1] = am[i][1] - am[i][2] - am[i][3] + biasData[oc];
+          }
+        }
+      }
+    }
+  }
+  return output;
+}
+
 /**
  * @brief Realiza el paso hacia atrás de la convolución.
  */
@@ -85,36 +590,64 @@ Tensor Conv2D::backward(const Tensor &outputGradient) {
   const size_t outH = outputGradient.getShape()[2];
   const size_t outW = outputGradient.getShape()[3];
 
+  // Si el forward usó el algoritmo directo o Winograd, la matriz de columnas no existe aún.
+  if (!this->im2colValid) {
+    this->im2col(this->lastInput, outH, outW);
+    this->im2colValid = true;
+  }
+
   // --- 1. Calcular el gradiente del bias (dE/db) ---
   // El gradiente de cada bias es la suma de los gradientes de salida de su mapa de características.
-  this->biasGradients = outputGradient.sum(0).sum(2).sum(3); // Suma sobre B, H, W
-
-  // --- 2. Calcular el gradiente de los pesos (dE/dW) ---
-  // dE/dW = dE/dY * (im2colMatrix)^T
-  Tensor reshapedOutGrad({this->outChannels, batchSize * outH * outW});
-  // TODO: Evitar esta copia si es posible. Un `Tensor::reshape` sin copia sería ideal.
-  std::copy(outputGradient.getData(), outputGradient.getData() + outputGradient.getSize(), reshapedOutGrad.getData());
-
-  Tensor im2colTransposed = this->im2colMatrix.transpose();
-  Tensor flatWeightGradients = matrixMultiply(reshapedOutGrad, im2colTransposed);
-
-  // TODO: Evitar esta copia. `weightGradients` podría construirse como una vista de `flatWeightGradients`.
-  std::copy(flatWeightGradients.getData(), flatWeightGradients.getData() + flatWeightGradients.getSize(),
-            this->weightGradients.getData());
-
-  // --- 3. Calcular el gradiente de la entrada (dE/dX) ---
-  // dE/dX se obtiene mediante la "convolución transpuesta" del gradiente de salida con los pesos.
-  // En el paradigma im2col, esto es: dL/dX_col = W^T * dL/dY
-  Tensor reshapedWeights({this->outChannels, this->inChannels * this->kernelSize * this->kernelSize});
-  std::copy(this->weights.getData(), this->weights.getData() + this->weights.getSize(), reshapedWeights.getData());
+  this->biasGradients.copyFrom(outputGradient.sum(0).sum(2).sum(3).reshape(this->bias.getShape())); // Suma sobre B, H, W
+
+  // Las columnas de im2colMatrix están ordenadas por (b, oh, ow) y dE/dY es {B, outC, outH, outW}:
+  // la muestra b es la matriz {outC, outH*outW} y sus columnas son el bloque b de im2colMatrix.
+  // Se trabaja muestra a muestra con vistas, sin reordenar dE/dY.
+  const size_t positions = outH * outW;
+  const size_t patchSize = this->inChannels * this->kernelSize * this->kernelSize;
+  const Tensor gradient = outputGradient.contiguous();
+  const Tensor transposedWeights = this->weights.reshape({this->outChannels, patchSize}).transpose();
+  Tensor flatWeightGradients;
+  Tensor inputGradient = Tensor::uninitialized(this->inputShape); // col2im escribe cada píxel.
 
-  Tensor transposedWeights = reshapedWeights.transpose();
-  Tensor dL_dX_col = matrixMultiply(transposedWeights, reshapedOutGrad);
+  for (size_t b = 0; b < batchSize; ++b) {
+    const Tensor sampleGradient = gradient.slice(b, 1).reshape({this->outChannels, positions});
+    const Tensor sampleColumns = this->im2colMatrix.slice(1, b * positions, positions);
+
+    // --- 2. Gradiente de los pesos: dE/dW = sum_b dE/dY_b * (columnas_b)^T ---
+    Tensor sampleWeightGradients = matrixMultiply(sampleGradient, sampleColumns.transpose());
+    if (b == 0) {
+      flatWeightGradients = sampleWeightGradients;
+    } else {
+      float *acc = flatWeightGradients.getData();
+      const float *add = sampleWeightGradients.getData();
+#pragma omp parallel for
+      for (size_t i = 0; i < flatWeightGradients.getSize(); ++i) {
+        acc[i] += add[i];
+      }
+    }
 
-  // Ahora, transformamos la matriz de gradientes de columna de vuelta a una "imagen".
-  Tensor inputGradient(this->inputShape);
-  this->col2im(dL_dX_col, inputGradient);
+    // --- 3. Gradiente de la entrada ("convolución transpuesta"): dL/dX_col = W^T * dL/dY ---
+    // col2im devuelve las columnas de la muestra a su "imagen" dentro de inputGradient.
+    Tensor sampleColumnGradients = matrixMultiply(transposedWeights, sampleGradient);
+    Tensor sampleInputGradient = inputGradient.slice(b, 1);
+    this->col2im(sampleColumnGradients, sampleInputGradient);
+  }
 
+  // dE/dW {outC, inC, K, K} es el resultado del GEMM. Con canales repetidos todos los
+  // canales vieron el mismo plano, así que comparten el gradiente {outC, K*K} calculado.
+  if (this->broadcastInput) {
+    const size_t taps = this->kernelSize * this->kernelSize;
+    float *dst = this->weightGradients.getData() + this->weightGradients.getDataOffset();
+    const float *src = flatWeightGradients.getData();
+    for (size_t oc = 0; oc < this->outChannels; ++oc) {
+      for (size_t ic = 0; ic < this->inChannels; ++ic) {
+        std::copy(src + oc * taps, src + (oc + 1) * taps, dst + (oc * this->inChannels + ic) * taps);
+      }
+    }
+  } else {
+    this->weightGradients.copyFrom(flatWeightGradients.reshape(this->weights.getShape()));
+  }
   return inputGradient;
 }
 
@@ -129,9 +662,10 @@ void Conv2D::im2col(const Tensor &input, size_t outH, size_t outW) {
   const size_t batchSize = input.getShape()[0];
   const size_t inH = input.getShape()[2];
   const size_t inW = input.getShape()[3];
-  const size_t colRows = this->inChannels * this->kernelSize * this->kernelSize;
+  const size_t channels = input.getShape()[1];
+  const size_t colRows = channels * this->kernelSize * this->kernelSize;
   const size_t colCols = batchSize * outH * outW;
-  this->im2colMatrix = Tensor({colRows, colCols});
+  this->im2colMatrix = Tensor::uninitialized({colRows, colCols});
 
 #pragma omp parallel for
   for (size_t col_idx = 0; col_idx < colCols; ++col_idx) {
@@ -142,7 +676,7 @@ void Conv2D::im2col(const Tensor &input, size_t outH, size_t outW) {
 
     size_t row_idx = 0;
     // Rellenar la columna iterando sobre el parche correspondiente
-    for (size_t ic = 0; ic < this->inChannels; ++ic) {
+    for (size_t ic = 0; ic < channels; ++ic) {
       for (size_t kh = 0; kh < this->kernelSize; ++kh) {
         for (size_t kw = 0; kw < this->kernelSize; ++kw) {
           int h_in = static_cast<int>(oh * this->stride + kh) - static_cast<int>(this->padding);
@@ -162,8 +696,12 @@ void Conv2D::im2col(const Tensor &input, size_t outH, size_t outW) {
 
 /**
  * @brief Operación inversa a im2col. Transforma una matriz de columnas en una "imagen".
- * @details Acumula los valores de las columnas en las posiciones correctas de un tensor de
- *          salida. Esencial para calcular el gradiente de entrada (dE/dX).
+ * @details Formulación por recolección (gather): cada píxel (b, ic, h, w) de la imagen
+ *          suma las entradas de las columnas cuyos parches lo cubren, es decir, las
+ *          posiciones de salida (oh, ow) con oh*stride + kh - padding = h (igual para w).
+ *          Cada hilo escribe solo sus píxeles, así que no hacen falta operaciones atómicas,
+ *          y el orden de la suma (kh, kw) es fijo: el resultado es idéntico bit a bit con
+ *          cualquier número de hilos. Esencial para calcular el gradiente de entrada (dE/dX).
  */
 void Conv2D::col2im(const Tensor &colMatrix, Tensor &outputImage) {
   const size_t batchSize = outputImage.getShape()[0];
@@ -171,29 +709,33 @@ void Conv2D::col2im(const Tensor &colMatrix, Tensor &outputImage) {
   const size_t imgW = outputImage.getShape()[3]; // Anchura de la imagen de salida (sin padding)
   const size_t outH = (imgH + 2 * padding - kernelSize) / stride + 1;
   const size_t outW = (imgW + 2 * padding - kernelSize) / stride + 1;
-  outputImage.fill(0.0f); // Es crucial empezar con ceros porque vamos a acumular.
-
-#pragma omp parallel for
-  for (size_t col_idx = 0; col_idx < colMatrix.getShape()[1]; ++col_idx) {
-    // Calcular a qué parche (b, oh, ow) corresponde esta columna
-    size_t b = col_idx / (outH * outW);
-    size_t oh = (col_idx / outW) % outH;
-    size_t ow = col_idx % outW;
+  const size_t K = this->kernelSize;
 
-    size_t row_idx = 0;
+#pragma omp parallel for collapse(3)
+  for (size_t b = 0; b < batchSize; ++b) {
     for (size_t ic = 0; ic < this->inChannels; ++ic) {
-      for (size_t kh = 0; kh < this->kernelSize; ++kh) {
-        for (size_t kw = 0; kw < this->kernelSize; ++kw) {
-          int h_img = static_cast<int>(oh * this->stride + kh) - static_cast<int>(this->padding);
-          int w_img = static_cast<int>(ow * this->stride + kw) - static_cast<int>(this->padding);
-
-          if (h_img >= 0 && h_img < static_cast<int>(imgH) && w_img >= 0 && w_img < static_cast<int>(imgW)) {
-            // Un píxel de la imagen de entrada puede ser parte de varios parches,
-            // por lo que sus gradientes deben sumarse.
-#pragma omp atomic
-            outputImage(b, ic, h_img, w_img) += colMatrix(row_idx, col_idx);
+      for (size_t h = 0; h < imgH; ++h) {
+        for (size_t w = 0; w < imgW; ++w) {
+          float sum = 0.0f;
+          for (size_t kh = 0; kh < K; ++kh) {
+            // Fila de salida cuyo parche coloca el tap kh sobre h (si existe).
+            const size_t hPadded = h + this->padding;
+            if (hPadded < kh || (hPadded - kh) % this->stride != 0)
+              continue;
+            const size_t oh = (hPadded - kh) / this->stride;
+            if (oh >= outH)
+              continue;
+            for (size_t kw = 0; kw < K; ++kw) {
+              const size_t wPadded = w + this->padding;
+              if (wPadded < kw || (wPadded - kw) % this->stride != 0)
+                continue;
+              const size_t ow = (wPadded - kw) / this->stride;
+              if (ow >= outW)
+                continue;
+              sum += colMatrix((ic * K + kh) * K + kw, (b * outH + oh) * outW + ow);
+            }
           }
-          row_idx++;
+          outputImage(b, ic, h, w) = sum;
         }
       }
     }
@@ -205,3 +747,25 @@ void Conv2D::col2im(const Tensor &colMatrix, Tensor &outputImage) {
 std::vector<Tensor *> Conv2D::getParameters() { return {&this->weights, &this->bias}; }
 
 std::vector<Tensor *> Conv2D::getGradients() { return {&this->weightGradients, &this->biasGradients}; }
+
+std::unique_ptr<Layer> Conv2D::clone() const {
+  auto copy = std::make_unique<Conv2D>(*this);
+  copy->weightGradients = Tensor(this->weightGradients.getShape());
+  copy->biasGradients = Tensor(this->biasGradients.getShape());
+  return copy;
+}
+
+/**
+ * @brief FLOPs del forward para una entrada {B, inC, H, W}.
+ * @details im2col solo copia datos, así que se cuentan los de la convolución directa.
+ */
+double Conv2D::getFlops(const std::vector<size_t> &inputShape) const {
+  const double outputs = countElements(this->getOutputShape(inputShape));
+  return outputs * (2.0 * inChannels * kernelSize * kernelSize + 1.0);
+}
+
+std::vector<size_t> Conv2D::getOutputShape(const std::vector<size_t> &inputShape) const {
+  const size_t outH = (inputShape[2] + 2 * padding - kernelSize) / stride + 1;
+  const size_t outW = (inputShape[3] + 2 * padding - kernelSize) / stride + 1;
+  return {inputShape[0], outChannels, outH, outW};
+}
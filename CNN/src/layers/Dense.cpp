@@ -36,6 +36,14 @@ Tensor Dense::forward(const Tensor &input, bool isTraining) {
   if (isTraining) {
     this->inputTensor = input; // inputTensor es una copia.
   }
+  this->int8.observe(input);
+
+  // Inferencia cuantizada: el bias se suma dentro del producto int8.
+  if (!isTraining && this->int8.isQuantized()) {
+    Tensor output = Tensor::uninitialized({input.getShape()[0], this->weights.getShape()[1]});
+    this->int8.forward(input, output);
+    return output;
+  }
 
   // 1. Multiplicación de la matriz de entrada por los pesos: Y' = X * W
   Tensor output = matrixMultiply(input, this->weights);
@@ -57,14 +65,14 @@ Tensor Dense::backward(const Tensor &outputGradient) {
   //    Aplicando la regla de la cadena: dE/dW = dE/dY * (dY/dW) = dE/dY * X^T
   //    En notación matricial, esto es: X^T * dE/dY
   Tensor inputTransposed = this->inputTensor.transpose();
-  this->weightGradients = matrixMultiply(inputTransposed, outputGradient);
+  this->weightGradients.copyFrom(matrixMultiply(inputTransposed, outputGradient));
 
   // 2. Gradiente del bias (dE/db):
   //    La derivada de (Y + b) respecto a b es 1.
   //    Aplicando la regla de la cadena: dE/db = dE/dY * (dY/db) = dE/dY
   //    Como el bias se suma a cada muestra del batch, su gradiente es la suma
   //    de los gradientes de salida a lo largo de la dimensión del batch (axis=0).
-  this->biasGradients = outputGradient.sum(0);
+  this->biasGradients.copyFrom(outputGradient.sum(0));
 
   // --- Cálculo del gradiente para la capa anterior ---
 
@@ -88,3 +96,23 @@ std::vector<Tensor *> Dense::getParameters() { return {&this->weights, &this->bi
  * @details El orden DEBE coincidir con getParameters().
  */
 std::vector<Tensor *> Dense::getGradients() { return {&this->weightGradients, &this->biasGradients}; }
+
+/**
+ * @brief Copia para una réplica: los parámetros se comparten, los gradientes no.
+ */
+std::unique_ptr<Layer> Dense::clone() const {
+  auto copy = std::make_unique<Dense>(*this);
+  copy->weightGradients = Tensor(this->weightGradients.getShape());
+  copy->biasGradients = Tensor(this->biasGradients.getShape());
+  return copy;
+}
+
+/**
+ * @brief FLOPs del forward para una entrada {batch, inputSize}.
+ */
+double Dense::getFlops(const std::vector<size_t> &inputShape) const {
+  const double inputSize = static_cast<double>(this->weights.getShape()[0]);
+  const double outputSize = static_cast<double>(this->weights.getShape()[1]);
+  const double rows = countElements(inputShape) / inputSize;
+  return 2.0 * rows * inputSize * outputSize + rows * outputSize;
+}
@@ -73,7 +73,7 @@ Tensor Dropout::forward(const Tensor &input, bool isTraining) {
   // 2. Aplicar la máscara (multiplicación elemento a elemento).
   // Podríamos unificar los bucles de creación y aplicación de la máscara,
   // pero separarlos puede ser más claro.
-  Tensor output(input.getShape());
+  Tensor output = Tensor::uninitialized(input.getShape());
   if (shape.size() == 2) {
 #pragma omp parallel for collapse(2)
     for (size_t i = 0; i < shape[0]; ++i) {
@@ -105,7 +105,7 @@ Tensor Dropout::forward(const Tensor &input, bool isTraining) {
 Tensor Dropout::backward(const Tensor &outputGradient) {
   // La derivada de la operación de dropout es simplemente la propia máscara.
   // Por la regla de la cadena: dE/dX = dE/dY * (dY/dX) = dE/dY * dropoutMask.
-  Tensor inputGradient(outputGradient.getShape());
+  Tensor inputGradient = Tensor::uninitialized(outputGradient.getShape());
   const auto &shape = outputGradient.getShape();
 
   if (shape.size() == 2) {
@@ -132,3 +132,5 @@ Tensor Dropout::backward(const Tensor &outputGradient) {
 
   return inputGradient;
 }
+
+double Dropout::getFlops(const std::vector<size_t> &inputShape) const { return countElements(inputShape); }
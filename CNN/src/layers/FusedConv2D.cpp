@@ -0,0 +1,164 @@
+#include "layers/FusedConv2D.hpp"
+
+#include <limits>
+#include <stdexcept>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/**
+ * @brief Constructor del bloque fusionado.
+ */
+FusedConv2D::FusedConv2D(std::unique_ptr<Conv2D> conv, std::unique_ptr<Pooling2D> pool)
+    : conv(std::move(conv)), pool(std::move(pool)) {
+  if (this->pool && !canFusePool(*this->pool)) {
+    throw std::invalid_argument("FusedConv2D solo admite max pooling con ventanas no solapadas.");
+  }
+}
+
+bool FusedConv2D::canFusePool(const Pooling2D &pool) {
+  return pool.getType() == Pooling2D::PoolType::Max && pool.getStride() == pool.getPoolSize() &&
+         pool.getPoolSize() * pool.getPoolSize() < BLOCKED;
+}
+
+std::string FusedConv2D::getName() const {
+  return this->conv->getName() + "+ReLU" + (this->pool ? "+" + this->pool->getName() : "");
+}
+
+std::unique_ptr<Layer> FusedConv2D::clone() const {
+  std::unique_ptr<Pooling2D> poolCopy = this->pool ? std::make_unique<Pooling2D>(*this->pool) : nullptr;
+  std::unique_ptr<Conv2D> convCopy(static_cast<Conv2D *>(this->conv->clone().release()));
+  return std::make_unique<FusedConv2D>(std::move(convCopy), std::move(poolCopy));
+}
+
+/**
+ * @brief Convolución seguida de ReLU y max pooling en un único recorrido.
+ * @details max(ReLU(z)) = ReLU(max(z)) y, si el máximo es positivo, la posición del máximo
+ *          es la misma con o sin ReLU, así que el resultado y el gradiente coinciden con los
+ *          de las capas separadas.
+ */
+Tensor FusedConv2D::forward(const Tensor &input, bool isTraining) {
+  Tensor convOutput = this->conv->forward(input, isTraining);
+  const auto &shape = convOutput.getShape();
+  const size_t batchSize = shape[0];
+  const size_t channels = shape[1];
+  const size_t inH = shape[2];
+  const size_t inW = shape[3];
+  if (isTraining) {
+    this->convOutputShape = shape;
+  }
+
+  // --- Sin pooling: ReLU en el sitio sobre la salida (recién creada) de la convolución ---
+  if (!this->pool) {
+    const size_t size = convOutput.getSize();
+    float *data = convOutput.getData();
+    if (isTraining) {
+      this->argmax.resize(size);
+    }
+    uint8_t *mask = this->argmax.data();
+#pragma omp parallel for
+    for (size_t i = 0; i < size; ++i) {
+      const bool active = data[i] > 0.0f;
+      data[i] = active ? data[i] : 0.0f;
+      if (isTraining) {
+        mask[i] = active ? 0 : BLOCKED;
+      }
+    }
+    return convOutput;
+  }
+
+  // --- Con pooling: ReLU + max pooling leyendo la salida de la convolución una sola vez ---
+  const size_t poolSize = this->pool->getPoolSize();
+  const size_t outH = (inH - poolSize) / poolSize + 1;
+  const size_t outW = (inW - poolSize) / poolSize + 1;
+  Tensor output = Tensor::uninitialized({batchSize, channels, outH, outW});
+  if (isTraining) {
+    this->argmax.resize(output.getSize());
+  }
+  const float *in = convOutput.getData();
+  float *out = output.getData();
+  uint8_t *positions = this->argmax.data();
+
+#pragma omp parallel for collapse(2)
+  for (size_t b = 0; b < batchSize; ++b) {
+    for (size_t c = 0; c < channels; ++c) {
+      const size_t plane = b * channels + c;
+      const float *inPlane = in + plane * inH * inW;
+      for (size_t oh = 0; oh < outH; ++oh) {
+        for (size_t ow = 0; ow < outW; ++ow) {
+          float best = -std::numeric_limits<float>::infinity();
+          uint8_t bestPosition = 0;
+          for (size_t ph = 0; ph < poolSize; ++ph) {
+            const float *row = inPlane + (oh * poolSize + ph) * inW + ow * poolSize;
+            for (size_t pw = 0; pw < poolSize; ++pw) {
+              if (row[pw] > best) {
+                best = row[pw];
+                bestPosition = static_cast<uint8_t>(ph * poolSize + pw);
+              }
+            }
+          }
+          const size_t o = (plane * outH + oh) * outW + ow;
+          const bool active = best > 0.0f;
+          out[o] = active ? best : 0.0f;
+          if (isTraining) {
+            positions[o] = active ? bestPosition : BLOCKED;
+          }
+        }
+      }
+    }
+  }
+  return output;
+}
+
+/**
+ * @brief Reconstruye dE/dZ (gradiente respecto a la salida de la convolución) a partir de
+ *        las posiciones guardadas y lo pasa al backward de la convolución.
+ */
+Tensor FusedConv2D::backward(const Tensor &outputGradient) {
+  const auto &shape = outputGradient.getShape();
+  const size_t batchSize = shape[0];
+  const size_t channels = shape[1];
+  const size_t outH = shape[2];
+  const size_t outW = shape[3];
+  const uint8_t *positions = this->argmax.data();
+
+  if (!this->pool) {
+    Tensor convGradient = Tensor::uninitialized(this->convOutputShape);
+#pragma omp parallel for collapse(2)
+    for (size_t b = 0; b < batchSize; ++b) {
+      for (size_t c = 0; c < channels; ++c) {
+        for (size_t h = 0; h < outH; ++h) {
+          for (size_t w = 0; w < outW; ++w) {
+            const size_t i = ((b * channels + c) * outH + h) * outW + w;
+            convGradient(b, c, h, w) = positions[i] == BLOCKED ? 0.0f : outputGradient(b, c, h, w);
+          }
+        }
+      }
+    }
+    return this->conv->backward(convGradient);
+  }
+
+  // Ventanas sin solapamiento: cada posición recibe a lo sumo un gradiente.
+  const size_t poolSize = this->pool->getPoolSize();
+  Tensor convGradient(this->convOutputShape); // Se inicializa a ceros
+#pragma omp parallel for collapse(2)
+  for (size_t b = 0; b < batchSize; ++b) {
+    for (size_t c = 0; c < channels; ++c) {
+      for (size_t oh = 0; oh < outH; ++oh) {
+        for (size_t ow = 0; ow < outW; ++ow) {
+          const uint8_t position = positions[((b * channels + c) * outH + oh) * outW + ow];
+          if (position != BLOCKED) {
+            convGradient(b, c, oh * poolSize + position / poolSize, ow * poolSize + position % poolSize) =
+                outputGradient(b, c, oh, ow);
+          }
+        }
+      }
+    }
+  }
+  return this->conv->backward(convGradient);
+}
+
+double FusedConv2D::getFlops(const std::vector<size_t> &inputShape) const {
+  return this->conv->getFlops(inputShape) + countElements(this->conv->getOutputShape(inputShape));
+}
@@ -0,0 +1,55 @@
+#include "layers/FusedDense.hpp"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/**
+ * @brief Constructor del bloque fusionado.
+ */
+FusedDense::FusedDense(std::unique_ptr<Dense> dense) : dense(std::move(dense)) {}
+
+/**
+ * @brief Forward de la Dense y ReLU en el sitio sobre su salida.
+ */
+Tensor FusedDense::forward(const Tensor &input, bool isTraining) {
+  Tensor output = this->dense->forward(input, isTraining);
+  const size_t size = output.getSize();
+  float *data = output.getData();
+  if (isTraining) {
+    this->activeMask.resize(size);
+  }
+  uint8_t *mask = this->activeMask.data();
+
+#pragma omp parallel for
+  for (size_t i = 0; i < size; ++i) {
+    const bool active = data[i] > 0.0f;
+    data[i] = active ? data[i] : 0.0f;
+    if (isTraining) {
+      mask[i] = active;
+    }
+  }
+  return output;
+}
+
+/**
+ * @brief dE/dZ = dE/dY donde la salida era positiva, 0 en el resto.
+ */
+Tensor FusedDense::backward(const Tensor &outputGradient) {
+  const size_t rows = outputGradient.getShape()[0];
+  const size_t cols = outputGradient.getShape()[1];
+  Tensor denseGradient = Tensor::uninitialized({rows, cols});
+  const uint8_t *mask = this->activeMask.data();
+
+#pragma omp parallel for collapse(2)
+  for (size_t i = 0; i < rows; ++i) {
+    for (size_t j = 0; j < cols; ++j) {
+      denseGradient(i, j) = mask[i * cols + j] ? outputGradient(i, j) : 0.0f;
+    }
+  }
+  return this->dense->backward(denseGradient);
+}
+
+double FusedDense::getFlops(const std::vector<size_t> &inputShape) const {
+  return this->dense->getFlops(inputShape) + static_cast<double>(inputShape[0]) * this->dense->getOutputSize();
+}
@@ -45,11 +45,11 @@ Tensor Pooling2D::forward(const Tensor &input, bool isTraining) {
   const size_t outH = (inH - poolSize) / stride + 1;
   const size_t outW = (inW - poolSize) / stride + 1;
 
-  Tensor output({batchSize, channels, outH, outW});
+  Tensor output = Tensor::uninitialized({batchSize, channels, outH, outW});
 
   // Si es Max Pooling y estamos entrenando, inicializamos el tensor para guardar los índices.
   if (this->type == PoolType::Max && isTraining) {
-    this->maxIndices = Tensor({batchSize, channels, outH, outW});
+    this->maxIndices = Tensor::uninitialized({batchSize, channels, outH, outW});
   }
 
 #pragma omp parallel for collapse(2)
@@ -151,3 +151,12 @@ Tensor Pooling2D::backward(const Tensor &outputGradient) {
   }
   return inputGradient;
 }
+
+/**
+ * @brief FLOPs del forward: poolSize^2 comparaciones (o sumas) por elemento de salida.
+ */
+double Pooling2D::getFlops(const std::vector<size_t> &inputShape) const {
+  const size_t outH = (inputShape[2] - poolSize) / stride + 1;
+  const size_t outW = (inputShape[3] - poolSize) / stride + 1;
+  return static_cast<double>(inputShape[0]) * inputShape[1] * outH * outW * poolSize * poolSize;
+}
@@ -18,7 +18,7 @@
  * @return Un tensor de probabilidades con la misma forma.
  */
 Tensor softmax(const Tensor &logits) {
-  Tensor probabilities(logits.getShape());
+  Tensor probabilities = Tensor::uninitialized(logits.getShape());
   const size_t batchSize = logits.getShape()[0];
   const size_t numClasses = logits.getShape()[1];
 
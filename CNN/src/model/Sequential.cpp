@@ -1,15 +1,32 @@
 #include "model/Sequential.hpp"
+#include "activations/ReLU.hpp"
+#include "core/Allocator.hpp"
+#include "layers/FusedConv2D.hpp"
+#include "layers/FusedDense.hpp"
 #include "losses/CrossEntropy.hpp"
+#include "utils/DataLoader.hpp"
+#include "utils/Profiler.hpp"
 
 #include <algorithm>
 #include <chrono>
+#include <exception>
 #include <iomanip>
 #include <iostream>
+#include <numeric>
 #include <stdexcept>
+#include <string>
 #include <vector>
 
 // --- Implementación de los Métodos ---
 
+/**
+ * @brief Nombre de la capa `index` en el perfil (ej. "0:Conv2D").
+ * @details Solo se usa con el perfilado compilado; sin él las macros descartan la etiqueta.
+ */
+[[maybe_unused]] static std::string layerLabel(size_t index, const Layer &layer) {
+  return std::to_string(index) + ":" + layer.getName();
+}
+
 /**
  * @brief Constructor por defecto del modelo secuencial.
  */
@@ -23,8 +40,8 @@ Sequential::Sequential() {}
 Tensor Sequential::predict(const Tensor &input) {
   Tensor currentOutput = input;
   // Propaga la salida de una capa como la entrada de la siguiente.
-  for (const auto &layer : this->layers) {
-    currentOutput = layer->forward(currentOutput, false); // isTraining = false
+  for (size_t l = 0; l < this->layers.size(); ++l) {
+    currentOutput = PROFILE_FORWARD(layerLabel(l, *this->layers[l]), *this->layers[l], currentOutput, false);
   }
   return currentOutput;
 }
@@ -38,17 +55,43 @@ size_t argmax(const float *data, size_t size) {
   return std::distance(data, std::max_element(data, data + size));
 }
 
+/**
+ * @brief Cuenta las muestras del batch cuya clase predicha coincide con la etiqueta.
+ * @details La clase predicha es el argmax de los logits (el mismo que el de softmax).
+ *          Las etiquetas pueden ser una vista (se leen a partir de `getDataOffset`).
+ */
+static size_t countCorrect(const Tensor &logits, const Tensor &labels) {
+  const size_t batchSize = logits.getShape()[0];
+  const size_t numClasses = logits.getShape()[1];
+  const Tensor predictions = logits.contiguous();
+  const float *predPtr = predictions.getData() + predictions.getDataOffset();
+  const float *labelsPtr = labels.getData() + labels.getDataOffset();
+  size_t correct = 0;
+  for (size_t i = 0; i < batchSize; ++i) {
+    if (argmax(predPtr + i * numClasses, numClasses) == argmax(labelsPtr + i * numClasses, numClasses)) {
+      correct++;
+    }
+  }
+  return correct;
+}
+
 /**
  * @brief Evalúa la pérdida y la precisión del modelo en un conjunto de datos.
- * @details Procesa los datos en batches para no agotar la memoria.
  */
 std::pair<float, float> Sequential::evaluate(const Tensor &X, const Tensor &y) {
+  return this->evaluate(TensorDataset(X, y));
+}
+
+/**
+ * @brief Evalúa la pérdida y la precisión del modelo sobre un Dataset.
+ * @details Procesa los datos en batches para no agotar la memoria.
+ */
+std::pair<float, float> Sequential::evaluate(const Dataset &data) {
   if (!loss) {
     throw std::runtime_error("El modelo debe ser compilado para poder evaluar.");
   }
 
-  const size_t numSamples = X.getShape()[0];
-  const size_t numClasses = y.getShape()[1];
+  const size_t numSamples = data.size();
   float totalLoss = 0.0f;
   size_t correctPredictions = 0;
 
@@ -56,11 +99,15 @@ std::pair<float, float> Sequential::evaluate(const Tensor &X, const Tensor &y) {
   const size_t evalBatchSize = 256;
   size_t numBatches = 0;
 
-  for (size_t i = 0; i < numSamples; i += evalBatchSize) {
-    size_t end = std::min(i + evalBatchSize, numSamples);
+  // Orden secuencial: con un TensorDataset cada batch es una vista, sin copia.
+  std::vector<size_t> indices(numSamples);
+  std::iota(indices.begin(), indices.end(), 0);
+  DataLoader loader(data, std::move(indices), evalBatchSize, this->prefetchBatches);
+  std::pair<Tensor, Tensor> batch;
 
-    Tensor X_batch = X.slice(i, end - i);
-    Tensor y_batch = y.slice(i, end - i);
+  while (loader.next(batch)) {
+    PROFILE_SCOPE("eval_step", "step");
+    const auto &[X_batch, y_batch] = batch;
 
     // 1. Obtener predicciones (logits) del modelo.
     Tensor yPred = this->predict(X_batch);
@@ -69,19 +116,7 @@ std::pair<float, float> Sequential::evaluate(const Tensor &X, const Tensor &y) {
     totalLoss += this->loss->calculate(yPred, y_batch);
 
     // 3. Calcular la precisión del batch.
-    Tensor probabilities = softmax(yPred);
-    for (size_t sample_idx = 0; sample_idx < X_batch.getShape()[0]; ++sample_idx) {
-      // Punteros directos para evitar recálculos de acceso en `operator()`
-      const float *predProbsPtr = probabilities.getData() + sample_idx * numClasses;
-      const float *trueLabelsPtr = y.getData() + (i + sample_idx) * numClasses;
-
-      size_t predictedClass = argmax(predProbsPtr, numClasses);
-      size_t trueClass = argmax(trueLabelsPtr, numClasses);
-
-      if (predictedClass == trueClass) {
-        correctPredictions++;
-      }
-    }
+    correctPredictions += countCorrect(yPred, y_batch);
     numBatches++;
   }
 
@@ -92,17 +127,41 @@ std::pair<float, float> Sequential::evaluate(const Tensor &X, const Tensor &y) {
   return {avgLoss, accuracy};
 }
 
+/**
+ * @brief Gradientes de una pila de capas, en el mismo orden que `getParameters`.
+ */
+static std::vector<Tensor *> collectGradients(const std::vector<std::unique_ptr<Layer>> &layers) {
+  std::vector<Tensor *> gradients;
+  for (const auto &layer : layers) {
+    auto layerGradients = layer->getGradients();
+    gradients.insert(gradients.end(), layerGradients.begin(), layerGradients.end());
+  }
+  return gradients;
+}
+
 /**
  * @brief El bucle de entrenamiento principal del modelo.
  */
 void Sequential::train(const Tensor &X_train, const Tensor &y_train, int epochs, size_t batchSize, const Tensor &X_val,
                        const Tensor &y_val) {
+  this->train(TensorDataset(X_train, y_train), epochs, batchSize, TensorDataset(X_val, y_val));
+}
+
+/**
+ * @brief El bucle de entrenamiento sobre Datasets (en orden, sin barajar).
+ */
+void Sequential::train(const Dataset &trainData, int epochs, size_t batchSize, const Dataset &valData) {
   if (!optimizer || !loss) {
     throw std::runtime_error("El modelo debe ser compilado antes de entrenar.");
   }
 
-  const size_t numTrainSamples = X_train.getShape()[0];
-  const size_t numClasses = y_train.getShape()[1]; // Asume clasificación
+  const size_t numTrainSamples = trainData.size();
+  std::vector<size_t> indices(numTrainSamples);
+  std::iota(indices.begin(), indices.end(), 0);
+  // Parámetros y gradientes pasan a los buffers planos del registro antes de que las réplicas
+  // copien las capas, para que compartan los parámetros ya reubicados.
+  this->parameters = ParameterRegistry(this->getParameters(), collectGradients(this->layers));
+  this->buildReplicas();
 
   for (int epoch = 0; epoch < epochs; ++epoch) {
     auto epochStart = std::chrono::high_resolution_clock::now();
@@ -111,59 +170,65 @@ void Sequential::train(const Tensor &X_train, const Tensor &y_train, int epochs,
     size_t numBatches = 0;
 
     // --- Bucle principal sobre los mini-batches ---
-    for (size_t i = 0; i < numTrainSamples; i += batchSize) {
-      size_t end = std::min(i + batchSize, numTrainSamples);
-      Tensor X_batch = X_train.slice(i, end - i);
-      Tensor y_batch = y_train.slice(i, end - i);
-
-      // --- 1. Forward Pass ---
-      // Propaga la entrada a través de la red, capa por capa, con `isTraining=true`.
-      // Esto asegura que las capas (como Dropout, ReLU) almacenen lo necesario.
-      Tensor yPred = X_batch;
-      for (const auto &layer : this->layers) {
-        yPred = layer->forward(yPred, true);
+    // El DataLoader prepara los siguientes batches en su hilo mientras se entrena el actual.
+    DataLoader loader(trainData, indices, batchSize, this->prefetchBatches);
+    std::pair<Tensor, Tensor> batch;
+    for (size_t b = 0; b < loader.numBatches(); ++b) {
+      PROFILE_SCOPE("train_step", "step");
+      {
+        PROFILE_SCOPE("batch_wait", "step");
+        loader.next(batch);
       }
+      const auto &[X_batch, y_batch] = batch;
 
-      // --- 2. Cálculo de Pérdida y Métricas ---
-      // Se usan los logits (yPred) para calcular la pérdida y la precisión.
-      epochTrainLoss += this->loss->calculate(yPred, y_batch);
-      Tensor probabilities = softmax(yPred);
-      for (size_t sample_idx = 0; sample_idx < X_batch.getShape()[0]; ++sample_idx) {
-        const float *predProbsPtr = probabilities.getData() + sample_idx * numClasses;
-        const float *trueLabelsPtr = y_train.getData() + (i + sample_idx) * numClasses;
-        if (argmax(predProbsPtr, numClasses) == argmax(trueLabelsPtr, numClasses)) {
-          epochTrainCorrect++;
+      if (!this->replicas.empty()) {
+        // --- 1-3. Forward, pérdida y backward de cada parte del batch en su réplica ---
+        const auto [batchLoss, batchCorrect] = this->dataParallelStep(X_batch, y_batch);
+        epochTrainLoss += batchLoss;
+        epochTrainCorrect += batchCorrect;
+      } else {
+        // --- 1. Forward Pass ---
+        // Propaga la entrada a través de la red, capa por capa, con `isTraining=true`.
+        // Esto asegura que las capas (como Dropout, ReLU) almacenen lo necesario.
+        Tensor yPred = X_batch;
+        for (size_t l = 0; l < this->layers.size(); ++l) {
+          yPred = PROFILE_FORWARD(layerLabel(l, *this->layers[l]), *this->layers[l], yPred, true);
         }
-      }
 
-      // --- 3. Backward Pass (Retropropagación) ---
-      // Inicia la retropropagación desde la función de pérdida.
-      Tensor gradient = this->loss->backward(yPred, y_batch);
-      // Propaga el gradiente hacia atrás a través de la red, en orden inverso.
-      for (auto it = this->layers.rbegin(); it != this->layers.rend(); ++it) {
-        gradient = (*it)->backward(gradient);
+        // --- 2. Cálculo de Pérdida y Métricas ---
+        // Se usan los logits (yPred) para calcular la pérdida y la precisión.
+        {
+          PROFILE_SCOPE("loss", "forward");
+          epochTrainLoss += this->loss->calculate(yPred, y_batch);
+          epochTrainCorrect += countCorrect(yPred, y_batch);
+        }
+
+        // --- 3. Backward Pass (Retropropagación) ---
+        // Inicia la retropropagación desde la función de pérdida.
+        Tensor gradient = this->loss->backward(yPred, y_batch);
+        // Propaga el gradiente hacia atrás a través de la red, en orden inverso.
+        for (size_t l = this->layers.size(); l-- > 0;) {
+          gradient = PROFILE_BACKWARD(layerLabel(l, *this->layers[l]), *this->layers[l], gradient);
+        }
       }
 
       // --- 4. Actualización de Pesos ---
-      // Recopila todos los parámetros y gradientes de todas las capas.
-      std::vector<Tensor *> allParams;
-      std::vector<Tensor *> allGrads;
-      for (const auto &layer : this->layers) {
-        auto params = layer->getParameters();
-        auto grads = layer->getGradients();
-        allParams.insert(allParams.end(), params.begin(), params.end());
-        allGrads.insert(allGrads.end(), grads.begin(), grads.end());
-      }
-      // Pasa los parámetros y gradientes al optimizador para que los actualice.
-      if (!allParams.empty()) {
-        this->optimizer->update(allParams, allGrads);
+      // Un único recorrido del optimizador sobre los buffers planos de todas las capas.
+      if (this->parameters.size() > 0) {
+        PROFILE_SCOPE("optimizer", "step");
+        this->optimizer->update(this->parameters);
+        this->parametersUpdated();
       }
 
+      // --- 5. Fin del paso ---
+      // El pool libera los bloques cacheados que este mini-batch no reutilizó.
+      getAllocator()->resetStep();
+
       numBatches++;
     }
 
     // --- Fin de la Época: Evaluación y Reporte ---
-    auto [valLoss, valAcc] = this->evaluate(X_val, y_val);
+    auto [valLoss, valAcc] = this->evaluate(valData);
     auto epochEnd = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> epochDuration = epochEnd - epochStart;
 
@@ -179,6 +244,229 @@ void Sequential::train(const Tensor &X_train, const Tensor &y_train, int epochs,
   }
 }
 
+// --- Paralelismo de datos ---
+
+/**
+ * @brief Puntero al primer elemento de un gradiente; la reducción exige tensores contiguos.
+ */
+static float *contiguousData(Tensor &tensor) {
+  if (!tensor.isContiguous()) {
+    throw std::runtime_error("Paralelismo de datos: los gradientes deben ser tensores contiguos.");
+  }
+  return tensor.getData() + tensor.getDataOffset();
+}
+
+/**
+ * @brief Suma los gradientes de todas las réplicas en `gradients[0]` con un árbol de orden fijo.
+ * @details En el nivel s, la réplica r (múltiplo de 2s) acumula la r + s. Cada trozo de
+ *          cada tensor lo suma un único hilo y siempre en el mismo orden, así que el
+ *          resultado es idéntico bit a bit con cualquier número de hilos.
+ */
+static void treeReduce(const std::vector<std::vector<Tensor *>> &gradients) {
+  constexpr size_t CHUNK = 16384;
+  struct Job {
+    float *dst;
+    const float *src;
+    size_t size;
+  };
+  for (size_t stride = 1; stride < gradients.size(); stride *= 2) {
+    std::vector<Job> jobs;
+    for (size_t r = 0; r + stride < gradients.size(); r += 2 * stride) {
+      for (size_t t = 0; t < gradients[r].size(); ++t) {
+        Tensor &dst = *gradients[r][t];
+        Tensor &src = *gradients[r + stride][t];
+        if (dst.getShape() != src.getShape()) {
+          throw std::runtime_error("Paralelismo de datos: las réplicas no tienen los mismos gradientes.");
+        }
+        float *dstData = contiguousData(dst);
+        const float *srcData = contiguousData(src);
+        for (size_t begin = 0; begin < dst.getSize(); begin += CHUNK) {
+          jobs.push_back({dstData + begin, srcData + begin, std::min(CHUNK, dst.getSize() - begin)});
+        }
+      }
+    }
+#pragma omp parallel for schedule(dynamic)
+    for (size_t j = 0; j < jobs.size(); ++j) {
+      for (size_t i = 0; i < jobs[j].size; ++i) {
+        jobs[j].dst[i] += jobs[j].src[i];
+      }
+    }
+  }
+}
+
+/**
+ * @brief Crea (o descarta) las réplicas según `dataParallelReplicas`.
+ * @details Se llama al empezar `train`, después de la fusión de `compile` y de `loadModel`,
+ *          para que las réplicas copien las capas definitivas.
+ */
+void Sequential::buildReplicas() {
+  this->replicas.clear();
+  for (size_t r = 1; r < this->dataParallelReplicas; ++r) {
+    Replica replica;
+    for (const auto &layer : this->layers) {
+      std::unique_ptr<Layer> copy = layer->clone();
+      if (!copy) {
+        throw std::runtime_error("La capa " + layer->getName() + " no admite paralelismo de datos.");
+      }
+      replica.layers.push_back(std::move(copy));
+    }
+    replica.loss = this->loss->clone();
+    if (!replica.loss) {
+      throw std::runtime_error("La función de pérdida no admite paralelismo de datos.");
+    }
+    this->replicas.push_back(std::move(replica));
+  }
+}
+
+/**
+ * @brief Un paso de paralelismo de datos.
+ * @details La réplica r procesa las filas [B*r/R, B*(r+1)/R) del mini-batch. El gradiente
+ *          de la pérdida media del batch es la suma de los de cada parte ponderados por su
+ *          fracción de filas, así que cada réplica escala el gradiente de sus logits antes
+ *          del backward y el árbol solo tiene que sumar.
+ */
+std::pair<float, size_t> Sequential::dataParallelStep(const Tensor &X_batch, const Tensor &y_batch) {
+  const size_t rows = X_batch.getShape()[0];
+  const size_t active = std::min(this->replicas.size() + 1, rows);
+  std::vector<float> losses(active, 0.0f);
+  std::vector<size_t> correct(active, 0);
+  std::exception_ptr error;
+
+  {
+    PROFILE_SCOPE("replicas", "step");
+    // Un hilo por réplica; dentro de la región, las operaciones de cada réplica van en serie.
+#pragma omp parallel for num_threads(active) schedule(static, 1)
+    for (size_t r = 0; r < active; ++r) {
+      try {
+        auto &layers = r == 0 ? this->layers : this->replicas[r - 1].layers;
+        Loss &loss = r == 0 ? *this->loss : *this->replicas[r - 1].loss;
+        const size_t begin = rows * r / active;
+        const size_t count = rows * (r + 1) / active - begin;
+        const float weight = static_cast<float>(count) / static_cast<float>(rows);
+        const Tensor X_part = X_batch.slice(begin, count);
+        const Tensor y_part = y_batch.slice(begin, count);
+
+        Tensor yPred = X_part;
+        for (const auto &layer : layers) {
+          yPred = layer->forward(yPred, true);
+        }
+        losses[r] = weight * loss.calculate(yPred, y_part);
+        correct[r] = countCorrect(yPred, y_part);
+
+        Tensor gradient = loss.backward(yPred, y_part);
+        float *gradientData = contiguousData(gradient);
+        for (size_t i = 0; i < gradient.getSize(); ++i) {
+          gradientData[i] *= weight;
+        }
+        for (size_t l = layers.size(); l-- > 0;) {
+          gradient = layers[l]->backward(gradient);
+        }
+      } catch (...) {
+#pragma omp critical(data_parallel_error)
+        if (!error) {
+          error = std::current_exception();
+        }
+      }
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+
+  {
+    PROFILE_SCOPE("gradient_reduce", "step");
+    std::vector<std::vector<Tensor *>> gradients;
+    gradients.push_back(collectGradients(this->layers));
+    for (size_t r = 1; r < active; ++r) {
+      gradients.push_back(collectGradients(this->replicas[r - 1].layers));
+    }
+    treeReduce(gradients);
+  }
+
+  // Pérdida y aciertos del mini-batch completo, sumados en orden fijo.
+  return {std::accumulate(losses.begin(), losses.end(), 0.0f), std::accumulate(correct.begin(), correct.end(), size_t{0})};
+}
+
+/**
+ * @brief Calibra el rango de las entradas y cuantiza las capas a int8.
+ */
+void Sequential::quantizeInt8(const Dataset &calibration, size_t numSamples, size_t batchSize) {
+  const size_t count = std::min(numSamples, calibration.size());
+  if (count == 0 || batchSize == 0) {
+    throw std::invalid_argument("quantizeInt8 necesita al menos una muestra de calibracion.");
+  }
+
+  this->setInt8Mode(Int8Mode::Calibrate);
+  std::vector<size_t> indices(count);
+  std::iota(indices.begin(), indices.end(), 0);
+  for (size_t start = 0; start < count; start += batchSize) {
+    const size_t size = std::min(batchSize, count - start);
+    const Tensor X_batch = calibration.getBatch(indices.data() + start, size).first;
+    this->predict(X_batch);
+  }
+  this->setInt8Mode(Int8Mode::Quantized);
+  std::cout << "Modelo cuantizado a int8 (calibrado con " << count << " muestras)." << std::endl;
+}
+
+void Sequential::setInt8Mode(Int8Mode mode) {
+  for (const auto &layer : this->layers) {
+    layer->setInt8Mode(mode);
+  }
+}
+
+void Sequential::parametersUpdated() {
+  for (const auto &layer : this->layers) {
+    layer->parametersUpdated();
+  }
+  for (const auto &replica : this->replicas) {
+    for (const auto &layer : replica.layers) {
+      layer->parametersUpdated();
+    }
+  }
+}
+
+void Sequential::autotune(const Tensor &sample) {
+  Tensor x = sample;
+  for (const auto &layer : this->layers) {
+    layer->autotune(x);
+    x = layer->forward(x, false);
+  }
+}
+
+/**
+ * @brief Sustituye las secuencias fusionables por sus capas combinadas.
+ * @details Las capas originales pasan a ser propiedad del bloque fusionado, así que los
+ *          tensores de parámetros (y sus punteros) no cambian.
+ */
+void Sequential::fuseLayers() {
+  std::vector<std::unique_ptr<Layer>> fused;
+  const size_t count = this->layers.size();
+  size_t i = 0;
+  while (i < count) {
+    Layer *layer = this->layers[i].get();
+    const bool nextIsReLU = i + 1 < count && dynamic_cast<ReLU *>(this->layers[i + 1].get()) != nullptr;
+
+    if (nextIsReLU && dynamic_cast<Conv2D *>(layer)) {
+      std::unique_ptr<Conv2D> conv(static_cast<Conv2D *>(this->layers[i].release()));
+      std::unique_ptr<Pooling2D> pool;
+      auto *next = i + 2 < count ? dynamic_cast<Pooling2D *>(this->layers[i + 2].get()) : nullptr;
+      if (next && FusedConv2D::canFusePool(*next)) {
+        pool.reset(static_cast<Pooling2D *>(this->layers[i + 2].release()));
+      }
+      i += pool ? 3 : 2;
+      fused.push_back(std::make_unique<FusedConv2D>(std::move(conv), std::move(pool)));
+    } else if (nextIsReLU && dynamic_cast<Dense *>(layer)) {
+      std::unique_ptr<Dense> dense(static_cast<Dense *>(this->layers[i].release()));
+      i += 2;
+      fused.push_back(std::make_unique<FusedDense>(std::move(dense)));
+    } else {
+      fused.push_back(std::move(this->layers[i]));
+      i += 1;
+    }
+  }
+  this->layers = std::move(fused);
+}
+
 /**
  * @brief Recopila los punteros a todos los parámetros entrenables del modelo.
  */
@@ -90,3 +90,37 @@ void Adam::update(std::vector<Tensor *> &parameters, const std::vector<Tensor *>
     }
   }
 }
+
+/**
+ * @brief Aplica la regla de Adam a todo el buffer del registro en un solo bucle.
+ */
+void Adam::update(ParameterRegistry &registry) {
+  const size_t size = registry.size();
+  if (this->flatM.getSize() != size) {
+    this->flatM = Tensor({size});
+    this->flatV = Tensor({size});
+  }
+
+  t++;
+  const float beta1_t = std::pow(beta1, t);
+  const float beta2_t = std::pow(beta2, t);
+  const float b1 = beta1, b2 = beta2, eps = epsilon, lr = learningRate;
+  const float correction1 = 1.0f - beta1_t;
+  const float correction2 = 1.0f - beta2_t;
+
+  float *params = registry.parameterData();
+  const float *grads = registry.gradientData();
+  float *m_data = this->flatM.getData();
+  float *v_data = this->flatV.getData();
+
+  // El relleno del registro tiene parámetro, gradiente y momentos a cero y sigue a cero.
+#pragma omp parallel for simd schedule(static)
+  for (size_t i = 0; i < size; ++i) {
+    const float g = grads[i];
+    m_data[i] = b1 * m_data[i] + (1.0f - b1) * g;
+    v_data[i] = b2 * v_data[i] + (1.0f - b2) * (g * g);
+    const float m_hat = m_data[i] / correction1;
+    const float v_hat = v_data[i] / correction2;
+    params[i] -= lr * m_hat / (std::sqrt(v_hat) + eps);
+  }
+}
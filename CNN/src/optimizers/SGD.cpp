@@ -66,3 +66,17 @@ void SGD::update(std::vector<Tensor *> &parameters, const std::vector<Tensor *>
     }
   }
 }
+
+/**
+ * @brief Aplica `param -= lr * grad` a todo el buffer del registro en un solo bucle.
+ */
+void SGD::update(ParameterRegistry &registry) {
+  float *params = registry.parameterData();
+  const float *grads = registry.gradientData();
+  const size_t size = registry.size();
+  const float lr = this->learningRate;
+#pragma omp parallel for simd schedule(static)
+  for (size_t i = 0; i < size; ++i) {
+    params[i] -= lr * grads[i];
+  }
+}
@@ -0,0 +1,224 @@
+#include "utils/CsvParser.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <ctime>
+#include <random>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace {
+/** @brief Archivo proyectado en memoria, de solo lectura (se libera al destruirse). */
+class MappedFile {
+public:
+  explicit MappedFile(const std::string &path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw std::runtime_error("Error: No se pudo abrir el archivo: " + path);
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+      ::close(fd);
+      throw std::runtime_error("Error: No se pudo leer el tamaño de: " + path);
+    }
+    size = static_cast<size_t>(info.st_size);
+    if (size > 0) {
+      void *mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (mapping == MAP_FAILED) {
+        ::close(fd);
+        throw std::runtime_error("Error: No se pudo proyectar en memoria: " + path);
+      }
+      ::madvise(mapping, size, MADV_SEQUENTIAL);
+      data = static_cast<const char *>(mapping);
+    }
+    ::close(fd);
+  }
+  ~MappedFile() {
+    if (data) {
+      ::munmap(const_cast<char *>(data), size);
+    }
+  }
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  const char *data = nullptr;
+  size_t size = 0;
+};
+
+/** @brief Rango de líneas completas que procesa un hilo. */
+struct Chunk {
+  const char *begin;
+  const char *end;
+  size_t firstRow = 0;  ///< Índice global de su primera fila.
+  size_t rowCount = 0;
+  size_t firstSlot = 0; ///< Posición en la salida de su primera fila seleccionada.
+  size_t keptCount = 0;
+};
+
+/** @brief Llama a `visit(inicio, fin)` por cada línea de [p, end), sin el '\n'. */
+template <typename Visitor> void forEachLine(const char *p, const char *end, Visitor visit) {
+  while (p < end) {
+    const char *newline = static_cast<const char *>(std::memchr(p, '\n', end - p));
+    const char *lineEnd = newline ? newline : end;
+    visit(p, lineEnd);
+    p = lineEnd + 1;
+  }
+}
+
+/**
+ * @brief Parsea "etiqueta,p0,...,pN-1" escribiendo los píxeles en `out`.
+ * @return `false` si la fila no tiene exactamente N píxeles enteros en [0, 255] o la
+ *         etiqueta no es válida.
+ */
+bool parseRow(const char *p, const char *end, size_t numPixels, int numClasses, int32_t &label, uint8_t *out) {
+  if (end > p && end[-1] == '\r') {
+    --end;
+  }
+  int value = 0;
+  auto [ptr, ec] = std::from_chars(p, end, value);
+  if (ec != std::errc() || value < 0 || value >= numClasses) {
+    return false;
+  }
+  label = value;
+  p = ptr;
+  for (size_t i = 0; i < numPixels; ++i) {
+    if (p == end || *p != ',') {
+      return false;
+    }
+    auto [next, err] = std::from_chars(p + 1, end, value);
+    if (err != std::errc() || value < 0 || value > 255) {
+      return false;
+    }
+    out[i] = static_cast<uint8_t>(value);
+    p = next;
+  }
+  return p == end;
+}
+
+/**
+ * @brief Marca las filas que se guardan.
+ * @details Con `randomSample` usa el algoritmo de Floyd, que elige un subconjunto uniforme
+ *          de k filas en O(k) pasos sin barajar un vector de índices.
+ */
+std::vector<uint8_t> selectRows(size_t totalRows, float sampleFraction, bool randomSample) {
+  size_t samplesToLoad = static_cast<size_t>(totalRows * static_cast<double>(sampleFraction));
+  if (samplesToLoad == 0 && totalRows > 0 && sampleFraction > 0.0f) {
+    samplesToLoad = 1;
+  }
+  samplesToLoad = std::min(samplesToLoad, totalRows);
+
+  std::vector<uint8_t> keep(totalRows, 0);
+  if (samplesToLoad == totalRows || !randomSample) {
+    std::fill(keep.begin(), keep.begin() + samplesToLoad, 1);
+    return keep;
+  }
+  std::mt19937_64 rng(static_cast<unsigned long long>(std::time(nullptr)));
+  for (size_t j = totalRows - samplesToLoad; j < totalRows; ++j) {
+    const size_t t = std::uniform_int_distribution<size_t>(0, j)(rng);
+    keep[keep[t] ? j : t] = 1;
+  }
+  return keep;
+}
+} // namespace
+
+// --- Implementación ---
+
+MnistCsv parseMnistCsv(const std::string &filePath, float sampleFraction, bool randomSample, size_t pixelsPerSample,
+                       int numClasses) {
+  MappedFile file(filePath);
+  MnistCsv result;
+  result.pixelsPerSample = pixelsPerSample;
+
+  // 1. Saltar la cabecera y dividir el resto en bloques que terminan en fin de línea
+  const char *fileEnd = file.data + file.size;
+  const char *headerEnd = file.data ? static_cast<const char *>(std::memchr(file.data, '\n', file.size)) : nullptr;
+  const char *body = headerEnd ? headerEnd + 1 : fileEnd;
+  const size_t bodySize = static_cast<size_t>(fileEnd - body);
+
+  size_t numThreads = 1;
+#ifdef _OPENMP
+  numThreads = static_cast<size_t>(omp_get_max_threads());
+#endif
+  // Varios bloques por hilo para repartir mejor la carga, de al menos 64 KB cada uno
+  const size_t numChunks = std::max<size_t>(1, std::min(numThreads * 4, bodySize / (64 * 1024)));
+  std::vector<Chunk> chunks(numChunks);
+  const char *chunkBegin = body;
+  for (size_t c = 0; c < numChunks; ++c) {
+    const char *chunkEnd = fileEnd;
+    if (c + 1 < numChunks) {
+      chunkEnd = std::max(chunkBegin, body + bodySize * (c + 1) / numChunks);
+      const char *newline = static_cast<const char *>(std::memchr(chunkEnd, '\n', fileEnd - chunkEnd));
+      chunkEnd = newline ? newline + 1 : fileEnd;
+    }
+    chunks[c].begin = chunkBegin;
+    chunks[c].end = chunkEnd;
+    chunkBegin = chunkEnd;
+  }
+
+  // 2. Contar las filas de cada bloque (solo se buscan los '\n')
+#pragma omp parallel for schedule(dynamic)
+  for (size_t c = 0; c < numChunks; ++c) {
+    size_t rows = 0;
+    forEachLine(chunks[c].begin, chunks[c].end, [&](const char *, const char *) { ++rows; });
+    chunks[c].rowCount = rows;
+  }
+  size_t totalRows = 0;
+  for (auto &chunk : chunks) {
+    chunk.firstRow = totalRows;
+    totalRows += chunk.rowCount;
+  }
+
+  // 3. Elegir las filas a guardar y reservar los buffers de salida una sola vez
+  const std::vector<uint8_t> keep = selectRows(totalRows, sampleFraction, randomSample);
+  size_t totalKept = 0;
+  for (auto &chunk : chunks) {
+    chunk.keptCount = std::count(keep.begin() + chunk.firstRow, keep.begin() + chunk.firstRow + chunk.rowCount, 1);
+    chunk.firstSlot = totalKept;
+    totalKept += chunk.keptCount;
+  }
+  result.labels.resize(totalKept);
+  result.pixels.resize(totalKept * pixelsPerSample);
+  std::vector<uint8_t> valid(totalKept, 0);
+
+  // 4. Parsear solo las filas elegidas, cada una directamente en su posición final
+#pragma omp parallel for schedule(dynamic)
+  for (size_t c = 0; c < numChunks; ++c) {
+    size_t row = chunks[c].firstRow;
+    size_t slot = chunks[c].firstSlot;
+    forEachLine(chunks[c].begin, chunks[c].end, [&](const char *line, const char *lineEnd) {
+      if (keep[row++]) {
+        valid[slot] = parseRow(line, lineEnd, pixelsPerSample, numClasses, result.labels[slot],
+                               result.pixels.data() + slot * pixelsPerSample);
+        ++slot;
+      }
+    });
+  }
+
+  // 5. Compactar si alguna fila resultó inválida
+  size_t numValid = 0;
+  for (size_t i = 0; i < totalKept; ++i) {
+    if (!valid[i]) {
+      continue;
+    }
+    if (numValid != i) {
+      result.labels[numValid] = result.labels[i];
+      std::memcpy(result.pixels.data() + numValid * pixelsPerSample, result.pixels.data() + i * pixelsPerSample,
+                  pixelsPerSample);
+    }
+    ++numValid;
+  }
+  result.labels.resize(numValid);
+  result.pixels.resize(numValid * pixelsPerSample);
+  result.numSamples = numValid;
+  result.skippedRows = totalKept - numValid;
+  return result;
+}
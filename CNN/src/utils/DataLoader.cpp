@@ -0,0 +1,93 @@
+#include "utils/DataLoader.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace {
+/**
+ * @brief Espera activa breve y después a intervalos de 50 µs.
+ * @details Con la cola llena, el hilo de fondo espera lo que dura un paso de entrenamiento:
+ *          no debe quitarles CPU a los hilos de cálculo.
+ */
+void backoff(size_t &attempt) {
+  if (++attempt < 64) {
+    std::this_thread::yield();
+  } else {
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+  }
+}
+} // namespace
+
+DataLoader::DataLoader(const Dataset &dataset, std::vector<size_t> order, size_t batchSize, size_t prefetch)
+    : dataset(dataset), order(std::move(order)), batchSize(std::max<size_t>(1, batchSize)),
+      totalBatches((this->order.size() + this->batchSize - 1) / this->batchSize), ring(prefetch) {
+  if (prefetch > 0 && this->totalBatches > 0) {
+    this->worker = std::thread(&DataLoader::produce, this);
+  }
+}
+
+DataLoader::~DataLoader() {
+  this->stopping.store(true, std::memory_order_relaxed);
+  if (this->worker.joinable()) {
+    this->worker.join();
+  }
+}
+
+std::pair<Tensor, Tensor> DataLoader::makeBatch(size_t index) const {
+  const size_t start = index * this->batchSize;
+  const size_t count = std::min(this->batchSize, this->order.size() - start);
+  return this->dataset.getBatch(this->order.data() + start, count);
+}
+
+/**
+ * @brief Bucle del hilo de fondo: arma los batches en orden y los encola.
+ */
+void DataLoader::produce() {
+#ifdef _OPENMP
+  omp_set_num_threads(1);
+#endif
+  try {
+    for (size_t i = 0; i < this->totalBatches; ++i) {
+      std::pair<Tensor, Tensor> batch = this->makeBatch(i);
+      size_t attempt = 0;
+      while (!this->ring.tryPush(batch)) {
+        if (this->stopping.load(std::memory_order_relaxed)) {
+          return;
+        }
+        backoff(attempt);
+      }
+    }
+  } catch (...) {
+    this->error = std::current_exception();
+    this->failed.store(true, std::memory_order_release);
+  }
+}
+
+bool DataLoader::next(std::pair<Tensor, Tensor> &batch) {
+  if (this->consumed == this->totalBatches) {
+    return false;
+  }
+  if (!this->worker.joinable()) {
+    batch = this->makeBatch(this->consumed++);
+    return true;
+  }
+
+  size_t attempt = 0;
+  while (!this->ring.tryPop(batch)) {
+    // Tras ver el error se reintenta una vez: el último batch encolado antes del fallo
+    // pudo llegar entre el tryPop anterior y esta lectura.
+    if (this->failed.load(std::memory_order_acquire)) {
+      if (this->ring.tryPop(batch)) {
+        break;
+      }
+      std::rethrow_exception(this->error);
+    }
+    backoff(attempt);
+  }
+  ++this->consumed;
+  return true;
+}
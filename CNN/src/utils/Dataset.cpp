@@ -0,0 +1,278 @@
+#include "utils/Dataset.hpp"
+#include "utils/CsvParser.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// --- Formato binario ---
+namespace {
+constexpr char MAGIC[8] = {'F', 'M', 'N', 'I', 'S', 'T', 'U', '8'};
+constexpr uint32_t FORMAT_VERSION = 1;
+constexpr size_t HEADER_SIZE = 64;
+constexpr size_t PIXEL_ALIGNMENT = 64;
+constexpr size_t IMAGE_SIDE = 28;
+constexpr uint32_t NUM_CLASSES = 10;
+
+/// Cabecera del archivo (ocupa los primeros HEADER_SIZE bytes, el resto es relleno).
+struct BinaryHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t numClasses;
+  uint64_t numSamples;
+  uint32_t rows;
+  uint32_t cols;
+  uint64_t labelsOffset;
+  uint64_t pixelsOffset;
+};
+static_assert(sizeof(BinaryHeader) <= HEADER_SIZE, "La cabecera debe caber en 64 bytes");
+
+size_t alignUp(size_t value, size_t alignment) { return (value + alignment - 1) / alignment * alignment; }
+
+/// "data/x.csv" -> "data/x.u8.bin"
+std::string binaryPathFor(const std::string &csvPath) {
+  std::filesystem::path path(csvPath);
+  path.replace_extension(".u8.bin");
+  return path.string();
+}
+} // namespace
+
+// --- TensorDataset ---
+
+TensorDataset::TensorDataset(const Tensor &X, const Tensor &y) : sampleShape(X.getShape()) {
+  if (X.getShape().empty() || y.getShape().size() != 2 || X.getShape()[0] != y.getShape()[0]) {
+    throw std::invalid_argument("TensorDataset: X e y deben tener el mismo número de muestras.");
+  }
+  // Los ejes repetidos (stride 0, ej. los canales de `loadMnist`) se guardan con tamaño 1
+  // y se vuelven a expandir en cada batch.
+  Tensor compact = X;
+  for (size_t d = 1; d < compact.getShape().size(); ++d) {
+    if (compact.isBroadcast(d)) {
+      compact = compact.slice(d, 0, 1);
+    }
+  }
+  this->X = compact.contiguous();
+  this->y = y.contiguous();
+}
+
+Tensor TensorDataset::expandBatch(Tensor batch) const {
+  for (size_t d = 1; d < this->sampleShape.size(); ++d) {
+    if (batch.getShape()[d] != this->sampleShape[d]) {
+      batch = batch.expand(d, this->sampleShape[d]);
+    }
+  }
+  return batch;
+}
+
+std::pair<Tensor, Tensor> TensorDataset::getBatch(const size_t *indices, size_t count) const {
+  const size_t numSamples = this->size();
+  bool consecutive = true;
+  for (size_t j = 0; j < count; ++j) {
+    if (indices[j] >= numSamples) {
+      throw std::out_of_range("TensorDataset: índice de muestra fuera de rango.");
+    }
+    consecutive = consecutive && indices[j] == indices[0] + j;
+  }
+  if (consecutive && count > 0) {
+    return {this->expandBatch(this->X.slice(indices[0], count)), this->y.slice(indices[0], count)};
+  }
+
+  std::vector<size_t> batchShape = this->X.getShape();
+  batchShape[0] = count;
+  Tensor X_batch = Tensor::uninitialized(batchShape);
+  Tensor y_batch = Tensor::uninitialized({count, this->y.getShape()[1]});
+
+  const size_t xRow = this->X.getSize() / numSamples;
+  const size_t yRow = this->y.getShape()[1];
+  const float *xSrc = this->X.getData() + this->X.getDataOffset();
+  const float *ySrc = this->y.getData() + this->y.getDataOffset();
+  float *xDst = X_batch.getData();
+  float *yDst = y_batch.getData();
+#pragma omp parallel for
+  for (size_t j = 0; j < count; ++j) {
+    std::memcpy(xDst + j * xRow, xSrc + indices[j] * xRow, xRow * sizeof(float));
+    std::memcpy(yDst + j * yRow, ySrc + indices[j] * yRow, yRow * sizeof(float));
+  }
+  return {this->expandBatch(std::move(X_batch)), std::move(y_batch)};
+}
+
+// --- MappedDataset ---
+
+MappedDataset::MappedDataset(const std::string &binPath, int channels) {
+  if (channels != 1 && channels != 3) {
+    throw std::invalid_argument("El número de canales debe ser 1 o 3.");
+  }
+  this->channels = static_cast<size_t>(channels);
+
+  int fd = ::open(binPath.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Error: No se pudo abrir el archivo: " + binPath);
+  }
+  struct stat info;
+  if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < HEADER_SIZE) {
+    ::close(fd);
+    throw std::runtime_error("Error: Archivo binario inválido: " + binPath);
+  }
+  this->mappingSize = static_cast<size_t>(info.st_size);
+  this->mapping = ::mmap(nullptr, this->mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd); // La proyección sigue siendo válida sin el descriptor.
+  if (this->mapping == MAP_FAILED) {
+    this->mapping = nullptr;
+    throw std::runtime_error("Error: No se pudo proyectar en memoria: " + binPath);
+  }
+
+  BinaryHeader header;
+  std::memcpy(&header, this->mapping, sizeof(header));
+  const size_t pixelBytes = static_cast<size_t>(header.numSamples) * header.rows * header.cols;
+  const bool valid = std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 && header.version == FORMAT_VERSION &&
+                     header.numClasses > 0 && header.labelsOffset >= HEADER_SIZE &&
+                     header.labelsOffset + header.numSamples * sizeof(int32_t) <= header.pixelsOffset &&
+                     header.pixelsOffset % PIXEL_ALIGNMENT == 0 && header.pixelsOffset + pixelBytes <= this->mappingSize;
+  if (!valid) {
+    this->unmap();
+    throw std::runtime_error("Error: Cabecera de dataset binario inválida: " + binPath);
+  }
+
+  this->numSamples = header.numSamples;
+  this->rows = header.rows;
+  this->cols = header.cols;
+  this->numClasses = header.numClasses;
+  const char *base = static_cast<const char *>(this->mapping);
+  this->labels = reinterpret_cast<const int32_t *>(base + header.labelsOffset);
+  this->pixelData = reinterpret_cast<const uint8_t *>(base + header.pixelsOffset);
+}
+
+MappedDataset::~MappedDataset() { this->unmap(); }
+
+MappedDataset::MappedDataset(MappedDataset &&other) noexcept { *this = std::move(other); }
+
+MappedDataset &MappedDataset::operator=(MappedDataset &&other) noexcept {
+  if (this != &other) {
+    this->unmap();
+    this->mapping = other.mapping;
+    this->mappingSize = other.mappingSize;
+    this->numSamples = other.numSamples;
+    this->rows = other.rows;
+    this->cols = other.cols;
+    this->numClasses = other.numClasses;
+    this->channels = other.channels;
+    this->labels = other.labels;
+    this->pixelData = other.pixelData;
+    other.mapping = nullptr;
+    other.mappingSize = 0;
+    other.numSamples = 0;
+  }
+  return *this;
+}
+
+void MappedDataset::unmap() {
+  if (this->mapping) {
+    ::munmap(this->mapping, this->mappingSize);
+    this->mapping = nullptr;
+  }
+}
+
+/**
+ * @brief Normaliza los píxeles de las muestras pedidas a [0, 1] y arma las etiquetas one-hot.
+ * @details Con 3 canales el batch es una vista con stride 0 sobre el único plano de gris.
+ */
+std::pair<Tensor, Tensor> MappedDataset::getBatch(const size_t *indices, size_t count) const {
+  for (size_t j = 0; j < count; ++j) {
+    if (indices[j] >= this->numSamples) {
+      throw std::out_of_range("MappedDataset: índice de muestra fuera de rango.");
+    }
+  }
+
+  const size_t planeSize = this->rows * this->cols;
+  Tensor X = Tensor::uninitialized({count, 1, this->rows, this->cols});
+  Tensor y({count, this->numClasses}); // Se inicializa a ceros
+  float *xData = X.getData();
+  float *yData = y.getData();
+#pragma omp parallel for
+  for (size_t j = 0; j < count; ++j) {
+    const uint8_t *src = this->pixels(indices[j]);
+    float *sample = xData + j * planeSize;
+    for (size_t p = 0; p < planeSize; ++p) {
+      sample[p] = static_cast<float>(src[p]) / 255.0f;
+    }
+    const int32_t label = this->labels[indices[j]];
+    if (label >= 0 && static_cast<size_t>(label) < this->numClasses) {
+      yData[j * this->numClasses + label] = 1.0f;
+    }
+  }
+  if (this->channels > 1) {
+    X = X.expand(1, this->channels);
+  }
+  return {std::move(X), std::move(y)};
+}
+
+// --- Conversión desde CSV ---
+
+size_t convertCsvToBinary(const std::string &csvPath, const std::string &binPath) {
+  MnistCsv csv = parseMnistCsv(csvPath, 1.0f, false, IMAGE_SIDE * IMAGE_SIDE, NUM_CLASSES);
+  if (csv.skippedRows > 0) {
+    std::cerr << "Advertencia: " << csv.skippedRows << " filas inválidas en " << csvPath << ". Se ignoran." << std::endl;
+  }
+  const std::vector<int32_t> &labels = csv.labels;
+  const std::vector<uint8_t> &pixels = csv.pixels;
+
+  BinaryHeader header{};
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = FORMAT_VERSION;
+  header.numClasses = NUM_CLASSES;
+  header.numSamples = labels.size();
+  header.rows = IMAGE_SIDE;
+  header.cols = IMAGE_SIDE;
+  header.labelsOffset = HEADER_SIZE;
+  header.pixelsOffset = alignUp(HEADER_SIZE + labels.size() * sizeof(int32_t), PIXEL_ALIGNMENT);
+
+  // Se escribe en un temporal y se renombra: nunca queda un binario a medio escribir.
+  const std::string tmpPath = binPath + ".tmp";
+  {
+    std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+      throw std::runtime_error("Error: No se pudo crear el archivo: " + tmpPath);
+    }
+    std::vector<char> padding(HEADER_SIZE - sizeof(header), 0);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(padding.data(), padding.size());
+    out.write(reinterpret_cast<const char *>(labels.data()), labels.size() * sizeof(int32_t));
+    padding.assign(header.pixelsOffset - HEADER_SIZE - labels.size() * sizeof(int32_t), 0);
+    out.write(padding.data(), padding.size());
+    out.write(reinterpret_cast<const char *>(pixels.data()), pixels.size());
+    if (!out) {
+      throw std::runtime_error("Error: Fallo al escribir el archivo: " + tmpPath);
+    }
+  }
+  std::filesystem::rename(tmpPath, binPath);
+  return labels.size();
+}
+
+MappedDataset openMnistDataset(const std::string &csvPath, int channels) {
+  const std::string binPath = binaryPathFor(csvPath);
+  const bool stale = !std::filesystem::exists(binPath) ||
+                     (std::filesystem::exists(csvPath) &&
+                      std::filesystem::last_write_time(csvPath) > std::filesystem::last_write_time(binPath));
+  if (stale) {
+    std::cout << "Convirtiendo " << csvPath << " a formato binario: " << binPath << std::endl;
+    const size_t samples = convertCsvToBinary(csvPath, binPath);
+    std::cout << "  -> " << samples << " muestras convertidas." << std::endl;
+  }
+
+  MappedDataset dataset(binPath, channels);
+  std::cout << "Dataset proyectado: " << binPath << " (" << dataset.size() << " muestras, canales: " << channels
+            << ")" << std::endl;
+  return dataset;
+}
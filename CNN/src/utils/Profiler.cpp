@@ -0,0 +1,204 @@
+#include "utils/Profiler.hpp"
+#include "core/Allocator.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+
+namespace {
+double steadyMicros() {
+  const auto now = std::chrono::steady_clock::now().time_since_epoch();
+  return std::chrono::duration<double, std::micro>(now).count();
+}
+
+std::string jsonEscape(const std::string &text) {
+  std::string escaped;
+  for (char c : text) {
+    if (c == '"' || c == '\\')
+      escaped += '\\';
+    escaped += c;
+  }
+  return escaped;
+}
+} // namespace
+
+// --- Implementación de Profiler ---
+
+Profiler &Profiler::instance() {
+  static Profiler profiler;
+  return profiler;
+}
+
+Profiler::Profiler() {
+  const char *env = std::getenv("CNN_PROFILE");
+  if (env && *env) {
+    exitTracePath = env;
+    start();
+  }
+}
+
+Profiler::~Profiler() {
+  if (exitTracePath.empty())
+    return;
+  try {
+    writeChromeTrace(exitTracePath);
+    printSummary(std::cout);
+    std::cout << "Traza de perfilado guardada en: " << exitTracePath << std::endl;
+  } catch (const std::exception &e) {
+    std::cerr << "Profiler: " << e.what() << std::endl;
+  }
+}
+
+void Profiler::start() {
+  events.clear();
+  stack.clear();
+  forwardFlops.clear();
+  origin = steadyMicros();
+  enabled = true;
+}
+
+void Profiler::stop() { enabled = false; }
+
+double Profiler::nowUs() const { return steadyMicros() - origin; }
+
+size_t Profiler::enter(const std::string &label) {
+  stack.push_back(stack.empty() ? label : stack.back() + "/" + label);
+  return stack.size() - 1;
+}
+
+void Profiler::leave(ProfileEvent event) {
+  if (stack.empty())
+    return; // start() se llamó con este ámbito abierto.
+  event.name = std::move(stack.back());
+  stack.pop_back();
+  events.push_back(std::move(event));
+}
+
+double Profiler::getForwardFlops(const Layer *layer) const {
+  auto it = forwardFlops.find(layer);
+  return it == forwardFlops.end() ? 0.0 : it->second;
+}
+
+void Profiler::writeChromeTrace(const std::string &path) const {
+  std::ofstream out(path);
+  if (!out) {
+    throw std::runtime_error("No se pudo abrir el archivo de traza: " + path);
+  }
+  out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+  out << std::fixed << std::setprecision(3);
+  for (size_t i = 0; i < events.size(); ++i) {
+    const ProfileEvent &e = events[i];
+    // El visor anida los eventos por tiempo: basta el último componente de la ruta como nombre.
+    const std::string label = e.name.substr(e.name.find_last_of('/') + 1);
+    out << "{\"name\": \"" << jsonEscape(label) << "\", \"cat\": \"" << e.phase << "\", \"ph\": \"X\", \"ts\": "
+        << e.startUs << ", \"dur\": " << e.durationUs << ", \"pid\": 0, \"tid\": 0, \"args\": {\"path\": \""
+        << jsonEscape(e.name) << "\", \"flops\": " << e.flops << ", \"bytes_allocated\": " << e.bytesAllocated
+        << ", \"peak_bytes\": " << e.peakBytes << "}}" << (i + 1 < events.size() ? ",\n" : "\n");
+  }
+  out << "]}\n";
+}
+
+void Profiler::printSummary(std::ostream &out) const {
+  struct Row {
+    std::string name;
+    const char *phase;
+    size_t calls = 0;
+    double totalUs = 0.0;
+    double flops = 0.0;
+    double bytesAllocated = 0.0;
+    size_t peakBytes = 0;
+  };
+
+  // Agrega por (ruta, fase) conservando el orden de aparición para los empates.
+  std::map<std::pair<std::string, std::string>, size_t> index;
+  std::vector<Row> rows;
+  double rootUs = 0.0;
+  for (const ProfileEvent &e : events) {
+    auto [it, inserted] = index.try_emplace({e.name, e.phase}, rows.size());
+    if (inserted)
+      rows.push_back(Row{e.name, e.phase});
+    Row &row = rows[it->second];
+    row.calls++;
+    row.totalUs += e.durationUs;
+    row.flops += e.flops;
+    row.bytesAllocated += static_cast<double>(e.bytesAllocated);
+    row.peakBytes = std::max(row.peakBytes, e.peakBytes);
+    if (e.depth == 0)
+      rootUs += e.durationUs;
+  }
+  std::stable_sort(rows.begin(), rows.end(), [](const Row &a, const Row &b) { return a.totalUs > b.totalUs; });
+
+  constexpr int NAME_WIDTH = 52;
+  const auto flags = out.flags();
+  const auto precision = out.precision();
+  out << "\n--- Perfil por capa ---\n";
+  out << std::left << std::setw(NAME_WIDTH) << "Ámbito" << std::setw(10) << "Fase" << std::right << std::setw(9) << "Llamadas"
+      << std::setw(12) << "Total ms" << std::setw(11) << "Media ms" << std::setw(8) << "%" << std::setw(10) << "GFLOP/s"
+      << std::setw(13) << "MB/llamada" << std::setw(10) << "Pico MB" << "\n";
+  out << std::string(NAME_WIDTH + 83, '-') << "\n";
+  out << std::fixed;
+  for (const Row &row : rows) {
+    const double totalMs = row.totalUs * 1e-3;
+    out << std::left << std::setw(NAME_WIDTH) << (row.name + " ") << std::setw(10) << row.phase << std::right << std::setw(9) << row.calls
+        << std::setprecision(2) << std::setw(12) << totalMs << std::setprecision(3) << std::setw(11)
+        << totalMs / row.calls << std::setprecision(1) << std::setw(8)
+        << (rootUs > 0.0 ? 100.0 * row.totalUs / rootUs : 0.0) << std::setprecision(2) << std::setw(10)
+        << (row.totalUs > 0.0 ? row.flops / row.totalUs * 1e-3 : 0.0) << std::setw(13)
+        << row.bytesAllocated / row.calls / (1024.0 * 1024.0) << std::setw(10)
+        << static_cast<double>(row.peakBytes) / (1024.0 * 1024.0) << "\n";
+  }
+  out.flags(flags);
+  out.precision(precision);
+}
+
+// --- Implementación de ProfileScope ---
+
+ProfileScope::ProfileScope(const std::string &label, const char *phase, double flops) {
+  if (Profiler::instance().isEnabled())
+    begin(label, phase, flops);
+}
+
+ProfileScope::ProfileScope(const std::string &label, const Layer &layer, const Tensor &input) {
+  Profiler &profiler = Profiler::instance();
+  if (!profiler.isEnabled())
+    return;
+  const double flops = layer.getFlops(input.getShape());
+  profiler.setForwardFlops(&layer, flops);
+  begin(label, "forward", flops);
+}
+
+ProfileScope::ProfileScope(const std::string &label, const Layer &layer) {
+  Profiler &profiler = Profiler::instance();
+  if (profiler.isEnabled())
+    begin(label, "backward", 2.0 * profiler.getForwardFlops(&layer));
+}
+
+void ProfileScope::begin(const std::string &label, const char *phase, double flops) {
+  Profiler &profiler = Profiler::instance();
+  const std::shared_ptr<Allocator> &allocator = getAllocator();
+  active = true;
+  event.phase = phase;
+  event.flops = flops;
+  event.depth = profiler.enter(label);
+  bytesAllocatedAtStart = allocator->stats().bytesAllocated;
+  // El pico pasa a contar desde ahora; el anterior se restaura al salir del ámbito.
+  peakBeforeScope = allocator->resetPeak(0);
+  event.startUs = profiler.nowUs();
+}
+
+ProfileScope::~ProfileScope() {
+  if (!active)
+    return;
+  Profiler &profiler = Profiler::instance();
+  const std::shared_ptr<Allocator> &allocator = getAllocator();
+  event.durationUs = profiler.nowUs() - event.startUs;
+  event.bytesAllocated = allocator->stats().bytesAllocated - bytesAllocatedAtStart;
+  event.peakBytes = allocator->resetPeak(0);
+  allocator->resetPeak(std::max(peakBeforeScope, event.peakBytes));
+  profiler.leave(std::move(event));
+}
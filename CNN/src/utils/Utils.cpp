@@ -92,6 +92,7 @@ void loadModel(Sequential &model, const std::string &filePath) {
   }
 
   inFile.close();
+  model.parametersUpdated();
   std::cout << "Modelo cargado con éxito." << std::endl;
 }
 
@@ -0,0 +1,293 @@
+#include "layers/Conv2D.hpp"
+#include "layers/Dense.hpp"
+#include "layers/Flatten.hpp"
+#include "layers/Pooling2D.hpp"
+#include "losses/CrossEntropy.hpp"
+#include "model/Sequential.hpp"
+#include "optimizers/SGD.hpp"
+#include "activations/ReLU.hpp"
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/**
+ * @file conv2d_gradient_test.cpp
+ * @brief Prueba del backward de Conv2D con batch > 1.
+ *
+ * 1. Diferencias finitas centradas de L = sum(Y * G) frente a dL/dX, dL/dW y dL/db, con
+ *    varios kernels, strides y paddings y con cada algoritmo del forward (el backward usa
+ *    siempre im2col + col2im, muestra a muestra).
+ * 2. Una entrada con canales repetidos (`expand`) frente a la misma entrada copiada, también
+ *    después de cambiar los pesos (la caché de pesos sumados debe invalidarse).
+ * 3. Forward y backward con 1 hilo y con 4 hilos: Conv2D sola y una red
+ *    Conv2D → ReLU → MaxPooling → Flatten → Dense deben dar resultados idénticos bit a bit.
+ *
+ * Devuelve 1 si algún caso falla.
+ */
+
+namespace {
+int failures = 0;
+
+Tensor randomTensor(const std::vector<size_t> &shape) {
+  Tensor t(shape);
+  t.randomize(-1.0f, 1.0f);
+  return t;
+}
+
+/** @brief Recorre todos los elementos de un tensor de rango 1, 2 o 4 (puede ser una vista). */
+template <typename Fn> void forEach(const Tensor &t, Fn fn) {
+  const auto &s = t.getShape();
+  if (s.size() == 4) {
+    for (size_t a = 0; a < s[0]; ++a) {
+      for (size_t b = 0; b < s[1]; ++b) {
+        for (size_t c = 0; c < s[2]; ++c) {
+          for (size_t d = 0; d < s[3]; ++d) {
+            fn(a * s[1] * s[2] * s[3] + (b * s[2] + c) * s[3] + d, t(a, b, c, d));
+          }
+        }
+      }
+    }
+  } else if (s.size() == 2) {
+    for (size_t i = 0; i < s[0]; ++i) {
+      for (size_t j = 0; j < s[1]; ++j) {
+        fn(i * s[1] + j, t(i, j));
+      }
+    }
+  } else {
+    for (size_t i = 0; i < s[0]; ++i) {
+      fn(i, t(i));
+    }
+  }
+}
+
+/** @brief Elemento `i` (en orden lógico) de un tensor de rango 1, 2 o 4. */
+float &at(Tensor &t, size_t i) {
+  const auto &s = t.getShape();
+  if (s.size() == 4) {
+    return t(i / (s[1] * s[2] * s[3]), i / (s[2] * s[3]) % s[1], i / s[3] % s[2], i % s[3]);
+  }
+  if (s.size() == 2) {
+    return t(i / s[1], i % s[1]);
+  }
+  return t(i);
+}
+
+/** @brief Diferencia máxima relativa al mayor valor absoluto de la referencia. */
+double relativeDiff(const Tensor &got, const Tensor &ref) {
+  std::vector<float> values(ref.getSize());
+  forEach(ref, [&](size_t i, float v) { values[i] = v; });
+  double worst = 0.0;
+  double magnitude = 1.0;
+  forEach(got, [&](size_t i, float v) {
+    worst = std::max(worst, static_cast<double>(std::fabs(v - values[i])));
+    magnitude = std::max(magnitude, static_cast<double>(std::fabs(values[i])));
+  });
+  return worst / magnitude;
+}
+
+/** @brief Diferencia máxima absoluta; 0 si los tensores son idénticos bit a bit. */
+double maxDiff(const Tensor &got, const Tensor &ref) {
+  std::vector<float> values(ref.getSize());
+  forEach(ref, [&](size_t i, float v) { values[i] = v; });
+  double worst = 0.0;
+  forEach(got, [&](size_t i, float v) { worst = std::max(worst, static_cast<double>(std::fabs(v - values[i]))); });
+  return worst;
+}
+
+void report(const std::string &name, double worst, double tolerance) {
+  const bool ok = worst <= tolerance;
+  if (!ok) {
+    ++failures;
+  }
+  std::printf("%-52s %s (max diff %.2e)\n", name.c_str(), ok ? "OK" : "FALLA", worst);
+}
+
+/** @brief L = sum(Y * G) en double. */
+double weightedSum(Conv2D &conv, const Tensor &input, const Tensor &outputGradient) {
+  const Tensor output = conv.forward(input, false);
+  std::vector<float> g(outputGradient.getSize());
+  forEach(outputGradient, [&](size_t i, float v) { g[i] = v; });
+  double sum = 0.0;
+  forEach(output, [&](size_t i, float v) { sum += static_cast<double>(v) * g[i]; });
+  return sum;
+}
+
+/** @brief Derivada centrada de L respecto a cada elemento de `target`, que se restaura después. */
+Tensor numericGradient(Conv2D &conv, const Tensor &input, const Tensor &outputGradient, Tensor &target) {
+  constexpr float EPS = 1e-2f;
+  Tensor numeric(target.getShape());
+  for (size_t i = 0; i < target.getSize(); ++i) {
+    const float saved = at(target, i);
+    at(target, i) = saved + EPS;
+    const double plus = weightedSum(conv, input, outputGradient);
+    at(target, i) = saved - EPS;
+    const double minus = weightedSum(conv, input, outputGradient);
+    at(target, i) = saved;
+    at(numeric, i) = static_cast<float>((plus - minus) / (2.0 * EPS));
+  }
+  return numeric;
+}
+
+void testFiniteDifferences(size_t batch, size_t inC, size_t outC, size_t size, size_t kernel, size_t stride,
+                           size_t padding, Conv2D::Algorithm algorithm) {
+  const std::string label = "B=" + std::to_string(batch) + " k" + std::to_string(kernel) + " s" +
+                            std::to_string(stride) + " p" + std::to_string(padding) + " " +
+                            Conv2D::algorithmName(algorithm);
+  Conv2D conv(inC, outC, kernel, stride, padding);
+  conv.setAlgorithm(algorithm);
+  Tensor input = randomTensor({batch, inC, size, size});
+  const Tensor outputGradient = randomTensor(conv.getOutputShape(input.getShape()));
+
+  conv.forward(input, true);
+  const Tensor inputGradient = conv.backward(outputGradient);
+  const std::vector<Tensor *> params = conv.getParameters();
+  const std::vector<Tensor *> grads = conv.getGradients();
+
+  report(label + ": dL/dX", relativeDiff(inputGradient, numericGradient(conv, input, outputGradient, input)), 2e-3);
+  report(label + ": dL/dW", relativeDiff(*grads[0], numericGradient(conv, input, outputGradient, *params[0])), 2e-3);
+  report(label + ": dL/db", relativeDiff(*grads[1], numericGradient(conv, input, outputGradient, *params[1])), 2e-3);
+}
+
+void testBroadcastInput(Conv2D::Algorithm algorithm) {
+  const std::string label = "canales repetidos " + Conv2D::algorithmName(algorithm);
+  Conv2D conv(3, 4, 3, 1, 1);
+  conv.setAlgorithm(algorithm);
+  const Tensor plane = randomTensor({2, 1, 6, 6});
+  const Tensor expanded = plane.expand(1, 3);
+  const Tensor copied = expanded.contiguous();
+  const Tensor outputGradient = randomTensor({2, 4, 6, 6});
+
+  const Tensor outCopied = conv.forward(copied, true);
+  const Tensor dXCopied = conv.backward(outputGradient);
+  const Tensor dWCopied = conv.getGradients()[0]->contiguous();
+  const Tensor outExpanded = conv.forward(expanded, true);
+  const Tensor dXExpanded = conv.backward(outputGradient);
+
+  report(label + ": salida", relativeDiff(outExpanded, outCopied), 1e-5);
+  report(label + ": dL/dX", relativeDiff(dXExpanded, dXCopied), 1e-5);
+  report(label + ": dL/dW", relativeDiff(*conv.getGradients()[0], dWCopied), 1e-5);
+}
+
+/**
+ * @brief Los pesos sumados de una entrada con canales repetidos siguen a los pesos actuales.
+ * @details Se cambian los pesos después de un forward con canales repetidos, directamente
+ *          (con `parametersUpdated`) y con un paso de `Sequential::train`.
+ */
+void testSummedWeightsCache() {
+  Conv2D conv(3, 4, 3, 1, 1);
+  const Tensor expanded = randomTensor({2, 1, 6, 6}).expand(1, 3);
+  const Tensor copied = expanded.contiguous();
+  conv.forward(expanded, false);
+  Tensor &weights = *conv.getParameters()[0];
+  const Tensor shifted = randomTensor(weights.getShape());
+  weights.copyFrom(shifted);
+  conv.parametersUpdated();
+  report("canales repetidos tras cambiar los pesos", relativeDiff(conv.forward(expanded, false), conv.forward(copied, false)),
+         1e-5);
+
+  Sequential model;
+  model.add<Conv2D>(3, 4, 3, 1, 1);
+  model.add<Flatten>();
+  model.add<Dense>(4 * 6 * 6, 3);
+  model.compile<SGD, CrossEntropy>(0.5f);
+  const Tensor X = randomTensor({6, 1, 6, 6}).expand(1, 3);
+  const Tensor XCopied = X.contiguous();
+  Tensor y({6, 3});
+  for (size_t i = 0; i < 6; ++i) {
+    y(i, i % 3) = 1.0f;
+  }
+  const Tensor before = model.predict(X);
+  model.train(XCopied, y, 1, 3, XCopied, y);
+  const Tensor after = model.predict(X);
+  report("canales repetidos tras Sequential::train", relativeDiff(after, model.predict(XCopied)), 1e-5);
+  report("Sequential::train cambia la prediccion", relativeDiff(after, before) > 1e-4 ? 0.0 : 1.0, 0.0);
+}
+
+/** @brief Salida, dL/dX y gradientes de una pasada forward + backward por `layers`. */
+std::vector<Tensor> forwardBackward(std::vector<std::unique_ptr<Layer>> &layers, const Tensor &input,
+                                    const Tensor &outputGradient) {
+  Tensor x = input;
+  for (auto &layer : layers) {
+    x = layer->forward(x, true);
+  }
+  std::vector<Tensor> results = {x};
+  Tensor gradient = outputGradient;
+  for (size_t l = layers.size(); l-- > 0;) {
+    gradient = layers[l]->backward(gradient);
+  }
+  results.push_back(gradient);
+  for (auto &layer : layers) {
+    for (Tensor *g : layer->getGradients()) {
+      results.push_back(g->contiguous());
+    }
+  }
+  return results;
+}
+
+void testThreads(const std::string &label, std::vector<std::unique_ptr<Layer>> &layers, const Tensor &input,
+                 const Tensor &outputGradient) {
+#ifdef _OPENMP
+  const int previous = omp_get_max_threads();
+  omp_set_num_threads(1);
+  const std::vector<Tensor> serial = forwardBackward(layers, input, outputGradient);
+  omp_set_num_threads(4);
+  const std::vector<Tensor> parallel = forwardBackward(layers, input, outputGradient);
+  omp_set_num_threads(previous);
+
+  double worst = 0.0;
+  for (size_t i = 0; i < serial.size(); ++i) {
+    worst = std::max(worst, maxDiff(parallel[i], serial[i]));
+  }
+  report(label + ": 1 hilo vs 4 hilos", worst, 0.0);
+#else
+  (void)layers;
+  (void)input;
+  (void)outputGradient;
+  std::printf("%-52s OMITIDA (sin OpenMP)\n", (label + ": 1 hilo vs 4 hilos").c_str());
+#endif
+}
+} // namespace
+
+int main() {
+  const Conv2D::Algorithm algorithms[] = {Conv2D::Algorithm::Im2col, Conv2D::Algorithm::Direct,
+                                          Conv2D::Algorithm::Winograd};
+  for (Conv2D::Algorithm algorithm : algorithms) {
+    testFiniteDifferences(3, 2, 3, 7, 3, 1, 1, algorithm);
+  }
+  testFiniteDifferences(3, 2, 3, 8, 3, 2, 1, Conv2D::Algorithm::Direct);
+  testFiniteDifferences(2, 3, 2, 7, 5, 1, 2, Conv2D::Algorithm::Im2col);
+  testFiniteDifferences(4, 2, 2, 6, 2, 2, 0, Conv2D::Algorithm::Direct);
+
+  for (Conv2D::Algorithm algorithm : algorithms) {
+    testBroadcastInput(algorithm);
+  }
+  testSummedWeightsCache();
+
+  for (Conv2D::Algorithm algorithm : algorithms) {
+    std::vector<std::unique_ptr<Layer>> layers;
+    auto conv = std::make_unique<Conv2D>(4, 8, 3, 1, 1);
+    conv->setAlgorithm(algorithm);
+    layers.push_back(std::move(conv));
+    testThreads("Conv2D " + Conv2D::algorithmName(algorithm), layers, randomTensor({6, 4, 10, 10}),
+                randomTensor({6, 8, 10, 10}));
+  }
+  std::vector<std::unique_ptr<Layer>> network;
+  network.push_back(std::make_unique<Conv2D>(3, 8, 3, 1, 1));
+  network.push_back(std::make_unique<ReLU>());
+  network.push_back(std::make_unique<Pooling2D>(2));
+  network.push_back(std::make_unique<Flatten>());
+  network.push_back(std::make_unique<Dense>(8 * 6 * 6, 10));
+  testThreads("Conv2D+ReLU+MaxPooling+Dense", network, randomTensor({5, 3, 12, 12}), randomTensor({5, 10}));
+
+  if (failures) {
+    std::printf("%d casos fallaron.\n", failures);
+    return 1;
+  }
+  std::printf("Todas las pruebas del backward de Conv2D pasaron.\n");
+  return 0;
+}
@@ -0,0 +1,221 @@
+#include "activations/ReLU.hpp"
+#include "layers/Conv2D.hpp"
+#include "layers/Dense.hpp"
+#include "layers/Flatten.hpp"
+#include "layers/FusedConv2D.hpp"
+#include "layers/FusedDense.hpp"
+#include "layers/Pooling2D.hpp"
+#include "losses/CrossEntropy.hpp"
+#include "model/Sequential.hpp"
+#include "optimizers/SGD.hpp"
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @file fused_layers_test.cpp
+ * @brief Prueba de las capas fusionadas frente a las capas separadas con los mismos pesos.
+ *
+ * 1. FusedConv2D (Conv2D → ReLU, con y sin MaxPooling) y FusedDense (Dense → ReLU) frente a
+ *    la secuencia de capas originales: salida, dL/dX y gradientes de los parámetros, también
+ *    con una entrada nula (empates en las ventanas del pooling y máximos no positivos).
+ * 2. Dos modelos Sequential iguales, con y sin la fusión de `compile`: predicción antes de
+ *    entrenar y parámetros tras una época de SGD, con una y con dos réplicas.
+ *
+ * Devuelve 1 si algún caso falla.
+ */
+
+namespace {
+int failures = 0;
+
+Tensor randomTensor(const std::vector<size_t> &shape) {
+  Tensor t(shape);
+  t.randomize(-1.0f, 1.0f);
+  return t;
+}
+
+/** @brief Recorre todos los elementos de un tensor de rango 1, 2 o 4 (puede ser una vista). */
+template <typename Fn> void forEach(const Tensor &t, Fn fn) {
+  const auto &s = t.getShape();
+  if (s.size() == 4) {
+    for (size_t a = 0; a < s[0]; ++a) {
+      for (size_t b = 0; b < s[1]; ++b) {
+        for (size_t c = 0; c < s[2]; ++c) {
+          for (size_t d = 0; d < s[3]; ++d) {
+            fn(a * s[1] * s[2] * s[3] + (b * s[2] + c) * s[3] + d, t(a, b, c, d));
+          }
+        }
+      }
+    }
+  } else if (s.size() == 2) {
+    for (size_t i = 0; i < s[0]; ++i) {
+      for (size_t j = 0; j < s[1]; ++j) {
+        fn(i * s[1] + j, t(i, j));
+      }
+    }
+  } else {
+    for (size_t i = 0; i < s[0]; ++i) {
+      fn(i, t(i));
+    }
+  }
+}
+
+/** @brief Diferencia máxima relativa al mayor valor absoluto de la referencia. */
+double relativeDiff(const Tensor &got, const Tensor &ref) {
+  if (got.getShape() != ref.getShape()) {
+    return INFINITY;
+  }
+  std::vector<float> values(ref.getSize());
+  forEach(ref, [&](size_t i, float v) { values[i] = v; });
+  double worst = 0.0;
+  double magnitude = 1.0;
+  forEach(got, [&](size_t i, float v) {
+    worst = std::max(worst, static_cast<double>(std::fabs(v - values[i])));
+    magnitude = std::max(magnitude, static_cast<double>(std::fabs(values[i])));
+  });
+  return worst / magnitude;
+}
+
+void report(const std::string &name, double worst) {
+  const bool ok = worst <= 1e-6;
+  if (!ok) {
+    ++failures;
+  }
+  std::printf("%-52s %s (max diff %.2e)\n", name.c_str(), ok ? "OK" : "FALLA", worst);
+}
+
+const char *const NAMES[] = {"W", "b"};
+
+/**
+ * @brief Compara una capa fusionada con la secuencia de capas que sustituye.
+ * @details Las capas separadas son clones de las que toma la fusionada: comparten los pesos
+ *          y tienen sus propios gradientes.
+ */
+void compareBlock(const std::string &label, Layer &fused, std::vector<std::unique_ptr<Layer>> &separate,
+                  const Tensor &input) {
+  Tensor outSeparate = input;
+  for (auto &layer : separate) {
+    outSeparate = layer->forward(outSeparate, true);
+  }
+  const Tensor outFused = fused.forward(input, true);
+  report(label + ": salida", relativeDiff(outFused, outSeparate));
+
+  const Tensor outputGradient = randomTensor(outSeparate.getShape());
+  Tensor dXSeparate = outputGradient;
+  for (size_t l = separate.size(); l-- > 0;) {
+    dXSeparate = separate[l]->backward(dXSeparate);
+  }
+  report(label + ": dL/dX", relativeDiff(fused.backward(outputGradient), dXSeparate));
+
+  const std::vector<Tensor *> gradFused = fused.getGradients();
+  const std::vector<Tensor *> gradSeparate = separate.front()->getGradients();
+  for (size_t p = 0; p < gradFused.size(); ++p) {
+    report(label + ": d" + NAMES[p], relativeDiff(*gradFused[p], *gradSeparate[p]));
+  }
+}
+
+void testConvBlock(bool withPool, size_t size, bool zeroInput) {
+  const std::string label = std::string(withPool ? "Conv2D+ReLU+MaxPooling" : "Conv2D+ReLU") + " S=" +
+                            std::to_string(size) + (zeroInput ? " entrada nula" : "");
+  auto conv = std::make_unique<Conv2D>(3, 6, 3, 1, 1);
+  auto pool = withPool ? std::make_unique<Pooling2D>(2) : nullptr;
+
+  std::vector<std::unique_ptr<Layer>> separate;
+  separate.push_back(conv->clone());
+  separate.push_back(std::make_unique<ReLU>());
+  if (pool) {
+    separate.push_back(pool->clone());
+  }
+  FusedConv2D fused(std::move(conv), std::move(pool));
+
+  Tensor input({4, 3, size, size});
+  if (!zeroInput) {
+    input.randomize(-1.0f, 1.0f);
+  }
+  compareBlock(label, fused, separate, input);
+}
+
+void testDenseBlock(bool zeroInput) {
+  const std::string label = std::string("Dense+ReLU") + (zeroInput ? " entrada nula" : "");
+  auto dense = std::make_unique<Dense>(20, 12);
+
+  std::vector<std::unique_ptr<Layer>> separate;
+  separate.push_back(dense->clone());
+  separate.push_back(std::make_unique<ReLU>());
+  FusedDense fused(std::move(dense));
+
+  Tensor input({5, 20});
+  if (!zeroInput) {
+    input.randomize(-1.0f, 1.0f);
+  }
+  compareBlock(label, fused, separate, input);
+}
+
+void buildModel(Sequential &model) {
+  model.add<Conv2D>(1, 4, 3, 1, 1);
+  model.add<ReLU>();
+  model.add<Pooling2D>(2);
+  model.add<Conv2D>(4, 4, 3, 1, 1);
+  model.add<ReLU>();
+  model.add<Flatten>();
+  model.add<Dense>(4 * 5 * 5, 16);
+  model.add<ReLU>();
+  model.add<Dense>(16, 3);
+}
+
+void testModel(size_t replicas) {
+  const std::string label = "Sequential con y sin fusion, replicas=" + std::to_string(replicas);
+  Sequential fusedModel;
+  Sequential separateModel;
+  buildModel(fusedModel);
+  buildModel(separateModel);
+  const std::vector<Tensor *> from = fusedModel.getParameters();
+  const std::vector<Tensor *> to = separateModel.getParameters();
+  for (size_t p = 0; p < from.size(); ++p) {
+    to[p]->copyFrom(*from[p]);
+  }
+  fusedModel.setDataParallelReplicas(replicas);
+  separateModel.setDataParallelReplicas(replicas);
+  separateModel.setLayerFusion(false);
+  fusedModel.compile<SGD, CrossEntropy>(0.1f);
+  separateModel.compile<SGD, CrossEntropy>(0.1f);
+
+  const Tensor X = randomTensor({12, 1, 10, 10});
+  Tensor y({12, 3});
+  for (size_t i = 0; i < 12; ++i) {
+    y(i, i % 3) = 1.0f;
+  }
+  report(label + ": predict", relativeDiff(fusedModel.predict(X), separateModel.predict(X)));
+
+  fusedModel.train(X, y, 1, 4, X, y);
+  separateModel.train(X, y, 1, 4, X, y);
+  const std::vector<Tensor *> trained = fusedModel.getParameters();
+  const std::vector<Tensor *> reference = separateModel.getParameters();
+  double worst = 0.0;
+  for (size_t p = 0; p < trained.size(); ++p) {
+    worst = std::max(worst, relativeDiff(*trained[p], *reference[p]));
+  }
+  report(label + ": pesos tras una epoca", worst);
+}
+} // namespace
+
+int main() {
+  for (bool zeroInput : {false, true}) {
+    testConvBlock(true, 8, zeroInput);
+    testConvBlock(true, 7, zeroInput);
+    testConvBlock(false, 6, zeroInput);
+    testDenseBlock(zeroInput);
+  }
+
+  testModel(1);
+  testModel(2);
+
+  if (failures) {
+    std::printf("%d casos fallaron.\n", failures);
+    return 1;
+  }
+  std::printf("Todas las pruebas de las capas fusionadas pasaron.\n");
+  return 0;
+}
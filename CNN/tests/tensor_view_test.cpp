@@ -0,0 +1,239 @@
+#include "core/Tensor.hpp"
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * @file tensor_view_test.cpp
+ * @brief Prueba de las vistas de Tensor: `slice` por cualquier eje, `transpose` y `expand`.
+ *
+ * 1. Lecturas a través de vistas no contiguas (con offset, strides permutados y stride 0),
+ *    también encadenadas, y `contiguous()` sobre ellas en los caminos 2D, 4D y general.
+ * 2. `contiguous()` de una vista con stride 0 materializa las copias en un bloque propio.
+ * 3. Operaciones que reciben vistas: `reshape`, `sum`, `copyFrom` y `matrixMultiply`.
+ * 4. Escrituras a través de vistas: llegan a la posición correcta del tensor original y
+ *    solo a ella; `copyFrom` sobre una vista no contigua se rechaza.
+ *
+ * Devuelve 1 si algún caso falla.
+ */
+
+namespace {
+int failures = 0;
+
+void check(const std::string &name, bool ok) {
+  if (!ok) {
+    ++failures;
+  }
+  std::printf("%-64s %s\n", name.c_str(), ok ? "OK" : "FALLA");
+}
+
+/** @brief Tensor cuyo elemento de índice plano i vale i. */
+Tensor iota(const std::vector<size_t> &shape) {
+  Tensor t(shape);
+  for (size_t i = 0; i < t.getSize(); ++i) {
+    t.getData()[i] = static_cast<float>(i);
+  }
+  return t;
+}
+
+/** @brief Recorre un tensor de rango 2, 3 o 4 en orden row-major con sus índices. */
+template <typename Fn> bool all(const Tensor &t, Fn expected) {
+  const auto &s = t.getShape();
+  bool ok = true;
+  if (s.size() == 4) {
+    for (size_t a = 0; a < s[0]; ++a) {
+      for (size_t b = 0; b < s[1]; ++b) {
+        for (size_t c = 0; c < s[2]; ++c) {
+          for (size_t d = 0; d < s[3]; ++d) {
+            ok = ok && t(a, b, c, d) == expected(a, b, c, d);
+          }
+        }
+      }
+    }
+  } else if (s.size() == 3) {
+    for (size_t a = 0; a < s[0]; ++a) {
+      for (size_t b = 0; b < s[1]; ++b) {
+        for (size_t c = 0; c < s[2]; ++c) {
+          ok = ok && t(a, b, c) == expected(a, b, c, size_t{0});
+        }
+      }
+    }
+  } else {
+    for (size_t a = 0; a < s[0]; ++a) {
+      for (size_t b = 0; b < s[1]; ++b) {
+        ok = ok && t(a, b) == expected(a, b, size_t{0}, size_t{0});
+      }
+    }
+  }
+  return ok;
+}
+
+/** @brief Los datos de `t` están en un bloque propio, en orden row-major y con los valores de `expected`. */
+template <typename Fn> bool isCompactCopy(const Tensor &t, Fn expected) {
+  return t.isContiguous() && t.getDataOffset() == 0 && all(t, expected);
+}
+
+void testReads() {
+  // base(a, b, c, d) = ((a * 3 + b) * 4 + c) * 5 + d.
+  const Tensor base = iota({2, 3, 4, 5});
+  auto value = [](size_t a, size_t b, size_t c, size_t d) { return static_cast<float>(((a * 3 + b) * 4 + c) * 5 + d); };
+
+  for (size_t axis = 0; axis < 4; ++axis) {
+    const Tensor view = base.slice(axis, 1, base.getShape()[axis] - 1);
+    auto expected = [&](size_t a, size_t b, size_t c, size_t d) {
+      size_t idx[] = {a, b, c, d};
+      idx[axis] += 1;
+      return value(idx[0], idx[1], idx[2], idx[3]);
+    };
+    const std::string label = "slice(" + std::to_string(axis) + ", 1, n-1)";
+    check(label + ": lectura", all(view, expected));
+    check(label + ": contiguo solo en el eje 0", view.isContiguous() == (axis == 0));
+    check(label + ": contiguous()", all(view.contiguous(), expected));
+  }
+
+  const Tensor transposed = base.transpose(1, 3);
+  auto transposedValue = [&](size_t a, size_t d, size_t c, size_t b) { return value(a, b, c, d); };
+  check("transpose(1, 3): lectura", all(transposed, transposedValue));
+  check("transpose(1, 3): contiguous() copia en orden row-major", isCompactCopy(transposed.contiguous(), transposedValue));
+
+  // Vista encadenada: columnas de una transpuesta, con offset y strides permutados.
+  const Tensor chained = base.transpose(2, 3).slice(2, 2, 3).slice(1, 1, 2);
+  auto chainedValue = [&](size_t a, size_t b, size_t d, size_t c) { return value(a, b + 1, c, d + 2); };
+  check("transpose(2, 3).slice(2).slice(1): lectura", all(chained, chainedValue));
+  check("transpose(2, 3).slice(2).slice(1): contiguous()", isCompactCopy(chained.contiguous(), chainedValue));
+
+  // Rango 3 (camino general de contiguous).
+  const Tensor cube = iota({2, 3, 4});
+  const Tensor cubeView = cube.transpose(0, 2).slice(1, 1, 2);
+  auto cubeValue = [](size_t c, size_t b, size_t a, size_t) { return static_cast<float>((a * 3 + b + 1) * 4 + c); };
+  check("rango 3: transpose(0, 2).slice(1): contiguous()", isCompactCopy(cubeView.contiguous(), cubeValue));
+
+  // Rango 2.
+  const Tensor matrix = iota({4, 6});
+  const Tensor columns = matrix.slice(1, 2, 3).transpose();
+  auto columnValue = [](size_t j, size_t i, size_t, size_t) { return static_cast<float>(i * 6 + j + 2); };
+  check("rango 2: slice(1).transpose(): contiguous()", isCompactCopy(columns.contiguous(), columnValue));
+}
+
+void testBroadcast() {
+  const Tensor plane = iota({2, 1, 3, 4});
+  const Tensor expanded = plane.expand(1, 3);
+  auto value = [](size_t a, size_t, size_t c, size_t d) { return static_cast<float>((a * 3 + c) * 4 + d); };
+  check("expand(1, 3): lectura y stride 0", all(expanded, value) && expanded.isBroadcast(1) && !expanded.isContiguous());
+
+  Tensor copy = expanded.contiguous();
+  check("expand(1, 3): contiguous() materializa las copias", isCompactCopy(copy, value) && !copy.isBroadcast(1));
+  copy(1, 2, 2, 3) = -1.0f;
+  check("expand(1, 3): contiguous() no comparte memoria con el original",
+        plane(1, 0, 2, 3) == value(1, 0, 2, 3) && copy(1, 0, 2, 3) == value(1, 0, 2, 3));
+
+  const Tensor sliced = expanded.slice(1, 1, 2).slice(2, 1, 2);
+  auto slicedValue = [&](size_t a, size_t b, size_t c, size_t d) { return value(a, b, c + 1, d); };
+  check("expand(1, 3).slice(1).slice(2): sigue siendo broadcast", sliced.isBroadcast(1) && all(sliced, slicedValue));
+  check("expand(1, 3).slice(1).slice(2): contiguous()", isCompactCopy(sliced.contiguous(), slicedValue));
+
+  const Tensor row = iota({1, 5});
+  const Tensor rows = row.expand(0, 4);
+  auto rowValue = [](size_t, size_t j, size_t, size_t) { return static_cast<float>(j); };
+  check("rango 2: expand(0, 4): contiguous()", isCompactCopy(rows.contiguous(), rowValue));
+
+  const Tensor cube = iota({1, 3, 2}).expand(0, 2);
+  auto cubeValue = [](size_t, size_t b, size_t c, size_t) { return static_cast<float>(b * 2 + c); };
+  check("rango 3: expand(0, 2): contiguous()", isCompactCopy(cube.contiguous(), cubeValue));
+}
+
+void testOperations() {
+  const Tensor base = iota({2, 3, 4, 5});
+  const Tensor transposed = base.transpose(2, 3);
+
+  const Tensor reshaped = transposed.reshape({2, 3, 20});
+  auto reshapedValue = [&](size_t a, size_t b, size_t k, size_t) { return base(a, b, k % 4, k / 4); };
+  check("reshape de una transpuesta copia en orden row-major", all(reshaped, reshapedValue));
+
+  const Tensor contiguousReshape = base.slice(0, 1, 1).reshape({3, 20});
+  check("reshape de una vista contigua no copia",
+        contiguousReshape.getDataOffset() == 60 && contiguousReshape.getData() == base.getData());
+
+  const Tensor summed = base.slice(3, 1, 3).sum(1);
+  auto sumValue = [&](size_t a, size_t, size_t c, size_t d) {
+    return base(a, 0, c, d + 1) + base(a, 1, c, d + 1) + base(a, 2, c, d + 1);
+  };
+  check("sum(1) sobre slice(3)", all(summed, sumValue));
+
+  Tensor target({2, 3, 5, 4});
+  target.copyFrom(transposed);
+  check("copyFrom desde una transpuesta", all(target, [&](size_t a, size_t b, size_t c, size_t d) {
+          return base(a, b, d, c);
+        }));
+
+  // C = A^T * B con A^T una vista transpuesta y B un bloque de columnas.
+  const Tensor a = iota({5, 3});
+  const Tensor b = iota({5, 7}).slice(1, 2, 4);
+  const Tensor product = matrixMultiply(a.transpose(), b);
+  check("matrixMultiply con operandos transpuestos y recortados", all(product, [&](size_t i, size_t j, size_t, size_t) {
+          float sum = 0.0f;
+          for (size_t k = 0; k < 5; ++k) {
+            sum += a(k, i) * b(k, j);
+          }
+          return sum;
+        }));
+}
+
+void testWrites() {
+  Tensor base = iota({2, 3, 4, 5});
+  const Tensor original = iota({2, 3, 4, 5});
+
+  Tensor columns = base.slice(3, 1, 2);
+  Tensor transposed = base.transpose(0, 2);
+  Tensor batch = base.slice(0, 1, 1);
+  columns(1, 2, 3, 1) = -1.0f; // base(1, 2, 3, 2)
+  transposed(2, 1, 0, 4) = -2.0f; // base(0, 1, 2, 4)
+  batch(0, 0, 1, 0) = -3.0f; // base(1, 0, 1, 0)
+  check("escritura por slice(3), transpose y slice(0)", all(base, [&](size_t a, size_t b, size_t c, size_t d) {
+          if (a == 1 && b == 2 && c == 3 && d == 2) {
+            return -1.0f;
+          }
+          if (a == 0 && b == 1 && c == 2 && d == 4) {
+            return -2.0f;
+          }
+          if (a == 1 && b == 0 && c == 1 && d == 0) {
+            return -3.0f;
+          }
+          return original(a, b, c, d);
+        }));
+
+  Tensor reshaped = batch.reshape({3, 20});
+  reshaped(2, 19) = -4.0f;
+  check("escritura por reshape de una vista contigua", base(1, 2, 3, 4) == -4.0f);
+
+  Tensor replacement({1, 3, 4, 5});
+  replacement.fill(7.0f);
+  batch.copyFrom(replacement);
+  check("copyFrom sobre slice(0) escribe solo ese bloque", all(base, [&](size_t a, size_t b, size_t c, size_t d) {
+          return a == 1 ? 7.0f : (a == 0 && b == 1 && c == 2 && d == 4 ? -2.0f : original(a, b, c, d));
+        }));
+
+  bool rejected = false;
+  try {
+    columns.copyFrom(Tensor({2, 3, 4, 2}));
+  } catch (const std::runtime_error &) {
+    rejected = true;
+  }
+  check("copyFrom sobre una vista no contigua se rechaza", rejected);
+}
+} // namespace
+
+int main() {
+  testReads();
+  testBroadcast();
+  testOperations();
+  testWrites();
+
+  if (failures) {
+    std::printf("%d casos fallaron.\n", failures);
+    return 1;
+  }
+  std::printf("Todas las pruebas de vistas de Tensor pasaron.\n");
+  return 0;
+}
@@ -0,0 +1,108 @@
+// Lanzador del entrenamiento distribuido: arranca P copias de un programa en esta maquina,
+// cada una con su rank en las variables de entorno que lee Communicator::from_environment.
+//
+// Uso: vit_launch [-n P] [--backend shm|tcp] [--port PUERTO] -- programa [argumentos...]
+//
+// Si OMP_NUM_THREADS no esta definida, reparte los nucleos entre los procesos. Si un
+// proceso falla, termina los demas (que si no se quedarian esperando en el anillo).
+#include <algorithm>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+void usage() {
+  std::cerr << "Uso: vit_launch [-n P] [--backend shm|tcp] [--port PUERTO] -- programa [argumentos...]" << std::endl;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  size_t world_size = 2;
+  std::string backend = "shm";
+  std::string port = "29500";
+  int command_start = -1;
+
+  try {
+    for (int i = 1; i < argc; ++i) {
+      const std::string arg = argv[i];
+      if (arg == "--") {
+        command_start = i + 1;
+        break;
+      }
+      if (i + 1 >= argc) {
+        usage();
+        return 2;
+      }
+      if (arg == "-n") {
+        world_size = std::stoul(argv[++i]);
+      } else if (arg == "--backend") {
+        backend = argv[++i];
+      } else if (arg == "--port") {
+        port = argv[++i];
+      } else {
+        usage();
+        return 2;
+      }
+    }
+  } catch (const std::exception &) {
+    usage();
+    return 2;
+  }
+  if (command_start < 0 || command_start >= argc || world_size == 0 || (backend != "shm" && backend != "tcp")) {
+    usage();
+    return 2;
+  }
+
+  const std::string job = std::to_string(getpid());
+  const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+  const std::string threads = std::to_string(std::max<size_t>(1, cores / world_size));
+
+  std::vector<pid_t> children;
+  for (size_t rank = 0; rank < world_size; ++rank) {
+    const pid_t pid = fork();
+    if (pid < 0) {
+      std::perror("fork");
+      for (pid_t child : children)
+        kill(child, SIGTERM);
+      return 1;
+    }
+    if (pid == 0) {
+      setenv("VIT_RANK", std::to_string(rank).c_str(), 1);
+      setenv("VIT_WORLD_SIZE", std::to_string(world_size).c_str(), 1);
+      setenv("VIT_DIST_BACKEND", backend.c_str(), 1);
+      setenv("VIT_DIST_PORT", port.c_str(), 1);
+      setenv("VIT_DIST_JOB", job.c_str(), 1);
+      setenv("OMP_NUM_THREADS", threads.c_str(), 0);
+      execvp(argv[command_start], argv + command_start);
+      std::perror("execvp");
+      _exit(127);
+    }
+    children.push_back(pid);
+  }
+
+  // Espera a todos; al primer fallo termina el resto.
+  int exit_code = 0;
+  size_t remaining = children.size();
+  while (remaining > 0) {
+    int status = 0;
+    const pid_t pid = wait(&status);
+    if (pid < 0)
+      break;
+    --remaining;
+    const bool failed = !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+    if (failed && exit_code == 0) {
+      exit_code = 1;
+      std::cerr << "vit_launch: el proceso " << pid << " termino con error; se detienen los demas." << std::endl;
+      for (pid_t child : children)
+        if (child != pid)
+          kill(child, SIGTERM);
+    }
+  }
+  return exit_code;
+}
@@ -1,11 +1,23 @@
 #include "model/Trainer.hpp"
-#include "utils/DataReader.hpp"
+#include "utils/Dataset.hpp"
+#include "utils/Distributed.hpp"
 #include "utils/ModelUtils.hpp"
+#include <chrono>
+#include <iomanip>
 #include <iostream>
+#include <memory>
 
 // Punto de entrada principal de la aplicacion.
 int main() {
   try {
+    // --- 0. Entrenamiento distribuido (opcional) ---
+    // Con vit_launch (ej. ./bin/vit_launch -n 4 -- ./bin/ViT) cada proceso entrena sobre su
+    // parte de los datos. Solo el rank 0 escribe en la salida estandar.
+    std::unique_ptr<Communicator> communicator = Communicator::from_environment();
+    const bool is_main_process = !communicator || communicator->rank() == 0;
+    if (!is_main_process)
+      std::cout.setstate(std::ios::failbit);
+
     // --- 1. Definir Configuraciones del Modelo y Entrenador ---
     ViTConfig model_config;
     // Hiperparametros de la arquitectura del Vision Transformer.
@@ -13,6 +25,13 @@ int main() {
     model_config.num_layers = 1;
     model_config.num_heads = 2;
     model_config.mlp_hidden_dim = model_config.embedding_dim * 4;
+    // Atencion fusionada por bloques; poner a false para usar la implementacion original.
+    model_config.use_flash_attention = true;
+    // Proyeccion Q, K, V empaquetada en un solo GEMM (pesos compatibles con la version separada).
+    model_config.fuse_qkv = true;
+    // Recalcula en backward las activaciones de cada bloque en lugar de guardarlas (menos
+    // memoria, permite batches mayores).
+    model_config.checkpoint_activations = false;
 
     TrainerConfig train_config;
     // Hiperparametros para el bucle de entrenamiento.
@@ -20,15 +39,30 @@ int main() {
     train_config.batch_size = 32;
     train_config.learning_rate = 0.0001f;
     train_config.weight_decay = 0.01f;
+    // Replicas del modelo (paralelismo de datos, un hilo por replica); 1 = desactivado.
+    train_config.data_parallel_replicas = 1;
+    // Etapas de pipeline (grupos de bloques en distintos nucleos, requiere num_layers >= etapas)
+    // y micro-batches por batch; 1 etapa = desactivado.
+    train_config.pipeline_stages = 1;
+    train_config.pipeline_micro_batches = 4;
+    // Batches acumulados por paso de Adam (batch efectivo = batch_size * accumulation_steps).
+    train_config.accumulation_steps = 1;
 
-    // --- 2. Cargar los datos de entrenamiento y prueba desde archivos CSV ---
+    // --- 2. Cargar los datos de entrenamiento y prueba ---
+    // Se proyecta la version binaria de cada CSV (se genera en la primera ejecucion).
+    // Con varios procesos, el rank 0 genera los binarios que falten y los demas esperan.
     std::cout << "--- Cargando Datos de Fashion MNIST ---" << std::endl;
-    auto train_data = load_csv_data("data/fashion_train.csv", 1.0f);
-    auto test_data = load_csv_data("data/fashion_test.csv", 1.0f);
+    if (!is_main_process)
+      communicator->barrier();
+    MappedDataset train_data = open_binary_dataset("data/fashion_train.csv");
+    MappedDataset test_data = open_binary_dataset("data/fashion_test.csv");
+    if (communicator && is_main_process)
+      communicator->barrier();
 
     // --- 3. Crear la instancia del modelo y pasarla al entrenador ---
     VisionTransformer model(model_config);
     Trainer trainer(model, train_config);
+    trainer.set_communicator(communicator.get());
 
     // --- 4. Iniciar el bucle de entrenamiento y evaluacion ---
     trainer.train(train_data, test_data);
@@ -37,8 +71,25 @@ int main() {
 
     // --- 5. Guardar los pesos del modelo entrenado para uso futuro ---
     const std::string weights_path = "vit_fashion_mnist.weights.1_2_64_32";
-    std::cout << "\nGuardando pesos del modelo entrenado en: " << weights_path << std::endl;
-    ModelUtils::save_weights(model, weights_path);
+    if (is_main_process) {
+      std::cout << "\nGuardando pesos del modelo entrenado en: " << weights_path << std::endl;
+      ModelUtils::save_weights(model, weights_path);
+    }
+
+    // --- 6. Inferencia int8: calibra con datos de entrenamiento y compara con float ---
+    // Tambien sirve tras ModelUtils::load_weights: la cuantizacion parte de los pesos float.
+    auto timed_evaluate = [&](const char *label) {
+      const auto start = std::chrono::steady_clock::now();
+      const auto [loss, acc] = trainer.evaluate(test_data);
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      std::cout << std::fixed << std::setprecision(4) << label << " | Test Loss: " << loss << " | Test Acc: " << acc << " | Tiempo: " << elapsed.count()
+                << "s" << std::endl;
+      return acc;
+    };
+    const float fp32_acc = timed_evaluate("float32");
+    ModelUtils::quantize_int8(model, train_data);
+    const float int8_acc = timed_evaluate("int8   ");
+    std::cout << "Diferencia de precision int8 - float32: " << int8_acc - fp32_acc << std::endl;
 
     std::cout << "\nProceso finalizado." << std::endl;
 
@@ -0,0 +1,69 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+
+// Mini arnes de microbenchmarks al estilo de Google Benchmark.
+//
+// Cada benchmark es una funcion que prepara sus datos y luego repite la operacion
+// medida dentro de 'while (state.keepRunning())'. El ejecutor elige el numero de
+// iteraciones hasta superar un tiempo minimo y repite cada caso para cada numero
+// de hilos de OpenMP pedido. Con los trabajos por iteracion declarados (flops y
+// bytes) se informan GFLOP/s y bytes/s, en una tabla y opcionalmente en JSON.
+//
+// Uso: bench [--filter=<regex>] [--threads=1,2,4] [--min_time=<segundos>] [--json=<archivo>]
+
+class BenchmarkState {
+public:
+  explicit BenchmarkState(size_t iterations) : maxIterations(iterations) {}
+
+  // Devuelve true mientras queden iteraciones. El cronometro arranca en la primera
+  // llamada, de modo que la preparacion previa al bucle no se mide.
+  bool keepRunning() {
+    if (!started) {
+      started = true;
+      start = std::chrono::steady_clock::now();
+    }
+    if (done < maxIterations) {
+      ++done;
+      return true;
+    }
+    end = std::chrono::steady_clock::now();
+    return false;
+  }
+
+  // Trabajo de una iteracion, para calcular GFLOP/s y bytes/s.
+  void setFlops(double flopsPerIteration) { flops = flopsPerIteration; }
+  void setBytes(double bytesPerIteration) { bytes = bytesPerIteration; }
+
+  size_t iterations() const { return done; }
+  double flopsPerIteration() const { return flops; }
+  double bytesPerIteration() const { return bytes; }
+  double seconds() const { return std::chrono::duration<double>(end - start).count(); }
+
+private:
+  size_t maxIterations;
+  size_t done = 0;
+  bool started = false;
+  double flops = 0.0;
+  double bytes = 0.0;
+  std::chrono::steady_clock::time_point start, end;
+};
+
+// Registra un benchmark. Los nombres siguen la forma "operacion/variante/forma".
+void registerBenchmark(const std::string &name, std::function<void(BenchmarkState &)> body);
+
+// Ejecuta los benchmarks registrados segun los argumentos de la linea de comandos.
+int runBenchmarks(int argc, char **argv);
+
+// Impide que el compilador elimine un calculo cuyo resultado no se usa.
+template <typename T> inline void doNotOptimize(const T &value) { asm volatile("" : : "r,m"(value) : "memory"); }
+
+// Registro de los benchmarks de cada archivo.
+void registerTensorBenchmarks();
+void registerLayerBenchmarks();
+
+#endif // BENCHMARK_HPP
@@ -0,0 +1,148 @@
+#include "Benchmark.hpp"
+#include "activations/GELU.hpp"
+#include "layers/LayerNorm.hpp"
+#include "layers/MultiHeadAttention.hpp"
+#include "optimizers/Adam.hpp"
+
+#include <memory>
+
+// Benchmarks de capas (forward y backward) y del optimizador.
+// Para las operaciones elemento a elemento los flops son nominales (ver cada caso);
+// en ellas la metrica util es el ancho de banda.
+
+namespace {
+Tensor randomTensor(const std::vector<size_t> &shape) {
+  Tensor t(shape);
+  t.randomize(-1.0f, 1.0f);
+  return t;
+}
+
+std::string tokensName(size_t batch, size_t tokens, size_t dim) {
+  return std::to_string(batch) + "x" + std::to_string(tokens) + "x" + std::to_string(dim);
+}
+
+// LayerNorm sobre {B, N, D}. Forward: ~8 flops por elemento (media, varianza, normalizacion
+// y afin); lee x y escribe y. Backward: ~12 flops; lee dY y x_hat, escribe dX.
+void layerNormBenchmarks(size_t batch, size_t tokens, size_t dim) {
+  const double elements = static_cast<double>(batch) * tokens * dim;
+  registerBenchmark("LayerNorm/forward/" + tokensName(batch, tokens, dim), [=](BenchmarkState &state) {
+    LayerNorm norm(dim);
+    Tensor x = randomTensor({batch, tokens, dim});
+    while (state.keepRunning())
+      doNotOptimize(norm.forward(x, false));
+    state.setFlops(8.0 * elements);
+    state.setBytes(8.0 * elements);
+  });
+  registerBenchmark("LayerNorm/backward/" + tokensName(batch, tokens, dim), [=](BenchmarkState &state) {
+    LayerNorm norm(dim);
+    Tensor x = randomTensor({batch, tokens, dim});
+    Tensor dy = randomTensor({batch, tokens, dim});
+    norm.forward(x, true);
+    while (state.keepRunning()) {
+      // backward suma a los gradientes: cada iteracion empieza de cero, como un paso.
+      norm.zeroGradients();
+      doNotOptimize(norm.backward(dy));
+    }
+    state.setFlops(12.0 * elements);
+    state.setBytes(12.0 * elements);
+  });
+}
+
+// GELU (aproximacion de tanh) sobre {B*N, H}: ~10 flops por elemento en forward y ~16 en backward.
+void geluBenchmarks(size_t rows, size_t hidden) {
+  const double elements = static_cast<double>(rows) * hidden;
+  const std::string shape = std::to_string(rows) + "x" + std::to_string(hidden);
+  registerBenchmark("GELU/forward/" + shape, [=](BenchmarkState &state) {
+    GELU gelu;
+    Tensor x = randomTensor({rows, hidden});
+    while (state.keepRunning())
+      doNotOptimize(gelu.forward(x, false));
+    state.setFlops(10.0 * elements);
+    state.setBytes(8.0 * elements);
+  });
+  registerBenchmark("GELU/backward/" + shape, [=](BenchmarkState &state) {
+    GELU gelu;
+    Tensor x = randomTensor({rows, hidden});
+    Tensor dy = randomTensor({rows, hidden});
+    gelu.forward(x, true);
+    while (state.keepRunning())
+      doNotOptimize(gelu.backward(dy));
+    state.setFlops(16.0 * elements);
+    state.setBytes(12.0 * elements);
+  });
+}
+
+// Atencion multi-cabeza sobre {B, N, D}. Forward: cuatro proyecciones (8*B*N*D^2) mas
+// Q*K^T y P*V (4*B*N^2*D). El backward se cuenta como el doble del forward.
+void attentionBenchmarks(size_t batch, size_t tokens, size_t dim, size_t heads, bool flash, bool fused) {
+  const double projections = 8.0 * batch * tokens * dim * dim;
+  const double scores = 4.0 * batch * tokens * tokens * dim;
+  const double activations = 4.0 * batch * tokens * dim;
+  const std::string variant = std::string(flash ? "flash" : "standard") + (fused ? "_fused" : "");
+  const std::string shape = tokensName(batch, tokens, dim) + "/h" + std::to_string(heads);
+
+  registerBenchmark("MultiHeadAttention/forward/" + variant + "/" + shape, [=](BenchmarkState &state) {
+    MultiHeadAttention mha(dim, heads, flash, fused);
+    Tensor x = randomTensor({batch, tokens, dim});
+    while (state.keepRunning())
+      doNotOptimize(mha.forward(x, false));
+    state.setFlops(projections + scores);
+    state.setBytes(2.0 * activations + 16.0 * dim * dim);
+  });
+  registerBenchmark("MultiHeadAttention/backward/" + variant + "/" + shape, [=](BenchmarkState &state) {
+    MultiHeadAttention mha(dim, heads, flash, fused);
+    Tensor x = randomTensor({batch, tokens, dim});
+    Tensor dy = randomTensor({batch, tokens, dim});
+    mha.forward(x, true);
+    while (state.keepRunning()) {
+      mha.zeroGradients();
+      doNotOptimize(mha.backward(dy));
+    }
+    state.setFlops(2.0 * (projections + scores));
+    state.setBytes(2.0 * activations + 32.0 * dim * dim);
+  });
+}
+
+// Adam sobre un conjunto de matrices {rows, cols}: ~14 flops por parametro. Lee
+// parametro, gradiente, m y v y escribe parametro, m y v (28 bytes por parametro).
+void adamBenchmark(size_t tensors, size_t rows, size_t cols) {
+  const double count = static_cast<double>(tensors) * rows * cols;
+  const std::string name = "Adam/update/" + std::to_string(tensors) + "x" + std::to_string(rows) + "x" + std::to_string(cols);
+  registerBenchmark(name, [=](BenchmarkState &state) {
+    std::vector<Tensor> params, grads;
+    for (size_t i = 0; i < tensors; ++i) {
+      params.push_back(randomTensor({rows, cols}));
+      grads.push_back(randomTensor({rows, cols}));
+    }
+    std::vector<Tensor *> paramPtrs, gradPtrs;
+    for (size_t i = 0; i < tensors; ++i) {
+      paramPtrs.push_back(&params[i]);
+      gradPtrs.push_back(&grads[i]);
+    }
+    Adam adam(1e-4f, 0.9f, 0.999f, 1e-8f, 0.01f);
+    adam.update(paramPtrs, gradPtrs); // Reserva los momentos fuera de la medicion.
+    while (state.keepRunning())
+      adam.update(paramPtrs, gradPtrs);
+    state.setFlops(14.0 * count);
+    state.setBytes(28.0 * count);
+  });
+}
+} // namespace
+
+void registerLayerBenchmarks() {
+  layerNormBenchmarks(32, 50, 64);
+  layerNormBenchmarks(32, 197, 768);
+
+  geluBenchmarks(1600, 256);
+  geluBenchmarks(6304, 3072);
+
+  for (bool flash : {false, true})
+    for (bool fused : {false, true})
+      attentionBenchmarks(32, 50, 64, 2, flash, fused);
+  attentionBenchmarks(8, 197, 256, 8, false, true);
+  attentionBenchmarks(8, 197, 256, 8, true, true);
+
+  // Parametros de un bloque del ViT de ejemplo y un conjunto grande (~4M parametros).
+  adamBenchmark(8, 64, 256);
+  adamBenchmark(16, 512, 512);
+}
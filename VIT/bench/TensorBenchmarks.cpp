@@ -0,0 +1,108 @@
+#include "Benchmark.hpp"
+#include "core/FlashAttention.hpp"
+#include "core/Quantization.hpp"
+#include "core/Tensor.hpp"
+
+#include <cmath>
+
+// Benchmarks de las operaciones de Tensor: GEMM (float, bfloat16 e int8), BMM y atencion fusionada.
+// Las formas cubren matrices cuadradas y las que aparecen en el ViT de app/main.cpp
+// (lote 32, 50 tokens, D = 64, MLP de 256, 2 cabezas).
+
+namespace {
+Tensor randomTensor(const std::vector<size_t> &shape) {
+  Tensor t(shape);
+  t.randomize(-1.0f, 1.0f);
+  return t;
+}
+
+std::string dims(std::initializer_list<size_t> values) {
+  std::string text;
+  for (size_t v : values)
+    text += (text.empty() ? "" : "x") + std::to_string(v);
+  return text;
+}
+
+// C{m, n} = A{m, k} * B{k, n}. Con transposedB, B es la vista transpuesta de un {n, k}.
+void gemmBenchmark(size_t m, size_t k, size_t n, bool transposedB) {
+  const std::string name = std::string("matrixMultiply/") + (transposedB ? "bT/" : "") + dims({m, k, n});
+  registerBenchmark(name, [=](BenchmarkState &state) {
+    Tensor a = randomTensor({m, k});
+    Tensor b = transposedB ? randomTensor({n, k}).transpose(0, 1) : randomTensor({k, n});
+    Tensor c = Tensor::uninitialized({m, n});
+    while (state.keepRunning())
+      matrixMultiply(a, b, c);
+    state.setFlops(2.0 * m * k * n);
+    state.setBytes(4.0 * (m * k + k * n + m * n));
+  });
+}
+
+// Mismo producto con B cuantizada a int8 (inferencia); A se cuantiza en cada llamada.
+void qgemmBenchmark(size_t m, size_t k, size_t n) {
+  registerBenchmark("qgemm/int8/" + dims({m, k, n}), [=](BenchmarkState &state) {
+    Tensor a = randomTensor({m, k});
+    Tensor b = randomTensor({k, n});
+    Tensor bias = randomTensor({1, n});
+    const QuantizedMatrix quantized(b.getData(), k, n, n, 1, 1.0f / 127.0f, bias.getData());
+    Tensor c = Tensor::uninitialized({m, n});
+    while (state.keepRunning())
+      qgemm(m, a.getData(), k, 1, quantized, c.getData(), n);
+    state.setFlops(2.0 * m * k * n);
+    state.setBytes(4.0 * (m * k + m * n) + 1.0 * k * n);
+  });
+}
+
+// Lote de productos {batch, m, k} x {batch, k, n}, como Q*K^T y P*V de la atencion.
+void bmmBenchmark(size_t batch, size_t m, size_t k, size_t n) {
+  registerBenchmark("batchMatrixMultiply/" + dims({batch, m, k, n}), [=](BenchmarkState &state) {
+    Tensor a = randomTensor({batch, m, k});
+    Tensor b = randomTensor({batch, k, n});
+    Tensor c = Tensor::uninitialized({batch, m, n});
+    while (state.keepRunning())
+      batchMatrixMultiply(a, b, c);
+    state.setFlops(2.0 * batch * m * k * n);
+    state.setBytes(4.0 * batch * (m * k + k * n + m * n));
+  });
+}
+
+// Atencion fusionada sobre {batch*heads, tokens, headDim}: dos productos de N x N x d_h.
+void flashBenchmark(size_t batchHeads, size_t tokens, size_t headDim) {
+  registerBenchmark("flashAttention/forward/" + dims({batchHeads, tokens, headDim}), [=](BenchmarkState &state) {
+    Tensor q = randomTensor({batchHeads, tokens, headDim});
+    Tensor k = randomTensor({batchHeads, tokens, headDim});
+    Tensor v = randomTensor({batchHeads, tokens, headDim});
+    Tensor out = Tensor::uninitialized({batchHeads, tokens, headDim});
+    Tensor lse = Tensor::uninitialized({batchHeads, tokens});
+    const float scale = 1.0f / std::sqrt(static_cast<float>(headDim));
+    while (state.keepRunning())
+      flashAttentionForward(q, k, v, scale, out, lse);
+    state.setFlops(4.0 * batchHeads * tokens * tokens * headDim);
+    state.setBytes(4.0 * batchHeads * tokens * (4 * headDim + 1));
+  });
+}
+} // namespace
+
+void registerTensorBenchmarks() {
+  for (size_t n : {64, 128, 256, 512, 1024})
+    gemmBenchmark(n, n, n, false);
+  // Proyecciones y MLP del ViT: {B*T, D} x {D, D}, {D, 4D} y {4D, D}.
+  gemmBenchmark(1600, 64, 64, false);
+  gemmBenchmark(1600, 64, 256, false);
+  gemmBenchmark(1600, 256, 64, false);
+  // Gradiente de la entrada: dY * W^T con W transpuesta como vista.
+  gemmBenchmark(1600, 64, 64, true);
+  gemmBenchmark(1600, 256, 64, true);
+  // Inferencia cuantizada: los mismos productos del ViT en int8.
+  qgemmBenchmark(1600, 64, 64);
+  qgemmBenchmark(1600, 64, 256);
+  qgemmBenchmark(1600, 256, 64);
+
+  // Q*K^T y P*V con 2 y 8 cabezas.
+  bmmBenchmark(64, 50, 32, 50);
+  bmmBenchmark(64, 50, 50, 32);
+  bmmBenchmark(256, 197, 64, 197);
+  bmmBenchmark(256, 197, 197, 64);
+
+  flashBenchmark(64, 50, 32);
+  flashBenchmark(256, 197, 64);
+}
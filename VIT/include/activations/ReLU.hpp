@@ -16,9 +16,14 @@ public:
   // Calcula el gradiente de la funcion ReLU.
   Tensor backward(const Tensor &outputGradient) override;
 
+  void releaseActivations() override { inputTensor = Tensor(); }
+
   // Devuelve el nombre de la capa.
   std::string getName() const override { return "ReLU"; }
 
+  // Una comparacion por elemento.
+  double getFlops(const std::vector<size_t> &inputShape) const override;
+
 private:
   // Almacena la entrada para el calculo del gradiente en backward.
   Tensor inputTensor;
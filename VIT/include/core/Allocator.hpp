@@ -0,0 +1,102 @@
+#ifndef ALLOCATOR_HPP
+#define ALLOCATOR_HPP
+
+#include <cstddef>
+#include <memory>
+
+// Asignadores de memoria para los datos de los tensores.
+//
+// Cada Tensor propietario pide su bloque al asignador activo y lo devuelve al
+// destruirse el ultimo tensor o vista que lo comparte. Todos los bloques estan
+// alineados a 64 bytes (una linea de cache, un registro AVX-512).
+//
+// Hay dos implementaciones:
+//  - SystemAllocator: una reserva del sistema por tensor (comportamiento original).
+//  - PoolAllocator: clases de tamaño con listas libres. Un paso de entrenamiento
+//    reutiliza los bloques que libero el anterior, sin malloc/free ni fallos de pagina.
+// La variable de entorno VIT_ALLOCATOR (system, pool) elige el asignador por defecto.
+
+// Contadores de un asignador (en bytes salvo las cuentas de llamadas).
+struct AllocatorStats {
+  size_t allocations = 0;       // Llamadas a allocate().
+  size_t systemAllocations = 0; // De ellas, las que pidieron memoria al sistema.
+  size_t bytesAllocated = 0;    // Total entregado por allocate() (acumulado).
+  size_t bytesInUse = 0;        // Memoria entregada a tensores vivos.
+  size_t bytesCached = 0;       // Memoria en listas libres, lista para reutilizar.
+  size_t peakBytesInUse = 0;    // Maximo de bytesInUse.
+};
+
+class Allocator {
+public:
+  virtual ~Allocator() = default;
+
+  // Reserva 'count' floats sin inicializar, alineados a 64 bytes.
+  virtual float *allocate(size_t count) = 0;
+  // Devuelve un bloque obtenido con allocate(count).
+  virtual void deallocate(float *ptr, size_t count) = 0;
+
+  // Marca el final de un paso (un lote de entrenamiento). El pool libera aqui la
+  // memoria cacheada que no se ha reutilizado durante el paso.
+  virtual void resetStep() {}
+
+  virtual AllocatorStats stats() const = 0;
+  virtual const char *name() const = 0;
+
+  // Reinicia el pico a max(floor, bytesInUse) y devuelve el pico anterior. Sirve para
+  // medir el pico de un intervalo (el Profiler lo usa por capa).
+  virtual size_t resetPeak(size_t floor) = 0;
+};
+
+// Reserva y libera cada bloque directamente con el sistema.
+class SystemAllocator : public Allocator {
+public:
+  SystemAllocator();
+  ~SystemAllocator() override;
+
+  float *allocate(size_t count) override;
+  void deallocate(float *ptr, size_t count) override;
+  AllocatorStats stats() const override;
+  const char *name() const override { return "system"; }
+  size_t resetPeak(size_t floor) override;
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> impl;
+};
+
+// Pool por clases de tamaño (cuatro clases por potencia de dos, desperdicio < 25%).
+// Es seguro entre hilos: cada hilo reserva y libera en sus propias listas libres y solo
+// acude a un pool compartido cuando la suya esta vacia o llena, asi que los hilos de
+// OpenMP no se disputan un unico mutex. En resetStep() devuelve al sistema, por cada
+// lista, tantos bloques como el minimo de bloques libres observado durante el paso: esos
+// bloques no se necesitaron y la memoria cacheada queda acotada por el pico de un paso.
+class PoolAllocator : public Allocator {
+public:
+  PoolAllocator();
+  ~PoolAllocator() override;
+
+  float *allocate(size_t count) override;
+  void deallocate(float *ptr, size_t count) override;
+  void resetStep() override;
+  AllocatorStats stats() const override;
+  const char *name() const override { return "pool"; }
+  size_t resetPeak(size_t floor) override;
+
+  // Libera toda la memoria cacheada.
+  void trim();
+
+private:
+  struct Impl;
+  // Compartido con las caches de cada hilo, que pueden terminar despues que el pool.
+  std::shared_ptr<Impl> impl;
+};
+
+// Asignador usado por los nuevos tensores. Los bloques ya reservados siempre vuelven
+// al asignador que los creo, por lo que se puede cambiar en cualquier momento.
+const std::shared_ptr<Allocator> &getAllocator();
+void setAllocator(std::shared_ptr<Allocator> allocator);
+
+// Bloque de datos de un tensor: al liberarse vuelve a su asignador.
+std::shared_ptr<float[]> allocateStorage(size_t count, bool zeroFill);
+
+#endif // ALLOCATOR_HPP
@@ -0,0 +1,36 @@
+#ifndef FLASHATTENTION_HPP
+#define FLASHATTENTION_HPP
+
+#include "core/Tensor.hpp"
+
+// Atencion escalada por producto punto fusionada y por bloques (estilo FlashAttention).
+//
+// Calcula softmax(Q * K^T * scale) * V sin construir nunca la matriz de puntuaciones
+// de N x N: para cada bloque de filas de Q recorre K y V por bloques y mantiene un
+// softmax "online" (maximo y suma acumulados por fila), reescalando el acumulador de
+// salida cada vez que aparece un maximo mayor. La memoria extra es O(N) por cabeza.
+//
+// q, k, v tienen forma {B*h, N, d_h} o {B, h, N, d_h}. Pueden ser vistas con strides
+// arbitrarios en las dimensiones de lote y de fila (p. ej. la division de cabezas
+// {B, N, h, d_h}.transpose(1, 2)) siempre que la ultima dimension sea contigua.
+
+// Paso hacia adelante. Devuelve la salida con la forma de q y escribe en 'logSumExp'
+// ({B*h, N}) el log de la suma de exponenciales de cada fila, que es todo lo que el
+// backward necesita para reconstruir las probabilidades.
+Tensor flashAttentionForward(const Tensor &q, const Tensor &k, const Tensor &v, float scale, Tensor &logSumExp);
+
+// Igual que el anterior pero escribe la salida en 'output', que debe tener la forma
+// de q y puede ser una vista (p. ej. sobre el buffer {B, N, D} ya re-ensamblado).
+// Si 'logSumExp' ya es un tensor contiguo {B*h, N} se escribe en el sin reservar memoria.
+void flashAttentionForward(const Tensor &q, const Tensor &k, const Tensor &v, float scale, Tensor &output,
+                           Tensor &logSumExp);
+
+// Paso hacia atras. Recalcula los bloques de probabilidades a partir de Q, K y
+// 'logSumExp' en lugar de guardarlos. 'output' es la salida del forward y
+// 'outputGradient' su gradiente. dQ, dK y dV son destinos con la forma de q, k y v
+// (pueden ser vistas) y se sobrescriben.
+void flashAttentionBackward(const Tensor &q, const Tensor &k, const Tensor &v, const Tensor &output,
+                            const Tensor &logSumExp, const Tensor &outputGradient, float scale, Tensor &dQ, Tensor &dK,
+                            Tensor &dV);
+
+#endif // FLASHATTENTION_HPP
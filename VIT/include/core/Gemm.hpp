@@ -0,0 +1,20 @@
+#ifndef GEMM_HPP
+#define GEMM_HPP
+
+#include <cstddef>
+
+// Nucleo GEMM (General Matrix Multiply) empaquetado y por bloques de cache.
+//
+// Calcula C (m x n) = A (m x k) * B (k x n), o C += A * B si 'accumulate' es true.
+// A y B se describen con un puntero y sus strides de fila y columna, de modo que
+// las vistas transpuestas o con offset se consumen directamente sin copiarlas.
+// C debe tener stride de columna 1 (filas contiguas), con stride de fila 'rsC'.
+//
+// Internamente divide el problema en bloques que caben en las caches (KC x NC de B
+// y MC x KC de A), empaqueta cada bloque en un buffer contiguo y lo recorre con un
+// microkernel que mantiene un tile de MR x NR elementos de C en registros.
+// Si se llama dentro de una region paralela de OpenMP se ejecuta en serie.
+void sgemm(size_t m, size_t n, size_t k, const float *a, size_t rsA, size_t csA, const float *b, size_t rsB, size_t csB,
+           float *c, size_t rsC, bool accumulate = false);
+
+#endif // GEMM_HPP
@@ -0,0 +1,112 @@
+#ifndef KERNELS_HPP
+#define KERNELS_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+// Libreria de kernels vectorizados para las operaciones elemento a elemento y
+// por filas del modelo (GELU, softmax, LayerNorm, Adam, sumas, reducciones...).
+//
+// Cada nivel de instrucciones SIMD (escalar, SSE4.1, AVX2+FMA, AVX-512, AVX-512 con
+// VNNI) se compila en su propia unidad de traduccion. Al arrancar se consulta la CPU
+// (cpuid) y se elige la mejor tabla disponible. La variable de entorno VIT_SIMD
+// (scalar, sse4.1, avx2, avx512, avx512vnni) permite forzar un nivel inferior.
+//
+// Todos los kernels trabajan sobre memoria contigua; los llamadores deben usar
+// su propio camino generico para vistas con strides.
+
+// Tamaño del tile de C del microkernel GEMM (filas x columnas).
+constexpr size_t GEMM_MR = 6;
+constexpr size_t GEMM_NR = 16;
+
+// Hiperparametros de un paso de Adam. bias1 y bias2 son (1 - beta^t).
+struct AdamStep {
+  float learningRate;
+  float beta1;
+  float beta2;
+  float epsilon;
+  float weightDecay;
+  float bias1;
+  float bias2;
+};
+
+// Salida del microkernel int8: c[r][j] = float(acc[r][j] - zeroCorrection[j]) * scale[j] + bias[j].
+// Los punteros apuntan a la primera columna del tile.
+struct Int8Output {
+  const int32_t *zeroCorrection;
+  const float *scale;
+  const float *bias;
+};
+
+struct KernelTable {
+  // Nombre del nivel SIMD ("scalar", "sse4.1", "avx2", "avx512", "avx512vnni").
+  const char *name;
+
+  // out = a + b
+  void (*add)(const float *a, const float *b, float *out, size_t n);
+  // out = a * b
+  void (*mul)(const float *a, const float *b, float *out, size_t n);
+  // x *= alpha
+  void (*scale)(float *x, float alpha, size_t n);
+  // y += alpha * x
+  void (*axpy)(float alpha, const float *x, float *y, size_t n);
+
+  // Reducciones sobre una fila.
+  float (*sum)(const float *x, size_t n);
+  float (*max)(const float *x, size_t n);
+  float (*dot)(const float *a, const float *b, size_t n);
+
+  // out = exp(x - shift); devuelve la suma de out.
+  float (*expSum)(const float *x, float *out, size_t n, float shift);
+  // Softmax numericamente estable de una fila: out = exp(x - max) / sum.
+  void (*softmaxRow)(const float *x, float *out, size_t n);
+  // Gradiente del softmax de una fila: out = s * (g - dot(g, s)).
+  void (*softmaxBackwardRow)(const float *grad, const float *s, float *out, size_t n);
+  // Igual que el anterior pero con dot(g, s) ya calculado: out = s * (g - rowDot).
+  void (*softmaxGradRow)(const float *grad, const float *s, float rowDot, float *out, size_t n);
+
+  // GELU con la aproximacion de tanh y su derivada (out = dGELU/dx * grad).
+  void (*geluForward)(const float *x, float *out, size_t n);
+  void (*geluBackward)(const float *x, const float *grad, float *out, size_t n);
+
+  // Normaliza una fila: y = gamma * (x - mean) * invStd + beta.
+  // Si xHat no es nulo guarda la entrada normalizada. Devuelve media e invStd.
+  void (*layerNormRow)(const float *x, const float *gamma, const float *beta, float *xHat, float *y, size_t n,
+                       float epsilon, float *mean, float *invStd);
+
+  // Paso de Adam (con weight decay L2) sobre un bloque contiguo de parametros.
+  void (*adamUpdate)(float *param, const float *grad, float *m, float *v, size_t n, const AdamStep &step);
+
+  // Microkernel GEMM sobre paneles empaquetados de GEMM_MR x kc (A) y kc x GEMM_NR (B).
+  // Puede ser nulo; en ese caso se usa el microkernel generico de Gemm.cpp.
+  void (*gemmMicroKernel)(size_t kc, const float *a, const float *b, float *c, size_t rsC, size_t mr, size_t nr,
+                          bool accumulate);
+
+  // Cuantiza activaciones a uint8 con punto cero 128: out = clamp(round(x * invScale), -127, 127) + 128.
+  void (*quantizeU8)(const float *x, float invScale, uint8_t *out, size_t n);
+
+  // Microkernel GEMM en int8 de la inferencia cuantizada (core/Quantization.hpp): A sin
+  // signo por B con signo, acumulado en int32 y devuelto a float con 'out'. Los paneles
+  // agrupan k de 4 en 4: A[(q * GEMM_MR + r) * 4 + t] y B[(q * GEMM_NR + j) * 4 + t]
+  // guardan el elemento k = 4q + t. Solo escribe las mr x nr posiciones validas de C.
+  void (*gemmMicroKernelU8S8)(size_t kQuads, const uint8_t *a, const int8_t *b, const Int8Output &out, float *c,
+                              size_t rsC, size_t mr, size_t nr);
+};
+
+// Devuelve la tabla de kernels seleccionada para esta CPU (se resuelve una sola vez).
+const KernelTable &kernels();
+
+// Divide [0, n) en bloques y los reparte entre los hilos de OpenMP.
+// 'body(begin, count)' se llama una vez por bloque.
+template <typename Body> void parallelChunks(size_t n, Body &&body) {
+  constexpr size_t CHUNK = 16384;
+  const size_t chunks = (n + CHUNK - 1) / CHUNK;
+#pragma omp parallel for if (chunks > 1)
+  for (size_t c = 0; c < chunks; ++c) {
+    const size_t begin = c * CHUNK;
+    body(begin, std::min(CHUNK, n - begin));
+  }
+}
+
+#endif // KERNELS_HPP
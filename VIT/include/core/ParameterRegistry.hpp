@@ -0,0 +1,51 @@
+#ifndef PARAMETERREGISTRY_HPP
+#define PARAMETERREGISTRY_HPP
+
+#include "core/Tensor.hpp"
+#include <vector>
+
+// Registro plano de los parametros de un modelo.
+//
+// Copia todos los parametros en un unico buffer alineado y sus gradientes en otro con la
+// misma disposicion, y rehace cada tensor de la lista como vista de su tramo. Asi el
+// optimizador recorre parametros, gradientes y momentos de una sola pasada vectorizada en
+// lugar de lanzar una region paralela por tensor, y el all-reduce o el broadcast pueden
+// usar el buffer tal cual.
+//
+// Los tensores de la lista que comparten memoria (los bloques Q, K, V de QKVProjection)
+// se trasladan juntos y conservan sus posiciones relativas; sus gradientes deben tener la
+// misma disposicion. Cada tramo empieza en un multiplo de 64 bytes y el relleno queda a
+// cero en los dos buffers, asi que un paso de Adam sobre el buffer completo lo deja a cero.
+//
+// Las capas siguen trabajando con sus tensores. Lo que guarde una copia de un tensor
+// anterior al registro (ej. la matriz empaquetada de QKVProjection) sigue viendo la memoria
+// vieja y tiene que volver a derivarla de sus vistas.
+class ParameterRegistry {
+public:
+  ParameterRegistry() = default;
+
+  // parameters[i] y gradients[i] deben tener la misma forma. Lanza invalid_argument si un
+  // grupo de gradientes no reproduce la disposicion de sus parametros.
+  ParameterRegistry(const std::vector<Tensor *> &parameters, const std::vector<Tensor *> &gradients);
+
+  // Numero de floats de cada buffer, relleno incluido.
+  size_t size() const { return parameterBuffer.getSize(); }
+
+  float *parameterData() { return parameterBuffer.getData(); }
+  float *gradientData() { return gradientBuffer.getData(); }
+
+  // Los tensores registrados, ya como vistas de los buffers.
+  const std::vector<Tensor *> &getParameters() const { return parameters; }
+  const std::vector<Tensor *> &getGradients() const { return gradients; }
+
+  // Pone a cero todos los gradientes con un solo recorrido.
+  void zeroGradients();
+
+private:
+  std::vector<Tensor *> parameters;
+  std::vector<Tensor *> gradients;
+  Tensor parameterBuffer; // {size()}
+  Tensor gradientBuffer;  // {size()}
+};
+
+#endif // PARAMETERREGISTRY_HPP
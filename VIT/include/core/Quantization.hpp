@@ -0,0 +1,78 @@
+#ifndef QUANTIZATION_HPP
+#define QUANTIZATION_HPP
+
+#include "core/Tensor.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// Inferencia cuantizada a int8 (post-training quantization) de las proyecciones lineales.
+//
+// - Pesos: int8 simetricos con una escala por columna (canal de salida), max|W[:, j]| / 127.
+// - Activaciones de entrada: uint8 con punto cero 128 y una escala fija por capa, sacada
+//   del rango max|x| observado durante la calibracion (x ~ escala * (q - 128)).
+// - Producto en int32 con el microkernel u8 x s8 (VNNI si la CPU lo tiene), corregido por
+//   el punto cero y devuelto a float con el bias sumado.
+//
+// Los pesos en float siguen en el modelo: la version int8 es una copia que se genera a
+// partir de ellos (ej. tras ModelUtils::load_weights), asi que el archivo de pesos no cambia.
+
+// Matriz B {k, n} cuantizada y empaquetada junto con la escala de la entrada y el bias.
+class QuantizedMatrix {
+public:
+  QuantizedMatrix() = default;
+  // Cuantiza B (strides rsB, csB) por columnas. 'inputScale' es la escala de A y
+  // 'bias' (n floats, puede ser nulo) se suma a la salida.
+  QuantizedMatrix(const float *b, size_t k, size_t n, size_t rsB, size_t csB, float inputScale, const float *bias);
+
+  size_t rows() const { return k; }
+  size_t cols() const { return n; }
+  bool empty() const { return n == 0; }
+
+private:
+  friend void qgemm(size_t m, const float *a, size_t rsA, size_t csA, const QuantizedMatrix &b, float *c, size_t rsC);
+
+  size_t k = 0;
+  size_t n = 0;
+  size_t kQuads = 0;
+  float invInputScale = 0.0f;
+  std::vector<int8_t> panels;         // [n / NR][k / 4][NR][4], ver KernelTable::gemmMicroKernelU8S8.
+  std::vector<int32_t> zeroCorrection; // 128 * sum(Bq[:, j]): lo que aporta el punto cero de A.
+  std::vector<float> outputScale;     // inputScale * escala de la columna j.
+  std::vector<float> bias;
+};
+
+// C (m x n) = A (m x k) * B + bias, con A cuantizada a uint8 al empaquetarla.
+// C debe tener filas contiguas (stride de columna 1). Se paraleliza por bloques de filas
+// salvo dentro de una region paralela de OpenMP.
+void qgemm(size_t m, const float *a, size_t rsA, size_t csA, const QuantizedMatrix &b, float *c, size_t rsC);
+
+// Modo de ejecucion int8 de una capa.
+// - Off: forward en float.
+// - Calibrate: forward en float registrando el rango de las entradas.
+// - Quantized: forward de inferencia (isTraining = false) en int8. El entrenamiento sigue en float.
+enum class Int8Mode { Off, Calibrate, Quantized };
+
+// Estado int8 de una proyeccion lineal Y = X * W + b (Dense, QKVProjection).
+class Int8Linear {
+public:
+  Int8Mode getMode() const { return mode; }
+  bool isQuantized() const { return mode == Int8Mode::Quantized; }
+
+  // Calibrate reinicia el rango observado; Quantized cuantiza W {k, n} y b {1, n} con ese
+  // rango (lanza si la capa no vio ninguna entrada); Off libera la copia int8.
+  void setMode(Int8Mode newMode, const Tensor &weights, const Tensor &bias);
+
+  // En modo Calibrate acumula max|x| de la entrada; en los demas no hace nada.
+  void observe(const Tensor &input);
+
+  // output {rows, n} (contiguo) = input {rows, k} * W + b en int8.
+  void forward(const Tensor &input, Tensor &output) const;
+
+private:
+  Int8Mode mode = Int8Mode::Off;
+  float absMax = 0.0f;
+  QuantizedMatrix matrix;
+};
+
+#endif // QUANTIZATION_HPP
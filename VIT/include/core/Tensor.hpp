@@ -29,6 +29,9 @@ public:
   explicit Tensor(const std::vector<size_t> &shape);
   // Constructor que crea un tensor a partir de una forma y datos existentes.
   Tensor(const std::vector<size_t> &shape, const std::vector<float> &data);
+  // Crea un tensor sin inicializar sus datos. Solo para buffers que se van a
+  // sobrescribir por completo (salidas de GEMM, copias, resultados elemento a elemento).
+  static Tensor uninitialized(const std::vector<size_t> &shape);
   // Constructores y operadores de copia y movimiento por defecto.
   Tensor(const Tensor &other) = default;
   Tensor(Tensor &&other) noexcept = default;
@@ -71,7 +74,7 @@ public:
 
   // --- Inicializacion y Modificacion ---
 
-  // Rellena todo el tensor con un valor escalar.
+  // Rellena todo el tensor con un valor escalar (contiguo o vista 2D con filas contiguas).
   void fill(float value);
   // Inicializa el tensor con valores aleatorios de una distribucion uniforme.
   void randomize(float min = -1.0f, float max = 1.0f);
@@ -88,8 +91,8 @@ public:
   const std::vector<size_t> &getStrides() const { return strides; }
   // Devuelve el desplazamiento inicial dentro del bloque de datos.
   size_t getDataOffset() const { return dataOffset; }
-  // Devuelve el puntero compartido al vector de datos subyacente.
-  const std::shared_ptr<std::vector<float>> &getDataPtr() const { return dataPtr; }
+  // Devuelve el puntero compartido al bloque de datos subyacente.
+  const std::shared_ptr<float[]> &getDataPtr() const { return dataPtr; }
   // Devuelve un puntero constante a los datos brutos del tensor.
   const float *getData() const;
   // Devuelve un puntero a los datos brutos del tensor.
@@ -101,7 +104,7 @@ public:
   // Imprime informacion de depuracion sobre el estado interno del tensor.
   void printDebugInfo(const std::string &name) const;
 
-  Tensor(std::shared_ptr<std::vector<float>> dataPtr, const std::vector<size_t> &shape, const std::vector<size_t> &strides,
+  Tensor(std::shared_ptr<float[]> dataPtr, const std::vector<size_t> &shape, const std::vector<size_t> &strides,
          size_t offset);
 
 private:
@@ -111,7 +114,7 @@ private:
   void computeStrides();
 
   // Puntero compartido al bloque de datos. Permite que varias vistas compartan memoria.
-  std::shared_ptr<std::vector<float>> dataPtr;
+  std::shared_ptr<float[]> dataPtr;
   // Dimensiones del tensor (ej. {lote, canales, alto, ancho}).
   std::vector<size_t> shape;
   // Pasos en memoria para navegar cada dimension. Clave para las vistas.
@@ -127,9 +130,16 @@ private:
 // Realiza la multiplicacion de matrices entre dos tensores 2D.
 Tensor matrixMultiply(const Tensor &a, const Tensor &b);
 
-// Realiza la multiplicacion de matrices por lotes (BMM) en tensores 3D.
+// Multiplicacion de matrices que escribe en 'out' (o acumula si 'accumulate'), que puede ser una vista.
+void matrixMultiply(const Tensor &a, const Tensor &b, Tensor &out, bool accumulate = false);
+
+// Realiza la multiplicacion de matrices por lotes (BMM) en tensores 3D o 4D.
+// Los operandos pueden ser vistas con strides (p. ej. {B, N, h, d_h} transpuesto a {B, h, N, d_h}).
 Tensor batchMatrixMultiply(const Tensor &a, const Tensor &b);
 
+// BMM que escribe en 'out' (o acumula si 'accumulate'), que puede ser una vista con strides.
+void batchMatrixMultiply(const Tensor &a, const Tensor &b, Tensor &out, bool accumulate = false);
+
 // --- Implementaciones Inline (para rendimiento) ---
 
 inline float &Tensor::operator()(size_t i) {
@@ -137,7 +147,7 @@ inline float &Tensor::operator()(size_t i) {
   if (shape.size() != 1 || i >= shape[0])
     throw std::out_of_range("Acceso 1D fuera de rango.");
 #endif
-  return (*dataPtr)[dataOffset + i * strides[0]];
+  return dataPtr[dataOffset + i * strides[0]];
 }
 
 inline const float &Tensor::operator()(size_t i) const {
@@ -145,7 +155,7 @@ inline const float &Tensor::operator()(size_t i) const {
   if (shape.size() != 1 || i >= shape[0])
     throw std::out_of_range("Acceso 1D fuera de rango.");
 #endif
-  return (*dataPtr)[dataOffset + i * strides[0]];
+  return dataPtr[dataOffset + i * strides[0]];
 }
 
 inline float &Tensor::operator()(size_t i, size_t j) {
@@ -153,7 +163,7 @@ inline float &Tensor::operator()(size_t i, size_t j) {
   if (shape.size() != 2 || i >= shape[0] || j >= shape[1])
     throw std::out_of_range("Acceso 2D fuera de rango.");
 #endif
-  return (*dataPtr)[dataOffset + i * strides[0] + j * strides[1]];
+  return dataPtr[dataOffset + i * strides[0] + j * strides[1]];
 }
 
 inline const float &Tensor::operator()(size_t i, size_t j) const {
@@ -161,7 +171,7 @@ inline const float &Tensor::operator()(size_t i, size_t j) const {
   if (shape.size() != 2 || i >= shape[0] || j >= shape[1])
     throw std::out_of_range("Acceso 2D fuera de rango.");
 #endif
-  return (*dataPtr)[dataOffset + i * strides[0] + j * strides[1]];
+  return dataPtr[dataOffset + i * strides[0] + j * strides[1]];
 }
 
 inline float &Tensor::operator()(size_t i, size_t j, size_t k) {
@@ -169,7 +179,7 @@ inline float &Tensor::operator()(size_t i, size_t j, size_t k) {
   if (shape.size() != 3 || i >= shape[0] || j >= shape[1] || k >= shape[2])
     throw std::out_of_range("Acceso 3D fuera de rango.");
 #endif
-  return (*dataPtr)[dataOffset + i * strides[0] + j * strides[1] + k * strides[2]];
+  return dataPtr[dataOffset + i * strides[0] + j * strides[1] + k * strides[2]];
 }
 
 inline const float &Tensor::operator()(size_t i, size_t j, size_t k) const {
@@ -177,7 +187,7 @@ inline const float &Tensor::operator()(size_t i, size_t j, size_t k) const {
   if (shape.size() != 3 || i >= shape[0] || j >= shape[1] || k >= shape[2])
     throw std::out_of_range("Acceso 3D fuera de rango.");
 #endif
-  return (*dataPtr)[dataOffset + i * strides[0] + j * strides[1] + k * strides[2]];
+  return dataPtr[dataOffset + i * strides[0] + j * strides[1] + k * strides[2]];
 }
 
 inline float &Tensor::operator()(size_t d0, size_t d1, size_t d2, size_t d3) {
@@ -185,7 +195,7 @@ inline float &Tensor::operator()(size_t d0, size_t d1, size_t d2, size_t d3) {
   if (shape.size() != 4 || d0 >= shape[0] || d1 >= shape[1] || d2 >= shape[2] || d3 >= shape[3])
     throw std::out_of_range("Acceso 4D fuera de rango.");
 #endif
-  return (*dataPtr)[dataOffset + d0 * strides[0] + d1 * strides[1] + d2 * strides[2] + d3 * strides[3]];
+  return dataPtr[dataOffset + d0 * strides[0] + d1 * strides[1] + d2 * strides[2] + d3 * strides[3]];
 }
 
 inline const float &Tensor::operator()(size_t d0, size_t d1, size_t d2, size_t d3) const {
@@ -193,7 +203,7 @@ inline const float &Tensor::operator()(size_t d0, size_t d1, size_t d2, size_t d
   if (shape.size() != 4 || d0 >= shape[0] || d1 >= shape[1] || d2 >= shape[2] || d3 >= shape[3])
     throw std::out_of_range("Acceso 4D fuera de rango.");
 #endif
-  return (*dataPtr)[dataOffset + d0 * strides[0] + d1 * strides[1] + d2 * strides[2] + d3 * strides[3]];
+  return dataPtr[dataOffset + d0 * strides[0] + d1 * strides[1] + d2 * strides[2] + d3 * strides[3]];
 }
 
 #endif // TENSOR_HPP
@@ -23,10 +23,27 @@ public:
   // Devuelve los gradientes de los parametros.
   std::vector<Tensor *> getGradients() override;
 
+  // Calibracion y cuantizacion int8 de W y b.
+  void setInt8Mode(Int8Mode mode) override { int8.setMode(mode, weights, bias); }
+
+  void releaseActivations() override { inputTensor = Tensor(); }
+
   // Devuelve el nombre de la capa.
   std::string getName() const override { return "Dense"; }
 
+  // Dimension de salida (columnas de los pesos).
+  size_t getOutputSize() const { return weights.getShape()[1]; }
+
+  // FLOPs del forward: GEMM (2 * filas * entrada * salida) mas el bias.
+  double getFlops(const std::vector<size_t> &inputShape) const override;
+
 private:
+  // InferencePlan usa los pesos sin pasar por forward().
+  friend class InferencePlan;
+
+  // X {filas, entrada} * W + b, en int8 si la capa esta cuantizada y no se entrena.
+  Tensor affine(const Tensor &input2D, bool isTraining) const;
+
   // Parametros entrenables
   Tensor weights; // Matriz de pesos, forma {input_size, output_size}.
   Tensor bias;    // Vector de bias, forma {1, output_size}.
@@ -37,6 +54,9 @@ private:
 
   // Almacena la entrada del forward pass para el calculo del backward pass.
   Tensor inputTensor;
+
+  // Copia int8 de los pesos y rango calibrado de la entrada.
+  Int8Linear int8;
 };
 
 #endif // DENSE_HPP
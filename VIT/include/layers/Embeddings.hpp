@@ -27,10 +27,19 @@ public:
   // Recolecta los gradientes de PatchEmbedding y los propios.
   std::vector<Tensor *> getGradients() override;
 
+  // Propaga el modo int8 a la proyeccion de los parches.
+  void setInt8Mode(Int8Mode mode) override;
+
   // Devuelve el nombre de la capa.
   std::string getName() const override { return "Embeddings"; }
 
+  // Proyeccion de parches mas la suma de la codificacion posicional.
+  double getFlops(const std::vector<size_t> &inputShape) const override;
+
 private:
+  // InferencePlan ensambla la secuencia de tokens en su propio buffer.
+  friend class InferencePlan;
+
   // Capa de parcheo contenida.
   std::unique_ptr<PatchEmbedding> patcher;
 
@@ -26,10 +26,22 @@ public:
   // Recolecta los gradientes de las capas Dense internas.
   std::vector<Tensor *> getGradients() override;
 
+  // Propaga el modo int8 a las dos capas Dense.
+  void setInt8Mode(Int8Mode mode) override;
+
+  // Suelta lo guardado por las dos Dense y la GELU (incluida la capa oculta).
+  void releaseActivations() override;
+
   // Devuelve el nombre de la capa.
   std::string getName() const override { return "FeedForward"; }
 
+  // Suma de los FLOPs de dense1, GELU y dense2.
+  double getFlops(const std::vector<size_t> &inputShape) const override;
+
 private:
+  // Acceso a dense1/dense2 para InferencePlan.
+  friend class InferencePlan;
+
   // Capas que componen la red Feed-Forward.
   Dense dense1;
   GELU activation;
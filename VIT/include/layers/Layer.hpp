@@ -1,6 +1,7 @@
 #ifndef LAYER_HPP
 #define LAYER_HPP
 
+#include "core/Quantization.hpp"
 #include "core/Tensor.hpp"
 #include <string>
 #include <vector>
@@ -15,7 +16,9 @@ public:
   // Realiza el paso hacia adelante (forward pass) de la capa.
   virtual Tensor forward(const Tensor &input, bool isTraining) = 0;
 
-  // Retropropaga el gradiente y calcula los gradientes de los parametros.
+  // Retropropaga el gradiente y SUMA los gradientes de los parametros a los que ya tienen
+  // (empiezan a cero). Asi varios backward seguidos acumulan el gradiente de varios
+  // micro-batches; hay que llamar a zeroGradients() antes de empezar un paso nuevo.
   virtual Tensor backward(const Tensor &outputGradient) = 0;
 
   // Devuelve los parametros entrenables de la capa (pesos, biases).
@@ -24,8 +27,35 @@ public:
   // Devuelve los gradientes asociados a los parametros entrenables.
   virtual std::vector<Tensor *> getGradients() { return {}; }
 
+  // Pone a cero los gradientes de los parametros (los de getGradients()).
+  void zeroGradients() {
+    for (Tensor *gradient : getGradients())
+      gradient->fill(0.0f);
+  }
+
+  // Cambia el modo int8 de las proyecciones lineales de la capa y de sus sub-capas
+  // (ver core/Quantization.hpp). Las capas sin pesos lineales lo ignoran.
+  virtual void setInt8Mode(Int8Mode /*mode*/) {}
+
+  // Suelta los tensores que el forward de entrenamiento guardo para el backward. Lo usa el
+  // checkpointing de activaciones para no retener lo recalculado entre pasos.
+  virtual void releaseActivations() {}
+
   // Devuelve el nombre de la capa (ej. "Dense").
   virtual std::string getName() const = 0;
+
+  // FLOPs aproximados del forward para una entrada de forma 'inputShape' (0 si la capa
+  // no los estima). Solo los usa el Profiler, que estima el backward como el doble.
+  virtual double getFlops(const std::vector<size_t> & /*inputShape*/) const { return 0.0; }
+
+protected:
+  // Numero de elementos de una forma, como double para las cuentas de FLOPs.
+  static double countElements(const std::vector<size_t> &shape) {
+    double count = 1.0;
+    for (size_t dim : shape)
+      count *= static_cast<double>(dim);
+    return count;
+  }
 };
 
 #endif // LAYER_HPP
@@ -23,10 +23,19 @@ public:
   // Devuelve los gradientes de los parametros.
   std::vector<Tensor *> getGradients() override;
 
+  // Suelta la entrada, las estadisticas y la entrada normalizada guardadas.
+  void releaseActivations() override;
+
   // Devuelve el nombre de la capa.
   std::string getName() const override { return "LayerNorm"; }
 
+  // FLOPs aproximados: ~8 por elemento (media, varianza, normalizacion y afin).
+  double getFlops(const std::vector<size_t> &inputShape) const override;
+
 private:
+  // InferencePlan normaliza con gamma, beta y epsilon en sus buffers.
+  friend class InferencePlan;
+
   float epsilon;
   size_t featureSize;
 
@@ -3,6 +3,7 @@
 
 #include "layers/Dense.hpp"
 #include "layers/Layer.hpp"
+#include "layers/QKVProjection.hpp"
 #include <memory>
 #include <vector>
 
@@ -13,7 +14,10 @@ public:
   // Constructor.
   // - embedding_dim: Dimension de los embeddings de entrada y salida (D).
   // - num_heads: Numero de cabezas de atencion (h). Debe dividir a D.
-  MultiHeadAttention(size_t embedding_dim, size_t num_heads);
+  // - use_flash_attention: usa la atencion fusionada por bloques (core/FlashAttention)
+  //   en lugar de construir la matriz de puntuaciones de N x N.
+  // - fuse_qkv: proyecta Q, K y V con una sola matriz empaquetada {D, 3D} (QKVProjection).
+  MultiHeadAttention(size_t embedding_dim, size_t num_heads, bool use_flash_attention = false, bool fuse_qkv = false);
 
   // Realiza el paso hacia adelante de la atencion.
   Tensor forward(const Tensor &input, bool isTraining) override;
@@ -27,27 +31,50 @@ public:
   // Recolecta los gradientes de las capas Dense internas.
   std::vector<Tensor *> getGradients() override;
 
+  // Propaga el modo int8 a las proyecciones Q, K, V y de salida.
+  void setInt8Mode(Int8Mode mode) override;
+
+  // Suelta Q, K, V, los pesos de atencion y lo guardado por las proyecciones.
+  void releaseActivations() override;
+
   // Devuelve el nombre de la capa.
   std::string getName() const override { return "MultiHeadAttention"; }
 
+  // FLOPs de las cuatro proyecciones y de Q*K^T y P*V para una entrada {B, N, D}.
+  double getFlops(const std::vector<size_t> &inputShape) const override;
+
 private:
+  // InferencePlan necesita las proyecciones y la configuracion de cabezas.
+  friend class InferencePlan;
+
   size_t embedding_dim;
   size_t num_heads;
   size_t head_dim; // Dimension de cada cabeza (D / h).
+  bool use_flash_attention;
+  bool fuse_qkv;
 
   // Capas de proyeccion lineal para Query, Key, Value y la salida.
   std::unique_ptr<Dense> q_proj;
   std::unique_ptr<Dense> k_proj;
   std::unique_ptr<Dense> v_proj;
   std::unique_ptr<Dense> out_proj;
+  // Proyeccion Q, K, V empaquetada (solo si fuse_qkv; sustituye a q_proj, k_proj y v_proj).
+  std::unique_ptr<QKVProjection> qkv_proj;
+
+  // Vista por cabezas {B, h, N, d_h} de uno de los bloques de un tensor empaquetado {B, N, 3D}.
+  Tensor packedHeads(const Tensor &packed, size_t part) const;
 
   // Funcion auxiliar para la atencion escalada por producto punto.
-  Tensor scaledDotProductAttention(const Tensor &q, const Tensor &k, const Tensor &v);
+  // q, k, v y context son vistas {B, h, N, d_h}; el resultado se escribe en context.
+  // Los pesos de atencion solo se guardan si isTraining.
+  void scaledDotProductAttention(const Tensor &q, const Tensor &k, const Tensor &v, Tensor &context, bool isTraining);
 
   // Tensores guardados para el backward pass.
   Tensor inputTensor;               // Entrada original.
-  Tensor q_split, k_split, v_split; // Proyecciones Q, K, V divididas por cabeza.
-  Tensor attention_weights;         // Pesos de atencion despues de softmax.
+  Tensor q_split, k_split, v_split; // Vistas {B, h, N, d_h} de las proyecciones Q, K, V.
+  Tensor attention_weights;         // Pesos de atencion despues de softmax {B, h, N, N}.
+  Tensor attention_output;          // Salida de la atencion fusionada (vista {B, h, N, d_h}).
+  Tensor attention_lse;             // Log-suma-exp por fila de la atencion fusionada {B*h, N}.
 };
 
 #endif // MULTIHEADATTENTION_HPP
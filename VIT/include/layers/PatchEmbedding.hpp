@@ -27,13 +27,26 @@ public:
   // Devuelve los gradientes de la capa de proyeccion interna.
   std::vector<Tensor *> getGradients() override;
 
+  // Propaga el modo int8 a la capa de proyeccion.
+  void setInt8Mode(Int8Mode mode) override;
+
   // Devuelve el nombre de la capa.
   std::string getName() const override { return "PatchEmbedding"; }
 
+  // FLOPs de la proyeccion de los parches (la extraccion solo copia).
+  double getFlops(const std::vector<size_t> &inputShape) const override;
+
   // Devuelve el numero de parches generados.
   size_t getNumPatches() const { return num_patches; }
 
+  // Copia los parches aplanados de 'input' {B, C, H, W} en 'patches' {B * num_patches, patch_dim},
+  // que debe ser contiguo. No reserva memoria.
+  void extractPatches(const Tensor &input, Tensor &patches) const;
+
 private:
+  // Acceso a la proyeccion para InferencePlan.
+  friend class InferencePlan;
+
   size_t image_height, image_width, patch_size, in_channels, embedding_dim;
   size_t patch_dim;   // Dimension del parche aplanado (patch_size * patch_size * channels).
   size_t num_patches; // Numero total de parches por imagen.
@@ -0,0 +1,73 @@
+#ifndef QKVPROJECTION_HPP
+#define QKVPROJECTION_HPP
+
+#include "layers/Layer.hpp"
+
+// Proyeccion Q, K, V fusionada para la atencion multi-cabeza.
+// Equivale a tres capas Dense {D, D} aplicadas a la misma entrada, pero guarda los
+// pesos empaquetados en una unica matriz {D, 3D} = [W_q | W_k | W_v] y un bias {1, 3D},
+// de modo que el forward es un solo GEMM y el gradiente de la entrada otro.
+//
+// getParameters() y getGradients() devuelven vistas {D, D} y {1, D} de cada bloque en
+// el mismo orden que tres Dense (W_q, b_q, W_k, b_k, W_v, b_v), asi que los archivos
+// de ModelUtils::save_weights son intercambiables con la version sin fusionar.
+class QKVProjection : public Layer {
+public:
+  // Constructor. embedding_dim es D.
+  explicit QKVProjection(size_t embedding_dim);
+
+  // {B, N, D} -> {B, N, 3D}, con Q, K y V en los tres bloques de la ultima dimension.
+  Tensor forward(const Tensor &input, bool isTraining) override;
+
+  // Recibe el gradiente {B, N, 3D} (dQ, dK, dV empaquetados) y devuelve dL/dX {B, N, D}.
+  Tensor backward(const Tensor &outputGradient) override;
+
+  // Devuelve las vistas de pesos y bias de Q, K y V.
+  std::vector<Tensor *> getParameters() override;
+
+  // Devuelve las vistas de los gradientes de Q, K y V.
+  std::vector<Tensor *> getGradients() override;
+
+  // Calibracion y cuantizacion int8 de la matriz empaquetada {D, 3D}.
+  void setInt8Mode(Int8Mode mode) override {
+    syncPackedStorage();
+    int8.setMode(mode, weights, bias);
+  }
+
+  void releaseActivations() override { inputTensor = Tensor(); }
+
+  // Devuelve el nombre de la capa.
+  std::string getName() const override { return "QKVProjection"; }
+
+  // FLOPs del GEMM empaquetado {B*N, D} x {D, 3D} y del bias.
+  double getFlops(const std::vector<size_t> &inputShape) const override;
+
+private:
+  // InferencePlan usa la matriz empaquetada {D, 3D} completa.
+  friend class InferencePlan;
+
+  // Si las vistas se han trasladado a otra memoria (ver ParameterRegistry), rehace el
+  // almacenamiento empaquetado sobre ella a partir de las vistas del bloque Q.
+  void syncPackedStorage();
+
+  size_t embedding_dim;
+
+  // Almacenamiento empaquetado.
+  Tensor weights;         // {D, 3D}
+  Tensor bias;            // {1, 3D}
+  Tensor weightGradients; // {D, 3D}
+  Tensor biasGradients;   // {1, 3D}
+
+  // Vistas por bloque (Q, K, V) sobre el almacenamiento empaquetado.
+  Tensor weightViews[3];
+  Tensor biasViews[3];
+  Tensor weightGradientViews[3];
+  Tensor biasGradientViews[3];
+
+  // Entrada del forward, aplanada a {B*N, D}.
+  Tensor inputTensor;
+
+  Int8Linear int8;
+};
+
+#endif // QKVPROJECTION_HPP
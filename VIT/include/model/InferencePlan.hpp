@@ -0,0 +1,92 @@
+#ifndef INFERENCEPLAN_HPP
+#define INFERENCEPLAN_HPP
+
+#include "model/VisionTransformer.hpp"
+#include <utility>
+#include <vector>
+
+// Plan de ejecucion de solo inferencia para un VisionTransformer y un tamaño de lote fijo.
+//
+// Al construirse recorre el modelo una vez y lo traduce a una lista de pasos (parcheo,
+// proyecciones, LayerNorm, atencion, GELU, sumas residuales) sobre activaciones de forma
+// conocida. Un analisis de vida (primer y ultimo paso que usa cada activacion) asigna las
+// activaciones a unos pocos buffers reutilizados. Los buffers, las vistas por cabezas y los
+// operandos de cada paso se crean aqui, de modo que run() no reserva memoria.
+//
+// El resultado coincide con VisionTransformer::forward(x, false). La LayerNorm final solo
+// se aplica a los tokens CLS, que son los unicos que lee la cabeza de clasificacion.
+// Los pesos se leen del modelo en cada run(): el plan sigue siendo valido tras entrenar o
+// cargar pesos, pero no si el modelo se destruye. Igualmente, las proyecciones usan la
+// version int8 si el modelo esta cuantizado en ese momento (VisionTransformer::setInt8Mode).
+class InferencePlan {
+public:
+  // Compila el plan para entradas {batchSize, C, H, W}.
+  InferencePlan(VisionTransformer &model, size_t batchSize);
+
+  // Forward de inferencia. Devuelve los logits {batchSize, num_classes}, que viven en un
+  // buffer del plan y se sobrescriben en la siguiente llamada.
+  const Tensor &run(const Tensor &input);
+
+  size_t getBatchSize() const { return batchSize; }
+  // Numero de buffers fisicos y memoria total que ocupan (en floats).
+  size_t getNumBuffers() const { return buffers.size(); }
+  size_t getArenaSize() const;
+  // Memoria que ocuparian las activaciones sin reutilizar buffers (en floats).
+  size_t getUnplannedSize() const;
+
+private:
+  enum class StepKind { Patchify, Linear, Tokens, LayerNorm, Attention, Add, Gelu };
+
+  // Activacion intermedia: forma, intervalo de vida [firstStep, lastStep] y buffer asignado.
+  struct Value {
+    std::vector<size_t> shape;
+    size_t size;
+    size_t firstStep;
+    size_t lastStep;
+    size_t buffer;
+  };
+
+  struct Step {
+    Step(StepKind kind, std::vector<size_t> values) : kind(kind), values(std::move(values)) {}
+
+    StepKind kind;
+    std::vector<size_t> values; // Activaciones que usa el paso (entradas, salida, temporales).
+    const Tensor *weight = nullptr;
+    const Tensor *bias = nullptr;
+    const Int8Linear *int8 = nullptr; // Version int8 de la proyeccion (se usa si esta cuantizada).
+    // Proyeccion QKV fusionada: su matriz empaquetada se rehace y se vuelve a leer en cada
+    // run(), porque un ParameterRegistry puede haber trasladado sus pesos.
+    QKVProjection *qkv = nullptr;
+    float scalar = 0.0f;       // epsilon de LayerNorm o escala de la atencion.
+    size_t rows = 0;           // Filas de LayerNorm o numero de cabezas de la atencion.
+    size_t rowStride = 0;      // Separacion entre filas de entrada de LayerNorm.
+    bool flash = false;        // Atencion fusionada por bloques.
+    std::vector<Tensor> views; // Operandos resueltos al final de la compilacion.
+  };
+
+  // --- Compilacion ---
+  size_t define(const std::vector<size_t> &shape);
+  void use(size_t value);
+  size_t linear(size_t input, const Dense &layer);
+  size_t layerNorm(size_t input, const LayerNorm &norm, size_t rows, size_t rowStride);
+  size_t attention(size_t input, const MultiHeadAttention &mha);
+  size_t encoderBlock(size_t input, const TransformerEncoderBlock &block);
+  void assignBuffers();
+  Tensor viewOf(size_t value) const;
+  void resolveViews();
+
+  // --- Ejecucion ---
+  void runAttention(Step &step);
+
+  VisionTransformer &model;
+  size_t batchSize;
+  size_t numTokens;
+  std::vector<size_t> inputShape;
+
+  std::vector<Value> values;
+  std::vector<Step> steps;
+  std::vector<Tensor> buffers;
+  size_t logits;
+};
+
+#endif // INFERENCEPLAN_HPP
@@ -0,0 +1,103 @@
+#ifndef PIPELINE_HPP
+#define PIPELINE_HPP
+
+#include "losses/CrossEntropy.hpp"
+#include "model/VisionTransformer.hpp"
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Paso de entrenamiento con paralelismo de pipeline para un VisionTransformer.
+//
+// El modelo se parte en etapas de partes consecutivas (ver VisionTransformer::numParts):
+// los bloques codificadores se reparten a partes iguales, la primera etapa lleva ademas los
+// embeddings y la ultima la cabeza y la perdida. Cada etapa corre en su propio hilo, fijado
+// a un grupo de nucleos distinto, y sus operaciones usan un equipo OpenMP del tamano de ese
+// grupo. Asi varias capas pequenas, que no llenan la maquina por si solas, se calculan a la
+// vez.
+//
+// Cada batch se divide en micro-batches que recorren las etapas con un calendario 1F1B: la
+// etapa s hace S - s - 1 forwards de calentamiento y despues alterna un forward y un
+// backward. En la etapa s hay como mucho S - s micro-batches a medias, asi que la memoria
+// de activaciones depende del numero de etapas y no del de micro-batches.
+//
+// Las capas guardan en si mismas lo que necesita su backward, por eso el micro-batch m usa
+// la copia m % S del modelo (la copia 0 es el propio modelo; las demas comparten sus
+// parametros, ver ModelUtils::share_parameters, y tienen gradientes propios). Cada copia acumula los gradientes de sus micro-batches y al final
+// cada etapa suma los de las copias 1..S-1 a los del modelo, en orden: el resultado no
+// depende del reparto de los hilos.
+class Pipeline {
+public:
+  // numStages entre 1 y num_layers del modelo. El modelo debe vivir mas que el Pipeline y
+  // no trasladar sus parametros despues de crearlo (el Trainer crea antes su registro).
+  Pipeline(VisionTransformer &model, size_t numStages, size_t microBatches);
+  ~Pipeline();
+
+  Pipeline(const Pipeline &) = delete;
+  Pipeline &operator=(const Pipeline &) = delete;
+
+  // Forward, perdida (CrossEntropy) y backward de un batch. Suma a los gradientes del
+  // modelo el de la perdida media del batch multiplicado por gradScale (ver
+  // Layer::backward) y devuelve esa perdida y los logits {B, num_classes}.
+  std::pair<float, Tensor> step(const Tensor &X, const Tensor &y, float gradScale = 1.0f);
+
+  size_t getNumStages() const { return stages.size(); }
+  // Partes [begin, end) del modelo que calcula la etapa.
+  std::pair<size_t, size_t> getStageParts(size_t stage) const;
+  // Nucleos a los que esta fijada la etapa.
+  const std::vector<int> &getStageCpus(size_t stage) const { return stages[stage].cpus; }
+
+private:
+  struct Stage {
+    size_t beginPart;
+    size_t endPart;
+    std::vector<int> cpus;
+    std::vector<float> gradientSum; // Gradientes del modelo mas los de las copias.
+    std::vector<float> scratch;
+    std::thread thread;
+  };
+
+  void stageLoop(size_t stage);
+  void runSchedule(size_t stage);
+  void forwardMicroBatch(size_t stage, size_t micro);
+  void backwardMicroBatch(size_t stage, size_t micro);
+  // Espera a que flag se ponga a 1; lanza si otra etapa ha fallado.
+  void waitFor(const std::vector<char> &flags, size_t micro);
+  void publish(std::vector<char> &flags, size_t micro);
+  VisionTransformer &copyFor(size_t micro) { return micro % stages.size() == 0 ? model : *replicas[micro % stages.size() - 1]; }
+
+  VisionTransformer &model;
+  std::vector<std::unique_ptr<VisionTransformer>> replicas;
+  std::vector<CrossEntropy> losses; // Una por copia: CrossEntropy guarda el softmax.
+  std::vector<Stage> stages;
+  size_t microBatches;
+
+  // --- Estado del paso en curso ---
+  const Tensor *batchX = nullptr;
+  const Tensor *batchY = nullptr;
+  size_t rows = 0;
+  size_t numMicro = 0;
+  float gradScale = 1.0f;
+  // activations[s][m]: entrada de la etapa s para el micro-batch m; gradients[s][m]:
+  // gradiente respecto a la salida de la etapa s. Los flags indican que ya estan listos.
+  std::vector<std::vector<Tensor>> activations;
+  std::vector<std::vector<Tensor>> gradients;
+  std::vector<std::vector<char>> activationReady;
+  std::vector<std::vector<char>> gradientReady;
+  std::vector<float> microLosses;
+  std::vector<Tensor> microLogits;
+
+  // --- Sincronizacion con los hilos de las etapas ---
+  std::mutex mutex;
+  std::condition_variable changed;
+  size_t stepId = 0;
+  size_t finishedStages = 0;
+  bool stopping = false;
+  std::exception_ptr error;
+};
+
+#endif // PIPELINE_HPP
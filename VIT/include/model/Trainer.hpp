@@ -1,9 +1,13 @@
 #ifndef TRAINER_HPP
 #define TRAINER_HPP
 
+#include "core/ParameterRegistry.hpp"
 #include "losses/CrossEntropy.hpp"
+#include "model/Pipeline.hpp"
 #include "model/VisionTransformer.hpp"
 #include "optimizers/Adam.hpp"
+#include "utils/Dataset.hpp"
+#include "utils/Distributed.hpp"
 #include <memory>
 #include <vector>
 
@@ -13,12 +17,31 @@ struct TrainerConfig {
   size_t batch_size = 64;
   float learning_rate = 0.001f;
   float weight_decay = 0.01f;
+  // Batches que el DataLoader prepara por adelantado en su hilo (0 = sin hilo).
+  size_t prefetch_batches = 2;
+  // Paralelismo de datos: numero de replicas del modelo (1 = desactivado). Cada replica
+  // entrena en su propio hilo, con las operaciones en serie, sobre una parte fija del
+  // batch; los gradientes se suman en un arbol de orden fijo y se hace un unico paso de
+  // Adam. Pensado para modelos pequenos, donde las regiones OpenMP de cada operacion son
+  // demasiado cortas para repartirlas. El resultado no depende del reparto de los hilos.
+  size_t data_parallel_replicas = 1;
+  // Paralelismo de pipeline: numero de etapas (1 = desactivado) y micro-batches por batch.
+  // Cada etapa es un grupo consecutivo de bloques codificadores con su propio hilo y grupo
+  // de nucleos; los micro-batches la recorren con un calendario 1F1B (ver model/Pipeline.hpp).
+  // Necesita pipeline_stages <= num_layers y no se combina con data_parallel_replicas.
+  size_t pipeline_stages = 1;
+  size_t pipeline_micro_batches = 4;
+  // Acumulacion de gradientes: batches de batch_size por paso de Adam (1 = desactivado).
+  // El batch efectivo es batch_size * accumulation_steps, pero la memoria de activaciones
+  // es la de batch_size. Se combina con las replicas, el pipeline y varios procesos.
+  size_t accumulation_steps = 1;
 };
 
 // Clase que orquesta el proceso de entrenamiento del modelo.
 class Trainer {
 public:
-  // Constructor. Recibe el modelo y la configuracion de entrenamiento.
+  // Constructor. Recibe el modelo y la configuracion de entrenamiento. Los parametros y
+  // gradientes del modelo pasan a ser vistas de un ParameterRegistry del Trainer.
   Trainer(VisionTransformer &model, const TrainerConfig &train_config);
 
   // Ejecuta el bucle de entrenamiento completo.
@@ -26,6 +49,27 @@ public:
   // - test_data: Par {Imagenes, Etiquetas} para la validacion.
   void train(const std::pair<Tensor, Tensor> &train_data, const std::pair<Tensor, Tensor> &test_data);
 
+  // Igual, pero pidiendo los batches a un Dataset (ej. un MappedDataset binario).
+  void train(const Dataset &train_data, const Dataset &test_data);
+
+  // Forward y backward de un batch con el modo configurado (replicas, pipeline o el modelo
+  // solo), sin paso de Adam. Suma a los gradientes del modelo los de la perdida media del
+  // batch multiplicados por grad_scale; no los pone a cero. Devuelve la perdida y precision
+  // del batch.
+  std::pair<float, float> accumulate_gradients(const Tensor &X_batch, const Tensor &y_batch, float grad_scale = 1.0f);
+
+  // Evalua el modelo en un conjunto de datos (sin actualizar pesos).
+  // Devuelve la perdida y precision promedio.
+  std::pair<float, float> evaluate(const Dataset &test_data);
+
+  // Entrenamiento distribuido entre procesos (ver utils/Distributed.hpp; nullptr = un solo
+  // proceso). Cada proceso entrena sobre su parte de cada epoca y los gradientes se
+  // promedian con un all-reduce en anillo antes de Adam; evaluate reparte el conjunto de
+  // test. Si el numero de muestras no es multiplo del de procesos, cada epoca repite las
+  // primeras del recorrido barajado hasta completar el reparto. Hay que fijarlo igual en
+  // todos los procesos, antes de train().
+  void set_communicator(Communicator *comm) { communicator = comm; }
+
   // Getters para acceder al modelo.
   const VisionTransformer &getModel() const { return model; }
   VisionTransformer &getModel() { return model; }
@@ -33,17 +77,51 @@ public:
 private:
   // Ejecuta una unica epoca de entrenamiento sobre el conjunto de datos.
   // Devuelve la perdida y precision promedio de la epoca.
-  std::pair<float, float> train_epoch(const Tensor &X_train, const Tensor &y_train);
+  std::pair<float, float> train_epoch(const Dataset &train_data);
 
-  // Evalua el modelo en un conjunto de datos (sin actualizar pesos).
-  // Devuelve la perdida y precision promedio.
-  std::pair<float, float> evaluate(const Tensor &X_test, const Tensor &y_test);
+  // Forward y backward de un batch repartido entre las replicas; suma a los gradientes del
+  // modelo los de la perdida media del batch multiplicados por grad_scale. Devuelve la
+  // perdida y precision del batch.
+  std::pair<float, float> data_parallel_step(const Tensor &X_batch, const Tensor &y_batch, float grad_scale);
+
+  // Gradientes de una parte del modelo copiados a un buffer contiguo para el all-reduce.
+  struct GradientBucket {
+    std::vector<Tensor *> grads;
+    std::vector<float> data;
+  };
+
+  // Copia los gradientes a un bucket y lanza su all-reduce sin esperar.
+  void queue_gradients(const std::vector<Tensor *> &grads);
+
+  // Espera los all-reduce pendientes y deja en cada gradiente la media de los procesos.
+  void finish_gradient_sync();
+
+  // Copia los parametros del rank 0 en todos los procesos.
+  void broadcast_parameters();
 
   // Componentes del entrenamiento.
   VisionTransformer &model; // Referencia al modelo a entrenar.
   Adam optimizer;
+  // Parametros y gradientes del modelo en dos buffers planos; Adam, el all-reduce y el
+  // broadcast trabajan sobre ellos.
+  ParameterRegistry parameters;
   CrossEntropy loss_fn;
 
+  // Replicas 1..R-1 del paralelismo de datos (la replica 0 es el propio modelo), con los
+  // parametros compartidos con el modelo y gradientes propios, y una funcion de perdida por
+  // replica, porque CrossEntropy guarda el softmax del forward.
+  std::vector<std::unique_ptr<VisionTransformer>> replicas;
+  std::vector<CrossEntropy> replica_losses;
+
+  // Ejecucion por etapas (solo con pipeline_stages > 1).
+  std::unique_ptr<Pipeline> pipeline;
+
+  // Estado del entrenamiento distribuido. Los buckets se reutilizan de un paso a otro.
+  Communicator *communicator = nullptr;
+  std::vector<GradientBucket> gradient_buckets;
+  size_t queued_buckets = 0;
+  double exposed_communication = 0.0; // Segundos de la epoca esperando al all-reduce.
+
   // Configuracion de entrenamiento.
   TrainerConfig config;
 };
@@ -15,7 +15,15 @@
 class TransformerEncoderBlock : public Layer {
 public:
   // Constructor del bloque codificador.
-  TransformerEncoderBlock(size_t embedding_dim, size_t num_heads, size_t mlp_hidden_dim);
+  // use_flash_attention selecciona la atencion fusionada por bloques en la sub-capa de atencion
+  // y fuse_qkv la proyeccion Q, K, V empaquetada.
+  // Con checkpoint_activations el forward de entrenamiento guarda solo la entrada del bloque
+  // y el backward repite el forward para reconstruir lo demas (Q, K, V, pesos de atencion,
+  // capa oculta de la FFN...). Entre el forward y el backward el bloque ocupa un tensor
+  // {B, N, D} en lugar de todas sus activaciones, a cambio de un forward extra.
+  TransformerEncoderBlock(size_t embedding_dim, size_t num_heads, size_t mlp_hidden_dim,
+                          bool use_flash_attention = false, bool fuse_qkv = false,
+                          bool checkpoint_activations = false);
 
   // Realiza el paso hacia adelante a traves del bloque completo.
   Tensor forward(const Tensor &input, bool isTraining) override;
@@ -29,10 +37,26 @@ public:
   // Recolecta los gradientes de todas las sub-capas.
   std::vector<Tensor *> getGradients() override;
 
+  // Propaga el modo int8 a la atencion y a la FFN.
+  void setInt8Mode(Int8Mode mode) override;
+
+  // Suelta las entradas de las conexiones residuales y lo guardado por las sub-capas.
+  void releaseActivations() override;
+
   // Devuelve el nombre de la capa.
   std::string getName() const override { return "TransformerEncoderBlock"; }
 
+  // Suma de las sub-capas y de las dos conexiones residuales.
+  double getFlops(const std::vector<size_t> &inputShape) const override;
+
 private:
+  // InferencePlan traduce el bloque a pasos sobre buffers planificados.
+  friend class InferencePlan;
+
+  // Forward de las sub-capas y las conexiones residuales; guarda lo necesario para el
+  // backward si isTraining.
+  Tensor forwardSublayers(const Tensor &input, bool isTraining);
+
   // Componentes del bloque.
   LayerNorm norm1;
   MultiHeadAttention attention;
@@ -42,6 +66,12 @@ private:
   // Tensores guardados para las conexiones residuales en el backward pass.
   Tensor input_skip1; // Entrada a la primera conexion residual.
   Tensor input_skip2; // Entrada a la segunda conexion residual.
+
+  // Checkpointing de activaciones.
+  bool checkpoint_activations;
+  bool pending_recompute = false; // El ultimo forward de entrenamiento no guardo las sub-capas.
+  // Los forward de inferencia observan o usan int8; con int8 activo no se hace checkpointing.
+  Int8Mode int8_mode = Int8Mode::Off;
 };
 
 #endif // TRANSFORMERENCODERBLOCK_HPP
@@ -6,6 +6,7 @@
 #include "layers/Layer.hpp"
 #include "layers/LayerNorm.hpp"
 #include "model/TransformerEncoderBlock.hpp"
+#include <functional>
 #include <memory>
 #include <vector>
 
@@ -19,6 +20,15 @@ struct ViTConfig {
   size_t num_heads = 8;
   size_t num_layers = 4;
   size_t mlp_hidden_dim = 512;
+  // Atencion fusionada por bloques (memoria O(N) en lugar de O(N^2) por cabeza).
+  // Desactivada por defecto para poder compararla con la implementacion original.
+  bool use_flash_attention = false;
+  // Proyeccion Q, K, V con una unica matriz {D, 3D}. Los pesos guardados son compatibles
+  // con los de la version sin fusionar.
+  bool fuse_qkv = false;
+  // Checkpointing de activaciones en cada bloque codificador: el entrenamiento guarda solo
+  // la entrada de cada bloque y la recalcula en backward (~un forward mas por paso).
+  bool checkpoint_activations = false;
 };
 
 // Implementacion completa del modelo Vision Transformer.
@@ -35,16 +45,50 @@ public:
   // Realiza un backward pass completo a traves de todo el modelo.
   Tensor backward(const Tensor &outputGradient) override;
 
+  // --- Ejecucion por partes (paralelismo de pipeline) ---
+  // El modelo se divide en numParts() partes consecutivas: 0 = embeddings, 1..num_layers =
+  // bloques codificadores y la ultima = cabeza (norma final, token CLS y mlp_head).
+  // forward() equivale a forwardParts(input, 0, numParts()), y lo mismo con backward.
+  size_t numParts() const { return encoder_blocks.size() + 2; }
+  Tensor forwardParts(const Tensor &input, size_t begin, size_t end, bool isTraining);
+  Tensor backwardParts(const Tensor &outputGradient, size_t begin, size_t end);
+  std::vector<Tensor *> getPartParameters(size_t begin, size_t end);
+  std::vector<Tensor *> getPartGradients(size_t begin, size_t end);
+
   // Recolecta los parametros de todas las capas del modelo.
   std::vector<Tensor *> getParameters() override;
 
   // Recolecta los gradientes de todas las capas del modelo.
   std::vector<Tensor *> getGradients() override;
 
+  // Cambia el modo int8 de todas las proyecciones lineales del modelo
+  // (ver ModelUtils::quantize_int8 para calibrar y cuantizar de una vez).
+  void setInt8Mode(Int8Mode mode) override;
+
+  // Funcion que el backward llama cada vez que termina una parte del modelo (cabeza, norma
+  // final, cada bloque de atras hacia adelante y embeddings) con sus gradientes ya listos.
+  // Sirve para enviarlos mientras se calcula el resto del backward. Vacia = desactivada.
+  using GradientHook = std::function<void(const std::vector<Tensor *> &)>;
+  void setGradientHook(GradientHook hook) { gradient_hook = std::move(hook); }
+
+  // Configuracion con la que se construyo el modelo (ej. para crear replicas).
+  const ViTConfig &getConfig() const { return config; }
+
   // Devuelve el nombre del modelo.
   std::string getName() const override { return "VisionTransformer"; }
 
+  // FLOPs de un forward completo para una entrada {B, C, H, W}.
+  double getFlops(const std::vector<size_t> &inputShape) const override;
+
 private:
+  // InferencePlan recorre las partes del modelo para compilar el plan.
+  friend class InferencePlan;
+
+  Tensor forwardHead(const Tensor &sequence, bool isTraining);
+  Tensor backwardHead(const Tensor &outputGradient);
+  void checkPartRange(size_t begin, size_t end) const;
+  std::vector<Layer *> partLayers(size_t begin, size_t end);
+
   ViTConfig config;
 
   // Las partes del modelo.
@@ -55,6 +99,8 @@ private:
 
   // Tensor guardado para el backward pass.
   Tensor final_norm_output;
+
+  GradientHook gradient_hook;
 };
 
 #endif // VISIONTRANSFORMER_HPP
@@ -15,6 +15,11 @@ public:
   // Realiza un unico paso de actualizacion de Adam.
   void update(std::vector<Tensor *> &parameters, const std::vector<Tensor *> &gradients) override;
 
+  // Paso de Adam sobre todo el registro con un unico kernel vectorizado. Los momentos son
+  // dos buffers con la disposicion del registro; el estado es independiente del de la
+  // version por tensores, asi que un mismo Adam debe usar siempre una de las dos.
+  void update(ParameterRegistry &registry) override;
+
 private:
   // Hiperparametros de Adam.
   float beta1;
@@ -29,6 +34,10 @@ private:
 
   // Flag para la inicializacion diferida de los tensores de momento.
   bool initialized;
+
+  // Momentos de la version sobre el registro (se crean en la primera llamada).
+  Tensor flat_m;
+  Tensor flat_v;
 };
 
 #endif // ADAM_HPP
@@ -1,6 +1,7 @@
 #ifndef OPTIMIZER_HPP
 #define OPTIMIZER_HPP
 
+#include "core/ParameterRegistry.hpp"
 #include "core/Tensor.hpp"
 #include <vector>
 
@@ -20,6 +21,9 @@ public:
   // - gradients: Punteros a los gradientes correspondientes a cada parametro.
   virtual void update(std::vector<Tensor *> &parameters, const std::vector<Tensor *> &gradients) = 0;
 
+  // Paso de optimizacion sobre los buffers planos de un registro, de una sola pasada.
+  virtual void update(ParameterRegistry &registry) = 0;
+
 protected:
   // Tasa de aprendizaje (learning rate) del algoritmo.
   float learningRate;
@@ -0,0 +1,32 @@
+#ifndef CSVPARSER_HPP
+#define CSVPARSER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Filas de un CSV tipo MNIST/Fashion-MNIST ya parseadas, en el orden del archivo.
+struct MnistCsv {
+  size_t num_samples = 0;
+  size_t pixels_per_sample = 0;
+  std::vector<int32_t> labels;  // Una etiqueta por muestra.
+  std::vector<uint8_t> pixels;  // num_samples * pixels_per_sample valores en [0, 255].
+  size_t skipped_rows = 0;      // Filas seleccionadas pero mal formadas (se descartan).
+};
+
+// Parser de CSV paralelo por bloques. Cada fila es "etiqueta,p0,...,p783" con enteros.
+// Detalles:
+// - El archivo se proyecta con mmap y se divide en bloques que terminan en fin de linea;
+//   cada hilo de OpenMP cuenta y luego parsea sus bloques con std::from_chars, escribiendo
+//   directamente en los buffers finales (reservados una sola vez).
+// - Muestreo: se cuentan las filas (solo buscando '\n') y se elige cuales se guardan antes
+//   de parsear nada, asi que las filas descartadas nunca se convierten. Con random_sample
+//   se toma un subconjunto aleatorio de floor(total * sample_fraction) filas; si no, las
+//   primeras.
+// - Las filas con otro numero de pixeles, valores fuera de [0, 255] o etiquetas fuera de
+//   [0, num_classes) se descartan (se cuentan en skipped_rows).
+MnistCsv parse_mnist_csv(const std::string &filePath, float sample_fraction = 1.0f, bool random_sample = true,
+                         size_t pixels_per_sample = 784, int num_classes = 10);
+
+#endif // CSVPARSER_HPP
@@ -0,0 +1,86 @@
+#ifndef DATALOADER_HPP
+#define DATALOADER_HPP
+
+#include "utils/Dataset.hpp"
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Cola circular de capacidad fija para un productor y un consumidor, sin locks.
+// Cada indice lo escribe un solo hilo (tail el productor, head el consumidor); el par
+// release/acquire publica el contenido del slot junto con el indice.
+template <typename T> class SpscRing {
+public:
+  explicit SpscRing(size_t capacity) : slots(capacity + 1) {}
+
+  // Mueve value a la cola si hay sitio. Si esta llena devuelve false y no toca value.
+  bool try_push(T &value) {
+    const size_t tail_index = tail.load(std::memory_order_relaxed);
+    const size_t next = (tail_index + 1) % slots.size();
+    if (next == head.load(std::memory_order_acquire))
+      return false;
+    slots[tail_index] = std::move(value);
+    tail.store(next, std::memory_order_release);
+    return true;
+  }
+
+  // Saca el elemento mas antiguo en value. Devuelve false si la cola esta vacia.
+  bool try_pop(T &value) {
+    const size_t head_index = head.load(std::memory_order_relaxed);
+    if (head_index == tail.load(std::memory_order_acquire))
+      return false;
+    value = std::move(slots[head_index]);
+    head.store((head_index + 1) % slots.size(), std::memory_order_release);
+    return true;
+  }
+
+private:
+  std::vector<T> slots; // Un slot extra para distinguir llena de vacia.
+  alignas(64) std::atomic<size_t> head{0};
+  alignas(64) std::atomic<size_t> tail{0};
+};
+
+// Recorre un Dataset en el orden dado armando los batches en un hilo de fondo.
+// Detalles:
+// - El hilo pide cada batch a dataset.get_batch (copias con memcpy, o vistas) y lo deja
+//   en un SpscRing; mantiene hasta 'prefetch' batches listos mientras el batch actual
+//   se entrena, asi el armado sale del camino critico.
+// - El hilo de fondo arma los batches con un solo hilo de OpenMP, para no competir con
+//   los hilos de calculo.
+// - Con prefetch = 0 no hay hilo: next() arma el batch en el momento.
+// - Si get_batch lanza una excepcion, next() la relanza en el hilo del entrenamiento.
+// El dataset debe vivir mas que el DataLoader.
+class DataLoader {
+public:
+  DataLoader(const Dataset &dataset, std::vector<size_t> order, size_t batch_size, size_t prefetch = 2);
+  ~DataLoader();
+
+  DataLoader(const DataLoader &) = delete;
+  DataLoader &operator=(const DataLoader &) = delete;
+
+  // Espera al siguiente batch {Imagenes, Etiquetas}. Devuelve false al terminar el recorrido.
+  bool next(std::pair<Tensor, Tensor> &batch);
+
+  size_t num_batches() const { return total_batches; }
+
+private:
+  std::pair<Tensor, Tensor> make_batch(size_t index) const;
+  void produce();
+
+  const Dataset &dataset;
+  std::vector<size_t> order;
+  size_t batch_size;
+  size_t total_batches;
+  size_t consumed = 0;
+
+  SpscRing<std::pair<Tensor, Tensor>> ring;
+  std::atomic<bool> stopping{false};
+  std::atomic<bool> failed{false};
+  std::exception_ptr error; // Se publica con failed (release/acquire).
+  std::thread worker;
+};
+
+#endif // DATALOADER_HPP
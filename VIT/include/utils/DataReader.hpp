@@ -7,7 +7,9 @@
 
 // Carga y procesa un dataset tipo MNIST/Fashion-MNIST desde un archivo CSV.
 // Detalles:
-// - Lee un CSV donde la primera columna es la etiqueta y las siguientes son pixeles.
+// - Lee un CSV donde la primera columna es la etiqueta y las siguientes son pixeles
+//   (con parse_mnist_csv: en paralelo y parseando solo las filas de la muestra).
+// - Las muestras quedan en el orden del archivo; el Trainer las baraja en cada epoca.
 // - Normaliza los valores de los pixeles al rango [0, 1].
 // - Codifica las etiquetas en formato one-hot.
 // - Remodela los datos a la forma de imagen 4D {N, C, H, W}.
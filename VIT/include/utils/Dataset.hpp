@@ -0,0 +1,92 @@
+#ifndef DATASET_HPP
+#define DATASET_HPP
+
+#include "core/Tensor.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+// Conjunto de datos del que el Trainer pide batches por indices de muestra.
+class Dataset {
+public:
+  virtual ~Dataset() = default;
+
+  // Numero de muestras.
+  virtual size_t size() const = 0;
+
+  // Arma el batch {Imagenes {count, C, H, W}, Etiquetas one-hot {count, clases}}
+  // con las muestras indices[0..count).
+  virtual std::pair<Tensor, Tensor> get_batch(const size_t *indices, size_t count) const = 0;
+};
+
+// Dataset sobre tensores ya cargados en memoria (ej. el resultado de load_csv_data).
+// Comparte los datos de los tensores (no los copia).
+class TensorDataset : public Dataset {
+public:
+  TensorDataset(const Tensor &images, const Tensor &labels);
+
+  size_t size() const override { return images.getShape()[0]; }
+
+  // Si los indices son consecutivos devuelve vistas (sin copia); si no, copia
+  // cada muestra con memcpy.
+  std::pair<Tensor, Tensor> get_batch(const size_t *indices, size_t count) const override;
+
+private:
+  Tensor images; // Contiguo: cada muestra es un bloque de memoria.
+  Tensor labels;
+};
+
+// Dataset en el formato binario de convert_csv_to_binary, proyectado en memoria con mmap.
+// Los pixeles se quedan como uint8 en el archivo (1 byte por pixel, 4 veces menos que en
+// float) y el sistema operativo solo carga las paginas que se leen. La normalizacion a
+// [0, 1] y el one-hot se hacen al armar cada batch.
+class MappedDataset : public Dataset {
+public:
+  // Proyecta el archivo binario. Lanza std::runtime_error si no existe o no es valido.
+  explicit MappedDataset(const std::string &binPath);
+  ~MappedDataset();
+
+  MappedDataset(const MappedDataset &) = delete;
+  MappedDataset &operator=(const MappedDataset &) = delete;
+  MappedDataset(MappedDataset &&other) noexcept;
+  MappedDataset &operator=(MappedDataset &&other) noexcept;
+
+  size_t size() const override { return num_samples; }
+  std::pair<Tensor, Tensor> get_batch(const size_t *indices, size_t count) const override;
+
+  size_t get_rows() const { return rows; }
+  size_t get_cols() const { return cols; }
+  size_t get_num_classes() const { return num_classes; }
+
+  // Acceso directo a una muestra (sin normalizar).
+  int label(size_t index) const { return labels[index]; }
+  const uint8_t *pixels(size_t index) const { return pixel_data + index * rows * cols; }
+
+private:
+  void unmap();
+
+  void *mapping = nullptr;
+  size_t mapping_size = 0;
+  size_t num_samples = 0;
+  size_t rows = 0;
+  size_t cols = 0;
+  size_t num_classes = 0;
+  const int32_t *labels = nullptr;
+  const uint8_t *pixel_data = nullptr;
+};
+
+// Convierte un CSV tipo MNIST/Fashion-MNIST (etiqueta + 784 pixeles por fila) al formato
+// binario de MappedDataset:
+//   - Cabecera de 64 bytes: "FMNISTU8", version, clases, muestras, filas, columnas y
+//     los desplazamientos de etiquetas y pixeles.
+//   - Etiquetas: int32 por muestra.
+//   - Pixeles: uint8, 784 por muestra, alineados a 64 bytes.
+// Devuelve el numero de muestras escritas.
+size_t convert_csv_to_binary(const std::string &csvPath, const std::string &binPath);
+
+// Abre la version binaria de un CSV ("<nombre>.u8.bin" junto al CSV). La convierte la
+// primera vez, o si el CSV es mas reciente que el binario.
+MappedDataset open_binary_dataset(const std::string &csvPath);
+
+#endif // DATASET_HPP
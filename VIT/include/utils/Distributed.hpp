@@ -0,0 +1,134 @@
+#ifndef DISTRIBUTED_HPP
+#define DISTRIBUTED_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// --- Entrenamiento distribuido entre procesos ---
+// Los procesos forman un anillo por rank: cada uno envia al rank + 1 y recibe del rank - 1.
+// El lanzador vit_launch arranca los procesos y les pasa la configuracion por entorno:
+// - VIT_RANK, VIT_WORLD_SIZE: posicion del proceso y numero de procesos.
+// - VIT_DIST_BACKEND: "shm" (memoria compartida, por defecto) o "tcp".
+// - VIT_DIST_ADDR, VIT_DIST_PORT: direccion y primer puerto del anillo TCP; el rank r
+//   escucha en VIT_DIST_PORT + r (por defecto 127.0.0.1 y 29500).
+// - VIT_DIST_JOB: identificador del trabajo, para que los segmentos de memoria compartida
+//   de dos lanzamientos no se mezclen.
+
+// Enlace del proceso con sus dos vecinos del anillo.
+class RingTransport {
+public:
+  virtual ~RingTransport() = default;
+
+  // Envia send_bytes al siguiente rank mientras recibe recv_bytes del anterior. Envio y
+  // recepcion avanzan intercalados: si todos enviaran primero, un mensaje mayor que el
+  // buffer del transporte bloquearia el anillo entero.
+  virtual void exchange(const void *send, size_t send_bytes, void *recv, size_t recv_bytes) = 0;
+};
+
+// Anillo sobre conexiones TCP (una saliente y una entrante por proceso).
+class TcpTransport : public RingTransport {
+public:
+  TcpTransport(size_t rank, size_t world_size, const std::string &address, unsigned port);
+  ~TcpTransport() override;
+
+  TcpTransport(const TcpTransport &) = delete;
+  TcpTransport &operator=(const TcpTransport &) = delete;
+
+  void exchange(const void *send, size_t send_bytes, void *recv, size_t recv_bytes) override;
+
+private:
+  int send_fd = -1;
+  int recv_fd = -1;
+};
+
+// Anillo sobre memoria compartida POSIX: cada enlace es una cola circular de bytes de un
+// productor y un consumidor en un segmento que crea el emisor. El nombre del segmento se
+// borra en cuanto el receptor lo abre, asi no quedan restos si un proceso termina mal.
+class ShmTransport : public RingTransport {
+public:
+  ShmTransport(size_t rank, size_t world_size, const std::string &job);
+  ~ShmTransport() override;
+
+  ShmTransport(const ShmTransport &) = delete;
+  ShmTransport &operator=(const ShmTransport &) = delete;
+
+  void exchange(const void *send, size_t send_bytes, void *recv, size_t recv_bytes) override;
+
+private:
+  struct Channel;
+  Channel *out = nullptr; // Enlace hacia el siguiente rank.
+  Channel *in = nullptr;  // Enlace desde el anterior.
+};
+
+// Operaciones colectivas sobre el anillo.
+// Detalles:
+// - Todas las operaciones se ejecutan en orden en un hilo de comunicacion propio; las
+//   versiones _async vuelven enseguida y wait() espera a que terminen las pendientes.
+//   Asi el entrenamiento puede mandar los gradientes de una parte del modelo mientras
+//   calcula el backward de la siguiente.
+// - Todos los procesos deben pedir las mismas operaciones, con los mismos tamanos y en el
+//   mismo orden.
+// - Si una operacion falla, wait() relanza la excepcion.
+class Communicator {
+public:
+  Communicator(size_t rank, size_t world_size, std::unique_ptr<RingTransport> transport);
+  ~Communicator();
+
+  Communicator(const Communicator &) = delete;
+  Communicator &operator=(const Communicator &) = delete;
+
+  // Crea el comunicador a partir de las variables de entorno (ver arriba). Devuelve nullptr
+  // si el proceso no forma parte de un trabajo distribuido (sin VIT_WORLD_SIZE o con 1).
+  static std::unique_ptr<Communicator> from_environment();
+
+  size_t rank() const { return rank_index; }
+  size_t world_size() const { return world; }
+
+  // Suma data en todos los procesos con un all-reduce en anillo (reduce-scatter y luego
+  // all-gather): cada proceso envia y recibe 2 * (P - 1) / P veces el buffer, sea cual sea
+  // P. Cada trozo se suma una sola vez y en el orden del anillo, asi que el resultado es
+  // identico bit a bit en todos los procesos.
+  void all_reduce(float *data, size_t size);
+  void all_reduce_async(float *data, size_t size);
+
+  // Copia los bytes del proceso root en todos los demas.
+  void broadcast(void *data, size_t bytes, size_t root);
+
+  // Vuelve cuando todos los procesos han llegado a este punto.
+  void barrier();
+
+  // Espera a que terminen las operaciones pendientes.
+  void wait();
+
+  // Segundos que el hilo de comunicacion ha pasado ejecutando operaciones.
+  double communication_seconds() const;
+
+private:
+  void enqueue(std::function<void()> operation);
+  void run_queue();
+  void ring_all_reduce(float *data, size_t size);
+  void ring_broadcast(void *data, size_t bytes, size_t root);
+
+  size_t rank_index;
+  size_t world;
+  std::unique_ptr<RingTransport> transport;
+
+  // Cola de operaciones del hilo de comunicacion.
+  mutable std::mutex mutex;
+  std::condition_variable queue_changed;
+  std::deque<std::function<void()>> queue;
+  size_t running = 0; // Operaciones sacadas de la cola que aun no han terminado.
+  bool stopping = false;
+  std::exception_ptr error;
+  double busy_seconds = 0.0;
+  std::thread worker;
+};
+
+#endif // DISTRIBUTED_HPP
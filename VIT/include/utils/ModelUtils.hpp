@@ -2,6 +2,7 @@
 #define MODELUTILS_HPP
 
 #include "model/VisionTransformer.hpp"
+#include "utils/Dataset.hpp"
 #include <string>
 #include <vector>
 
@@ -18,6 +19,29 @@ void save_weights(const VisionTransformer &model, const std::string &filePath);
 // El modelo debe tener la misma arquitectura (formas de tensor) que el guardado.
 void load_weights(VisionTransformer &model, const std::string &filePath);
 
+// Cuantizacion int8 post-entrenamiento para inferencia. Pasa las primeras 'num_samples'
+// muestras de 'calibration' por el modelo (forward de inferencia) para medir el rango de
+// entrada de cada proyeccion lineal y luego cuantiza sus pesos. Los forward con
+// isTraining = false (y los InferencePlan) pasan a usar int8; los pesos float no cambian,
+// asi que save_weights sigue guardando el modelo original. Se deshace con
+// model.setInt8Mode(Int8Mode::Off).
+void quantize_int8(VisionTransformer &model, const Dataset &calibration, size_t num_samples = 1024,
+                   size_t batch_size = 64);
+
+// Copia los tensores (parametros o gradientes) uno tras otro en un buffer plano,
+// reutilizando su capacidad. Admite tensores contiguos y vistas 2D con filas contiguas
+// (los bloques de QKVProjection).
+void pack_tensors(const std::vector<Tensor *> &tensors, std::vector<float> &buffer);
+
+// Operacion inversa de pack_tensors, multiplicando cada valor por scale.
+void unpack_tensors(const std::vector<float> &buffer, const std::vector<Tensor *> &tensors, float scale = 1.0f);
+
+// Convierte los parametros de 'replica' (misma arquitectura que 'model') en vistas de la
+// memoria de los de 'model', sin copiar datos: las copias de entrenamiento leen siempre los
+// pesos actuales. Los gradientes no se comparten. Si los parametros del modelo se trasladan
+// despues (ej. a un ParameterRegistry) hay que volver a llamarla.
+void share_parameters(VisionTransformer &model, VisionTransformer &replica);
+
 } // namespace ModelUtils
 
 #endif // MODELUTILS_HPP
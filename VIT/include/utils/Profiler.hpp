@@ -0,0 +1,129 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include "layers/Layer.hpp"
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Perfilado por capa: tiempo de forward y backward, FLOPs, memoria pedida al asignador
+// y pico de memoria de tensores vivos.
+//
+// La instrumentacion se escribe con las macros PROFILE_FORWARD, PROFILE_BACKWARD y
+// PROFILE_SCOPE, que solo miden si se compila con VIT_PROFILING (opcion de CMake
+// VIT_ENABLE_PROFILING). Sin ella se reducen a la llamada original y no queda codigo
+// de perfilado.
+//
+// Con el perfilado compilado, la medicion se activa con Profiler::instance().start() o
+// con la variable de entorno VIT_PROFILE=<archivo.json>. En el segundo caso, al terminar
+// el programa se escribe la traza (formato Chrome trace-event: chrome://tracing o
+// ui.perfetto.dev) y se imprime la tabla resumen.
+//
+// Solo se miden los ambitos del hilo que llamo a start(), fuera de regiones paralelas; los
+// de otros hilos (replicas, etapas del pipeline) se ignoran. Se anidan: el nombre de
+// cada evento es la ruta de ambitos abiertos (ej. "encoder[0]/attention").
+
+// Una medicion completada.
+struct ProfileEvent {
+  std::string name;      // Ruta del ambito.
+  const char *phase;     // "forward", "backward" o "step".
+  double startUs;        // Inicio desde start(), en microsegundos.
+  double durationUs;     // Duracion en microsegundos.
+  double flops;          // FLOPs estimados (0 si no se conocen).
+  size_t bytesAllocated; // Memoria entregada por el asignador dentro del ambito.
+  size_t peakBytes;      // Pico de memoria en uso por tensores dentro del ambito.
+  size_t depth;          // Nivel de anidamiento (0 = ambito exterior).
+};
+
+class Profiler {
+public:
+  // Unica instancia. Lee VIT_PROFILE la primera vez que se usa.
+  static Profiler &instance();
+
+  // Borra los eventos anteriores y empieza a registrar.
+  void start();
+  // Deja de registrar (los eventos se conservan).
+  void stop();
+  bool isEnabled() const { return enabled && std::this_thread::get_id() == owner; }
+
+  const std::vector<ProfileEvent> &getEvents() const { return events; }
+
+  // Escribe los eventos en formato Chrome trace-event ("ph": "X").
+  void writeChromeTrace(const std::string &path) const;
+  // Imprime una tabla por ambito y fase, ordenada por tiempo total.
+  void printSummary(std::ostream &out) const;
+
+  // --- Uso interno de ProfileScope ---
+  size_t enter(const std::string &label);
+  void leave(ProfileEvent event);
+  double nowUs() const;
+  void setForwardFlops(const Layer *layer, double flops) { forwardFlops[layer] = flops; }
+  double getForwardFlops(const Layer *layer) const;
+
+private:
+  Profiler();
+  ~Profiler();
+  Profiler(const Profiler &) = delete;
+  Profiler &operator=(const Profiler &) = delete;
+
+  bool enabled = false;
+  std::thread::id owner;               // Hilo que llamo a start().
+  double origin = 0.0;                 // Instante de start() (microsegundos de steady_clock).
+  std::vector<std::string> stack;      // Rutas de los ambitos abiertos.
+  std::vector<ProfileEvent> events;    // Mediciones en orden de finalizacion.
+  std::string exitTracePath;           // Traza a escribir al salir (VIT_PROFILE).
+  std::unordered_map<const Layer *, double> forwardFlops; // Ultimo forward de cada capa.
+};
+
+// Ambito medido (RAII): registra un evento al destruirse si el Profiler estaba activo
+// al construirse.
+class ProfileScope {
+public:
+  ProfileScope(const std::string &label, const char *phase, double flops = 0.0);
+  // Forward de una capa; los FLOPs se piden a layer.getFlops(input.getShape()).
+  ProfileScope(const std::string &label, const Layer &layer, const Tensor &input);
+  // Backward de una capa; se estima en el doble de FLOPs que su ultimo forward
+  // (gradiente de la entrada y de los pesos).
+  ProfileScope(const std::string &label, const Layer &layer);
+  ~ProfileScope();
+
+  ProfileScope(const ProfileScope &) = delete;
+  ProfileScope &operator=(const ProfileScope &) = delete;
+
+private:
+  void begin(const std::string &label, const char *phase, double flops);
+
+  bool active = false;
+  ProfileEvent event;
+  size_t bytesAllocatedAtStart = 0;
+  size_t peakBeforeScope = 0;
+};
+
+#ifdef VIT_PROFILING
+inline Tensor profiledForward(const std::string &label, Layer &layer, const Tensor &input, bool isTraining) {
+  ProfileScope scope(label, layer, input);
+  return layer.forward(input, isTraining);
+}
+
+inline Tensor profiledBackward(const std::string &label, Layer &layer, const Tensor &outputGradient) {
+  ProfileScope scope(label, layer);
+  return layer.backward(outputGradient);
+}
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+// Llamadas a una capa medidas como un ambito con nombre 'label'.
+#define PROFILE_FORWARD(label, layer, input, isTraining) profiledForward(label, layer, input, isTraining)
+#define PROFILE_BACKWARD(label, layer, outputGradient) profiledBackward(label, layer, outputGradient)
+// Mide el resto del bloque actual; 'phase' es un literal ("step", "forward"...).
+#define PROFILE_SCOPE(label, phase) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(label, phase)
+#else
+#define PROFILE_FORWARD(label, layer, input, isTraining) (layer).forward(input, isTraining)
+#define PROFILE_BACKWARD(label, layer, outputGradient) (layer).backward(outputGradient)
+#define PROFILE_SCOPE(label, phase)
+#endif
+
+#endif // PROFILER_HPP
@@ -16,6 +16,7 @@ BUILD_TYPE="Release"
 #   ./run.sh          (Compila en Release y ejecuta)
 #   ./run.sh debug    (Compila en Debug y ejecuta)
 #   ./run.sh clean    (Limpia el directorio de compilación)
+#   ./run.sh bench    (Compila en Release y ejecuta los microbenchmarks; guarda bench.json)
 
 if [ "$1" == "clean" ]; then
   echo "--- Limpiando el directorio de compilación ---"
@@ -60,6 +61,20 @@ run_app() {
   echo "--- Ejecución finalizada ---"
 }
 
+run_bench() {
+  echo "--- Ejecutando los microbenchmarks ---"
+  # Los argumentos extra se pasan al ejecutable (ej: ./run.sh bench --filter=LayerNorm).
+  ./${BUILD_DIR}/bin/bench --json=bench.json "$@"
+  echo "--- Benchmarks finalizados ---"
+}
+
+if [ "$1" == "bench" ]; then
+  shift
+  build_project
+  run_bench "$@"
+  exit 0
+fi
+
 # --- Flujo Principal ---
 echo "Iniciando flujo: Compilar y Ejecutar"
 echo "Proyecto: ${PROJECT_NAME}, Tipo de Compilación: ${BUILD_TYPE}"
@@ -1,12 +1,5 @@
 #include "activations/GELU.hpp"
-#include <cmath>
-
-#ifdef _OPENMP
-#include <omp.h>
-#endif
-
-// Constante para la aproximacion de GELU: sqrt(2/pi).
-const float SQRT_2_OVER_PI = 0.7978845608028654f;
+#include "core/Kernels.hpp"
 
 GELU::GELU() {}
 
@@ -16,22 +9,16 @@ Tensor GELU::forward(const Tensor &input, bool isTraining) {
     this->inputTensor = input;
   }
 
-  Tensor result(input.getShape());
+  Tensor result = Tensor::uninitialized(input.getShape());
 
   // Se asume que el tensor es contiguo para mayor rendimiento.
   if (input.isContiguous() && result.isContiguous()) {
-    const float *in_data = input.getData();
+    const float *in_data = input.getData() + input.getDataOffset();
     float *out_data = result.getData();
-    size_t size = input.getSize();
+    const auto gelu = kernels().geluForward;
 
-#pragma omp parallel for
-    for (size_t i = 0; i < size; ++i) {
-      float x = in_data[i];
-      // Aproximacion de GELU: 0.5 * x * (1 + tanh(sqrt(2/pi) * (x + 0.044715 * x^3)))
-      float x_cubed = x * x * x;
-      float inner = SQRT_2_OVER_PI * (x + 0.044715f * x_cubed);
-      out_data[i] = 0.5f * x * (1.0f + std::tanh(inner));
-    }
+    // Aproximacion de GELU: 0.5 * x * (1 + tanh(sqrt(2/pi) * (x + 0.044715 * x^3)))
+    parallelChunks(input.getSize(), [&](size_t begin, size_t count) { gelu(in_data + begin, out_data + begin, count); });
   } else {
     throw std::runtime_error("GELU::forward solo implementado para tensores contiguos.");
   }
@@ -40,37 +27,25 @@ Tensor GELU::forward(const Tensor &input, bool isTraining) {
 }
 
 Tensor GELU::backward(const Tensor &outputGradient) {
-  Tensor inputGradient(inputTensor.getShape());
+  Tensor inputGradient = Tensor::uninitialized(inputTensor.getShape());
 
   // Se asume que los tensores son contiguos para mayor rendimiento.
   if (inputTensor.isContiguous() && outputGradient.isContiguous()) {
-    const float *in_data = inputTensor.getData();
-    const float *grad_out_data = outputGradient.getData();
+    const float *in_data = inputTensor.getData() + inputTensor.getDataOffset();
+    const float *grad_out_data = outputGradient.getData() + outputGradient.getDataOffset();
     float *grad_in_data = inputGradient.getData();
-    size_t size = inputTensor.getSize();
-
-#pragma omp parallel for
-    for (size_t i = 0; i < size; ++i) {
-      float x = in_data[i];
-      float x_squared = x * x;
-
-      // Calculo de la derivada de la aproximacion de GELU.
-      // dGELU/dx = 0.5 * (1 + tanh(inner)) + 0.5 * x * sech^2(inner) * d(inner)/dx
-      // sech^2(z) = 1 - tanh^2(z)
-      float inner = SQRT_2_OVER_PI * (x + 0.044715f * x_squared * x);
-      float tanh_inner = std::tanh(inner);
+    const auto geluGrad = kernels().geluBackward;
 
-      float d_inner_dx = SQRT_2_OVER_PI * (1.0f + 3.0f * 0.044715f * x_squared);
-      float sech_squared = 1.0f - tanh_inner * tanh_inner;
-
-      float dGELU_dx = 0.5f * (1.0f + tanh_inner) + 0.5f * x * sech_squared * d_inner_dx;
-
-      // Aplicacion de la regla de la cadena: dE/dX = dE/dY * dY/dX
-      grad_in_data[i] = dGELU_dx * grad_out_data[i];
-    }
+    // dGELU/dx = 0.5 * (1 + tanh(inner)) + 0.5 * x * sech^2(inner) * d(inner)/dx
+    // Aplicacion de la regla de la cadena: dE/dX = dE/dY * dY/dX
+    parallelChunks(inputTensor.getSize(), [&](size_t begin, size_t count) {
+      geluGrad(in_data + begin, grad_out_data + begin, grad_in_data + begin, count);
+    });
   } else {
     throw std::runtime_error("GELU::backward solo implementado para tensores contiguos.");
   }
 
   return inputGradient;
 }
+
+double GELU::getFlops(const std::vector<size_t> &inputShape) const { return 10.0 * countElements(inputShape); }
@@ -13,7 +13,7 @@ Tensor ReLU::forward(const Tensor &input, bool isTraining) {
     this->inputTensor = input;
   }
 
-  Tensor result(input.getShape());
+  Tensor result = Tensor::uninitialized(input.getShape());
   const auto &shape = input.getShape();
 
   // Soporte para tensores 2D {batch, features}.
@@ -45,7 +45,7 @@ Tensor ReLU::forward(const Tensor &input, bool isTraining) {
 }
 
 Tensor ReLU::backward(const Tensor &outputGradient) {
-  Tensor inputGradient(this->inputTensor.getShape());
+  Tensor inputGradient = Tensor::uninitialized(this->inputTensor.getShape());
   const auto &shape = this->inputTensor.getShape();
 
   // dE/dX = dE/dY * dY/dX. La derivada de ReLU (dY/dX) es 1 si X > 0, sino 0.
@@ -71,3 +71,5 @@ Tensor ReLU::backward(const Tensor &outputGradient) {
 
   return inputGradient;
 }
+
+double ReLU::getFlops(const std::vector<size_t> &inputShape) const { return countElements(inputShape); }
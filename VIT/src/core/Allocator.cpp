@@ -0,0 +1,344 @@
+#include "core/Allocator.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+constexpr std::align_val_t ALIGNMENT{64};
+
+float *systemAllocate(size_t count) { return static_cast<float *>(::operator new(count * sizeof(float), ALIGNMENT)); }
+
+void systemDeallocate(float *ptr) { ::operator delete(ptr, ALIGNMENT); }
+
+// Redondea 'count' a su clase de tamaño: multiplo de 1/8 de la siguiente potencia de
+// dos (cuatro clases entre dos potencias consecutivas) y como minimo 64 bytes.
+size_t sizeClass(size_t count) {
+  constexpr size_t MIN_FLOATS = 16;
+  if (count <= MIN_FLOATS)
+    return MIN_FLOATS;
+  size_t top = MIN_FLOATS;
+  while (top < count)
+    top <<= 1;
+  const size_t step = std::max(MIN_FLOATS, top / 8);
+  return (count + step - 1) / step * step;
+}
+
+size_t resetPeakOf(AllocatorStats &stats, size_t floor) {
+  const size_t previous = stats.peakBytesInUse;
+  stats.peakBytesInUse = std::max(floor, stats.bytesInUse);
+  return previous;
+}
+
+void recordAllocation(AllocatorStats &stats, size_t bytes) {
+  stats.allocations++;
+  stats.bytesAllocated += bytes;
+  stats.bytesInUse += bytes;
+  stats.peakBytesInUse = std::max(stats.peakBytesInUse, stats.bytesInUse);
+}
+
+// Asignador inicial segun VIT_ALLOCATOR (por defecto, el pool).
+std::shared_ptr<Allocator> makeDefaultAllocator() {
+  const char *env = std::getenv("VIT_ALLOCATOR");
+  if (env && std::string(env) == "system")
+    return std::make_shared<SystemAllocator>();
+  return std::make_shared<PoolAllocator>();
+}
+
+std::shared_ptr<Allocator> &activeAllocator() {
+  static std::shared_ptr<Allocator> allocator = makeDefaultAllocator();
+  return allocator;
+}
+} // namespace
+
+// --- SystemAllocator ---
+
+struct SystemAllocator::Impl {
+  mutable std::mutex mutex;
+  AllocatorStats stats;
+};
+
+SystemAllocator::SystemAllocator() : impl(std::make_unique<Impl>()) {}
+SystemAllocator::~SystemAllocator() = default;
+
+float *SystemAllocator::allocate(size_t count) {
+  float *ptr = systemAllocate(std::max<size_t>(count, 1));
+  std::lock_guard<std::mutex> lock(impl->mutex);
+  recordAllocation(impl->stats, count * sizeof(float));
+  impl->stats.systemAllocations++;
+  return ptr;
+}
+
+void SystemAllocator::deallocate(float *ptr, size_t count) {
+  systemDeallocate(ptr);
+  std::lock_guard<std::mutex> lock(impl->mutex);
+  impl->stats.bytesInUse -= count * sizeof(float);
+}
+
+AllocatorStats SystemAllocator::stats() const {
+  std::lock_guard<std::mutex> lock(impl->mutex);
+  return impl->stats;
+}
+
+size_t SystemAllocator::resetPeak(size_t floor) {
+  std::lock_guard<std::mutex> lock(impl->mutex);
+  return resetPeakOf(impl->stats, floor);
+}
+
+// --- PoolAllocator ---
+
+namespace {
+// Lista libre de una clase de tamaño.
+struct FreeList {
+  std::vector<float *> blocks;
+  size_t lowWater = 0; // Minimo de blocks.size() desde el ultimo resetStep().
+
+  float *pop() {
+    float *ptr = blocks.back();
+    blocks.pop_back();
+    lowWater = std::min(lowWater, blocks.size());
+    return ptr;
+  }
+};
+
+using FreeLists = std::unordered_map<size_t, FreeList>; // Clave: tamaño de la clase en floats.
+
+// Bloques que puede guardar la cache de un hilo por clase: los que quepan en 1 MiB y al
+// menos uno. Los bloques grandes son pocos y caros de usar, asi que pasar por el pool
+// compartido no se nota; los pequenos son los que se piden miles de veces por paso.
+constexpr size_t THREAD_CACHE_BYTES = size_t(1) << 20;
+
+size_t threadCacheLimit(size_t classSize) { return std::max<size_t>(1, THREAD_CACHE_BYTES / (classSize * sizeof(float))); }
+
+// Se marca al destruir las caches del hilo. Es trivialmente destructible, asi que se puede
+// consultar durante toda la salida del hilo.
+thread_local bool threadCachesDestroyed = false;
+
+// Devuelve al sistema los bloques que no se usaron desde el ultimo resetStep().
+size_t releaseUnused(FreeLists &lists) {
+  size_t released = 0;
+  for (auto &[classSize, list] : lists) {
+    // Los 'lowWater' bloques mas antiguos no se usaron en todo el paso.
+    const size_t unused = std::min(list.lowWater, list.blocks.size());
+    for (size_t i = 0; i < unused; ++i)
+      systemDeallocate(list.blocks[i]);
+    list.blocks.erase(list.blocks.begin(), list.blocks.begin() + unused);
+    list.lowWater = list.blocks.size();
+    released += unused * classSize * sizeof(float);
+  }
+  return released;
+}
+
+void releaseAll(FreeLists &lists) {
+  for (auto &[classSize, list] : lists) {
+    for (float *ptr : list.blocks)
+      systemDeallocate(ptr);
+    list.blocks.clear();
+    list.lowWater = 0;
+  }
+}
+} // namespace
+
+// Cada hilo tiene su propia cache de listas libres (ThreadCache), protegida por un mutex
+// que solo se disputa cuando otro hilo llama a resetStep(), trim() o stats(). Si la cache
+// del hilo no tiene un bloque de la clase se acude al pool compartido y, si tampoco, al
+// sistema; al liberar, lo que no cabe en la cache del hilo va al pool compartido. Asi un
+// bloque que reserva un hilo y libera otro (ej. el hilo de precarga de lotes) vuelve a
+// estar disponible para todos.
+//
+// Orden de los mutex: primero el del pool y despues el de una cache, nunca al reves.
+struct PoolAllocator::Impl : std::enable_shared_from_this<PoolAllocator::Impl> {
+  struct ThreadCache {
+    std::shared_ptr<Impl> pool; // Mantiene vivo el pool mientras el hilo tenga cache.
+    std::mutex mutex;
+    FreeLists lists;
+    size_t allocations = 0;
+    size_t bytesAllocated = 0;
+    size_t bytesCached = 0;
+
+    explicit ThreadCache(std::shared_ptr<Impl> owner) : pool(std::move(owner)) {}
+
+    // Al terminar el hilo sus bloques pasan al pool compartido.
+    ~ThreadCache() {
+      std::lock_guard<std::mutex> poolLock(pool->mutex);
+      for (auto &[classSize, list] : lists) {
+        FreeList &shared = pool->lists[classSize];
+        shared.blocks.insert(shared.blocks.end(), list.blocks.begin(), list.blocks.end());
+      }
+      pool->bytesCached += bytesCached;
+      pool->retiredAllocations += allocations;
+      pool->retiredBytesAllocated += bytesAllocated;
+      pool->caches.erase(std::find(pool->caches.begin(), pool->caches.end(), this));
+    }
+  };
+
+  // Pool compartido y registro de caches, bajo 'mutex'.
+  mutable std::mutex mutex;
+  FreeLists lists;
+  std::vector<ThreadCache *> caches;
+  size_t bytesCached = 0;
+  size_t systemAllocations = 0;
+  size_t retiredAllocations = 0; // Contadores de los hilos ya terminados.
+  size_t retiredBytesAllocated = 0;
+
+  // Memoria en uso y su pico, compartidos por todos los hilos.
+  std::atomic<size_t> bytesInUse{0};
+  std::atomic<size_t> peakBytesInUse{0};
+
+  ~Impl() { releaseAll(lists); }
+
+  // Caches del hilo actual, una por pool.
+  struct ThreadCaches {
+    // Las caches retienen su pool, asi que la direccion de un pool vivo no se reutiliza.
+    std::unordered_map<const Impl *, std::unique_ptr<ThreadCache>> byPool;
+    ~ThreadCaches() { threadCachesDestroyed = true; }
+  };
+
+  // Cache del hilo actual, creada en su primera reserva o liberacion. Devuelve nullptr si
+  // el hilo ya esta terminando y destruyo sus caches (ej. tensores estaticos liberados al
+  // salir); entonces se usa directamente el pool compartido.
+  ThreadCache *localCache() {
+    if (threadCachesDestroyed)
+      return nullptr;
+    thread_local ThreadCaches threadCaches;
+    std::unique_ptr<ThreadCache> &cache = threadCaches.byPool[this];
+    if (!cache) {
+      cache = std::make_unique<ThreadCache>(shared_from_this());
+      std::lock_guard<std::mutex> lock(mutex);
+      caches.push_back(cache.get());
+    }
+    return cache.get();
+  }
+
+  void addInUse(size_t bytes) {
+    const size_t inUse = bytesInUse.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    size_t peak = peakBytesInUse.load(std::memory_order_relaxed);
+    while (inUse > peak && !peakBytesInUse.compare_exchange_weak(peak, inUse, std::memory_order_relaxed)) {
+    }
+  }
+};
+
+PoolAllocator::PoolAllocator() : impl(std::make_shared<Impl>()) {}
+
+PoolAllocator::~PoolAllocator() { trim(); }
+
+float *PoolAllocator::allocate(size_t count) {
+  const size_t classSize = sizeClass(count);
+  const size_t bytes = classSize * sizeof(float);
+  impl->addInUse(bytes);
+  Impl::ThreadCache *cache = impl->localCache();
+  if (cache) {
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    cache->allocations++;
+    cache->bytesAllocated += bytes;
+    FreeList &list = cache->lists[classSize];
+    if (!list.blocks.empty()) {
+      cache->bytesCached -= bytes;
+      return list.pop();
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(impl->mutex);
+    if (!cache) {
+      impl->retiredAllocations++;
+      impl->retiredBytesAllocated += bytes;
+    }
+    FreeList &list = impl->lists[classSize];
+    if (!list.blocks.empty()) {
+      impl->bytesCached -= bytes;
+      return list.pop();
+    }
+    impl->systemAllocations++;
+  }
+  return systemAllocate(classSize);
+}
+
+void PoolAllocator::deallocate(float *ptr, size_t count) {
+  const size_t classSize = sizeClass(count);
+  const size_t bytes = classSize * sizeof(float);
+  impl->bytesInUse.fetch_sub(bytes, std::memory_order_relaxed);
+  Impl::ThreadCache *cache = impl->localCache();
+  if (cache) {
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    FreeList &list = cache->lists[classSize];
+    if (list.blocks.size() < threadCacheLimit(classSize)) {
+      list.blocks.push_back(ptr);
+      cache->bytesCached += bytes;
+      return;
+    }
+  }
+  std::lock_guard<std::mutex> lock(impl->mutex);
+  impl->lists[classSize].blocks.push_back(ptr);
+  impl->bytesCached += bytes;
+}
+
+void PoolAllocator::resetStep() {
+  std::lock_guard<std::mutex> lock(impl->mutex);
+  impl->bytesCached -= releaseUnused(impl->lists);
+  for (Impl::ThreadCache *cache : impl->caches) {
+    std::lock_guard<std::mutex> cacheLock(cache->mutex);
+    cache->bytesCached -= releaseUnused(cache->lists);
+  }
+}
+
+void PoolAllocator::trim() {
+  std::lock_guard<std::mutex> lock(impl->mutex);
+  releaseAll(impl->lists);
+  impl->bytesCached = 0;
+  for (Impl::ThreadCache *cache : impl->caches) {
+    std::lock_guard<std::mutex> cacheLock(cache->mutex);
+    releaseAll(cache->lists);
+    cache->bytesCached = 0;
+  }
+}
+
+AllocatorStats PoolAllocator::stats() const {
+  std::lock_guard<std::mutex> lock(impl->mutex);
+  AllocatorStats stats;
+  stats.allocations = impl->retiredAllocations;
+  stats.bytesAllocated = impl->retiredBytesAllocated;
+  stats.systemAllocations = impl->systemAllocations;
+  stats.bytesCached = impl->bytesCached;
+  for (Impl::ThreadCache *cache : impl->caches) {
+    std::lock_guard<std::mutex> cacheLock(cache->mutex);
+    stats.allocations += cache->allocations;
+    stats.bytesAllocated += cache->bytesAllocated;
+    stats.bytesCached += cache->bytesCached;
+  }
+  stats.bytesInUse = impl->bytesInUse.load(std::memory_order_relaxed);
+  stats.peakBytesInUse = impl->peakBytesInUse.load(std::memory_order_relaxed);
+  return stats;
+}
+
+size_t PoolAllocator::resetPeak(size_t floor) {
+  const size_t inUse = impl->bytesInUse.load(std::memory_order_relaxed);
+  return impl->peakBytesInUse.exchange(std::max(floor, inUse), std::memory_order_relaxed);
+}
+
+// --- Asignador activo ---
+
+const std::shared_ptr<Allocator> &getAllocator() { return activeAllocator(); }
+
+void setAllocator(std::shared_ptr<Allocator> allocator) {
+  if (!allocator) {
+    throw std::invalid_argument("setAllocator: el asignador no puede ser nulo.");
+  }
+  activeAllocator() = std::move(allocator);
+}
+
+std::shared_ptr<float[]> allocateStorage(size_t count, bool zeroFill) {
+  // El deleter guarda una referencia al asignador: el bloque vuelve a quien lo creo
+  // aunque mientras tanto se haya cambiado el asignador activo.
+  std::shared_ptr<Allocator> allocator = getAllocator();
+  float *ptr = allocator->allocate(count);
+  if (zeroFill && count > 0)
+    std::memset(ptr, 0, count * sizeof(float));
+  return std::shared_ptr<float[]>(ptr, [allocator, count](float *p) { allocator->deallocate(p, count); });
+}
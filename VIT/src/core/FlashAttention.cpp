@@ -0,0 +1,268 @@
+#include "core/FlashAttention.hpp"
+#include "core/Gemm.hpp"
+#include "core/Kernels.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace {
+// Filas de Q y de K/V por bloque. Un bloque de puntuaciones de 64 x 64 floats (16 KB)
+// y los bloques de Q, K y V con d_h tipico caben juntos en L1/L2.
+constexpr size_t BLOCK_Q = 64;
+constexpr size_t BLOCK_KV = 64;
+
+const float *dataOf(const Tensor &t) { return t.getData() + t.getDataOffset(); }
+
+// Disposicion en memoria de un lote de matrices por cabeza: {L, N, d} o {L0, L1, N, d}
+// con strides arbitrarios en las dimensiones de lote y de fila, y columnas contiguas.
+// Permite trabajar directamente sobre las vistas {B, N, h, d_h} -> {B, h, N, d_h}.
+struct HeadLayout {
+  size_t count; // Numero total de cabezas (L o L0 * L1).
+  size_t inner; // Tamaño de la dimension de lote interna (L1, o L si es 3D).
+  size_t rows;
+  size_t dim;
+  size_t outerStride;
+  size_t innerStride;
+  size_t rowStride;
+
+  size_t offset(size_t head) const { return (head / inner) * outerStride + (head % inner) * innerStride; }
+};
+
+HeadLayout layoutOf(const Tensor &t) {
+  const auto &shape = t.getShape();
+  const auto &strides = t.getStrides();
+  if (shape.size() != 3 && shape.size() != 4) {
+    throw std::runtime_error("FlashAttention requiere tensores {B*h, N, d_h} o {B, h, N, d_h}.");
+  }
+  if (strides.back() != 1) {
+    throw std::runtime_error("FlashAttention requiere que la ultima dimension sea contigua.");
+  }
+  const bool is4D = shape.size() == 4;
+  HeadLayout layout;
+  layout.inner = is4D ? shape[1] : shape[0];
+  layout.count = is4D ? shape[0] * shape[1] : shape[0];
+  layout.rows = shape[shape.size() - 2];
+  layout.dim = shape.back();
+  layout.outerStride = is4D ? strides[0] : 0;
+  layout.innerStride = is4D ? strides[1] : strides[0];
+  layout.rowStride = strides[shape.size() - 2];
+  return layout;
+}
+
+void checkShapes(const Tensor &q, const Tensor &k, const Tensor &v) {
+  const auto &qs = q.getShape();
+  const auto &ks = k.getShape();
+  const auto &vs = v.getShape();
+  const bool sameRank = qs.size() == ks.size() && ks.size() == vs.size();
+  if (!sameRank || ks != vs || !std::equal(qs.begin(), qs.end() - 2, ks.begin()) || qs.back() != ks.back()) {
+    throw std::invalid_argument("Formas incompatibles para FlashAttention: Q" + q.shapeToString() + ", K" +
+                                k.shapeToString() + ", V" + v.shapeToString());
+  }
+}
+
+void checkDestination(const Tensor &dst, const Tensor &like) {
+  if (dst.getShape() != like.getShape()) {
+    throw std::invalid_argument("Destino de FlashAttention con forma " + dst.shapeToString() + ", se esperaba " +
+                                like.shapeToString());
+  }
+}
+
+// Pone a cero 'rows' filas de 'dim' elementos separadas por 'rowStride'.
+void zeroRows(float *data, size_t rows, size_t dim, size_t rowStride) {
+  for (size_t r = 0; r < rows; ++r)
+    std::fill(data + r * rowStride, data + r * rowStride + dim, 0.0f);
+}
+} // namespace
+
+Tensor flashAttentionForward(const Tensor &q, const Tensor &k, const Tensor &v, float scale, Tensor &logSumExp) {
+  Tensor output = Tensor::uninitialized(q.getShape());
+  flashAttentionForward(q, k, v, scale, output, logSumExp);
+  return output;
+}
+
+void flashAttentionForward(const Tensor &q, const Tensor &k, const Tensor &v, float scale, Tensor &output,
+                           Tensor &logSumExp) {
+  checkShapes(q, k, v);
+  checkDestination(output, q);
+  const HeadLayout qL = layoutOf(q);
+  const HeadLayout kL = layoutOf(k);
+  const HeadLayout vL = layoutOf(v);
+  const HeadLayout oL = layoutOf(output);
+
+  const size_t heads = qL.count;
+  const size_t n = qL.rows;
+  const size_t nKv = kL.rows;
+  const size_t d = qL.dim;
+  // Se reutiliza 'logSumExp' si ya tiene la forma correcta (p. ej. en un InferencePlan).
+  const auto &lseShape = logSumExp.getShape();
+  if (lseShape.size() != 2 || lseShape[0] != heads || lseShape[1] != n || !logSumExp.isContiguous()) {
+    logSumExp = Tensor::uninitialized({heads, n});
+  }
+
+  const float *qData = dataOf(q);
+  const float *kData = dataOf(k);
+  const float *vData = dataOf(v);
+  float *outData = output.getData() + output.getDataOffset();
+  float *lseData = logSumExp.getData() + logSumExp.getDataOffset();
+  const KernelTable &kt = kernels();
+  const size_t qBlocks = (n + BLOCK_Q - 1) / BLOCK_Q;
+
+  // Cada tarea es un bloque de filas de Q de una cabeza: sus filas de salida son solo suyas.
+#pragma omp parallel for collapse(2) schedule(dynamic)
+  for (size_t h = 0; h < heads; ++h) {
+    for (size_t qb = 0; qb < qBlocks; ++qb) {
+      static thread_local std::vector<float> scores;
+      static thread_local std::vector<float> rowMax;
+      static thread_local std::vector<float> rowSum;
+
+      const size_t q0 = qb * BLOCK_Q;
+      const size_t br = std::min(BLOCK_Q, n - q0);
+      scores.resize(BLOCK_Q * BLOCK_KV);
+      rowMax.assign(br, -std::numeric_limits<float>::infinity());
+      rowSum.assign(br, 0.0f);
+
+      const float *qBlock = qData + qL.offset(h) + q0 * qL.rowStride;
+      const float *kHead = kData + kL.offset(h);
+      const float *vHead = vData + vL.offset(h);
+      float *out = outData + oL.offset(h) + q0 * oL.rowStride;
+      zeroRows(out, br, d, oL.rowStride); // La salida es el acumulador.
+
+      for (size_t kv0 = 0; kv0 < nKv; kv0 += BLOCK_KV) {
+        const size_t bc = std::min(BLOCK_KV, nKv - kv0);
+        const float *kBlock = kHead + kv0 * kL.rowStride;
+        const float *vBlock = vHead + kv0 * vL.rowStride;
+
+        // S = Q_i * K_j^T (K_j se lee transpuesto mediante sus strides).
+        sgemm(br, bc, d, qBlock, qL.rowStride, 1, kBlock, 1, kL.rowStride, scores.data(), BLOCK_KV);
+
+        // Softmax online: nuevo maximo, P = exp(S - max) y reescalado de lo acumulado.
+        for (size_t r = 0; r < br; ++r) {
+          float *srow = scores.data() + r * BLOCK_KV;
+          kt.scale(srow, scale, bc);
+          const float newMax = std::max(rowMax[r], kt.max(srow, bc));
+          const float correction = std::exp(rowMax[r] - newMax);
+          rowSum[r] = rowSum[r] * correction + kt.expSum(srow, srow, bc, newMax);
+          if (correction != 1.0f)
+            kt.scale(out + r * oL.rowStride, correction, d);
+          rowMax[r] = newMax;
+        }
+
+        // O_i += P * V_j
+        sgemm(br, d, bc, scores.data(), BLOCK_KV, 1, vBlock, vL.rowStride, 1, out, oL.rowStride, true);
+      }
+
+      // Normalizacion final y log-suma-exp para el backward.
+      for (size_t r = 0; r < br; ++r) {
+        kt.scale(out + r * oL.rowStride, 1.0f / rowSum[r], d);
+        lseData[h * n + q0 + r] = rowMax[r] + std::log(rowSum[r]);
+      }
+    }
+  }
+}
+
+void flashAttentionBackward(const Tensor &q, const Tensor &k, const Tensor &v, const Tensor &output,
+                            const Tensor &logSumExp, const Tensor &outputGradient, float scale, Tensor &dQ, Tensor &dK,
+                            Tensor &dV) {
+  checkShapes(q, k, v);
+  checkDestination(output, q);
+  checkDestination(outputGradient, q);
+  checkDestination(dQ, q);
+  checkDestination(dK, k);
+  checkDestination(dV, v);
+  const HeadLayout qL = layoutOf(q);
+  const HeadLayout kL = layoutOf(k);
+  const HeadLayout vL = layoutOf(v);
+  const HeadLayout oL = layoutOf(output);
+  const HeadLayout dOL = layoutOf(outputGradient);
+  const HeadLayout dQL = layoutOf(dQ);
+  const HeadLayout dKL = layoutOf(dK);
+  const HeadLayout dVL = layoutOf(dV);
+
+  const size_t heads = qL.count;
+  const size_t n = qL.rows;
+  const size_t nKv = kL.rows;
+  const size_t d = qL.dim;
+
+  const float *qData = dataOf(q);
+  const float *kData = dataOf(k);
+  const float *vData = dataOf(v);
+  const float *oData = dataOf(output);
+  const float *dOData = dataOf(outputGradient);
+  const float *lseData = dataOf(logSumExp);
+  float *dQData = dQ.getData() + dQ.getDataOffset();
+  float *dKData = dK.getData() + dK.getDataOffset();
+  float *dVData = dV.getData() + dV.getDataOffset();
+  const KernelTable &kt = kernels();
+
+  // Cada cabeza es independiente; dentro de ella dQ, dK y dV se acumulan bloque a bloque.
+#pragma omp parallel for schedule(dynamic)
+  for (size_t h = 0; h < heads; ++h) {
+    static thread_local std::vector<float> probs;
+    static thread_local std::vector<float> dProbs;
+    static thread_local std::vector<float> rowDot;
+    probs.resize(BLOCK_Q * BLOCK_KV);
+    dProbs.resize(BLOCK_Q * BLOCK_KV);
+    rowDot.resize(n);
+
+    const float *qHead = qData + qL.offset(h);
+    const float *kHead = kData + kL.offset(h);
+    const float *vHead = vData + vL.offset(h);
+    const float *oHead = oData + oL.offset(h);
+    const float *dOHead = dOData + dOL.offset(h);
+    const float *lse = lseData + h * n;
+    float *dQHead = dQData + dQL.offset(h);
+    float *dKHead = dKData + dKL.offset(h);
+    float *dVHead = dVData + dVL.offset(h);
+    zeroRows(dQHead, n, d, dQL.rowStride);
+    zeroRows(dKHead, nKv, d, dKL.rowStride);
+    zeroRows(dVHead, nKv, d, dVL.rowStride);
+
+    // D_i = sum(dO_i * O_i), el termino sum(dL/dP * P) del softmax de cada fila.
+    for (size_t i = 0; i < n; ++i)
+      rowDot[i] = kt.dot(dOHead + i * dOL.rowStride, oHead + i * oL.rowStride, d);
+
+    for (size_t kv0 = 0; kv0 < nKv; kv0 += BLOCK_KV) {
+      const size_t bc = std::min(BLOCK_KV, nKv - kv0);
+      const float *kBlock = kHead + kv0 * kL.rowStride;
+      const float *vBlock = vHead + kv0 * vL.rowStride;
+      float *dKBlock = dKHead + kv0 * dKL.rowStride;
+      float *dVBlock = dVHead + kv0 * dVL.rowStride;
+
+      for (size_t q0 = 0; q0 < n; q0 += BLOCK_Q) {
+        const size_t br = std::min(BLOCK_Q, n - q0);
+        const float *qBlock = qHead + q0 * qL.rowStride;
+        const float *dOBlock = dOHead + q0 * dOL.rowStride;
+
+        // P = exp(Q_i * K_j^T * scale - LSE_i), recalculado en lugar de guardado.
+        sgemm(br, bc, d, qBlock, qL.rowStride, 1, kBlock, 1, kL.rowStride, probs.data(), BLOCK_KV);
+        for (size_t r = 0; r < br; ++r) {
+          float *prow = probs.data() + r * BLOCK_KV;
+          kt.scale(prow, scale, bc);
+          kt.expSum(prow, prow, bc, lse[q0 + r]);
+        }
+
+        // dV_j += P^T * dO_i
+        sgemm(bc, d, br, probs.data(), 1, BLOCK_KV, dOBlock, dOL.rowStride, 1, dVBlock, dVL.rowStride, true);
+
+        // dP = dO_i * V_j^T ; dS = P * (dP - D_i) * scale
+        sgemm(br, bc, d, dOBlock, dOL.rowStride, 1, vBlock, 1, vL.rowStride, dProbs.data(), BLOCK_KV);
+        for (size_t r = 0; r < br; ++r) {
+          float *dsrow = dProbs.data() + r * BLOCK_KV;
+          kt.softmaxGradRow(dsrow, probs.data() + r * BLOCK_KV, rowDot[q0 + r], dsrow, bc);
+          kt.scale(dsrow, scale, bc);
+        }
+
+        // dK_j += dS^T * Q_i ; dQ_i += dS * K_j
+        sgemm(bc, d, br, dProbs.data(), 1, BLOCK_KV, qBlock, qL.rowStride, 1, dKBlock, dKL.rowStride, true);
+        sgemm(br, d, bc, dProbs.data(), BLOCK_KV, 1, kBlock, kL.rowStride, 1, dQHead + q0 * dQL.rowStride,
+              dQL.rowStride, true);
+      }
+    }
+  }
+}
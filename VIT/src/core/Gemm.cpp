@@ -0,0 +1,228 @@
+#include "core/Gemm.hpp"
+#include "core/Kernels.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// --- Parametros de bloqueo ---
+// MR x NR: tamaño del tile de C que el microkernel mantiene en registros.
+// KC: profundidad de los paneles (un panel de B de KC x NR cabe en L1).
+// MC: filas de A por bloque (un bloque MC x KC de A cabe en L2).
+// NC: columnas de B por bloque (un bloque KC x NC de B cabe en L3).
+namespace {
+constexpr size_t MR = GEMM_MR;
+constexpr size_t NR = GEMM_NR;
+constexpr size_t KC = 256;
+constexpr size_t MC = 72;
+constexpr size_t NC = 3072;
+
+// Por debajo de este numero de multiplicaciones-suma no compensa empaquetar.
+constexpr size_t SMALL_GEMM_FLOPS = 16 * 16 * 16;
+
+// Empaqueta un bloque mc x kc de A en paneles de MR filas.
+// Dentro de cada panel los datos quedan ordenados por k: [p][0..MR).
+// Las filas que faltan en el ultimo panel se rellenan con ceros.
+void packA(size_t mc, size_t kc, const float *a, size_t rsA, size_t csA, float *dst) {
+  for (size_t ir = 0; ir < mc; ir += MR) {
+    const size_t mr = std::min(MR, mc - ir);
+    float *panel = dst + ir * kc;
+    if (rsA == 1) {
+      // Camino rapido: A transpuesta (columnas contiguas), se copian MR floats por k.
+      for (size_t p = 0; p < kc; ++p) {
+        const float *src = a + ir + p * csA;
+        float *out = panel + p * MR;
+        size_t r = 0;
+        for (; r < mr; ++r)
+          out[r] = src[r];
+        for (; r < MR; ++r)
+          out[r] = 0.0f;
+      }
+    } else if (csA == 1) {
+      // Camino rapido: A row-major, cada fila es contigua a lo largo de k.
+      for (size_t r = 0; r < mr; ++r) {
+        const float *src = a + (ir + r) * rsA;
+        for (size_t p = 0; p < kc; ++p)
+          panel[p * MR + r] = src[p];
+      }
+      for (size_t r = mr; r < MR; ++r)
+        for (size_t p = 0; p < kc; ++p)
+          panel[p * MR + r] = 0.0f;
+    } else {
+      for (size_t p = 0; p < kc; ++p) {
+        float *out = panel + p * MR;
+        for (size_t r = 0; r < MR; ++r)
+          out[r] = (r < mr) ? a[(ir + r) * rsA + p * csA] : 0.0f;
+      }
+    }
+  }
+}
+
+// Empaqueta un bloque kc x nc de B en paneles de NR columnas.
+// Dentro de cada panel los datos quedan ordenados por k: [p][0..NR).
+void packBPanel(size_t kc, size_t nr, const float *b, size_t rsB, size_t csB, float *panel) {
+  if (csB == 1) {
+    // Camino rapido: B row-major, se copian NR floats contiguos por fila.
+    for (size_t p = 0; p < kc; ++p) {
+      const float *src = b + p * rsB;
+      float *out = panel + p * NR;
+      std::memcpy(out, src, nr * sizeof(float));
+      for (size_t j = nr; j < NR; ++j)
+        out[j] = 0.0f;
+    }
+  } else if (rsB == 1) {
+    // Camino rapido: B transpuesta, cada columna es contigua a lo largo de k.
+    for (size_t j = 0; j < nr; ++j) {
+      const float *src = b + j * csB;
+      for (size_t p = 0; p < kc; ++p)
+        panel[p * NR + j] = src[p];
+    }
+    for (size_t j = nr; j < NR; ++j)
+      for (size_t p = 0; p < kc; ++p)
+        panel[p * NR + j] = 0.0f;
+  } else {
+    for (size_t p = 0; p < kc; ++p) {
+      float *out = panel + p * NR;
+      for (size_t j = 0; j < NR; ++j)
+        out[j] = (j < nr) ? b[p * rsB + j * csB] : 0.0f;
+    }
+  }
+}
+
+// Microkernel generico: calcula un tile MR x NR de C a partir de un panel de A y uno de B.
+// Se usa cuando la tabla de kernels SIMD no ofrece uno propio. El tile se procesa en
+// dos mitades de MR x (NR/2) para que los acumuladores quepan en los 16 registros
+// vectoriales de SSE; el compilador vectoriza el bucle interno.
+void microKernel(size_t kc, const float *a, const float *b, float *c, size_t rsC, size_t mr, size_t nr, bool accumulate) {
+  constexpr size_t HALF = NR / 2;
+  for (size_t h = 0; h < NR; h += HALF) {
+    if (h >= nr)
+      break;
+    float acc[MR][HALF] = {};
+    for (size_t p = 0; p < kc; ++p) {
+      const float *bp = b + p * NR + h;
+      const float *ap = a + p * MR;
+      for (size_t r = 0; r < MR; ++r) {
+        const float av = ap[r];
+        for (size_t j = 0; j < HALF; ++j)
+          acc[r][j] += av * bp[j];
+      }
+    }
+
+    const size_t cols = std::min(HALF, nr - h);
+    for (size_t r = 0; r < mr; ++r) {
+      float *crow = c + r * rsC + h;
+      if (accumulate) {
+        for (size_t j = 0; j < cols; ++j)
+          crow[j] += acc[r][j];
+      } else {
+        for (size_t j = 0; j < cols; ++j)
+          crow[j] = acc[r][j];
+      }
+    }
+  }
+}
+
+// Camino para problemas pequeños: bucle directo sobre los strides, sin empaquetado.
+void smallGemm(size_t m, size_t n, size_t k, const float *a, size_t rsA, size_t csA, const float *b, size_t rsB, size_t csB,
+               float *c, size_t rsC, bool accumulate) {
+  for (size_t i = 0; i < m; ++i) {
+    float *crow = c + i * rsC;
+    if (!accumulate)
+      std::fill(crow, crow + n, 0.0f);
+    for (size_t p = 0; p < k; ++p) {
+      const float av = a[i * rsA + p * csA];
+      const float *brow = b + p * rsB;
+      for (size_t j = 0; j < n; ++j)
+        crow[j] += av * brow[j * csB];
+    }
+  }
+}
+
+bool inParallelRegion() {
+#ifdef _OPENMP
+  return omp_in_parallel() != 0;
+#else
+  return false;
+#endif
+}
+} // namespace
+
+void sgemm(size_t m, size_t n, size_t k, const float *a, size_t rsA, size_t csA, const float *b, size_t rsB, size_t csB,
+           float *c, size_t rsC, bool accumulate) {
+  if (m == 0 || n == 0)
+    return;
+  if (k == 0) {
+    if (!accumulate)
+      for (size_t i = 0; i < m; ++i)
+        std::fill(c + i * rsC, c + i * rsC + n, 0.0f);
+    return;
+  }
+  if (m * n * k <= SMALL_GEMM_FLOPS) {
+    smallGemm(m, n, k, a, rsA, csA, b, rsB, csB, c, rsC, accumulate);
+    return;
+  }
+
+  // Buffers de empaquetado propios del hilo que llama. Se reutilizan entre llamadas
+  // para no reservar memoria en cada multiplicacion.
+  static thread_local std::vector<float> packedA;
+  static thread_local std::vector<float> packedB;
+
+  // Microkernel vectorizado del nivel SIMD activo, o el generico si no hay.
+  auto kernel = kernels().gemmMicroKernel;
+  if (!kernel)
+    kernel = microKernel;
+
+  const bool parallel = !inParallelRegion();
+  const size_t mPadded = (m + MR - 1) / MR * MR;
+  const size_t mBlocks = (m + MC - 1) / MC;
+
+  for (size_t jc = 0; jc < n; jc += NC) {
+    const size_t nc = std::min(NC, n - jc);
+    const size_t ncPanels = (nc + NR - 1) / NR;
+
+    for (size_t pc = 0; pc < k; pc += KC) {
+      const size_t kc = std::min(KC, k - pc);
+      const bool acc = accumulate || pc > 0;
+
+      if (packedB.size() < ncPanels * NR * kc)
+        packedB.resize(ncPanels * NR * kc);
+      if (packedA.size() < mPadded * kc)
+        packedA.resize(mPadded * kc);
+      float *bBuf = packedB.data();
+      float *aBuf = packedA.data();
+
+      // 1. Empaquetar el bloque de B (kc x nc) y todo el bloque de A (m x kc).
+#pragma omp parallel for if (parallel)
+      for (size_t jp = 0; jp < ncPanels; ++jp) {
+        const size_t j = jp * NR;
+        packBPanel(kc, std::min(NR, nc - j), b + pc * rsB + (jc + j) * csB, rsB, csB, bBuf + jp * NR * kc);
+      }
+#pragma omp parallel for if (parallel)
+      for (size_t ib = 0; ib < mBlocks; ++ib) {
+        const size_t ic = ib * MC;
+        packA(std::min(MC, m - ic), kc, a + ic * rsA + pc * csA, rsA, csA, aBuf + ic * kc);
+      }
+
+      // 2. Recorrer los tiles: cada tarea es un bloque MC de filas por un panel NR de columnas.
+      //    Con jp como indice interno, cada hilo reutiliza su bloque de A en L2.
+#pragma omp parallel for collapse(2) schedule(static) if (parallel)
+      for (size_t ib = 0; ib < mBlocks; ++ib) {
+        for (size_t jp = 0; jp < ncPanels; ++jp) {
+          const size_t ic = ib * MC;
+          const size_t mc = std::min(MC, m - ic);
+          const size_t j = jp * NR;
+          const size_t nr = std::min(NR, nc - j);
+          const float *bPanel = bBuf + jp * NR * kc;
+          for (size_t ir = 0; ir < mc; ir += MR) {
+            kernel(kc, aBuf + (ic + ir) * kc, bPanel, c + (ic + ir) * rsC + jc + j, rsC, std::min(MR, mc - ir), nr, acc);
+          }
+        }
+      }
+    }
+  }
+}
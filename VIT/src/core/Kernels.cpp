@@ -0,0 +1,80 @@
+#include "core/Kernels.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+// Tablas definidas en src/core/kernels/. Devuelven nullptr si el compilador no
+// pudo generar codigo para ese nivel.
+const KernelTable *scalarKernelTable();
+const KernelTable *sse41KernelTable();
+const KernelTable *avx2KernelTable();
+const KernelTable *avx512KernelTable();
+const KernelTable *avx512VnniKernelTable();
+
+namespace {
+enum class SimdLevel { Scalar = 0, SSE41 = 1, AVX2 = 2, AVX512 = 3, AVX512VNNI = 4 };
+
+// Nivel mas alto que soportan la CPU y el sistema operativo (cpuid + xgetbv).
+SimdLevel detectCpuLevel() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vnni"))
+    return SimdLevel::AVX512VNNI;
+  if (__builtin_cpu_supports("avx512f"))
+    return SimdLevel::AVX512;
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    return SimdLevel::AVX2;
+  if (__builtin_cpu_supports("sse4.1"))
+    return SimdLevel::SSE41;
+#endif
+  return SimdLevel::Scalar;
+}
+
+// Limite opcional impuesto por la variable de entorno VIT_SIMD.
+SimdLevel requestedLevel() {
+  const char *env = std::getenv("VIT_SIMD");
+  if (!env)
+    return SimdLevel::AVX512VNNI;
+  const std::string value(env);
+  if (value == "scalar")
+    return SimdLevel::Scalar;
+  if (value == "sse4.1" || value == "sse")
+    return SimdLevel::SSE41;
+  if (value == "avx2")
+    return SimdLevel::AVX2;
+  if (value == "avx512")
+    return SimdLevel::AVX512;
+  return SimdLevel::AVX512VNNI;
+}
+
+const KernelTable *tableFor(SimdLevel level) {
+  switch (level) {
+  case SimdLevel::AVX512VNNI:
+    return avx512VnniKernelTable();
+  case SimdLevel::AVX512:
+    return avx512KernelTable();
+  case SimdLevel::AVX2:
+    return avx2KernelTable();
+  case SimdLevel::SSE41:
+    return sse41KernelTable();
+  default:
+    return scalarKernelTable();
+  }
+}
+
+// Recorre los niveles de mayor a menor hasta encontrar uno compilado.
+const KernelTable *selectKernels() {
+  const int top = std::min(static_cast<int>(detectCpuLevel()), static_cast<int>(requestedLevel()));
+  for (int level = top; level > 0; --level) {
+    if (const KernelTable *table = tableFor(static_cast<SimdLevel>(level)))
+      return table;
+  }
+  return scalarKernelTable();
+}
+} // namespace
+
+const KernelTable &kernels() {
+  static const KernelTable *table = selectKernels();
+  return *table;
+}
@@ -0,0 +1,109 @@
+#include "core/ParameterRegistry.hpp"
+#include "core/Kernels.hpp"
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+namespace {
+// Los tramos empiezan en multiplos de 16 floats (64 bytes, la alineacion del asignador).
+constexpr size_t ALIGNMENT = 16;
+
+// Tensores de la lista que comparten memoria y su extension [begin, end) en ella.
+struct Group {
+  std::vector<size_t> members;
+  size_t begin;
+  size_t end;
+  size_t start = 0; // Posicion del tramo en el buffer plano.
+};
+
+// Ultima posicion (exclusiva) que alcanza el tensor dentro de su memoria.
+size_t tensorEnd(const Tensor &t) {
+  if (t.getSize() == 0)
+    return t.getDataOffset();
+  size_t last = t.getDataOffset();
+  for (size_t d = 0; d < t.getShape().size(); ++d)
+    last += (t.getShape()[d] - 1) * t.getStrides()[d];
+  return last + 1;
+}
+
+// Agrupa los tensores por memoria, en el orden de su primera aparicion.
+std::vector<Group> groupByStorage(const std::vector<Tensor *> &tensors) {
+  std::vector<Group> groups;
+  std::unordered_map<const float *, size_t> index;
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    const Tensor &t = *tensors[i];
+    auto [it, inserted] = index.emplace(t.getData(), groups.size());
+    if (inserted)
+      groups.push_back({{}, t.getDataOffset(), tensorEnd(t)});
+    Group &group = groups[it->second];
+    group.members.push_back(i);
+    group.begin = std::min(group.begin, t.getDataOffset());
+    group.end = std::max(group.end, tensorEnd(t));
+  }
+  return groups;
+}
+
+// Copia la extension del grupo al buffer plano y rehace sus tensores como vistas del tramo.
+// El shared_ptr de cada vista comparte la propiedad del buffer pero apunta al inicio del
+// tramo, asi que getData() + getDataOffset() sigue siendo valido para todo el codigo.
+void relocate(const Group &group, const std::vector<Tensor *> &tensors, Tensor &buffer) {
+  const Tensor &first = *tensors[group.members.front()];
+  std::copy(first.getData() + group.begin, first.getData() + group.end, buffer.getData() + group.start);
+  const std::shared_ptr<float[]> segment(buffer.getDataPtr(), buffer.getData() + group.start);
+  for (size_t i : group.members) {
+    Tensor &t = *tensors[i];
+    t = Tensor(segment, t.getShape(), t.getStrides(), t.getDataOffset() - group.begin);
+  }
+}
+} // namespace
+
+ParameterRegistry::ParameterRegistry(const std::vector<Tensor *> &parameters, const std::vector<Tensor *> &gradients)
+    : parameters(parameters), gradients(gradients) {
+  if (parameters.size() != gradients.size())
+    throw std::invalid_argument("ParameterRegistry: el numero de parametros y gradientes no coincide.");
+  for (size_t i = 0; i < parameters.size(); ++i) {
+    if (parameters[i]->getShape() != gradients[i]->getShape())
+      throw std::invalid_argument("ParameterRegistry: el parametro " + std::to_string(i) +
+                                  " y su gradiente tienen formas distintas.");
+  }
+
+  std::vector<Group> groups = groupByStorage(parameters);
+  std::vector<Group> gradientGroups = groupByStorage(gradients);
+  if (gradientGroups.size() != groups.size())
+    throw std::invalid_argument("ParameterRegistry: los gradientes no comparten memoria como sus parametros.");
+
+  size_t total = 0;
+  for (size_t g = 0; g < groups.size(); ++g) {
+    Group &group = groups[g];
+    Group &gradientGroup = gradientGroups[g];
+    // El gradiente de cada tensor debe ocupar en su grupo la misma posicion que el parametro.
+    bool sameLayout =
+        group.members == gradientGroup.members && group.end - group.begin == gradientGroup.end - gradientGroup.begin;
+    for (size_t k = 0; sameLayout && k < group.members.size(); ++k) {
+      const Tensor &p = *parameters[group.members[k]];
+      const Tensor &dp = *gradients[group.members[k]];
+      sameLayout = p.getStrides() == dp.getStrides() &&
+                   p.getDataOffset() - group.begin == dp.getDataOffset() - gradientGroup.begin;
+    }
+    if (!sameLayout)
+      throw std::invalid_argument("ParameterRegistry: los gradientes no comparten memoria como sus parametros.");
+
+    group.start = gradientGroup.start = total;
+    total += (group.end - group.begin + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+  }
+
+  // Buffers a cero: el relleno entre tramos no se toca nunca.
+  parameterBuffer = Tensor({total});
+  gradientBuffer = Tensor({total});
+  for (size_t g = 0; g < groups.size(); ++g) {
+    relocate(groups[g], parameters, parameterBuffer);
+    relocate(gradientGroups[g], gradients, gradientBuffer);
+  }
+}
+
+void ParameterRegistry::zeroGradients() {
+  float *data = gradientBuffer.getData();
+  parallelChunks(size(), [data](size_t begin, size_t count) { std::fill(data + begin, data + begin + count, 0.0f); });
+}
@@ -0,0 +1,168 @@
+#include "core/Quantization.hpp"
+#include "core/Kernels.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace {
+constexpr size_t MR = GEMM_MR;
+constexpr size_t NR = GEMM_NR;
+// Filas de A por tarea: el bloque cuantizado (MC x k bytes) se queda en L1/L2 mientras
+// se recorren todos los paneles de B.
+constexpr size_t MC = 72;
+
+// Punto cero de las activaciones uint8.
+constexpr int32_t ZERO_POINT = 128;
+
+// Redondea t al entero mas cercano (al par en los empates) y lo recorta a [-127, 127].
+// Sumar 1.5 * 2^23 deja el entero en los bits bajos de la mantisa; como los bits de un
+// float crecen con su valor, el recorte en enteros tambien vale para |t| grandes. Sin
+// comparaciones de float el bucle se vectoriza aunque el compilador respete las
+// excepciones. Es el mismo redondeo que KernelTable::quantizeU8 usa para las activaciones.
+inline int32_t roundClamped(float t) {
+  const float shifted = t + 12582912.0f;
+  int32_t bits;
+  std::memcpy(&bits, &shifted, sizeof(bits));
+  return std::min(std::max(bits - 0x4B400000, -127), 127);
+}
+
+// Posicion del elemento (k = p, fila o columna 'lane') en un panel de 'width' lineas.
+inline size_t quadIndex(size_t p, size_t lane, size_t width) { return ((p >> 2) * width + lane) * 4 + (p & 3); }
+
+// Cuantiza un bloque mc x k de A a uint8 en paneles de MR filas (ver gemmMicroKernelU8S8).
+// Cada fila se cuantiza primero entera en 'row' con el kernel vectorizado y luego se
+// reparte en grupos de 4 bytes. Las filas y los k de relleno quedan en el punto cero.
+void packAInt8(size_t mc, size_t k, size_t kQuads, const float *a, size_t rsA, size_t csA, float invScale,
+               float *gather, uint8_t *row, uint8_t *dst) {
+  const auto quantize = kernels().quantizeU8;
+  std::fill(dst, dst + (mc + MR - 1) / MR * MR * kQuads * 4, static_cast<uint8_t>(ZERO_POINT));
+  std::fill(row + k, row + kQuads * 4, static_cast<uint8_t>(ZERO_POINT));
+  for (size_t i = 0; i < mc; ++i) {
+    const float *src = a + i * rsA;
+    if (csA != 1) {
+      // Fila con stride (A transpuesta): se copia antes a un buffer contiguo.
+      for (size_t p = 0; p < k; ++p)
+        gather[p] = src[p * csA];
+      src = gather;
+    }
+    quantize(src, invScale, row, k);
+    uint8_t *panel = dst + (i / MR) * MR * kQuads * 4 + (i % MR) * 4;
+    for (size_t q = 0; q < kQuads; ++q)
+      std::memcpy(panel + q * MR * 4, row + q * 4, 4);
+  }
+}
+
+bool inParallelRegion() {
+#ifdef _OPENMP
+  return omp_in_parallel() != 0;
+#else
+  return false;
+#endif
+}
+} // namespace
+
+QuantizedMatrix::QuantizedMatrix(const float *b, size_t k, size_t n, size_t rsB, size_t csB, float inputScale,
+                                 const float *bias)
+    : k(k), n(n), kQuads((k + 3) / 4), invInputScale(1.0f / inputScale) {
+  const size_t nPanels = (n + NR - 1) / NR;
+  this->panels.assign(nPanels * NR * this->kQuads * 4, 0);
+  this->zeroCorrection.assign(n, 0);
+  this->outputScale.assign(n, 0.0f);
+  this->bias.assign(n, 0.0f);
+
+  for (size_t j = 0; j < n; ++j) {
+    float colMax = 0.0f;
+    for (size_t p = 0; p < k; ++p)
+      colMax = std::max(colMax, std::fabs(b[p * rsB + j * csB]));
+    // Una columna de ceros se queda en ceros con cualquier escala.
+    const float scale = colMax > 0.0f ? colMax / 127.0f : 1.0f;
+
+    int8_t *panel = this->panels.data() + (j / NR) * NR * this->kQuads * 4;
+    int32_t colSum = 0;
+    for (size_t p = 0; p < k; ++p) {
+      const int32_t q = roundClamped(b[p * rsB + j * csB] / scale);
+      panel[quadIndex(p, j % NR, NR)] = static_cast<int8_t>(q);
+      colSum += q;
+    }
+    this->zeroCorrection[j] = ZERO_POINT * colSum;
+    this->outputScale[j] = inputScale * scale;
+    if (bias)
+      this->bias[j] = bias[j];
+  }
+}
+
+void qgemm(size_t m, const float *a, size_t rsA, size_t csA, const QuantizedMatrix &b, float *c, size_t rsC) {
+  const size_t n = b.n;
+  const size_t kQuads = b.kQuads;
+  const size_t nPanels = (n + NR - 1) / NR;
+  const size_t mBlocks = (m + MC - 1) / MC;
+  const auto kernel = kernels().gemmMicroKernelU8S8;
+
+#pragma omp parallel for schedule(static) if (mBlocks > 1 && !inParallelRegion())
+  for (size_t ib = 0; ib < mBlocks; ++ib) {
+    static thread_local std::vector<uint8_t> packedA;
+    static thread_local std::vector<uint8_t> row;
+    static thread_local std::vector<float> gather;
+    const size_t ic = ib * MC;
+    const size_t mc = std::min(MC, m - ic);
+    const size_t mcPadded = (mc + MR - 1) / MR * MR;
+    if (packedA.size() < mcPadded * kQuads * 4)
+      packedA.resize(mcPadded * kQuads * 4);
+    if (row.size() < kQuads * 4) {
+      row.resize(kQuads * 4);
+      gather.resize(kQuads * 4);
+    }
+    packAInt8(mc, b.k, kQuads, a + ic * rsA, rsA, csA, b.invInputScale, gather.data(), row.data(), packedA.data());
+
+    for (size_t jp = 0; jp < nPanels; ++jp) {
+      const size_t j0 = jp * NR;
+      const Int8Output out{b.zeroCorrection.data() + j0, b.outputScale.data() + j0, b.bias.data() + j0};
+      const int8_t *bPanel = b.panels.data() + jp * NR * kQuads * 4;
+      for (size_t ir = 0; ir < mc; ir += MR) {
+        kernel(kQuads, packedA.data() + ir * kQuads * 4, bPanel, out, c + (ic + ir) * rsC + j0, rsC,
+               std::min(MR, mc - ir), std::min(NR, n - j0));
+      }
+    }
+  }
+}
+
+void Int8Linear::setMode(Int8Mode newMode, const Tensor &weights, const Tensor &bias) {
+  if (newMode == Int8Mode::Quantized) {
+    if (this->absMax <= 0.0f)
+      throw std::runtime_error("Int8Linear: no hay rango de entrada; calibra la capa antes de cuantizarla.");
+    const auto &shape = weights.getShape();
+    const auto &strides = weights.getStrides();
+    this->matrix = QuantizedMatrix(weights.getData() + weights.getDataOffset(), shape[0], shape[1], strides[0],
+                                   strides[1], this->absMax / 127.0f, bias.getData() + bias.getDataOffset());
+  } else {
+    this->matrix = QuantizedMatrix();
+    if (newMode == Int8Mode::Calibrate)
+      this->absMax = 0.0f;
+  }
+  this->mode = newMode;
+}
+
+void Int8Linear::observe(const Tensor &input) {
+  if (this->mode != Int8Mode::Calibrate)
+    return;
+  const Tensor dense = input.isContiguous() ? input : input.contiguous();
+  const float *data = dense.getData() + dense.getDataOffset();
+  const size_t size = dense.getSize();
+  float localMax = 0.0f;
+#pragma omp parallel for reduction(max : localMax) if (size > 65536)
+  for (size_t i = 0; i < size; ++i)
+    localMax = std::max(localMax, std::fabs(data[i]));
+  this->absMax = std::max(this->absMax, localMax);
+}
+
+void Int8Linear::forward(const Tensor &input, Tensor &output) const {
+  const auto &strides = input.getStrides();
+  qgemm(input.getShape()[0], input.getData() + input.getDataOffset(), strides[0], strides[1], this->matrix,
+        output.getData() + output.getDataOffset(), this->matrix.cols());
+}
@@ -1,4 +1,7 @@
 #include "core/Tensor.hpp"
+#include "core/Allocator.hpp"
+#include "core/Gemm.hpp"
+#include "core/Kernels.hpp"
 
 #include <algorithm>
 #include <iostream>
@@ -36,26 +39,38 @@ void Tensor::computeStrides() {
 Tensor::Tensor() : dataOffset(0), totalSize(0) {}
 
 // Constructor de un tensor "propietario" (dueño de la memoria).
-// Crea la memoria para los datos y la inicializa a cero.
+// Pide la memoria al asignador activo y la inicializa a cero.
 Tensor::Tensor(const std::vector<size_t> &newShape) : shape(newShape), dataOffset(0) {
   totalSize = newShape.empty() ? 0 : std::accumulate(newShape.begin(), newShape.end(), 1, std::multiplies<size_t>());
-  dataPtr = std::make_shared<std::vector<float>>(totalSize, 0.0f);
+  dataPtr = allocateStorage(totalSize, true);
   computeStrides();
 }
 
+// Tensor propietario cuyos datos no se inicializan.
+Tensor Tensor::uninitialized(const std::vector<size_t> &newShape) {
+  Tensor result;
+  result.shape = newShape;
+  result.totalSize =
+      newShape.empty() ? 0 : std::accumulate(newShape.begin(), newShape.end(), 1, std::multiplies<size_t>());
+  result.dataPtr = allocateStorage(result.totalSize, false);
+  result.computeStrides();
+  return result;
+}
+
 // Constructor de un tensor "propietario" con datos iniciales.
 Tensor::Tensor(const std::vector<size_t> &newShape, const std::vector<float> &initialData) : shape(newShape), dataOffset(0) {
   totalSize = std::accumulate(newShape.begin(), newShape.end(), 1, std::multiplies<size_t>());
   if (totalSize != initialData.size()) {
     throw std::invalid_argument("El tamaño de los datos iniciales no coincide con la forma del tensor.");
   }
-  dataPtr = std::make_shared<std::vector<float>>(initialData);
+  dataPtr = allocateStorage(totalSize, false);
+  std::copy(initialData.begin(), initialData.end(), dataPtr.get());
   computeStrides();
 }
 
 // Constructor privado para crear vistas (slices, reshapes, etc.).
 // Reutiliza el puntero de datos del tensor original.
-Tensor::Tensor(std::shared_ptr<std::vector<float>> ptr, const std::vector<size_t> &newShape,
+Tensor::Tensor(std::shared_ptr<float[]> ptr, const std::vector<size_t> &newShape,
                const std::vector<size_t> &newStrides, size_t offset)
     : dataPtr(std::move(ptr)), shape(newShape), strides(newStrides), dataOffset(offset) {
   totalSize = shape.empty() ? 0 : std::accumulate(shape.begin(), shape.end(), 1, std::multiplies<size_t>());
@@ -67,14 +82,14 @@ Tensor::Tensor(std::shared_ptr<std::vector<float>> ptr, const std::vector<size_t
 float *Tensor::getData() {
   if (!dataPtr)
     return nullptr;
-  return dataPtr->data();
+  return dataPtr.get();
 }
 
 // Devuelve un puntero de solo lectura al inicio del bloque de datos.
 const float *Tensor::getData() const {
   if (!dataPtr)
     return nullptr;
-  return dataPtr->data();
+  return dataPtr.get();
 }
 
 // Comprueba si el tensor es contiguo en memoria.
@@ -109,10 +124,18 @@ std::string Tensor::shapeToString() const {
 
 // --- Inicializacion y Modificacion ---
 
-// Rellena el tensor con un valor escalar. Solo para tensores contiguos.
+// Rellena el tensor con un valor escalar. Admite tensores contiguos y vistas 2D con filas
+// contiguas (ej. los bloques de QKVProjection).
 void Tensor::fill(float value) {
   if (!isContiguous()) {
-    throw std::runtime_error("fill() solo se puede usar en tensores contiguos.");
+    if (shape.size() != 2 || strides[1] != 1) {
+      throw std::runtime_error("fill() solo se puede usar en tensores contiguos o vistas 2D con filas contiguas.");
+    }
+    for (size_t r = 0; r < shape[0]; ++r) {
+      float *row = this->getData() + this->dataOffset + r * strides[0];
+      std::fill(row, row + shape[1], value);
+    }
+    return;
   }
   if (dataPtr) {
     float *start_ptr = this->getData() + this->dataOffset;
@@ -182,9 +205,9 @@ Tensor Tensor::reshape(const std::vector<size_t> &newShape) const {
   if (this->totalSize != newTotalSize) {
     throw std::runtime_error("No se puede hacer reshape: el numero total de elementos debe ser el mismo.");
   }
-  // Crea un tensor temporal solo para calcular los nuevos strides.
-  Tensor tempForStrides(newShape);
-  return Tensor(this->dataPtr, newShape, tempForStrides.getStrides(), this->dataOffset);
+  Tensor view(this->dataPtr, newShape, {}, this->dataOffset);
+  view.computeStrides();
+  return view;
 }
 
 // Devuelve una vista transpuesta del tensor intercambiando dos dimensiones.
@@ -208,7 +231,7 @@ Tensor Tensor::contiguous() const {
     return *this;
   }
 
-  Tensor new_tensor(this->shape);
+  Tensor new_tensor = Tensor::uninitialized(this->shape);
   // Usa los operadores () que manejan strides para copiar elemento por elemento
   // desde el tensor (posiblemente no contiguo) al nuevo tensor contiguo.
   if (shape.size() == 4) {
@@ -240,7 +263,17 @@ Tensor Tensor::operator+(const Tensor &other) const {
                                 other.shapeToString());
   }
 
-  Tensor result(this->shape);
+  Tensor result = Tensor::uninitialized(this->shape);
+
+  // Camino rapido: ambos operandos contiguos, se suman con el kernel vectorizado.
+  if (this->isContiguous() && other.isContiguous()) {
+    const float *a_data = this->getData() + this->dataOffset;
+    const float *b_data = other.getData() + other.getDataOffset();
+    float *out_data = result.getData();
+    const auto add = kernels().add;
+    parallelChunks(totalSize, [&](size_t begin, size_t count) { add(a_data + begin, b_data + begin, out_data + begin, count); });
+    return result;
+  }
 
   // Iteramos sobre el tensor de salida. El uso de los operadores () asegura
   // que funcione correctamente incluso para tensores no contiguos (vistas).
@@ -274,7 +307,16 @@ Tensor Tensor::operator+(const Tensor &other) const {
 
 // Devuelve un nuevo tensor con el cuadrado de cada elemento.
 Tensor Tensor::square() const {
-  Tensor result(this->shape);
+  Tensor result = Tensor::uninitialized(this->shape);
+
+  // Camino rapido para tensores contiguos con el kernel vectorizado.
+  if (isContiguous()) {
+    const float *in_data = this->getData() + this->dataOffset;
+    float *out_data = result.getData();
+    const auto mul = kernels().mul;
+    parallelChunks(totalSize, [&](size_t begin, size_t count) { mul(in_data + begin, in_data + begin, out_data + begin, count); });
+    return result;
+  }
 
   if (this->shape.size() == 2) {
 #pragma omp parallel for collapse(2)
@@ -382,11 +424,27 @@ void Tensor::addBroadcast(const Tensor &other) {
 
 // Realiza la multiplicacion de matrices (GEMM: General Matrix Multiply).
 // Multiplica una matriz A (m x n) por una matriz B (n x p), resultando en C (m x p).
-// Funciona correctamente con vistas (slices, transposiciones) gracias al acceso `()`.
+// Delega en el nucleo sgemm, que consume directamente los strides y offsets de
+// 'a' y 'b', por lo que las vistas (slices, transposiciones) no se copian.
 Tensor matrixMultiply(const Tensor &a, const Tensor &b) {
   const auto &aShape = a.getShape();
   const auto &bShape = b.getShape();
 
+  if (aShape.size() != 2 || bShape.size() != 2) {
+    throw std::runtime_error("matrixMultiply solo esta implementada para tensores 2D.");
+  }
+
+  Tensor result = Tensor::uninitialized({aShape[0], bShape[1]});
+  matrixMultiply(a, b, result);
+  return result;
+}
+
+// Version de matrixMultiply que escribe (o acumula) en un tensor destino ya existente,
+// que puede ser una vista con strides siempre que sus filas sean contiguas.
+void matrixMultiply(const Tensor &a, const Tensor &b, Tensor &out, bool accumulate) {
+  const auto &aShape = a.getShape();
+  const auto &bShape = b.getShape();
+
   if (aShape.size() != 2 || bShape.size() != 2) {
     throw std::runtime_error("matrixMultiply solo esta implementada para tensores 2D.");
   }
@@ -399,62 +457,122 @@ Tensor matrixMultiply(const Tensor &a, const Tensor &b) {
   const size_t n = aShape[1];
   const size_t p = bShape[1];
 
-  Tensor result({m, p});
-
-  // Se paraleliza el bucle mas externo.
-#pragma omp parallel for
-  for (size_t i = 0; i < m; ++i) {
-    for (size_t j = 0; j < p; ++j) {
-      float sum = 0.0f;
-      for (size_t k = 0; k < n; ++k) {
-        // El uso de a(i, k) y b(k, j) asegura que se manejen correctamente los
-        // strides y offsets si 'a' o 'b' son vistas.
-        sum += a(i, k) * b(k, j);
-      }
-      result(i, j) = sum;
-    }
+  const auto &outShape = out.getShape();
+  if (outShape.size() != 2 || outShape[0] != m || outShape[1] != p) {
+    throw std::invalid_argument("Forma de destino " + out.shapeToString() + " incompatible con el producto de " +
+                                a.shapeToString() + " y " + b.shapeToString());
   }
-  return result;
+  if (out.getStrides()[1] != 1) {
+    throw std::runtime_error("El tensor destino de matrixMultiply debe tener filas contiguas (ultimo stride 1).");
+  }
+
+  const auto &aStrides = a.getStrides();
+  const auto &bStrides = b.getStrides();
+  sgemm(m, p, n, a.getData() + a.getDataOffset(), aStrides[0], aStrides[1], b.getData() + b.getDataOffset(), bStrides[0],
+        bStrides[1], out.getData() + out.getDataOffset(), out.getStrides()[0], accumulate);
 }
 
-// Realiza la multiplicacion de matrices por lotes (BMM: Batched Matrix Multiply).
-// Multiplica un tensor A (B x m x n) por un tensor B (B x n x p), resultando C (B x m x p).
-Tensor batchMatrixMultiply(const Tensor &a, const Tensor &b) {
+// --- Multiplicacion de matrices por lotes ---
+
+namespace {
+// Comprueba que 'a' y 'b' sean lotes de matrices compatibles: rank 3 {L, m, n} o
+// rank 4 {L0, L1, m, n}, con las mismas dimensiones de lote.
+void checkBatchOperands(const Tensor &a, const Tensor &b) {
   const auto &aShape = a.getShape();
   const auto &bShape = b.getShape();
-
-  if (aShape.size() != 3 || bShape.size() != 3) {
-    throw std::runtime_error("BMM solo esta implementado para tensores 3D.");
+  if ((aShape.size() != 3 && aShape.size() != 4) || aShape.size() != bShape.size()) {
+    throw std::runtime_error("BMM solo esta implementado para tensores 3D o 4D del mismo rank.");
   }
-  if (aShape[0] != bShape[0]) {
+  const size_t rank = aShape.size();
+  if (!std::equal(aShape.begin(), aShape.end() - 2, bShape.begin())) {
     throw std::runtime_error("El tamaño del batch debe ser el mismo para ambos tensores en BMM.");
   }
-  if (aShape[2] != bShape[1]) {
+  if (aShape[rank - 1] != bShape[rank - 2]) {
     throw std::runtime_error("Dimensiones de matriz incompatibles para BMM: " + a.shapeToString() + " y " + b.shapeToString());
   }
+}
 
-  const size_t batchSize = aShape[0];
-  const size_t m = aShape[1];
-  const size_t n = aShape[2];
-  const size_t p = bShape[2];
-
-  Tensor result({batchSize, m, p});
-
+// Ejecuta un sgemm por cada matriz del lote usando los strides de los tres tensores.
+// Las dimensiones de lote pueden tener cualquier stride, de modo que las vistas
+// {B, N, h, d_h} -> {B, h, N, d_h} se consumen y se escriben sin copiarlas.
+void stridedBatchGemm(const Tensor &a, const Tensor &b, Tensor &out, bool accumulate) {
+  const auto &aShape = a.getShape();
+  const auto &bShape = b.getShape();
+  const size_t rank = aShape.size();
+  const size_t m = aShape[rank - 2];
+  const size_t n = aShape[rank - 1];
+  const size_t p = bShape[rank - 1];
+
+  // Un lote 3D se trata como 4D con una primera dimension de lote de tamaño 1.
+  const size_t outer = rank == 4 ? aShape[0] : 1;
+  const size_t inner = aShape[rank - 3];
+  const size_t batchSize = outer * inner;
+
+  const auto &aStrides = a.getStrides();
+  const auto &bStrides = b.getStrides();
+  const auto &cStrides = out.getStrides();
+  const float *aData = a.getData() + a.getDataOffset();
+  const float *bData = b.getData() + b.getDataOffset();
+  float *cData = out.getData() + out.getDataOffset();
+
+  auto runOne = [&](size_t idx) {
+    const size_t i0 = idx / inner;
+    const size_t i1 = idx % inner;
+    const size_t aOff = (rank == 4 ? i0 * aStrides[0] : 0) + i1 * aStrides[rank - 3];
+    const size_t bOff = (rank == 4 ? i0 * bStrides[0] : 0) + i1 * bStrides[rank - 3];
+    const size_t cOff = (rank == 4 ? i0 * cStrides[0] : 0) + i1 * cStrides[rank - 3];
+    sgemm(m, p, n, aData + aOff, aStrides[rank - 2], aStrides[rank - 1], bData + bOff, bStrides[rank - 2],
+          bStrides[rank - 1], cData + cOff, cStrides[rank - 2], accumulate);
+  };
+
+  // Con suficientes matrices se reparte el lote entre hilos y cada sgemm corre en
+  // serie; si el lote es pequeño, cada sgemm se paraleliza internamente.
+  int numThreads = 1;
+#ifdef _OPENMP
+  numThreads = omp_get_max_threads();
+#endif
+  if (batchSize >= static_cast<size_t>(numThreads)) {
 #pragma omp parallel for
-  for (size_t i = 0; i < batchSize; ++i) {
-    for (size_t j = 0; j < m; ++j) {
-      for (size_t k = 0; k < p; ++k) {
-        float sum = 0.0f;
-        for (size_t l = 0; l < n; ++l) {
-          sum += a(i, j, l) * b(i, l, k);
-        }
-        result(i, j, k) = sum;
-      }
-    }
+    for (size_t i = 0; i < batchSize; ++i)
+      runOne(i);
+  } else {
+    for (size_t i = 0; i < batchSize; ++i)
+      runOne(i);
   }
+}
+} // namespace
+
+// Realiza la multiplicacion de matrices por lotes (BMM: Batched Matrix Multiply).
+// Multiplica un tensor A (L x m x n) por un tensor B (L x n x p), resultando C (L x m x p).
+// Tambien acepta lotes 4D {L0, L1, m, n}. Los operandos pueden ser vistas con strides
+// arbitrarios (transposiciones, divisiones de cabezas) y no se copian.
+Tensor batchMatrixMultiply(const Tensor &a, const Tensor &b) {
+  checkBatchOperands(a, b);
+  std::vector<size_t> resultShape = a.getShape();
+  resultShape.back() = b.getShape().back();
+  Tensor result = Tensor::uninitialized(resultShape);
+  stridedBatchGemm(a, b, result, false);
   return result;
 }
 
+// Version de BMM que escribe (o acumula) en un tensor destino ya existente, que
+// puede ser una vista con strides siempre que sus filas sean contiguas.
+void batchMatrixMultiply(const Tensor &a, const Tensor &b, Tensor &out, bool accumulate) {
+  checkBatchOperands(a, b);
+  // Se compara sin construir la forma esperada: esta funcion no reserva memoria.
+  const auto &aShape = a.getShape();
+  const auto &outShape = out.getShape();
+  if (outShape.size() != aShape.size() || !std::equal(aShape.begin(), aShape.end() - 1, outShape.begin()) ||
+      outShape.back() != b.getShape().back()) {
+    throw std::invalid_argument("Forma de destino " + out.shapeToString() + " incompatible con BMM de " + a.shapeToString() +
+                                " y " + b.shapeToString());
+  }
+  if (out.getStrides().back() != 1) {
+    throw std::runtime_error("El tensor destino de BMM debe tener filas contiguas (ultimo stride 1).");
+  }
+  stridedBatchGemm(a, b, out, accumulate);
+}
+
 // Concatena una lista de tensores a lo largo de un eje especifico.
 // Todos los tensores deben tener las mismas dimensiones excepto en el eje de concatenacion.
 Tensor concatenate(const std::vector<Tensor> &tensors, size_t axis) {
@@ -483,7 +601,7 @@ Tensor concatenate(const std::vector<Tensor> &tensors, size_t axis) {
   // 2. Calcular la nueva forma y crear el tensor resultado
   std::vector<size_t> newShape = firstShape;
   newShape[axis] = newDimSize;
-  Tensor result(newShape);
+  Tensor result = Tensor::uninitialized(newShape); // Los slices lo cubren por completo.
 
   // 3. Copiar los datos de cada tensor en la seccion correcta del resultado
   size_t offset_on_axis = 0;
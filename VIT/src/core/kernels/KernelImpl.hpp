@@ -0,0 +1,361 @@
+#ifndef KERNEL_IMPL_HPP
+#define KERNEL_IMPL_HPP
+
+// Implementacion generica de los kernels de core/Kernels.hpp.
+//
+// Este archivo se incluye desde cada unidad de traduccion de un nivel SIMD
+// (KernelsScalar.cpp, KernelsSSE41.cpp, ...). Cada una define un tipo 'Vec' con
+// las operaciones basicas sobre su registro vectorial y obtiene la tabla con
+// makeKernelTable<Vec>(). Todo vive en un namespace anonimo y solo usa builtins
+// del compilador para que ninguna funcion compilada con instrucciones de un nivel
+// superior pueda acabar enlazada desde otro nivel.
+
+#include "core/Kernels.hpp"
+
+namespace {
+
+// Version escalar de la interfaz vectorial. La usan el nivel escalar y las colas
+// de los bucles de los demas niveles, de modo que todos calculan lo mismo.
+struct ScalarVec {
+  using Reg = float;
+  static constexpr size_t W = 1;
+  static Reg load(const float *p) { return *p; }
+  static void store(float *p, Reg x) { *p = x; }
+  static Reg set1(float x) { return x; }
+  static Reg zero() { return 0.0f; }
+  static Reg add(Reg a, Reg b) { return a + b; }
+  static Reg sub(Reg a, Reg b) { return a - b; }
+  static Reg mul(Reg a, Reg b) { return a * b; }
+  static Reg div(Reg a, Reg b) { return a / b; }
+  static Reg fmadd(Reg a, Reg b, Reg c) { return a * b + c; }
+  static Reg max(Reg a, Reg b) { return a > b ? a : b; }
+  static Reg min(Reg a, Reg b) { return a < b ? a : b; }
+  static Reg sqrt(Reg x) { return __builtin_sqrtf(x); }
+  static Reg round(Reg x) { return __builtin_nearbyintf(x); }
+  // 2^n para n entero representado como float.
+  static Reg pow2n(Reg n) {
+    const int bits = (static_cast<int>(n) + 127) << 23;
+    float out;
+    __builtin_memcpy(&out, &bits, sizeof(out));
+    return out;
+  }
+  static float reduceAdd(Reg x) { return x; }
+  static float reduceMax(Reg x) { return x; }
+};
+
+// exp(x) con la reduccion de rango y el polinomio de Cephes (error relativo ~1e-7).
+template <typename V> typename V::Reg vexp(typename V::Reg x) {
+  using Reg = typename V::Reg;
+  x = V::min(V::max(x, V::set1(-87.3f)), V::set1(88.3f));
+  // x = n * ln2 + r, con |r| <= ln2 / 2. ln2 se separa en dos partes para no perder precision.
+  const Reg n = V::round(V::mul(x, V::set1(1.44269504088896341f)));
+  Reg r = V::fmadd(n, V::set1(-0.693359375f), x);
+  r = V::fmadd(n, V::set1(2.12194440e-4f), r);
+
+  Reg p = V::set1(1.9875691500e-4f);
+  p = V::fmadd(p, r, V::set1(1.3981999507e-3f));
+  p = V::fmadd(p, r, V::set1(8.3334519073e-3f));
+  p = V::fmadd(p, r, V::set1(4.1665795894e-2f));
+  p = V::fmadd(p, r, V::set1(1.6666665459e-1f));
+  p = V::fmadd(p, r, V::set1(5.0000001201e-1f));
+  p = V::fmadd(p, V::mul(r, r), V::add(r, V::set1(1.0f)));
+  return V::mul(p, V::pow2n(n));
+}
+
+// Recorre [0, n) en pasos de V::W y termina la cola con ScalarVec.
+// 'f(tag, i)' recibe como primer argumento una instancia del tipo a usar.
+template <typename V, typename F> void forEach(size_t n, F &&f) {
+  size_t i = 0;
+  for (; i + V::W <= n; i += V::W)
+    f(V{}, i);
+  for (; i < n; ++i)
+    f(ScalarVec{}, i);
+}
+
+// Constantes de la aproximacion de GELU: sqrt(2/pi) y el coeficiente cubico.
+constexpr float GELU_C = 0.7978845608028654f;
+constexpr float GELU_A = 0.044715f;
+
+template <typename V> struct KernelImpl {
+  static void add(const float *a, const float *b, float *out, size_t n) {
+    forEach<V>(n, [&](auto tag, size_t i) {
+      using U = decltype(tag);
+      U::store(out + i, U::add(U::load(a + i), U::load(b + i)));
+    });
+  }
+
+  static void mul(const float *a, const float *b, float *out, size_t n) {
+    forEach<V>(n, [&](auto tag, size_t i) {
+      using U = decltype(tag);
+      U::store(out + i, U::mul(U::load(a + i), U::load(b + i)));
+    });
+  }
+
+  static void scale(float *x, float alpha, size_t n) {
+    forEach<V>(n, [&](auto tag, size_t i) {
+      using U = decltype(tag);
+      U::store(x + i, U::mul(U::load(x + i), U::set1(alpha)));
+    });
+  }
+
+  static void axpy(float alpha, const float *x, float *y, size_t n) {
+    forEach<V>(n, [&](auto tag, size_t i) {
+      using U = decltype(tag);
+      U::store(y + i, U::fmadd(U::set1(alpha), U::load(x + i), U::load(y + i)));
+    });
+  }
+
+  static float sum(const float *x, size_t n) {
+    typename V::Reg acc = V::zero();
+    size_t i = 0;
+    for (; i + V::W <= n; i += V::W)
+      acc = V::add(acc, V::load(x + i));
+    float total = V::reduceAdd(acc);
+    for (; i < n; ++i)
+      total += x[i];
+    return total;
+  }
+
+  static float max(const float *x, size_t n) {
+    if (n == 0)
+      return -__builtin_inff();
+    typename V::Reg acc = V::set1(x[0]);
+    size_t i = 0;
+    for (; i + V::W <= n; i += V::W)
+      acc = V::max(acc, V::load(x + i));
+    float best = V::reduceMax(acc);
+    for (; i < n; ++i)
+      best = x[i] > best ? x[i] : best;
+    return best;
+  }
+
+  static float dot(const float *a, const float *b, size_t n) {
+    typename V::Reg acc = V::zero();
+    size_t i = 0;
+    for (; i + V::W <= n; i += V::W)
+      acc = V::fmadd(V::load(a + i), V::load(b + i), acc);
+    float total = V::reduceAdd(acc);
+    for (; i < n; ++i)
+      total += a[i] * b[i];
+    return total;
+  }
+
+  static float expSum(const float *x, float *out, size_t n, float shift) {
+    typename V::Reg acc = V::zero();
+    size_t i = 0;
+    for (; i + V::W <= n; i += V::W) {
+      const typename V::Reg e = vexp<V>(V::sub(V::load(x + i), V::set1(shift)));
+      V::store(out + i, e);
+      acc = V::add(acc, e);
+    }
+    float total = V::reduceAdd(acc);
+    for (; i < n; ++i) {
+      out[i] = vexp<ScalarVec>(x[i] - shift);
+      total += out[i];
+    }
+    return total;
+  }
+
+  static void softmaxRow(const float *x, float *out, size_t n) {
+    // exp(x - max) se escribe en la salida y se acumula la suma en el mismo recorrido.
+    const float total = expSum(x, out, n, max(x, n));
+    scale(out, 1.0f / total, n);
+  }
+
+  static void softmaxGradRow(const float *grad, const float *s, float rowDot, float *out, size_t n) {
+    forEach<V>(n, [&](auto tag, size_t i) {
+      using U = decltype(tag);
+      const auto si = U::load(s + i);
+      U::store(out + i, U::mul(si, U::sub(U::load(grad + i), U::set1(rowDot))));
+    });
+  }
+
+  static void softmaxBackwardRow(const float *grad, const float *s, float *out, size_t n) {
+    softmaxGradRow(grad, s, dot(grad, s, n), out, n);
+  }
+
+  // 0.5 * x * (1 + tanh(u)) = x * sigmoid(2u), con u = sqrt(2/pi) * (x + 0.044715 x^3).
+  static void geluForward(const float *x, float *out, size_t n) {
+    forEach<V>(n, [&](auto tag, size_t i) {
+      using U = decltype(tag);
+      const auto xi = U::load(x + i);
+      const auto x2 = U::mul(xi, xi);
+      const auto u = U::mul(U::mul(xi, U::set1(GELU_C)), U::fmadd(x2, U::set1(GELU_A), U::set1(1.0f)));
+      const auto e = vexp<U>(U::mul(u, U::set1(-2.0f)));
+      U::store(out + i, U::div(xi, U::add(U::set1(1.0f), e)));
+    });
+  }
+
+  // dGELU/dx = 0.5 * (1 + tanh(u)) + 0.5 * x * (1 - tanh^2(u)) * du/dx
+  static void geluBackward(const float *x, const float *grad, float *out, size_t n) {
+    forEach<V>(n, [&](auto tag, size_t i) {
+      using U = decltype(tag);
+      const auto one = U::set1(1.0f);
+      const auto xi = U::load(x + i);
+      const auto x2 = U::mul(xi, xi);
+      const auto u = U::mul(U::mul(xi, U::set1(GELU_C)), U::fmadd(x2, U::set1(GELU_A), one));
+      const auto sig = U::div(one, U::add(one, vexp<U>(U::mul(u, U::set1(-2.0f)))));
+      const auto t = U::fmadd(sig, U::set1(2.0f), U::set1(-1.0f));
+      const auto sech2 = U::sub(one, U::mul(t, t));
+      const auto du = U::mul(U::set1(GELU_C), U::fmadd(x2, U::set1(3.0f * GELU_A), one));
+      const auto d = U::fmadd(U::mul(U::mul(xi, U::set1(0.5f)), sech2), du, sig);
+      U::store(out + i, U::mul(d, U::load(grad + i)));
+    });
+  }
+
+  static void layerNormRow(const float *x, const float *gamma, const float *beta, float *xHat, float *y, size_t n,
+                           float epsilon, float *meanOut, float *invStdOut) {
+    const float mean = sum(x, n) / static_cast<float>(n);
+
+    typename V::Reg acc = V::zero();
+    size_t i = 0;
+    for (; i + V::W <= n; i += V::W) {
+      const typename V::Reg d = V::sub(V::load(x + i), V::set1(mean));
+      acc = V::fmadd(d, d, acc);
+    }
+    float variance = V::reduceAdd(acc);
+    for (; i < n; ++i)
+      variance += (x[i] - mean) * (x[i] - mean);
+    variance /= static_cast<float>(n);
+    const float invStd = 1.0f / __builtin_sqrtf(variance + epsilon);
+
+    forEach<V>(n, [&](auto tag, size_t j) {
+      using U = decltype(tag);
+      const auto normalized = U::mul(U::sub(U::load(x + j), U::set1(mean)), U::set1(invStd));
+      if (xHat)
+        U::store(xHat + j, normalized);
+      U::store(y + j, U::fmadd(U::load(gamma + j), normalized, U::load(beta + j)));
+    });
+
+    if (meanOut)
+      *meanOut = mean;
+    if (invStdOut)
+      *invStdOut = invStd;
+  }
+
+  static void adamUpdate(float *param, const float *grad, float *m, float *v, size_t n, const AdamStep &step) {
+    const float invBias1 = 1.0f / step.bias1;
+    const float invBias2 = 1.0f / step.bias2;
+    forEach<V>(n, [&](auto tag, size_t i) {
+      using U = decltype(tag);
+      const auto p = U::load(param + i);
+      const auto g = U::fmadd(U::set1(step.weightDecay), p, U::load(grad + i));
+      const auto mi = U::fmadd(U::set1(step.beta1), U::load(m + i), U::mul(U::set1(1.0f - step.beta1), g));
+      const auto vi = U::fmadd(U::set1(step.beta2), U::load(v + i), U::mul(U::set1(1.0f - step.beta2), U::mul(g, g)));
+      U::store(m + i, mi);
+      U::store(v + i, vi);
+      const auto mHat = U::mul(mi, U::set1(invBias1));
+      const auto vHat = U::mul(vi, U::set1(invBias2));
+      const auto denom = U::add(U::sqrt(vHat), U::set1(step.epsilon));
+      U::store(param + i, U::sub(p, U::div(U::mul(U::set1(step.learningRate), mHat), denom)));
+    });
+  }
+
+  // Redondeo con el desplazamiento 1.5 * 2^23 (ver roundClamped en Quantization.cpp): sin
+  // comparaciones de float, asi que el compilador lo vectoriza con las instrucciones del nivel.
+  static void quantizeU8(const float *x, float invScale, uint8_t *out, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+      const float shifted = x[i] * invScale + 12582912.0f;
+      int32_t bits;
+      __builtin_memcpy(&bits, &shifted, sizeof(bits));
+      const int32_t q = bits - 0x4B400000;
+      out[i] = static_cast<uint8_t>((q < -127 ? -127 : (q > 127 ? 127 : q)) + 128);
+    }
+  }
+
+  // Producto u8 x s8 con acumulacion en int32. No usa V; los niveles con instrucciones
+  // enteras adecuadas (AVX2, VNNI) lo sustituyen por uno propio.
+  static void gemmMicroKernelU8S8(size_t kQuads, const uint8_t *a, const int8_t *b, const Int8Output &out, float *c,
+                                  size_t rsC, size_t mr, size_t nr) {
+    int32_t acc[GEMM_MR][GEMM_NR] = {};
+    for (size_t q = 0; q < kQuads; ++q) {
+      const uint8_t *ap = a + q * GEMM_MR * 4;
+      const int8_t *bp = b + q * GEMM_NR * 4;
+      for (size_t r = 0; r < GEMM_MR; ++r) {
+        const int32_t a0 = ap[r * 4], a1 = ap[r * 4 + 1], a2 = ap[r * 4 + 2], a3 = ap[r * 4 + 3];
+        for (size_t j = 0; j < GEMM_NR; ++j)
+          acc[r][j] += a0 * bp[j * 4] + a1 * bp[j * 4 + 1] + a2 * bp[j * 4 + 2] + a3 * bp[j * 4 + 3];
+      }
+    }
+    for (size_t r = 0; r < mr; ++r) {
+      float *crow = c + r * rsC;
+      for (size_t j = 0; j < nr; ++j)
+        crow[j] = static_cast<float>(acc[r][j] - out.zeroCorrection[j]) * out.scale[j] + out.bias[j];
+    }
+  }
+
+  // Tile de GEMM_MR x GEMM_NR en registros: GEMM_NR / W registros por fila.
+  static void gemmMicroKernel(size_t kc, const float *a, const float *b, float *c, size_t rsC, size_t mr, size_t nr,
+                              bool accumulate) {
+    using Reg = typename V::Reg;
+    constexpr size_t R = GEMM_NR / V::W;
+    Reg acc[GEMM_MR][R];
+    for (size_t r = 0; r < GEMM_MR; ++r)
+      for (size_t j = 0; j < R; ++j)
+        acc[r][j] = V::zero();
+
+    for (size_t p = 0; p < kc; ++p) {
+      Reg bv[R];
+      for (size_t j = 0; j < R; ++j)
+        bv[j] = V::load(b + p * GEMM_NR + j * V::W);
+      for (size_t r = 0; r < GEMM_MR; ++r) {
+        const Reg av = V::set1(a[p * GEMM_MR + r]);
+        for (size_t j = 0; j < R; ++j)
+          acc[r][j] = V::fmadd(av, bv[j], acc[r][j]);
+      }
+    }
+
+    if (mr == GEMM_MR && nr == GEMM_NR) {
+      for (size_t r = 0; r < GEMM_MR; ++r) {
+        float *crow = c + r * rsC;
+        for (size_t j = 0; j < R; ++j) {
+          const Reg prev = accumulate ? V::load(crow + j * V::W) : V::zero();
+          V::store(crow + j * V::W, V::add(prev, acc[r][j]));
+        }
+      }
+      return;
+    }
+
+    // Tile parcial (borde de la matriz): se vuelca a un buffer y se copia lo valido.
+    float tile[GEMM_MR * GEMM_NR];
+    for (size_t r = 0; r < GEMM_MR; ++r)
+      for (size_t j = 0; j < R; ++j)
+        V::store(tile + r * GEMM_NR + j * V::W, acc[r][j]);
+    for (size_t r = 0; r < mr; ++r) {
+      float *crow = c + r * rsC;
+      for (size_t j = 0; j < nr; ++j)
+        crow[j] = accumulate ? crow[j] + tile[r * GEMM_NR + j] : tile[r * GEMM_NR + j];
+    }
+  }
+};
+
+// Construye la tabla de un nivel. El microkernel GEMM solo se incluye cuando el
+// nivel tiene registros suficientes para mantener el tile completo.
+template <typename V> KernelTable makeKernelTable(const char *name, bool withGemm) {
+  using K = KernelImpl<V>;
+  KernelTable table{};
+  table.name = name;
+  table.add = K::add;
+  table.mul = K::mul;
+  table.scale = K::scale;
+  table.axpy = K::axpy;
+  table.sum = K::sum;
+  table.max = K::max;
+  table.dot = K::dot;
+  table.expSum = K::expSum;
+  table.softmaxRow = K::softmaxRow;
+  table.softmaxBackwardRow = K::softmaxBackwardRow;
+  table.softmaxGradRow = K::softmaxGradRow;
+  table.geluForward = K::geluForward;
+  table.geluBackward = K::geluBackward;
+  table.layerNormRow = K::layerNormRow;
+  table.adamUpdate = K::adamUpdate;
+  table.gemmMicroKernel = withGemm ? K::gemmMicroKernel : nullptr;
+  table.quantizeU8 = K::quantizeU8;
+  table.gemmMicroKernelU8S8 = K::gemmMicroKernelU8S8;
+  return table;
+}
+
+} // namespace
+
+#endif // KERNEL_IMPL_HPP
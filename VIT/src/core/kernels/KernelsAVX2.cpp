@@ -0,0 +1,107 @@
+#include "KernelImpl.hpp"
+
+// Nivel AVX2 + FMA (8 floats por registro). CMake compila este archivo con
+// -mavx2 -mfma; si el compilador no lo soporta la tabla queda sin definir.
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+
+namespace {
+struct AVX2Vec {
+  using Reg = __m256;
+  static constexpr size_t W = 8;
+  static Reg load(const float *p) { return _mm256_loadu_ps(p); }
+  static void store(float *p, Reg x) { _mm256_storeu_ps(p, x); }
+  static Reg set1(float x) { return _mm256_set1_ps(x); }
+  static Reg zero() { return _mm256_setzero_ps(); }
+  static Reg add(Reg a, Reg b) { return _mm256_add_ps(a, b); }
+  static Reg sub(Reg a, Reg b) { return _mm256_sub_ps(a, b); }
+  static Reg mul(Reg a, Reg b) { return _mm256_mul_ps(a, b); }
+  static Reg div(Reg a, Reg b) { return _mm256_div_ps(a, b); }
+  static Reg fmadd(Reg a, Reg b, Reg c) { return _mm256_fmadd_ps(a, b, c); }
+  static Reg max(Reg a, Reg b) { return _mm256_max_ps(a, b); }
+  static Reg min(Reg a, Reg b) { return _mm256_min_ps(a, b); }
+  static Reg sqrt(Reg x) { return _mm256_sqrt_ps(x); }
+  static Reg round(Reg x) { return _mm256_round_ps(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+  static Reg pow2n(Reg n) {
+    const __m256i e = _mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127));
+    return _mm256_castsi256_ps(_mm256_slli_epi32(e, 23));
+  }
+  static float reduceAdd(Reg x) {
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 0x55));
+    return _mm_cvtss_f32(s);
+  }
+  static float reduceMax(Reg x) {
+    __m128 s = _mm_max_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1));
+    s = _mm_max_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_max_ss(s, _mm_shuffle_ps(s, s, 0x55));
+    return _mm_cvtss_f32(s);
+  }
+};
+
+// Microkernel int8 sin VNNI. vpmaddubsw satura en int16 con u8 x s8, asi que A y B se
+// extienden a int16 y se multiplican con vpmaddwd (exacto): cada registro de B tiene 4
+// columnas x 4 k y el resultado, 2 sumas parciales por columna. El tile se recorre en dos
+// mitades de 8 columnas (12 acumuladores) y las parciales se juntan con vphaddd al final.
+void gemmMicroKernelU8S8(size_t kQuads, const uint8_t *a, const int8_t *b, const Int8Output &out, float *c,
+                         size_t rsC, size_t mr, size_t nr) {
+  constexpr size_t HALF = GEMM_NR / 2;
+  for (size_t h = 0; h < GEMM_NR; h += HALF) {
+    if (h >= nr)
+      break;
+    __m256i acc[GEMM_MR][2];
+    for (size_t r = 0; r < GEMM_MR; ++r)
+      acc[r][0] = acc[r][1] = _mm256_setzero_si256();
+
+    for (size_t q = 0; q < kQuads; ++q) {
+      const int8_t *bp = b + (q * GEMM_NR + h) * 4;
+      const __m256i b0 = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(bp)));
+      const __m256i b1 = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(bp + 16)));
+      const uint8_t *ap = a + q * GEMM_MR * 4;
+      for (size_t r = 0; r < GEMM_MR; ++r) {
+        int quad;
+        __builtin_memcpy(&quad, ap + r * 4, sizeof(quad));
+        const __m256i av = _mm256_cvtepu8_epi16(_mm_set1_epi32(quad));
+        acc[r][0] = _mm256_add_epi32(acc[r][0], _mm256_madd_epi16(av, b0));
+        acc[r][1] = _mm256_add_epi32(acc[r][1], _mm256_madd_epi16(av, b1));
+      }
+    }
+
+    const size_t cols = std::min(HALF, nr - h);
+    if (cols == HALF) {
+      const __m256i correction = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(out.zeroCorrection + h));
+      const __m256 scale = _mm256_loadu_ps(out.scale + h);
+      const __m256 bias = _mm256_loadu_ps(out.bias + h);
+      for (size_t r = 0; r < mr; ++r) {
+        // hadd deja [c0 c1 c4 c5 | c2 c3 c6 c7]; la permutacion ordena las 8 columnas.
+        const __m256i sums = _mm256_permute4x64_epi64(_mm256_hadd_epi32(acc[r][0], acc[r][1]), 0xD8);
+        const __m256 value = _mm256_fmadd_ps(_mm256_cvtepi32_ps(_mm256_sub_epi32(sums, correction)), scale, bias);
+        _mm256_storeu_ps(c + r * rsC + h, value);
+      }
+    } else {
+      for (size_t r = 0; r < mr; ++r) {
+        alignas(32) int32_t sums[HALF];
+        _mm256_store_si256(reinterpret_cast<__m256i *>(sums),
+                           _mm256_permute4x64_epi64(_mm256_hadd_epi32(acc[r][0], acc[r][1]), 0xD8));
+        float *crow = c + r * rsC + h;
+        for (size_t j = 0; j < cols; ++j)
+          crow[j] = static_cast<float>(sums[j] - out.zeroCorrection[h + j]) * out.scale[h + j] + out.bias[h + j];
+      }
+    }
+  }
+}
+} // namespace
+
+// El tile de 6x16 ocupa 12 registros acumuladores + 2 de B + 1 de A.
+const KernelTable *avx2KernelTable() {
+  static const KernelTable table = [] {
+    KernelTable avx2 = makeKernelTable<AVX2Vec>("avx2", true);
+    avx2.gemmMicroKernelU8S8 = gemmMicroKernelU8S8;
+    return avx2;
+  }();
+  return &table;
+}
+#else
+const KernelTable *avx2KernelTable() { return nullptr; }
+#endif
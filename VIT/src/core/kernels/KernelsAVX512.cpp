@@ -0,0 +1,54 @@
+#include "KernelImpl.hpp"
+
+// Nivel AVX-512F (16 floats por registro). CMake compila este archivo con
+// -mavx512f; si el compilador no lo soporta la tabla queda sin definir.
+#if defined(__AVX512F__)
+// GCC 12 avisa de falsos "uninitialized" dentro de las propias intrinsecas
+// (_mm512_undefined_ps en las reducciones y conversiones).
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#include <immintrin.h>
+
+namespace {
+struct AVX512Vec {
+  using Reg = __m512;
+  static constexpr size_t W = 16;
+  static Reg load(const float *p) { return _mm512_loadu_ps(p); }
+  static void store(float *p, Reg x) { _mm512_storeu_ps(p, x); }
+  static Reg set1(float x) { return _mm512_set1_ps(x); }
+  static Reg zero() { return _mm512_setzero_ps(); }
+  static Reg add(Reg a, Reg b) { return _mm512_add_ps(a, b); }
+  static Reg sub(Reg a, Reg b) { return _mm512_sub_ps(a, b); }
+  static Reg mul(Reg a, Reg b) { return _mm512_mul_ps(a, b); }
+  static Reg div(Reg a, Reg b) { return _mm512_div_ps(a, b); }
+  static Reg fmadd(Reg a, Reg b, Reg c) { return _mm512_fmadd_ps(a, b, c); }
+  static Reg max(Reg a, Reg b) { return _mm512_max_ps(a, b); }
+  static Reg min(Reg a, Reg b) { return _mm512_min_ps(a, b); }
+  static Reg sqrt(Reg x) { return _mm512_sqrt_ps(x); }
+  static Reg round(Reg x) { return _mm512_roundscale_ps(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+  static Reg pow2n(Reg n) {
+    const __m512i e = _mm512_add_epi32(_mm512_cvtps_epi32(n), _mm512_set1_epi32(127));
+    return _mm512_castsi512_ps(_mm512_slli_epi32(e, 23));
+  }
+  static float reduceAdd(Reg x) { return _mm512_reduce_add_ps(x); }
+  static float reduceMax(Reg x) { return _mm512_reduce_max_ps(x); }
+};
+} // namespace
+
+const KernelTable *avx2KernelTable();
+
+// El tile de 6x16 ocupa una fila de registro por fila de C (6 acumuladores).
+// AVX-512F no tiene multiplicaciones enteras de 16 bits en 512 bits (son de AVX-512BW):
+// el GEMM int8 usa el microkernel AVX2.
+const KernelTable *avx512KernelTable() {
+  static const KernelTable table = [] {
+    KernelTable avx512 = makeKernelTable<AVX512Vec>("avx512", true);
+    if (const KernelTable *avx2 = avx2KernelTable())
+      avx512.gemmMicroKernelU8S8 = avx2->gemmMicroKernelU8S8;
+    return avx512;
+  }();
+  return &table;
+}
+#else
+const KernelTable *avx512KernelTable() { return nullptr; }
+#endif
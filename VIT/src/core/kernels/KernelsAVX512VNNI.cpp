@@ -0,0 +1,60 @@
+#include "core/Kernels.hpp"
+
+// Nivel AVX-512 con VNNI (Cascade Lake, Ice Lake, Sapphire Rapids, Zen 4). Reutiliza la
+// tabla AVX-512 y solo sustituye el microkernel int8 de la inferencia cuantizada.
+// CMake compila este archivo con -mavx512f -mavx512vnni.
+#if defined(__AVX512VNNI__)
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#include <immintrin.h>
+
+const KernelTable *avx512KernelTable();
+
+namespace {
+static_assert(GEMM_NR == 16, "El microkernel VNNI asume 16 columnas int32 por registro");
+
+// Por cada grupo de 4 k: un registro con los 16 x 4 bytes de B y, por fila, los 4 bytes
+// de A difundidos. vpdpbusd multiplica u8 x s8 y suma los 4 productos en int32.
+void gemmMicroKernelU8S8(size_t kQuads, const uint8_t *a, const int8_t *b, const Int8Output &out, float *c,
+                         size_t rsC, size_t mr, size_t nr) {
+  __m512i acc[GEMM_MR];
+  for (size_t r = 0; r < GEMM_MR; ++r)
+    acc[r] = _mm512_setzero_si512();
+
+  for (size_t q = 0; q < kQuads; ++q) {
+    const __m512i bv = _mm512_loadu_si512(b + q * GEMM_NR * 4);
+    const uint8_t *ap = a + q * GEMM_MR * 4;
+    for (size_t r = 0; r < GEMM_MR; ++r) {
+      int quad;
+      __builtin_memcpy(&quad, ap + r * 4, sizeof(quad));
+      acc[r] = _mm512_dpbusd_epi32(acc[r], _mm512_set1_epi32(quad), bv);
+    }
+  }
+
+  // Salida: las columnas que faltan en el ultimo panel quedan fuera de la mascara.
+  const __mmask16 mask = static_cast<__mmask16>((1u << nr) - 1u);
+  const __m512i correction = _mm512_maskz_loadu_epi32(mask, out.zeroCorrection);
+  const __m512 scale = _mm512_maskz_loadu_ps(mask, out.scale);
+  const __m512 bias = _mm512_maskz_loadu_ps(mask, out.bias);
+  for (size_t r = 0; r < mr; ++r) {
+    const __m512 value = _mm512_fmadd_ps(_mm512_cvtepi32_ps(_mm512_sub_epi32(acc[r], correction)), scale, bias);
+    _mm512_mask_storeu_ps(c + r * rsC, mask, value);
+  }
+}
+} // namespace
+
+const KernelTable *avx512VnniKernelTable() {
+  const KernelTable *base = avx512KernelTable();
+  if (!base)
+    return nullptr;
+  static const KernelTable table = [base] {
+    KernelTable vnni = *base;
+    vnni.name = "avx512vnni";
+    vnni.gemmMicroKernelU8S8 = gemmMicroKernelU8S8;
+    return vnni;
+  }();
+  return &table;
+}
+#else
+const KernelTable *avx512VnniKernelTable() { return nullptr; }
+#endif
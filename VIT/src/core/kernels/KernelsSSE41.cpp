@@ -0,0 +1,49 @@
+#include "KernelImpl.hpp"
+
+// Nivel SSE4.1 (4 floats por registro). CMake compila este archivo con -msse4.1;
+// si el compilador no lo soporta la tabla queda sin definir.
+#if defined(__SSE4_1__)
+#include <immintrin.h>
+
+namespace {
+struct SSE41Vec {
+  using Reg = __m128;
+  static constexpr size_t W = 4;
+  static Reg load(const float *p) { return _mm_loadu_ps(p); }
+  static void store(float *p, Reg x) { _mm_storeu_ps(p, x); }
+  static Reg set1(float x) { return _mm_set1_ps(x); }
+  static Reg zero() { return _mm_setzero_ps(); }
+  static Reg add(Reg a, Reg b) { return _mm_add_ps(a, b); }
+  static Reg sub(Reg a, Reg b) { return _mm_sub_ps(a, b); }
+  static Reg mul(Reg a, Reg b) { return _mm_mul_ps(a, b); }
+  static Reg div(Reg a, Reg b) { return _mm_div_ps(a, b); }
+  static Reg fmadd(Reg a, Reg b, Reg c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+  static Reg max(Reg a, Reg b) { return _mm_max_ps(a, b); }
+  static Reg min(Reg a, Reg b) { return _mm_min_ps(a, b); }
+  static Reg sqrt(Reg x) { return _mm_sqrt_ps(x); }
+  static Reg round(Reg x) { return _mm_round_ps(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+  static Reg pow2n(Reg n) {
+    const __m128i e = _mm_add_epi32(_mm_cvtps_epi32(n), _mm_set1_epi32(127));
+    return _mm_castsi128_ps(_mm_slli_epi32(e, 23));
+  }
+  static float reduceAdd(Reg x) {
+    x = _mm_add_ps(x, _mm_movehl_ps(x, x));
+    x = _mm_add_ss(x, _mm_shuffle_ps(x, x, 0x55));
+    return _mm_cvtss_f32(x);
+  }
+  static float reduceMax(Reg x) {
+    x = _mm_max_ps(x, _mm_movehl_ps(x, x));
+    x = _mm_max_ss(x, _mm_shuffle_ps(x, x, 0x55));
+    return _mm_cvtss_f32(x);
+  }
+};
+} // namespace
+
+// Con 16 registros SSE el tile de 6x16 no cabe; se usa el microkernel generico.
+const KernelTable *sse41KernelTable() {
+  static const KernelTable table = makeKernelTable<SSE41Vec>("sse4.1", false);
+  return &table;
+}
+#else
+const KernelTable *sse41KernelTable() { return nullptr; }
+#endif
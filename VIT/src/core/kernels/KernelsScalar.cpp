@@ -0,0 +1,7 @@
+#include "KernelImpl.hpp"
+
+// Nivel escalar: disponible siempre, tambien en CPUs que no son x86.
+const KernelTable *scalarKernelTable() {
+  static const KernelTable table = makeKernelTable<ScalarVec>("scalar", false);
+  return &table;
+}
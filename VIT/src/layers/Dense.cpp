@@ -22,6 +22,7 @@ Tensor Dense::forward(const Tensor &input, bool isTraining) {
     // Guarda la entrada para el calculo en backward.
     this->inputTensor = input;
   }
+  this->int8.observe(input);
 
   const auto &inputShape = input.getShape();
   size_t inputRank = inputShape.size();
@@ -34,8 +35,7 @@ Tensor Dense::forward(const Tensor &input, bool isTraining) {
     // Aplana a 2D para la multiplicacion.
     Tensor input2D = input.reshape({batchSize * numTokens, featuresIn});
 
-    Tensor output2D = matrixMultiply(input2D, this->weights);
-    output2D.addBroadcast(this->bias);
+    Tensor output2D = this->affine(input2D, isTraining);
 
     // Devuelve la forma original 3D.
     return output2D.reshape({batchSize, numTokens, this->bias.getShape()[1]});
@@ -43,14 +43,23 @@ Tensor Dense::forward(const Tensor &input, bool isTraining) {
 
   // Caso 2D: {batch, features_in} -> {batch, features_out}
   if (inputRank == 2) {
-    Tensor output = matrixMultiply(input, this->weights);
-    output.addBroadcast(this->bias);
-    return output;
+    return this->affine(input, isTraining);
   }
 
   throw std::runtime_error("Dense::forward solo soporta entradas 2D o 3D.");
 }
 
+Tensor Dense::affine(const Tensor &input2D, bool isTraining) const {
+  if (!isTraining && this->int8.isQuantized()) {
+    Tensor output = Tensor::uninitialized({input2D.getShape()[0], this->weights.getShape()[1]});
+    this->int8.forward(input2D, output);
+    return output;
+  }
+  Tensor output = matrixMultiply(input2D, this->weights);
+  output.addBroadcast(this->bias);
+  return output;
+}
+
 Tensor Dense::backward(const Tensor &outputGradient) {
   const auto &inputShape = this->inputTensor.getShape();
   size_t inputRank = inputShape.size();
@@ -79,11 +88,12 @@ Tensor Dense::backward(const Tensor &outputGradient) {
 
   // Calculos de gradientes (siempre se hacen en 2D).
   // dE/dW = X^T * dE/dY
+  // Ambos se suman a los gradientes acumulados.
   Tensor inputTransposed = input_to_process.transpose(0, 1);
-  this->weightGradients = matrixMultiply(inputTransposed, grad_to_process);
+  matrixMultiply(inputTransposed, grad_to_process, this->weightGradients, true);
 
   // dE/db = sum(dE/dY) a lo largo del eje del batch.
-  this->biasGradients = grad_to_process.sum(0);
+  this->biasGradients.addBroadcast(grad_to_process.sum(0));
 
   // dE/dX = dE/dY * W^T
   Tensor weightsTransposed = this->weights.transpose(0, 1);
@@ -100,3 +110,10 @@ Tensor Dense::backward(const Tensor &outputGradient) {
 std::vector<Tensor *> Dense::getParameters() { return {&this->weights, &this->bias}; }
 
 std::vector<Tensor *> Dense::getGradients() { return {&this->weightGradients, &this->biasGradients}; }
+
+double Dense::getFlops(const std::vector<size_t> &inputShape) const {
+  const double inputSize = static_cast<double>(weights.getShape()[0]);
+  const double outputSize = static_cast<double>(weights.getShape()[1]);
+  const double rows = countElements(inputShape) / inputSize;
+  return 2.0 * rows * inputSize * outputSize + rows * outputSize;
+}
@@ -44,7 +44,7 @@ Tensor Embeddings::forward(const Tensor &input, bool isTraining) {
 Tensor Embeddings::backward(const Tensor &outputGradient) {
   // El gradiente de una suma es el mismo para ambas ramas.
   // Por tanto, el gradiente de la codificacion posicional es la suma a traves del batch.
-  this->positionalEncodingGradient = outputGradient.sum(0); // -> {1, N+1, D}
+  this->positionalEncodingGradient.addBroadcast(outputGradient.sum(0)); // += {1, N+1, D}
   // El gradiente que fluye hacia la concatenacion es el mismo outputGradient.
   Tensor grad_before_pos = outputGradient;
 
@@ -53,11 +53,11 @@ Tensor Embeddings::backward(const Tensor &outputGradient) {
   Tensor grad_patches_view = grad_before_pos.slice(1, 1, this->num_patches); // -> {B, N, D}
 
   // El gradiente del token CLS es la suma a traves del batch de su gradiente.
-  this->clsTokenGradient = grad_cls.sum(0); // -> {1, 1, D}
+  this->clsTokenGradient.addBroadcast(grad_cls.sum(0)); // += {1, 1, D}
 
   // En lugar de llamar a .contiguous(), creamos un nuevo tensor y copiamos los datos.
   // Esto garantiza que el tensor que pasamos es 100% contiguo.
-  Tensor grad_patches_contiguous(grad_patches_view.getShape());
+  Tensor grad_patches_contiguous = Tensor::uninitialized(grad_patches_view.getShape());
 
   // Usamos el operator() que sabe cómo manejar los strides de la vista
   const auto &shape = grad_patches_view.getShape();
@@ -91,3 +91,10 @@ std::vector<Tensor *> Embeddings::getGradients() {
   grads.push_back(&this->positionalEncodingGradient);
   return grads;
 }
+
+void Embeddings::setInt8Mode(Int8Mode mode) { this->patcher->setInt8Mode(mode); }
+
+double Embeddings::getFlops(const std::vector<size_t> &inputShape) const {
+  const double tokens = static_cast<double>(inputShape[0]) * (this->num_patches + 1);
+  return patcher->getFlops(inputShape) + tokens * this->embedding_dim;
+}
@@ -1,4 +1,5 @@
 #include "layers/FeedForward.hpp"
+#include "utils/Profiler.hpp"
 
 // Constructor que inicializa las sub-capas en la lista de inicializadores.
 FeedForward::FeedForward(size_t embedding_dim, size_t hidden_dim)
@@ -8,17 +9,17 @@ FeedForward::FeedForward(size_t embedding_dim, size_t hidden_dim)
 
 // Encadena el forward pass de las sub-capas: dense1 -> activation -> dense2.
 Tensor FeedForward::forward(const Tensor &input, bool isTraining) {
-  Tensor x = dense1.forward(input, isTraining);
-  x = activation.forward(x, isTraining);
-  x = dense2.forward(x, isTraining);
+  Tensor x = PROFILE_FORWARD("dense1", dense1, input, isTraining);
+  x = PROFILE_FORWARD("gelu", activation, x, isTraining);
+  x = PROFILE_FORWARD("dense2", dense2, x, isTraining);
   return x;
 }
 
 // Encadena el backward pass de las sub-capas en orden inverso.
 Tensor FeedForward::backward(const Tensor &outputGradient) {
-  Tensor grad = dense2.backward(outputGradient);
-  grad = activation.backward(grad);
-  grad = dense1.backward(grad);
+  Tensor grad = PROFILE_BACKWARD("dense2", dense2, outputGradient);
+  grad = PROFILE_BACKWARD("gelu", activation, grad);
+  grad = PROFILE_BACKWARD("dense1", dense1, grad);
   return grad;
 }
 
@@ -39,3 +40,20 @@ std::vector<Tensor *> FeedForward::getGradients() {
   grads1.insert(grads1.end(), grads2.begin(), grads2.end());
   return grads1;
 }
+
+void FeedForward::setInt8Mode(Int8Mode mode) {
+  dense1.setInt8Mode(mode);
+  dense2.setInt8Mode(mode);
+}
+
+void FeedForward::releaseActivations() {
+  dense1.releaseActivations();
+  activation.releaseActivations();
+  dense2.releaseActivations();
+}
+
+double FeedForward::getFlops(const std::vector<size_t> &inputShape) const {
+  std::vector<size_t> hiddenShape = inputShape;
+  hiddenShape.back() = this->dense1.getOutputSize();
+  return dense1.getFlops(inputShape) + activation.getFlops(hiddenShape) + dense2.getFlops(hiddenShape);
+}
@@ -1,4 +1,5 @@
 #include "layers/LayerNorm.hpp"
+#include "core/Kernels.hpp"
 #include <cmath>
 #include <numeric>
 
@@ -35,45 +36,30 @@ Tensor LayerNorm::forward(const Tensor &input, bool isTraining) {
   // En entrenamiento, guardamos valores intermedios para backward.
   if (isTraining) {
     this->inputTensor = input2D;
-    this->mean = Tensor({batchSize, 1});
-    this->variance = Tensor({batchSize, 1}); // Se reutilizara para guardar inv_stddev.
+    this->mean = Tensor::uninitialized({batchSize, 1});
+    this->variance = Tensor::uninitialized({batchSize, 1}); // Se reutilizara para guardar inv_stddev.
+    this->normalizedInput = Tensor::uninitialized({batchSize, this->featureSize});
   }
 
-  Tensor output2D({batchSize, this->featureSize});
-  this->normalizedInput = Tensor({batchSize, this->featureSize});
+  Tensor output2D = Tensor::uninitialized({batchSize, this->featureSize});
+
+  // reshape() garantiza que input2D es contiguo: cada fila se procesa con el kernel
+  // vectorizado, que calcula media y varianza y luego normaliza, escala y desplaza.
+  const float *in_data = input2D.getData() + input2D.getDataOffset();
+  const float *gamma_data = this->gamma.getData();
+  const float *beta_data = this->beta.getData();
+  float *out_data = output2D.getData();
+  float *norm_data = isTraining ? this->normalizedInput.getData() : nullptr;
+  float *mean_data = isTraining ? this->mean.getData() : nullptr;
+  float *inv_std_data = isTraining ? this->variance.getData() : nullptr; // Guardamos 1/sqrt(var+eps)
+  const auto normalizeRow = kernels().layerNormRow;
 
 #pragma omp parallel for
   for (size_t i = 0; i < batchSize; ++i) {
-    // --- 1. Calcular la media ---
-    float current_mean = 0.0f;
-    for (size_t j = 0; j < this->featureSize; ++j) {
-      current_mean += input2D(i, j);
-    }
-    current_mean /= this->featureSize;
-
-    // --- 2. Calcular la varianza ---
-    float current_variance = 0.0f;
-    for (size_t j = 0; j < this->featureSize; ++j) {
-      float diff = input2D(i, j) - current_mean;
-      current_variance += diff * diff;
-    }
-    current_variance /= this->featureSize;
-
-    float inv_stddev = 1.0f / std::sqrt(current_variance + this->epsilon);
-
-    if (isTraining) {
-      this->mean(i, 0) = current_mean;
-      this->variance(i, 0) = inv_stddev; // Guardamos 1/sqrt(var+eps)
-    }
-
-    // --- 3. Normalizar, escalar y desplazar ---
-    for (size_t j = 0; j < this->featureSize; ++j) {
-      float x_hat = (input2D(i, j) - current_mean) * inv_stddev;
-      if (isTraining)
-        this->normalizedInput(i, j) = x_hat; // Guardamos la entrada normalizada.
-
-      output2D(i, j) = this->gamma(0, j) * x_hat + this->beta(0, j);
-    }
+    const size_t row = i * this->featureSize;
+    normalizeRow(in_data + row, gamma_data, beta_data, norm_data ? norm_data + row : nullptr, out_data + row,
+                 this->featureSize, this->epsilon, mean_data ? mean_data + i : nullptr,
+                 inv_std_data ? inv_std_data + i : nullptr);
   }
 
   // Devolvemos el tensor a su forma original.
@@ -87,10 +73,7 @@ Tensor LayerNorm::backward(const Tensor &outputGradient) {
   // Aplanamos el gradiente de salida a 2D.
   Tensor grad2D = outputGradient.reshape({batchSize, this->featureSize});
 
-  // Reseteamos los gradientes de los parametros antes de acumular.
-  this->gammaGradient.fill(0.0f);
-  this->betaGradient.fill(0.0f);
-  Tensor inputGradient({batchSize, this->featureSize});
+  Tensor inputGradient = Tensor::uninitialized({batchSize, this->featureSize});
 
   // El bucle sobre el batch es secuencial para evitar race conditions al acumular
   // los gradientes de gamma y beta, que son compartidos por todo el batch.
@@ -135,3 +118,12 @@ Tensor LayerNorm::backward(const Tensor &outputGradient) {
 std::vector<Tensor *> LayerNorm::getParameters() { return {&this->gamma, &this->beta}; }
 
 std::vector<Tensor *> LayerNorm::getGradients() { return {&this->gammaGradient, &this->betaGradient}; }
+
+void LayerNorm::releaseActivations() {
+  this->inputTensor = Tensor();
+  this->mean = Tensor();
+  this->variance = Tensor();
+  this->normalizedInput = Tensor();
+}
+
+double LayerNorm::getFlops(const std::vector<size_t> &inputShape) const { return 8.0 * countElements(inputShape); }
@@ -1,6 +1,9 @@
 
 #include "layers/MultiHeadAttention.hpp"
+#include "core/FlashAttention.hpp"
+#include "core/Kernels.hpp"
 #include "core/Tensor.hpp"
+#include "utils/Profiler.hpp"
 #include <cmath>
 
 // Declaraciones de funciones auxiliares ---
@@ -8,18 +11,22 @@ Tensor softmax(const Tensor &logits, int axis);
 
 Tensor softmax_backward(const Tensor &grad_output, const Tensor &softmax_output);
 
-MultiHeadAttention::MultiHeadAttention(size_t embedding_dim, size_t num_heads)
-    : embedding_dim(embedding_dim), num_heads(num_heads) {
+MultiHeadAttention::MultiHeadAttention(size_t embedding_dim, size_t num_heads, bool use_flash_attention, bool fuse_qkv)
+    : embedding_dim(embedding_dim), num_heads(num_heads), use_flash_attention(use_flash_attention), fuse_qkv(fuse_qkv) {
 
   if (embedding_dim % num_heads != 0) {
     throw std::invalid_argument("embedding_dim debe ser divisible por num_heads.");
   }
   this->head_dim = embedding_dim / num_heads;
 
-  // Inicializa las cuatro proyecciones lineales.
-  q_proj = std::make_unique<Dense>(embedding_dim, embedding_dim);
-  k_proj = std::make_unique<Dense>(embedding_dim, embedding_dim);
-  v_proj = std::make_unique<Dense>(embedding_dim, embedding_dim);
+  // Inicializa las proyecciones lineales: Q, K y V empaquetadas o por separado, y la salida.
+  if (fuse_qkv) {
+    qkv_proj = std::make_unique<QKVProjection>(embedding_dim);
+  } else {
+    q_proj = std::make_unique<Dense>(embedding_dim, embedding_dim);
+    k_proj = std::make_unique<Dense>(embedding_dim, embedding_dim);
+    v_proj = std::make_unique<Dense>(embedding_dim, embedding_dim);
+  }
   out_proj = std::make_unique<Dense>(embedding_dim, embedding_dim);
 }
 
@@ -31,32 +38,26 @@ Tensor MultiHeadAttention::forward(const Tensor &input, bool isTraining) {
   const auto &s = input.getShape(); // {B, N, D}
   size_t B = s[0], N = s[1];
 
-  // 1. Proyecciones Lineales para obtener Q, K, V.
-  Tensor q = q_proj->forward(input, isTraining); // -> {B, N, D}
-  Tensor k = k_proj->forward(input, isTraining); // -> {B, N, D}
-  Tensor v = v_proj->forward(input, isTraining); // -> {B, N, D}
-
-  // 2. Dividir Q, K, V en cabezas de atencion.
+  // 2. Dividir Q, K, V en cabezas de atencion como vistas, sin copiar datos.
   // {B, N, D} -> {B, N, h, d_h} -> {B, h, N, d_h}
-  q = q.reshape({B, N, this->num_heads, this->head_dim});
-  k = k.reshape({B, N, this->num_heads, this->head_dim});
-  v = v.reshape({B, N, this->num_heads, this->head_dim});
-
-  // {B, N, h, d_h} -> {B, h, N, d_h}
-  q = q.transpose(1, 2);
-  k = k.transpose(1, 2);
-  v = v.transpose(1, 2);
-
-  // Ahora q, k, v son vistas no contiguas.
-  // Para el siguiente reshape, necesitamos hacerlas contiguas.
-  q = q.contiguous();
-  k = k.contiguous();
-  v = v.contiguous();
-
-  // {B, h, N, d_h} -> {B*h, N, d_h}
-  q = q.reshape({B * this->num_heads, N, this->head_dim});
-  k = k.reshape({B * this->num_heads, N, this->head_dim});
-  v = v.reshape({B * this->num_heads, N, this->head_dim});
+  // Los BMM y la atencion fusionada recorren las cabezas mediante los strides.
+  auto split_heads = [&](const Tensor &t) {
+    return t.reshape({B, N, this->num_heads, this->head_dim}).transpose(1, 2);
+  };
+
+  // 1. Proyecciones Lineales para obtener Q, K, V.
+  Tensor q, k, v;
+  if (this->fuse_qkv) {
+    // Un solo GEMM produce {B, N, 3D}; cada bloque se ve directamente como {B, h, N, d_h}.
+    Tensor qkv = PROFILE_FORWARD("qkv_proj", *qkv_proj, input, isTraining);
+    q = packedHeads(qkv, 0);
+    k = packedHeads(qkv, 1);
+    v = packedHeads(qkv, 2);
+  } else {
+    q = split_heads(PROFILE_FORWARD("q_proj", *q_proj, input, isTraining)); // -> {B, N, D} -> {B, h, N, d_h}
+    k = split_heads(PROFILE_FORWARD("k_proj", *k_proj, input, isTraining));
+    v = split_heads(PROFILE_FORWARD("v_proj", *v_proj, input, isTraining));
+  }
 
   if (isTraining) {
     this->q_split = q;
@@ -65,53 +66,57 @@ Tensor MultiHeadAttention::forward(const Tensor &input, bool isTraining) {
   }
 
   // 3. Atención Escalada por Producto Punto
-  Tensor context = scaledDotProductAttention(q, k, v); // -> {B*h, N, d_h}
-
-  // 4. Re-ensamblar cabezas
-  // Invertimos el proceso de división
-  // {B*h, N, d_h} -> {B, h, N, d_h}
-  context = context.reshape({B, this->num_heads, N, this->head_dim});
-  // {B, h, N, d_h} -> {B, N, h, d_h}
-  context = context.transpose(1, 2);
-  // hacemos que el tensor sea contiguo en memoria.
-  context = context.contiguous();
-  // reshape.
-  // {B, N, h, d_h} -> {B, N, D}
-  context = context.reshape({B, N, this->embedding_dim});
+  // 4. Re-ensamblar cabezas: la atencion escribe directamente en el buffer {B, N, D}
+  // a traves de su vista por cabezas {B, h, N, d_h}, asi que no hay que copiarlo despues.
+  Tensor context = Tensor::uninitialized({B, N, this->embedding_dim});
+  Tensor context_heads = split_heads(context);
+  if (this->use_flash_attention) {
+    // Version fusionada: no materializa las puntuaciones {B, h, N, N}; guarda solo la
+    // salida y el log-suma-exp de cada fila para recalcular los bloques en backward.
+    float scale_factor = 1.0f / std::sqrt(static_cast<float>(this->head_dim));
+    Tensor lse;
+    flashAttentionForward(q, k, v, scale_factor, context_heads, lse);
+    if (isTraining) {
+      this->attention_output = context_heads;
+      this->attention_lse = lse;
+    }
+  } else {
+    scaledDotProductAttention(q, k, v, context_heads, isTraining);
+  }
 
   // 5. Proyección de salida final
-  return out_proj->forward(context, isTraining);
+  return PROFILE_FORWARD("out_proj", *out_proj, context, isTraining);
 }
 
-Tensor MultiHeadAttention::scaledDotProductAttention(const Tensor &q, const Tensor &k, const Tensor &v) {
+void MultiHeadAttention::scaledDotProductAttention(const Tensor &q, const Tensor &k, const Tensor &v, Tensor &context,
+                                                   bool isTraining) {
+  const auto &s = q.getShape(); // {B, h, N, d_h}
+  const size_t B = s[0], N = s[2];
+
   // scores = (Q * K^T) / sqrt(d_k)
-  // k_transposed -> {B*h, d_h, N}
-  Tensor k_transposed = k.transpose(1, 2);
-  // scores -> {B*h, N, N}
+  // k_transposed -> {B, h, d_h, N}
+  Tensor k_transposed = k.transpose(2, 3);
+  // scores -> {B, h, N, N}
   Tensor scores = batchMatrixMultiply(q, k_transposed);
 
   float scale_factor = 1.0f / std::sqrt(static_cast<float>(this->head_dim));
 
-  // Usamos un bucle para la multiplicación por escalar.
-  if (scores.isContiguous()) {
-    float *scores_data = scores.getData();
-#pragma omp parallel for
-    for (size_t i = 0; i < scores.getSize(); ++i) {
-      scores_data[i] *= scale_factor;
-    }
-  } else { // Fallback para vistas no contiguas
-    for (size_t i = 0; i < scores.getShape()[0]; ++i)
-      for (size_t j = 0; j < scores.getShape()[1]; ++j)
-        for (size_t l = 0; l < scores.getShape()[2]; ++l)
-          scores(i, j, l) *= scale_factor;
-  }
+  // Multiplicación por escalar con el kernel vectorizado (scores es contiguo).
+  float *scores_data = scores.getData();
+  const auto scale = kernels().scale;
+  parallelChunks(scores.getSize(), [&](size_t begin, size_t count) { scale(scores_data + begin, scale_factor, count); });
 
   // Aplica softmax para obtener los pesos de atencion.
-  Tensor attention = softmax(scores, 2);
-  this->attention_weights = attention;
+  Tensor attention = softmax(scores.reshape({B * this->num_heads, N, N}), 2).reshape({B, this->num_heads, N, N});
 
   // context = attention_weights * V
-  return batchMatrixMultiply(attention, v);
+  batchMatrixMultiply(attention, v, context);
+
+  // Fuera de entrenamiento no se guardan los pesos {B, h, N, N}.
+  if (!isTraining) {
+    return;
+  }
+  this->attention_weights = attention;
 }
 
 // Implementación de softmax
@@ -121,9 +126,19 @@ Tensor softmax(const Tensor &logits, int axis) {
   if (axis < 0)
     axis = shape.size() + axis;
 
-  Tensor probabilities(shape);
+  Tensor probabilities = Tensor::uninitialized(shape);
 
-  if (axis == 2 && shape.size() == 3) {
+  if (axis == 2 && shape.size() == 3 && logits.isContiguous()) {
+    // Camino rapido: cada fila es contigua y se procesa con el kernel vectorizado.
+    const size_t rows = shape[0] * shape[1];
+    const size_t cols = shape[2];
+    const float *in_data = logits.getData() + logits.getDataOffset();
+    float *out_data = probabilities.getData();
+    const auto softmaxRow = kernels().softmaxRow;
+#pragma omp parallel for
+    for (size_t r = 0; r < rows; ++r)
+      softmaxRow(in_data + r * cols, out_data + r * cols, cols);
+  } else if (axis == 2 && shape.size() == 3) {
 #pragma omp parallel for collapse(2)
     for (size_t b = 0; b < shape[0]; ++b) {
       for (size_t n = 0; n < shape[1]; ++n) {
@@ -156,77 +171,108 @@ Tensor MultiHeadAttention::backward(const Tensor &outputGradient) {
   const auto &inputShape = this->inputTensor.getShape();
   size_t B = inputShape[0], N = inputShape[1];
 
+  auto split_heads = [&](const Tensor &t) {
+    return t.reshape({B, N, this->num_heads, this->head_dim}).transpose(1, 2);
+  };
+
   // 1. Inversa de la Proyección de Salida (out_proj)
-  Tensor grad = this->out_proj->backward(outputGradient); // -> {B, N, D}
+  Tensor grad = PROFILE_BACKWARD("out_proj", *this->out_proj, outputGradient); // -> {B, N, D}
 
   // 2. Inversa del Re-ensamblaje de Cabezas
-  // FORWARD: context {B*h,N,d_h} -> reshape {B,h,N,d_h} -> transpose {B,N,h,d_h} -> contiguous -> reshape {B,N,D}
-  // BACKWARD:
-
-  grad = grad.reshape({B, N, this->num_heads, this->head_dim});
-  grad = grad.transpose(1, 2).contiguous();
-
-  grad = grad.reshape({B * this->num_heads, N, this->head_dim});
-  // 'grad' es ahora dL/d(attention_output) con forma {B*h, N, d_h}
+  // FORWARD: context {B, N, D} se escribio a traves de la vista {B, h, N, d_h}.
+  // BACKWARD: la misma vista sobre el gradiente, sin copias.
+  Tensor grad_heads = split_heads(grad);
+  // 'grad_heads' es ahora dL/d(attention_output) con forma {B, h, N, d_h}
+
+  // Los gradientes de Q, K y V se escriben directamente en buffers {B, N, D} (o en un
+  // unico {B, N, 3D} con la proyeccion fusionada) a traves de sus vistas por cabezas;
+  // esto sustituye al re-ensamblaje posterior.
+  Tensor dQ, dK, dV, dQKV;
+  Tensor dQ_heads, dK_heads, dV_heads;
+  if (this->fuse_qkv) {
+    dQKV = Tensor::uninitialized({B, N, 3 * this->embedding_dim});
+    dQ_heads = packedHeads(dQKV, 0);
+    dK_heads = packedHeads(dQKV, 1);
+    dV_heads = packedHeads(dQKV, 2);
+  } else {
+    dQ = Tensor::uninitialized({B, N, this->embedding_dim});
+    dK = Tensor::uninitialized({B, N, this->embedding_dim});
+    dV = Tensor::uninitialized({B, N, this->embedding_dim});
+    dQ_heads = split_heads(dQ);
+    dK_heads = split_heads(dK);
+    dV_heads = split_heads(dV);
+  }
 
-  // 3. Inversa de la Multiplicación Final de la Atención
-  // FORWARD: attention_output = attention_weights @ V
-  Tensor V_T = this->v_split.transpose(1, 2);
-  Tensor d_attention_weights = batchMatrixMultiply(grad, V_T);
+  if (this->use_flash_attention) {
+    // 3-5. Backward de la atencion fusionada: recalcula las probabilidades por bloques.
+    float scale_factor = 1.0f / std::sqrt(static_cast<float>(this->head_dim));
+    flashAttentionBackward(this->q_split, this->k_split, this->v_split, this->attention_output, this->attention_lse,
+                           grad_heads, scale_factor, dQ_heads, dK_heads, dV_heads);
+  } else {
+    // 3. Inversa de la Multiplicación Final de la Atención
+    // FORWARD: attention_output = attention_weights @ V
+    Tensor V_T = this->v_split.transpose(2, 3);
+    Tensor d_attention_weights = batchMatrixMultiply(grad_heads, V_T); // -> {B, h, N, N}
 
-  Tensor attention_weights_T = this->attention_weights.transpose(1, 2);
-  Tensor dV = batchMatrixMultiply(attention_weights_T, grad); // ¡Este ya es un gradiente real!
+    Tensor attention_weights_T = this->attention_weights.transpose(2, 3);
+    batchMatrixMultiply(attention_weights_T, grad_heads, dV_heads); // ¡Este ya es un gradiente real!
 
-  // 4. Inversa del Softmax
-  // Usamos la nueva función para obtener el gradiente con respecto a las puntuaciones (scores)
-  Tensor d_scores = softmax_backward(d_attention_weights, this->attention_weights);
+    // 4. Inversa del Softmax
+    // Usamos la nueva función para obtener el gradiente con respecto a las puntuaciones (scores)
+    Tensor d_scores = softmax_backward(d_attention_weights.reshape({B * this->num_heads, N, N}),
+                                       this->attention_weights.reshape({B * this->num_heads, N, N}));
 
-  // 5. Inversa del Escalamiento y Q @ K^T
+    // 5. Inversa del Escalamiento y Q @ K^T
 
-  // 5.1 Invertir el escalamiento
-  float scale_factor = 1.0f / std::sqrt(static_cast<float>(this->head_dim));
-  if (d_scores.isContiguous()) {
+    // 5.1 Invertir el escalamiento
+    float scale_factor = 1.0f / std::sqrt(static_cast<float>(this->head_dim));
     float *d_scores_data = d_scores.getData();
-#pragma omp parallel for
-    for (size_t i = 0; i < d_scores.getSize(); ++i)
-      d_scores_data[i] *= scale_factor;
+    const auto scale = kernels().scale;
+    parallelChunks(d_scores.getSize(), [&](size_t begin, size_t count) { scale(d_scores_data + begin, scale_factor, count); });
+    d_scores = d_scores.reshape({B, this->num_heads, N, N});
+
+    // 5.2 Propagar a través de Q @ K^T
+    // Forward: scores = Q @ K^T
+    // dL/dQ = dL/d(scores) @ K
+    batchMatrixMultiply(d_scores, this->k_split, dQ_heads);
+
+    // dL/dK = dL/d(scores)^T @ Q
+    Tensor d_scores_T = d_scores.transpose(2, 3);
+    batchMatrixMultiply(d_scores_T, this->q_split, dK_heads);
   }
 
-  // 5.2 Propagar a través de Q @ K^T
-  // Forward: scores = Q @ K^T
-  // dL/dQ = dL/d(scores) @ K
-  Tensor dQ = batchMatrixMultiply(d_scores, this->k_split);
-
-  // dL/dK = Q^T @ dL/d(scores)
-  Tensor Q_T = this->q_split.transpose(1, 2);
-  Tensor dK = batchMatrixMultiply(Q_T, d_scores);
-
-  // 6. Inversa de la División de Cabezas (Re-ensamblaje de Gradientes)
-  auto reassemble_grads = [&](Tensor &g) {
-    g = g.reshape({B, this->num_heads, N, this->head_dim});
-
-    g = g.transpose(1, 2).contiguous();
-
-    return g.reshape({B, N, this->embedding_dim});
-  };
-
-  dQ = reassemble_grads(dQ); // -> {B, N, D}
-  dK = reassemble_grads(dK); // -> {B, N, D}
-  dV = reassemble_grads(dV); // -> {B, N, D}
-
-  // 7. Inversa de las Proyecciones de Entrada
-  Tensor dInput_q = this->q_proj->backward(dQ);
-  Tensor dInput_k = this->k_proj->backward(dK);
-  Tensor dInput_v = this->v_proj->backward(dV); // calculo de gradientes reales para w_v, b_v
+  // 6. Inversa de las Proyecciones de Entrada
+  if (this->fuse_qkv) {
+    // Un solo GEMM {B*N, 3D} x {3D, D} da directamente la suma de las tres ramas.
+    return PROFILE_BACKWARD("qkv_proj", *this->qkv_proj, dQKV);
+  }
+  Tensor dInput_q = PROFILE_BACKWARD("q_proj", *this->q_proj, dQ);
+  Tensor dInput_k = PROFILE_BACKWARD("k_proj", *this->k_proj, dK);
+  Tensor dInput_v = PROFILE_BACKWARD("v_proj", *this->v_proj, dV); // calculo de gradientes reales para w_v, b_v
 
-  // 8. Suma de Gradientes
+  // 7. Suma de Gradientes
   // El gradiente de entrada es la suma de los gradientes de las 3 ramas.
   Tensor final_grad = dInput_q + dInput_k + dInput_v;
 
   return final_grad;
 }
 
+// Vista {B, h, N, d_h} del bloque 'part' (0 = Q, 1 = K, 2 = V) de un tensor {B, N, 3D}.
+Tensor MultiHeadAttention::packedHeads(const Tensor &packed, size_t part) const {
+  const auto &s = packed.getShape();
+  const size_t B = s[0], N = s[1], rowStride = s[2];
+  return Tensor(packed.getDataPtr(), {B, this->num_heads, N, this->head_dim}, {N * rowStride, this->head_dim, rowStride, 1},
+                packed.getDataOffset() + part * this->embedding_dim);
+}
+
 std::vector<Tensor *> MultiHeadAttention::getParameters() {
+  if (this->fuse_qkv) {
+    // Mismo orden que con Dense separadas: W_q, b_q, W_k, b_k, W_v, b_v, W_out, b_out.
+    auto all_params = qkv_proj->getParameters();
+    auto out_params = out_proj->getParameters();
+    all_params.insert(all_params.end(), out_params.begin(), out_params.end());
+    return all_params;
+  }
   auto q_params = q_proj->getParameters();
   auto k_params = k_proj->getParameters();
   auto v_params = v_proj->getParameters();
@@ -241,6 +287,12 @@ std::vector<Tensor *> MultiHeadAttention::getParameters() {
 }
 
 std::vector<Tensor *> MultiHeadAttention::getGradients() {
+  if (this->fuse_qkv) {
+    auto all_grads = qkv_proj->getGradients();
+    auto out_grads = out_proj->getGradients();
+    all_grads.insert(all_grads.end(), out_grads.begin(), out_grads.end());
+    return all_grads;
+  }
   auto q_grads = q_proj->getGradients();
   auto k_grads = k_proj->getGradients();
   auto v_grads = v_proj->getGradients();
@@ -254,13 +306,53 @@ std::vector<Tensor *> MultiHeadAttention::getGradients() {
   return all_grads;
 }
 
+void MultiHeadAttention::setInt8Mode(Int8Mode mode) {
+  if (this->fuse_qkv) {
+    qkv_proj->setInt8Mode(mode);
+  } else {
+    q_proj->setInt8Mode(mode);
+    k_proj->setInt8Mode(mode);
+    v_proj->setInt8Mode(mode);
+  }
+  out_proj->setInt8Mode(mode);
+}
+
+void MultiHeadAttention::releaseActivations() {
+  if (this->fuse_qkv) {
+    qkv_proj->releaseActivations();
+  } else {
+    q_proj->releaseActivations();
+    k_proj->releaseActivations();
+    v_proj->releaseActivations();
+  }
+  out_proj->releaseActivations();
+  this->inputTensor = Tensor();
+  this->q_split = Tensor();
+  this->k_split = Tensor();
+  this->v_split = Tensor();
+  this->attention_weights = Tensor();
+  this->attention_output = Tensor();
+  this->attention_lse = Tensor();
+}
+
 Tensor softmax_backward(const Tensor &grad_output, const Tensor &softmax_output) {
   // grad_output es dL/dS, softmax_output es S
   const auto &shape = grad_output.getShape();
-  Tensor grad_input(shape); // dL/dZ
+  Tensor grad_input = Tensor::uninitialized(shape); // dL/dZ
 
   // Asumimos que el softmax se aplicó en el último eje (axis=2)
-  if (shape.size() == 3) {
+  if (shape.size() == 3 && grad_output.isContiguous() && softmax_output.isContiguous()) {
+    // Camino rapido: por cada fila, dL/dZ = S * (dL/dS - sum(dL/dS * S)) con el kernel vectorizado.
+    const size_t rows = shape[0] * shape[1];
+    const size_t cols = shape[2];
+    const float *grad_data = grad_output.getData() + grad_output.getDataOffset();
+    const float *s_data = softmax_output.getData() + softmax_output.getDataOffset();
+    float *out_data = grad_input.getData();
+    const auto backwardRow = kernels().softmaxBackwardRow;
+#pragma omp parallel for
+    for (size_t r = 0; r < rows; ++r)
+      backwardRow(grad_data + r * cols, s_data + r * cols, out_data + r * cols, cols);
+  } else if (shape.size() == 3) {
 #pragma omp parallel for collapse(2)
     for (size_t b = 0; b < shape[0]; ++b) {
       for (size_t n = 0; n < shape[1]; ++n) {
@@ -284,3 +376,10 @@ Tensor softmax_backward(const Tensor &grad_output, const Tensor &softmax_output)
   }
   return grad_input;
 }
+
+double MultiHeadAttention::getFlops(const std::vector<size_t> &inputShape) const {
+  const double B = static_cast<double>(inputShape[0]), N = static_cast<double>(inputShape[1]);
+  const double D = static_cast<double>(this->embedding_dim);
+  // Q, K, V y salida: 4 GEMM de {B*N, D} x {D, D}. Puntuaciones y contexto: 2 BMM de N x N x D.
+  return 8.0 * B * N * D * D + 4.0 * B * N * N * D;
+}
@@ -1,4 +1,5 @@
 #include "layers/PatchEmbedding.hpp"
+#include <algorithm>
 #include <stdexcept>
 
 PatchEmbedding::PatchEmbedding(size_t image_height, size_t image_width, size_t patch_size, size_t in_channels,
@@ -24,32 +25,8 @@ Tensor PatchEmbedding::forward(const Tensor &input, bool isTraining) {
   size_t batchSize = inputShape[0];
 
   // Tensor para almacenar los parches aplanados, listo para la capa Densa.
-  Tensor patches_flat({batchSize * this->num_patches, this->patch_dim});
-
-  size_t patch_index_global = 0;
-  // Itera sobre cada imagen en el batch.
-  for (size_t b = 0; b < batchSize; ++b) {
-    // Itera para extraer cada parche.
-    for (size_t ph = 0; ph < image_height / patch_size; ++ph) {
-      for (size_t pw = 0; pw < image_width / patch_size; ++pw) {
-        // Extrae el parche como una vista, sin copiar datos.
-        size_t h_start = ph * patch_size;
-        size_t w_start = pw * patch_size;
-        Tensor patch_view = input
-                                .slice(0, b, 1)                 // Vista de la imagen b
-                                .slice(2, h_start, patch_size)  // Vista de la fila de parches
-                                .slice(3, w_start, patch_size); // Vista del parche exacto
-
-        // Copia la vista del parche aplanado a nuestro tensor de parches.
-        // Asumimos que la vista del parche es contigua.
-        const float *patch_data = patch_view.getData() + patch_view.getDataOffset();
-        float *dest_data = patches_flat.getData() + (patch_index_global * this->patch_dim);
-        std::copy(patch_data, patch_data + this->patch_dim, dest_data);
-
-        patch_index_global++;
-      }
-    }
-  }
+  Tensor patches_flat = Tensor::uninitialized({batchSize * this->num_patches, this->patch_dim});
+  extractPatches(input, patches_flat);
 
   if (isTraining) {
     this->flattenedPatches = patches_flat;
@@ -69,7 +46,7 @@ Tensor PatchEmbedding::backward(const Tensor &outputGradient) {
   Tensor patch_gradient = this->projectionLayer->backward(grad2D); // -> {B*num_patches, patch_dim}
 
   // 2. "Des-parchear" el gradiente, escribiendolo de vuelta en la forma de la imagen.
-  Tensor input_gradient({batchSize, this->in_channels, this->image_height, this->image_width});
+  Tensor input_gradient = Tensor::uninitialized({batchSize, this->in_channels, this->image_height, this->image_width});
   input_gradient.fill(0.0f);
 
   size_t patch_index_global = 0;
@@ -99,3 +76,31 @@ Tensor PatchEmbedding::backward(const Tensor &outputGradient) {
 std::vector<Tensor *> PatchEmbedding::getParameters() { return this->projectionLayer->getParameters(); }
 
 std::vector<Tensor *> PatchEmbedding::getGradients() { return this->projectionLayer->getGradients(); }
+
+void PatchEmbedding::setInt8Mode(Int8Mode mode) { this->projectionLayer->setInt8Mode(mode); }
+
+void PatchEmbedding::extractPatches(const Tensor &input, Tensor &patches) const {
+  const size_t batchSize = input.getShape()[0];
+  const auto &strides = input.getStrides();
+  const float *input_data = input.getData() + input.getDataOffset();
+  float *patches_data = patches.getData() + patches.getDataOffset();
+  const size_t patches_w = image_width / patch_size;
+
+  // Itera sobre cada imagen del batch y cada parche. El inicio del parche es el de la
+  // vista input.slice(0, b, 1).slice(2, h_start, p).slice(3, w_start, p), y se copian
+  // patch_dim elementos consecutivos a partir de el (se asume el parche contiguo).
+#pragma omp parallel for collapse(2)
+  for (size_t b = 0; b < batchSize; ++b) {
+    for (size_t p = 0; p < this->num_patches; ++p) {
+      const size_t h_start = (p / patches_w) * patch_size;
+      const size_t w_start = (p % patches_w) * patch_size;
+      const float *patch_data = input_data + b * strides[0] + h_start * strides[2] + w_start * strides[3];
+      float *dest_data = patches_data + (b * this->num_patches + p) * this->patch_dim;
+      std::copy(patch_data, patch_data + this->patch_dim, dest_data);
+    }
+  }
+}
+
+double PatchEmbedding::getFlops(const std::vector<size_t> &inputShape) const {
+  return projectionLayer->getFlops({inputShape[0] * this->num_patches, this->patch_dim});
+}
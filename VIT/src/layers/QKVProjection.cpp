@@ -0,0 +1,119 @@
+#include "layers/QKVProjection.hpp"
+#include "core/Kernels.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Vista {rows, D} del bloque 'part' (0 = Q, 1 = K, 2 = V) de un tensor empaquetado {rows, 3D}.
+// Con una sola fila se usan strides contiguos para que la vista sea contigua.
+Tensor blockView(const Tensor &packed, size_t part, size_t dim) {
+  const size_t rows = packed.getShape()[0];
+  const size_t rowStride = rows == 1 ? dim : packed.getStrides()[0];
+  return Tensor(packed.getDataPtr(), {rows, dim}, {rowStride, 1}, packed.getDataOffset() + part * dim);
+}
+
+// Tensor empaquetado {rows, 3D} cuyo bloque Q es la vista dada.
+Tensor packedFrom(const Tensor &view, size_t dim) {
+  const size_t rows = view.getShape()[0];
+  const size_t rowStride = rows == 1 ? 3 * dim : view.getStrides()[0];
+  return Tensor(view.getDataPtr(), {rows, 3 * dim}, {rowStride, 1}, view.getDataOffset());
+}
+
+// Rehace 'packed' si su bloque Q ya no esta en la memoria de 'view'.
+void resync(Tensor &packed, const Tensor &view, size_t dim) {
+  if (packed.getData() + packed.getDataOffset() != view.getData() + view.getDataOffset())
+    packed = packedFrom(view, dim);
+}
+} // namespace
+
+QKVProjection::QKVProjection(size_t embedding_dim) : embedding_dim(embedding_dim) {
+  const size_t D = embedding_dim;
+
+  // Inicializacion de pesos con He, igual que Dense (mismo fan-in para los tres bloques).
+  float stddev = std::sqrt(2.0f / static_cast<float>(D));
+  this->weights = Tensor({D, 3 * D});
+  this->weights.randomizeNormal(0.0f, stddev);
+  this->bias = Tensor({1, 3 * D});
+  this->weightGradients = Tensor({D, 3 * D});
+  this->biasGradients = Tensor({1, 3 * D});
+
+  for (size_t part = 0; part < 3; ++part) {
+    this->weightViews[part] = blockView(this->weights, part, D);
+    this->biasViews[part] = blockView(this->bias, part, D);
+    this->weightGradientViews[part] = blockView(this->weightGradients, part, D);
+    this->biasGradientViews[part] = blockView(this->biasGradients, part, D);
+  }
+}
+
+void QKVProjection::syncPackedStorage() {
+  resync(this->weights, this->weightViews[0], this->embedding_dim);
+  resync(this->bias, this->biasViews[0], this->embedding_dim);
+  resync(this->weightGradients, this->weightGradientViews[0], this->embedding_dim);
+  resync(this->biasGradients, this->biasGradientViews[0], this->embedding_dim);
+}
+
+Tensor QKVProjection::forward(const Tensor &input, bool isTraining) {
+  const auto &inputShape = input.getShape();
+  if (inputShape.size() != 3 || inputShape[2] != this->embedding_dim) {
+    throw std::runtime_error("QKVProjection::forward espera una entrada {B, N, D}.");
+  }
+  const size_t B = inputShape[0], N = inputShape[1];
+  syncPackedStorage();
+
+  // Un unico GEMM: {B*N, D} x {D, 3D}. La entrada se lee una sola vez.
+  Tensor input2D = input.reshape({B * N, this->embedding_dim});
+  if (isTraining) {
+    this->inputTensor = input2D;
+  }
+  this->int8.observe(input2D);
+
+  if (!isTraining && this->int8.isQuantized()) {
+    Tensor output2D = Tensor::uninitialized({B * N, 3 * this->embedding_dim});
+    this->int8.forward(input2D, output2D);
+    return output2D.reshape({B, N, 3 * this->embedding_dim});
+  }
+  Tensor output2D = matrixMultiply(input2D, this->weights);
+  output2D.addBroadcast(this->bias);
+  return output2D.reshape({B, N, 3 * this->embedding_dim});
+}
+
+Tensor QKVProjection::backward(const Tensor &outputGradient) {
+  const auto &gradShape = outputGradient.getShape(); // {B, N, 3D}
+  const size_t B = gradShape[0], N = gradShape[1];
+  const size_t D = this->embedding_dim;
+  const size_t rows = B * N;
+  syncPackedStorage();
+
+  Tensor grad2D = outputGradient.contiguous().reshape({rows, 3 * D});
+
+  // dE/dW = X^T * dE/dY, sumado en el buffer empaquetado para que las vistas lo vean.
+  Tensor inputTransposed = this->inputTensor.transpose(0, 1);
+  matrixMultiply(inputTransposed, grad2D, this->weightGradients, true);
+
+  // dE/db = sum(dE/dY) a lo largo del eje del batch.
+  float *biasGrad = this->biasGradients.getData() + this->biasGradients.getDataOffset();
+  const float *gradData = grad2D.getData() + grad2D.getDataOffset();
+  const auto add = kernels().add;
+  for (size_t r = 0; r < rows; ++r)
+    add(biasGrad, gradData + r * 3 * D, biasGrad, 3 * D);
+
+  // dE/dX = dE/dY * W^T: un solo GEMM con K = 3D sustituye a las tres ramas y sus dos sumas.
+  Tensor weightsTransposed = this->weights.transpose(0, 1);
+  Tensor inputGradient2D = matrixMultiply(grad2D, weightsTransposed);
+  return inputGradient2D.reshape({B, N, D});
+}
+
+std::vector<Tensor *> QKVProjection::getParameters() {
+  return {&weightViews[0], &biasViews[0], &weightViews[1], &biasViews[1], &weightViews[2], &biasViews[2]};
+}
+
+std::vector<Tensor *> QKVProjection::getGradients() {
+  return {&weightGradientViews[0], &biasGradientViews[0], &weightGradientViews[1],
+          &biasGradientViews[1],   &weightGradientViews[2], &biasGradientViews[2]};
+}
+
+double QKVProjection::getFlops(const std::vector<size_t> &inputShape) const {
+  const double D = static_cast<double>(this->embedding_dim);
+  const double rows = countElements(inputShape) / D;
+  return 2.0 * rows * D * 3.0 * D + rows * 3.0 * D;
+}
@@ -0,0 +1,361 @@
+#include "model/InferencePlan.hpp"
+#include "core/FlashAttention.hpp"
+#include "core/Kernels.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+// Strides row-major de una forma.
+std::vector<size_t> contiguousStrides(const std::vector<size_t> &shape) {
+  std::vector<size_t> strides(shape.size());
+  size_t stride = 1;
+  for (size_t i = shape.size(); i-- > 0;) {
+    strides[i] = stride;
+    stride *= shape[i];
+  }
+  return strides;
+}
+
+float *dataOf(Tensor &t) { return t.getData() + t.getDataOffset(); }
+const float *dataOf(const Tensor &t) { return t.getData() + t.getDataOffset(); }
+
+// Suma el bias {1, cols} a cada fila de un bloque contiguo {rows, cols}.
+void addBiasRows(float *data, const float *bias, size_t rows, size_t cols) {
+  const auto add = kernels().add;
+#pragma omp parallel for
+  for (size_t r = 0; r < rows; ++r)
+    add(data + r * cols, bias, data + r * cols, cols);
+}
+} // namespace
+
+InferencePlan::InferencePlan(VisionTransformer &model, size_t batchSize) : model(model), batchSize(batchSize) {
+  if (batchSize == 0) {
+    throw std::invalid_argument("InferencePlan requiere un tamaño de lote mayor que cero.");
+  }
+  const ViTConfig &config = model.config;
+  const Embeddings &embeddings = model.embeddings;
+  const PatchEmbedding &patcher = *embeddings.patcher;
+  const size_t D = config.embedding_dim;
+  this->numTokens = embeddings.num_patches + 1;
+  this->inputShape = {batchSize, config.in_channels, config.image_size, config.image_size};
+
+  // 1. Embeddings: parches aplanados, proyeccion y secuencia con CLS y codificacion posicional.
+  const size_t patches = define({batchSize * embeddings.num_patches, patcher.patch_dim});
+  steps.push_back({StepKind::Patchify, {patches}});
+
+  const size_t projected = linear(patches, *patcher.projectionLayer);
+
+  const size_t tokens = define({batchSize * numTokens, D});
+  use(projected);
+  Step assemble{StepKind::Tokens, {projected, tokens}};
+  assemble.weight = &embeddings.positionalEncoding;
+  steps.push_back(assemble);
+
+  // 2. Bloques codificadores.
+  size_t x = tokens;
+  for (const auto &block : model.encoder_blocks) {
+    x = encoderBlock(x, block);
+  }
+
+  // 3. LayerNorm final solo sobre los tokens CLS (fila 0 de cada muestra) y cabeza.
+  const size_t cls = layerNorm(x, model.final_norm, batchSize, numTokens * D);
+  this->logits = linear(cls, model.mlp_head);
+
+  assignBuffers();
+  resolveViews();
+}
+
+// Registra una nueva activacion producida por el siguiente paso.
+size_t InferencePlan::define(const std::vector<size_t> &shape) {
+  Value value;
+  value.shape = shape;
+  value.size = 1;
+  for (size_t dim : shape)
+    value.size *= dim;
+  value.firstStep = steps.size();
+  value.lastStep = steps.size();
+  value.buffer = 0;
+  values.push_back(value);
+  return values.size() - 1;
+}
+
+// Marca que el siguiente paso lee 'value'.
+void InferencePlan::use(size_t value) { values[value].lastStep = steps.size(); }
+
+size_t InferencePlan::linear(size_t input, const Dense &layer) {
+  const size_t rows = values[input].shape[0];
+  const size_t output = define({rows, layer.weights.getShape()[1]});
+  use(input);
+  Step step{StepKind::Linear, {input, output}};
+  step.weight = &layer.weights;
+  step.bias = &layer.bias;
+  step.int8 = &layer.int8;
+  steps.push_back(step);
+  return output;
+}
+
+size_t InferencePlan::layerNorm(size_t input, const LayerNorm &norm, size_t rows, size_t rowStride) {
+  const size_t output = define({rows, norm.featureSize});
+  use(input);
+  Step step{StepKind::LayerNorm, {input, output}};
+  step.weight = &norm.gamma;
+  step.bias = &norm.beta;
+  step.scalar = norm.epsilon;
+  step.rows = rows;
+  step.rowStride = rowStride;
+  steps.push_back(step);
+  return output;
+}
+
+size_t InferencePlan::attention(size_t input, const MultiHeadAttention &mha) {
+  const size_t rows = batchSize * numTokens;
+  const size_t D = mha.embedding_dim;
+
+  // Proyecciones: una sola {rows, 3D} con la version fusionada o tres {rows, D}.
+  std::vector<size_t> qkv;
+  if (mha.fuse_qkv) {
+    const size_t packed = define({rows, 3 * D});
+    use(input);
+    Step step{StepKind::Linear, {input, packed}};
+    step.qkv = mha.qkv_proj.get();
+    steps.push_back(step);
+    qkv = {packed};
+  } else {
+    qkv = {linear(input, *mha.q_proj), linear(input, *mha.k_proj), linear(input, *mha.v_proj)};
+  }
+
+  // Atencion. El temporal es la matriz de puntuaciones {B, h, N, N} o, con la version
+  // fusionada, el log-suma-exp {B*h, N}; vive solo durante este paso.
+  const size_t context = define({rows, D});
+  const size_t scratch = mha.use_flash_attention ? define({batchSize * mha.num_heads, numTokens})
+                                                 : define({batchSize, mha.num_heads, numTokens, numTokens});
+  for (size_t value : qkv)
+    use(value);
+  Step step{StepKind::Attention, qkv};
+  step.values.push_back(context);
+  step.values.push_back(scratch);
+  step.scalar = 1.0f / std::sqrt(static_cast<float>(mha.head_dim));
+  step.flash = mha.use_flash_attention;
+  step.rows = mha.num_heads; // Numero de cabezas, para construir las vistas.
+  steps.push_back(step);
+
+  return linear(context, *mha.out_proj);
+}
+
+size_t InferencePlan::encoderBlock(size_t input, const TransformerEncoderBlock &block) {
+  const size_t rows = batchSize * numTokens;
+  const size_t D = block.norm1.featureSize;
+
+  // residual1 = input + Attention(LayerNorm(input)), escrito sobre la salida de la atencion.
+  const size_t attended = attention(layerNorm(input, block.norm1, rows, D), block.attention);
+  use(input);
+  use(attended);
+  steps.push_back({StepKind::Add, {input, attended}});
+  const size_t residual1 = attended;
+
+  // salida = residual1 + FFN(LayerNorm(residual1)); GELU y la suma se hacen en su sitio.
+  const size_t hidden = linear(layerNorm(residual1, block.norm2, rows, D), block.ffn.dense1);
+  use(hidden);
+  steps.push_back({StepKind::Gelu, {hidden}});
+  const size_t ffnOut = linear(hidden, block.ffn.dense2);
+  use(residual1);
+  use(ffnOut);
+  steps.push_back({StepKind::Add, {residual1, ffnOut}});
+  return ffnOut;
+}
+
+// Asigna cada activacion a un buffer libre durante todo su intervalo de vida. Entre los
+// buffers libres se elige el mas pequeño que la contenga; si ninguno basta, se agranda el
+// mayor de ellos y, si no hay ninguno libre, se crea otro.
+void InferencePlan::assignBuffers() {
+  std::vector<size_t> bufferSize;
+  std::vector<size_t> busyUntil; // Ultimo paso en el que el buffer esta ocupado.
+  values[logits].lastStep = steps.size();
+
+  for (auto &value : values) {
+    size_t best = bufferSize.size();
+    for (size_t b = 0; b < bufferSize.size(); ++b) {
+      if (busyUntil[b] >= value.firstStep)
+        continue;
+      if (best == bufferSize.size()) {
+        best = b;
+        continue;
+      }
+      const bool fits = bufferSize[b] >= value.size;
+      const bool bestFits = bufferSize[best] >= value.size;
+      if ((fits && (!bestFits || bufferSize[b] < bufferSize[best])) || (!fits && !bestFits && bufferSize[b] > bufferSize[best]))
+        best = b;
+    }
+    if (best == bufferSize.size()) {
+      bufferSize.push_back(0);
+      busyUntil.push_back(0);
+    }
+    bufferSize[best] = std::max(bufferSize[best], value.size);
+    busyUntil[best] = value.lastStep;
+    value.buffer = best;
+  }
+
+  for (size_t size : bufferSize)
+    buffers.push_back(Tensor::uninitialized({size}));
+}
+
+Tensor InferencePlan::viewOf(size_t value) const {
+  const Value &v = values[value];
+  return Tensor(buffers[v.buffer].getDataPtr(), v.shape, contiguousStrides(v.shape), 0);
+}
+
+// Crea de antemano todas las vistas que usa cada paso.
+void InferencePlan::resolveViews() {
+  for (auto &step : steps) {
+    if (step.kind != StepKind::Attention) {
+      for (size_t value : step.values)
+        step.views.push_back(viewOf(value));
+      continue;
+    }
+
+    // Vistas por cabezas {B, h, N, d_h} de un bloque de columnas de una activacion {B*N, W}.
+    const size_t heads = step.rows;
+    const size_t context = step.values[step.values.size() - 2];
+    const size_t D = values[context].shape[1];
+    const size_t headDim = D / heads;
+    auto headsOf = [&](size_t value, size_t part) {
+      const size_t width = values[value].shape[1];
+      return Tensor(buffers[values[value].buffer].getDataPtr(), {batchSize, heads, numTokens, headDim},
+                    {numTokens * width, headDim, width, 1}, part * D);
+    };
+    const bool packed = step.values.size() == 3;
+    Tensor q = headsOf(step.values[0], 0);
+    Tensor k = packed ? headsOf(step.values[0], 1) : headsOf(step.values[1], 0);
+    Tensor v = packed ? headsOf(step.values[0], 2) : headsOf(step.values[2], 0);
+    // Sin atencion fusionada el BMM consume K^T como vista transpuesta.
+    step.views = {q, step.flash ? k : k.transpose(2, 3), v, headsOf(context, 0), viewOf(step.values.back())};
+  }
+}
+
+size_t InferencePlan::getArenaSize() const {
+  size_t total = 0;
+  for (const auto &buffer : buffers)
+    total += buffer.getSize();
+  return total;
+}
+
+size_t InferencePlan::getUnplannedSize() const {
+  size_t total = 0;
+  for (const auto &value : values)
+    total += value.size;
+  return total;
+}
+
+const Tensor &InferencePlan::run(const Tensor &input) {
+  const auto &shape = input.getShape();
+  if (shape.size() != 4 || !std::equal(shape.begin(), shape.end(), inputShape.begin())) {
+    throw std::invalid_argument("InferencePlan::run: la entrada " + input.shapeToString() +
+                                " no coincide con la forma para la que se compilo el plan.");
+  }
+  const KernelTable &kt = kernels();
+
+  // Pesos actuales de las proyecciones QKV fusionadas (ver Step::qkv).
+  for (auto &step : steps) {
+    if (step.qkv) {
+      step.qkv->syncPackedStorage();
+      step.weight = &step.qkv->weights;
+      step.bias = &step.qkv->bias;
+      step.int8 = &step.qkv->int8;
+    }
+  }
+
+  for (auto &step : steps) {
+    auto &views = step.views;
+    switch (step.kind) {
+    case StepKind::Patchify:
+      model.embeddings.patcher->extractPatches(input, views[0]);
+      break;
+
+    case StepKind::Linear:
+      if (step.int8 && step.int8->isQuantized()) {
+        step.int8->forward(views[0], views[1]);
+        break;
+      }
+      matrixMultiply(views[0], *step.weight, views[1]);
+      addBiasRows(dataOf(views[1]), dataOf(*step.bias), views[1].getShape()[0], views[1].getShape()[1]);
+      break;
+
+    case StepKind::Tokens: {
+      // Igual que Embeddings::forward: el token CLS de la secuencia es un tensor de ceros
+      // concatenado delante de los parches, y a todo se le suma la codificacion posicional.
+      const size_t D = views[1].getShape()[1];
+      const size_t numPatches = numTokens - 1;
+      const float *patchData = dataOf(views[0]);
+      const float *posData = dataOf(*step.weight);
+      float *out = dataOf(views[1]);
+#pragma omp parallel for
+      for (size_t b = 0; b < batchSize; ++b) {
+        float *sample = out + b * numTokens * D;
+        std::copy(posData, posData + D, sample);
+        kt.add(patchData + b * numPatches * D, posData + D, sample + D, numPatches * D);
+      }
+      break;
+    }
+
+    case StepKind::LayerNorm: {
+      const size_t D = views[1].getShape()[1];
+      const float *in = dataOf(views[0]);
+      float *out = dataOf(views[1]);
+      const float *gamma = dataOf(*step.weight);
+      const float *beta = dataOf(*step.bias);
+#pragma omp parallel for
+      for (size_t r = 0; r < step.rows; ++r)
+        kt.layerNormRow(in + r * step.rowStride, gamma, beta, nullptr, out + r * D, D, step.scalar, nullptr, nullptr);
+      break;
+    }
+
+    case StepKind::Attention:
+      runAttention(step);
+      break;
+
+    case StepKind::Add: {
+      const float *a = dataOf(views[0]);
+      float *b = dataOf(views[1]);
+      parallelChunks(views[1].getSize(), [&](size_t begin, size_t count) { kt.add(a + begin, b + begin, b + begin, count); });
+      break;
+    }
+
+    case StepKind::Gelu: {
+      float *x = dataOf(views[0]);
+      parallelChunks(views[0].getSize(), [&](size_t begin, size_t count) { kt.geluForward(x + begin, x + begin, count); });
+      break;
+    }
+    }
+  }
+  return steps.back().views[1];
+}
+
+void InferencePlan::runAttention(Step &step) {
+  Tensor &q = step.views[0];
+  Tensor &k = step.views[1];
+  Tensor &v = step.views[2];
+  Tensor &context = step.views[3];
+  Tensor &scratch = step.views[4];
+
+  if (step.flash) {
+    flashAttentionForward(q, k, v, step.scalar, context, scratch);
+    return;
+  }
+
+  // scores = softmax(Q * K^T * scale), escrito en el temporal {B, h, N, N}.
+  batchMatrixMultiply(q, k, scratch);
+  const size_t n = numTokens;
+  const size_t rows = scratch.getSize() / n;
+  float *scores = dataOf(scratch);
+  const KernelTable &kt = kernels();
+#pragma omp parallel for
+  for (size_t r = 0; r < rows; ++r) {
+    kt.scale(scores + r * n, step.scalar, n);
+    kt.softmaxRow(scores + r * n, scores + r * n, n);
+  }
+
+  // context = scores * V, escrito directamente en las columnas de cada cabeza.
+  batchMatrixMultiply(scratch, v, context);
+}
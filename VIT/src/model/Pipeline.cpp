@@ -0,0 +1,269 @@
+#include "model/Pipeline.hpp"
+#include "utils/ModelUtils.hpp"
+#include <algorithm>
+#include <numeric>
+#include <pthread.h>
+#include <sched.h>
+#include <stdexcept>
+#include <string>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// --- Funciones Auxiliares (privadas a este archivo) ---
+namespace {
+// Nucleos en los que puede correr el proceso (respeta taskset y similares).
+std::vector<int> available_cpus() {
+  std::vector<int> cpus;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+      if (CPU_ISSET(cpu, &set))
+        cpus.push_back(cpu);
+  }
+  if (cpus.empty()) {
+    cpus.resize(std::max(1u, std::thread::hardware_concurrency()));
+    std::iota(cpus.begin(), cpus.end(), 0);
+  }
+  return cpus;
+}
+} // namespace
+
+Pipeline::Pipeline(VisionTransformer &model, size_t numStages, size_t microBatches)
+    : model(model), microBatches(std::max<size_t>(1, microBatches)) {
+  const size_t layers = model.numParts() - 2;
+  if (numStages == 0 || numStages > layers) {
+    throw std::invalid_argument("Pipeline: el numero de etapas (" + std::to_string(numStages) +
+                                ") debe estar entre 1 y el numero de bloques (" + std::to_string(layers) + ").");
+  }
+
+  // Las copias leen los pesos del modelo, sin copiarlos en cada paso.
+  for (size_t r = 1; r < numStages; ++r) {
+    replicas.push_back(std::make_unique<VisionTransformer>(model.getConfig()));
+    ModelUtils::share_parameters(model, *replicas.back());
+  }
+  losses.resize(numStages);
+
+  // Bloques a partes iguales y nucleos en grupos consecutivos. Con menos nucleos que
+  // etapas, las etapas comparten nucleo.
+  const std::vector<int> cpus = available_cpus();
+  stages.resize(numStages);
+  for (size_t s = 0; s < numStages; ++s) {
+    Stage &stage = stages[s];
+    stage.beginPart = s == 0 ? 0 : 1 + layers * s / numStages;
+    stage.endPart = s + 1 == numStages ? model.numParts() : 1 + layers * (s + 1) / numStages;
+    const size_t first = cpus.size() * s / numStages;
+    const size_t last = cpus.size() * (s + 1) / numStages;
+    if (first == last)
+      stage.cpus = {cpus[s % cpus.size()]};
+    else
+      stage.cpus.assign(cpus.begin() + first, cpus.begin() + last);
+  }
+
+  for (size_t s = 0; s < numStages; ++s)
+    stages[s].thread = std::thread(&Pipeline::stageLoop, this, s);
+}
+
+Pipeline::~Pipeline() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  changed.notify_all();
+  for (Stage &stage : stages)
+    stage.thread.join();
+}
+
+std::pair<size_t, size_t> Pipeline::getStageParts(size_t stage) const {
+  return {stages.at(stage).beginPart, stages.at(stage).endPart};
+}
+
+std::pair<float, Tensor> Pipeline::step(const Tensor &X, const Tensor &y, float gradScale) {
+  rows = X.getShape()[0];
+  if (rows == 0)
+    throw std::invalid_argument("Pipeline: batch vacio.");
+  numMicro = std::min(microBatches, rows);
+  this->gradScale = gradScale;
+
+  // Las copias del modelo parten de gradientes a cero.
+  for (auto &replica : replicas)
+    replica->zeroGradients();
+
+  const size_t numStages = stages.size();
+  activations.assign(numStages, std::vector<Tensor>(numMicro));
+  gradients.assign(numStages, std::vector<Tensor>(numMicro));
+  activationReady.assign(numStages, std::vector<char>(numMicro, 0));
+  gradientReady.assign(numStages, std::vector<char>(numMicro, 0));
+  microLosses.assign(numMicro, 0.0f);
+  microLogits.assign(numMicro, Tensor());
+  batchX = &X;
+  batchY = &y;
+
+  // Lanza el paso en los hilos de las etapas y espera a que terminen todas.
+  std::exception_ptr failure;
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    error = nullptr;
+    finishedStages = 0;
+    ++stepId;
+    changed.notify_all();
+    changed.wait(lock, [this, numStages] { return finishedStages == numStages; });
+    failure = error;
+  }
+  activations.clear();
+  gradients.clear();
+  if (failure)
+    std::rethrow_exception(failure);
+
+  // Logits del batch completo, en el orden de las filas.
+  const size_t classes = microLogits[0].getShape()[1];
+  Tensor logits = Tensor::uninitialized({rows, classes});
+  for (size_t m = 0; m < numMicro; ++m) {
+    const Tensor part = microLogits[m].contiguous();
+    const float *src = part.getData() + part.getDataOffset();
+    std::copy(src, src + part.getSize(), logits.getData() + (rows * m / numMicro) * classes);
+  }
+  microLogits.clear();
+
+  return {std::accumulate(microLosses.begin(), microLosses.end(), 0.0f), logits};
+}
+
+// Hilo de una etapa: se fija a sus nucleos y ejecuta su calendario en cada paso.
+void Pipeline::stageLoop(size_t stage) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : stages[stage].cpus)
+    CPU_SET(cpu, &set);
+  // Si no se puede fijar (ej. contenedor restringido) la etapa sigue sin afinidad. Los
+  // hilos OpenMP que cree heredan la mascara.
+  pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#ifdef _OPENMP
+  omp_set_num_threads(static_cast<int>(stages[stage].cpus.size()));
+#endif
+
+  size_t seen = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      changed.wait(lock, [this, seen] { return stopping || stepId != seen; });
+      if (stopping)
+        return;
+      seen = stepId;
+    }
+
+    std::exception_ptr failure;
+    try {
+      runSchedule(stage);
+    } catch (...) {
+      failure = std::current_exception();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (failure && !error)
+        error = failure;
+      ++finishedStages;
+    }
+    changed.notify_all();
+  }
+}
+
+// Calendario 1F1B de la etapa: calentamiento, alternancia y vaciado.
+void Pipeline::runSchedule(size_t stage) {
+  const size_t warmup = std::min(stages.size() - stage - 1, numMicro);
+  for (size_t m = 0; m < warmup; ++m)
+    forwardMicroBatch(stage, m);
+  for (size_t m = 0; m + warmup < numMicro; ++m) {
+    forwardMicroBatch(stage, m + warmup);
+    backwardMicroBatch(stage, m);
+  }
+  for (size_t m = numMicro - warmup; m < numMicro; ++m)
+    backwardMicroBatch(stage, m);
+
+  // El modelo (copia 0) ya tiene sumados sus micro-batches; se le anaden los de las demas
+  // copias que hayan trabajado en este paso.
+  Stage &s = stages[stage];
+  const size_t usedCopies = std::min(stages.size(), numMicro);
+  if (usedCopies < 2)
+    return;
+  const std::vector<Tensor *> modelGrads = model.getPartGradients(s.beginPart, s.endPart);
+  ModelUtils::pack_tensors(modelGrads, s.gradientSum);
+  for (size_t c = 1; c < usedCopies; ++c) {
+    ModelUtils::pack_tensors(replicas[c - 1]->getPartGradients(s.beginPart, s.endPart), s.scratch);
+    for (size_t i = 0; i < s.scratch.size(); ++i)
+      s.gradientSum[i] += s.scratch[i];
+  }
+  ModelUtils::unpack_tensors(s.gradientSum, modelGrads);
+}
+
+void Pipeline::forwardMicroBatch(size_t stage, size_t micro) {
+  const Stage &s = stages[stage];
+  const size_t begin = rows * micro / numMicro;
+  const size_t count = rows * (micro + 1) / numMicro - begin;
+
+  Tensor input;
+  if (stage == 0) {
+    input = batchX->slice(0, begin, count);
+  } else {
+    waitFor(activationReady[stage], micro);
+    input = std::move(activations[stage][micro]);
+  }
+
+  VisionTransformer &copy = copyFor(micro);
+  Tensor output = copy.forwardParts(input, s.beginPart, s.endPart, true);
+
+  if (stage + 1 < stages.size()) {
+    activations[stage + 1][micro] = std::move(output);
+    publish(activationReady[stage + 1], micro);
+    return;
+  }
+
+  // Ultima etapa: perdida del micro-batch. El gradiente de los logits se pondera por la
+  // fraccion del batch que ocupa, asi la suma de los micro-batches es el gradiente de la
+  // perdida media del batch.
+  const Tensor y_part = batchY->slice(0, begin, count);
+  const float weight = static_cast<float>(count) / rows;
+  CrossEntropy &loss = losses[micro % stages.size()];
+  microLosses[micro] = weight * loss.calculate(output, y_part);
+  microLogits[micro] = output;
+
+  Tensor grad = loss.backward(output, y_part);
+  if (!grad.isContiguous())
+    grad = grad.contiguous();
+  float *grad_data = grad.getData() + grad.getDataOffset();
+  for (size_t i = 0; i < grad.getSize(); ++i)
+    grad_data[i] *= weight * gradScale;
+  gradients[stage][micro] = std::move(grad);
+  publish(gradientReady[stage], micro);
+}
+
+void Pipeline::backwardMicroBatch(size_t stage, size_t micro) {
+  const Stage &s = stages[stage];
+  waitFor(gradientReady[stage], micro);
+  const Tensor grad = std::move(gradients[stage][micro]);
+
+  // Los gradientes de la copia se acumulan sobre los de sus micro-batches anteriores.
+  VisionTransformer &copy = copyFor(micro);
+  Tensor inputGrad = copy.backwardParts(grad, s.beginPart, s.endPart);
+  if (stage > 0) {
+    gradients[stage - 1][micro] = std::move(inputGrad);
+    publish(gradientReady[stage - 1], micro);
+  }
+}
+
+void Pipeline::waitFor(const std::vector<char> &flags, size_t micro) {
+  std::unique_lock<std::mutex> lock(mutex);
+  changed.wait(lock, [&] { return flags[micro] != 0 || error != nullptr; });
+  if (!flags[micro])
+    throw std::runtime_error("Pipeline: etapa interrumpida porque otra etapa ha fallado.");
+}
+
+void Pipeline::publish(std::vector<char> &flags, size_t micro) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    flags[micro] = 1;
+  }
+  changed.notify_all();
+}
@@ -1,6 +1,12 @@
 #include "model/Trainer.hpp"
+#include "core/Allocator.hpp"
+#include "utils/DataLoader.hpp"
+#include "utils/ModelUtils.hpp"
+#include "utils/Profiler.hpp"
 #include <algorithm>
+#include <chrono>
 #include <ctime>
+#include <exception>
 #include <iomanip>
 #include <iostream>
 #include <limits>
@@ -33,39 +39,167 @@ float calculate_accuracy(const Tensor &logits, const Tensor &labels) {
   }
   return static_cast<float>(correct_predictions) / batch_size;
 }
+
+// --- Paralelismo de datos ---
+
+// Floats por trabajo al sumar tensores entre replicas.
+constexpr size_t REDUCE_CHUNK = 16384;
+
+// Trozo contiguo de un tensor destino y su homologo en otra replica.
+struct BufferJob {
+  float *dst;
+  const float *src;
+  size_t size;
+};
+
+float *contiguous_data(Tensor &t) {
+  if (!t.isContiguous())
+    throw std::runtime_error("Paralelismo de datos: se esperaba un tensor contiguo.");
+  return t.getData() + t.getDataOffset();
+}
+
+// Multiplica el gradiente de los logits por 'scale' antes del backward.
+void scale_gradient(Tensor &grad, float scale) {
+  if (scale == 1.0f)
+    return;
+  float *grad_data = contiguous_data(grad);
+  for (size_t i = 0; i < grad.getSize(); ++i)
+    grad_data[i] *= scale;
+}
+
+// Trabajos para recorrer a la par dos tensores de la misma forma: trozos de REDUCE_CHUNK
+// si son contiguos o, para las vistas 2D con filas contiguas (los bloques de
+// QKVProjection), una fila por trabajo.
+void append_jobs(std::vector<BufferJob> &jobs, Tensor &dst, Tensor &src) {
+  if (dst.getShape() != src.getShape())
+    throw std::runtime_error("Paralelismo de datos: las replicas no tienen los mismos parametros.");
+  if (dst.isContiguous() && src.isContiguous()) {
+    float *d = dst.getData() + dst.getDataOffset();
+    const float *s = src.getData() + src.getDataOffset();
+    for (size_t begin = 0; begin < dst.getSize(); begin += REDUCE_CHUNK)
+      jobs.push_back({d + begin, s + begin, std::min(REDUCE_CHUNK, dst.getSize() - begin)});
+    return;
+  }
+  const auto &shape = dst.getShape();
+  if (shape.size() != 2 || dst.getStrides()[1] != 1 || src.getStrides()[1] != 1)
+    throw std::runtime_error("Paralelismo de datos: parametro con un layout no soportado.");
+  for (size_t r = 0; r < shape[0]; ++r)
+    jobs.push_back({dst.getData() + dst.getDataOffset() + r * dst.getStrides()[0],
+                    src.getData() + src.getDataOffset() + r * src.getStrides()[0], shape[1]});
+}
+
+std::vector<BufferJob> make_jobs(const std::vector<Tensor *> &dst, const std::vector<Tensor *> &src) {
+  if (dst.size() != src.size())
+    throw std::runtime_error("Paralelismo de datos: las replicas no tienen los mismos parametros.");
+  std::vector<BufferJob> jobs;
+  for (size_t t = 0; t < dst.size(); ++t)
+    append_jobs(jobs, *dst[t], *src[t]);
+  return jobs;
+}
+
+// Suma los gradientes de todas las replicas en grads[0] con un arbol de orden fijo:
+// en el nivel s, la replica r (multiplo de 2s) suma la r + s. Cada elemento lo suma un
+// unico hilo y siempre en el mismo orden, asi que el resultado es identico bit a bit con
+// cualquier numero de hilos.
+void tree_reduce(const std::vector<std::vector<Tensor *>> &grads) {
+  for (size_t stride = 1; stride < grads.size(); stride *= 2) {
+    std::vector<BufferJob> jobs;
+    for (size_t r = 0; r + stride < grads.size(); r += 2 * stride) {
+      std::vector<BufferJob> pair_jobs = make_jobs(grads[r], grads[r + stride]);
+      jobs.insert(jobs.end(), pair_jobs.begin(), pair_jobs.end());
+    }
+#pragma omp parallel for schedule(dynamic)
+    for (size_t j = 0; j < jobs.size(); ++j) {
+      float *dst = jobs[j].dst;
+      const float *src = jobs[j].src;
+      for (size_t i = 0; i < jobs[j].size; ++i)
+        dst[i] += src[i];
+    }
+  }
+}
+
+// --- Entrenamiento distribuido ---
+
+// Posiciones rank, rank + P, rank + 2P... del recorrido barajado. Si N no es multiplo de P,
+// el recorrido se completa con sus primeras posiciones hasta ceil(N / P) * P: todos los
+// procesos hacen el mismo numero de pasos (y de all-reduce) y ninguna muestra se queda
+// fuera de la epoca.
+std::vector<size_t> shard_indices(const std::vector<size_t> &indices, size_t rank, size_t world) {
+  std::vector<size_t> shard((indices.size() + world - 1) / world);
+  for (size_t i = 0; i < shard.size(); ++i)
+    shard[i] = indices[(i * world + rank) % indices.size()];
+  return shard;
+}
 } // namespace
 
 // Constructor del Trainer. Recibe una referencia al modelo y la configuracion.
 Trainer::Trainer(VisionTransformer &model, const TrainerConfig &train_config)
-    : model(model), optimizer(train_config.learning_rate, 0.9f, 0.999f, 1e-8f, train_config.weight_decay), loss_fn(),
-      config(train_config) {}
+    : model(model), optimizer(train_config.learning_rate, 0.9f, 0.999f, 1e-8f, train_config.weight_decay),
+      parameters(model.getParameters(), model.getGradients()), loss_fn(), config(train_config) {
+  if (config.pipeline_stages > 1 && config.data_parallel_replicas > 1)
+    throw std::invalid_argument("Trainer: pipeline_stages y data_parallel_replicas no se pueden combinar.");
+  if (config.accumulation_steps == 0)
+    throw std::invalid_argument("Trainer: accumulation_steps debe ser al menos 1.");
+  // Las replicas leen los pesos del registro: el paso de Adam les llega sin copias.
+  for (size_t r = 1; r < config.data_parallel_replicas; ++r) {
+    replicas.push_back(std::make_unique<VisionTransformer>(model.getConfig()));
+    ModelUtils::share_parameters(model, *replicas.back());
+  }
+  replica_losses.resize(replicas.size() + 1);
+  if (config.pipeline_stages > 1)
+    pipeline = std::make_unique<Pipeline>(model, config.pipeline_stages, config.pipeline_micro_batches);
+}
 
 // Orquesta el proceso de entrenamiento completo a lo largo de varias epocas.
 void Trainer::train(const std::pair<Tensor, Tensor> &train_data, const std::pair<Tensor, Tensor> &test_data) {
-  const auto &[X_train, y_train] = train_data;
-  const auto &[X_test, y_test] = test_data;
+  train(TensorDataset(train_data.first, train_data.second), TensorDataset(test_data.first, test_data.second));
+}
+
+void Trainer::train(const Dataset &train_data, const Dataset &test_data) {
+  if (communicator) {
+    // Todos los procesos parten de los pesos del rank 0.
+    broadcast_parameters();
+    std::cout << "Entrenamiento distribuido: " << communicator->world_size() << " procesos." << std::endl;
+  }
 
   for (int epoch = 0; epoch < config.epochs; ++epoch) {
+    auto epoch_start = std::chrono::steady_clock::now();
+    exposed_communication = 0.0;
+    const double communication_before = communicator ? communicator->communication_seconds() : 0.0;
+
     // Ejecuta una epoca de entrenamiento y obtiene sus metricas.
-    auto [train_loss, train_acc] = train_epoch(X_train, y_train);
+    auto [train_loss, train_acc] = train_epoch(train_data);
+    std::chrono::duration<double> train_time = std::chrono::steady_clock::now() - epoch_start;
 
     // Limpia la linea de progreso de los batches.
     std::cout << "\r" << std::string(80, ' ') << "\r";
 
     // Evalua en el conjunto de test para obtener sus metricas.
-    auto [test_loss, test_acc] = evaluate(X_test, y_test);
+    auto [test_loss, test_acc] = evaluate(test_data);
+    std::chrono::duration<double> epoch_time = std::chrono::steady_clock::now() - epoch_start;
 
     // Imprime el resumen de la epoca.
     std::cout << "--- Epoca " << epoch + 1 << "/" << config.epochs << " | Train Loss: " << std::fixed << std::setprecision(4)
               << train_loss << " | Train Acc: " << train_acc << " | Test Loss: " << test_loss << " | Test Acc: " << test_acc
-              << std::endl;
+              << " | Tiempo: " << std::setprecision(2) << epoch_time.count() << "s" << std::endl;
+
+    if (communicator) {
+      // Eficiencia de escalado estimada: fraccion del tiempo de entrenamiento que no se pasa
+      // esperando al all-reduce (la comunicacion solapada con el backward no cuenta).
+      const size_t world = communicator->world_size();
+      const double samples = static_cast<double>((train_data.size() + world - 1) / world * world);
+      const double communication = communicator->communication_seconds() - communication_before;
+      std::cout << "    Distribuido: " << world << " procesos | " << std::setprecision(1) << samples / train_time.count()
+                << " muestras/s | Comunicacion: " << std::setprecision(2) << communication
+                << "s (expuesta " << exposed_communication << "s) | Eficiencia estimada: " << std::setprecision(1)
+                << 100.0 * (1.0 - exposed_communication / train_time.count()) << "%" << std::endl;
+    }
   }
 }
 
 // Ejecuta un ciclo completo sobre el dataset de entrenamiento (una epoca).
-std::pair<float, float> Trainer::train_epoch(const Tensor &X_train, const Tensor &y_train) {
-  size_t num_train_samples = X_train.getShape()[0];
-  size_t num_batches = (num_train_samples + config.batch_size - 1) / config.batch_size;
+std::pair<float, float> Trainer::train_epoch(const Dataset &train_data) {
+  size_t num_train_samples = train_data.size();
 
   float total_loss = 0.0f;
   float total_accuracy = 0.0f;
@@ -73,79 +207,235 @@ std::pair<float, float> Trainer::train_epoch(const Tensor &X_train, const Tensor
   // Crea y baraja los indices para procesar los datos en orden aleatorio.
   std::vector<size_t> indices(num_train_samples);
   std::iota(indices.begin(), indices.end(), 0);
-  std::srand(static_cast<unsigned int>(std::time(nullptr))); // Semilla para el barajado.
+  unsigned int seed = static_cast<unsigned int>(std::time(nullptr)); // Semilla para el barajado.
+  if (communicator) {
+    // Todos los procesos barajan igual y cada uno se queda con su parte.
+    communicator->broadcast(&seed, sizeof(seed), 0);
+  }
+  std::srand(seed);
   std::random_shuffle(indices.begin(), indices.end());
+  if (communicator)
+    indices = shard_indices(indices, communicator->rank(), communicator->world_size());
+  const size_t num_samples = indices.size();
+  size_t num_batches = (num_samples + config.batch_size - 1) / config.batch_size;
+  const size_t accumulation_steps = config.accumulation_steps;
+
+  // Con varios procesos y sin replicas ni pipeline, los gradientes de cada parte del modelo
+  // se envian en cuanto el backward la termina, mientras se calcula la siguiente. Con
+  // acumulacion, solo en el ultimo batch antes de Adam.
+  const bool overlap_communication = communicator && replicas.empty() && !pipeline;
+  bool sync_in_backward = false;
+  struct HookScope {
+    VisionTransformer &model;
+    ~HookScope() { model.setGradientHook(nullptr); }
+  } hook_scope{model};
+  if (overlap_communication)
+    model.setGradientHook([this, &sync_in_backward](const std::vector<Tensor *> &grads) {
+      if (sync_in_backward)
+        queue_gradients(grads);
+    });
+
+  // El DataLoader arma los batches barajados en segundo plano mientras se entrena.
+  DataLoader loader(train_data, std::move(indices), config.batch_size, config.prefetch_batches);
+  std::pair<Tensor, Tensor> batch;
 
   for (size_t i = 0; i < num_batches; ++i) {
-    size_t start_idx = i * config.batch_size;
-    size_t count = std::min(config.batch_size, num_train_samples - start_idx);
-    if (count == 0)
-      continue;
-
-    // Crea los tensores para el batch actual.
-    // Nota: Esta seccion podria optimizarse creando una funcion 'batch_slice'
-    // que extraiga un batch de datos usando una lista de indices.
-    Tensor X_batch({count, X_train.getShape()[1], X_train.getShape()[2], X_train.getShape()[3]});
-    Tensor y_batch({count, y_train.getShape()[1]});
-
-    for (size_t j = 0; j < count; ++j) {
-      size_t data_idx = indices[start_idx + j];
-      Tensor x_sample = X_train.slice(0, data_idx, 1);
-      Tensor y_sample = y_train.slice(0, data_idx, 1);
-      // Copia manual de datos.
-      for (size_t c = 0; c < X_batch.getShape()[1]; ++c)
-        for (size_t h = 0; h < X_batch.getShape()[2]; ++h)
-          for (size_t w = 0; w < X_batch.getShape()[3]; ++w)
-            X_batch(j, c, h, w) = x_sample(0, c, h, w);
-      for (size_t c = 0; c < y_batch.getShape()[1]; ++c)
-        y_batch(j, c) = y_sample(0, c);
+    PROFILE_SCOPE("train_step", "step");
+    {
+      // Solo mide la espera: con prefetch el batch ya suele estar listo.
+      PROFILE_SCOPE("batch_wait", "step");
+      loader.next(batch);
     }
+    const Tensor &X_batch = batch.first;
+    const Tensor &y_batch = batch.second;
+
+    // Grupo de batches que comparten un paso de Adam. Cada batch pesa segun su fraccion de
+    // filas del grupo, asi la suma es el gradiente de la perdida media del grupo.
+    const size_t group_begin = i - i % accumulation_steps;
+    const size_t group_end = std::min(group_begin + accumulation_steps, num_batches);
+    const size_t group_rows = std::min(group_end * config.batch_size, num_samples) - group_begin * config.batch_size;
+    const float grad_scale = static_cast<float>(X_batch.getShape()[0]) / group_rows;
+    const bool apply_update = i + 1 == group_end;
+    sync_in_backward = apply_update;
+    if (i == group_begin)
+      parameters.zeroGradients();
 
     // --- Ciclo de entrenamiento para el batch ---
-    // 1. Forward pass
-    Tensor logits = model.forward(X_batch, true);
-    total_loss += loss_fn.calculate(logits, y_batch);
-    total_accuracy += calculate_accuracy(logits, y_batch);
+    // 1-2. Forward y backward (suma su gradiente al del grupo).
+    auto [batch_loss, batch_accuracy] = accumulate_gradients(X_batch, y_batch, grad_scale);
+    total_loss += batch_loss;
+    total_accuracy += batch_accuracy;
+
+    if (apply_update) {
+      // 2b. Media de los gradientes de todos los procesos.
+      if (communicator) {
+        if (!overlap_communication)
+          queue_gradients(parameters.getGradients());
+        finish_gradient_sync();
+      }
 
-    // 2. Backward pass
-    Tensor grad = loss_fn.backward(logits, y_batch);
-    model.backward(grad);
+      // 3. Actualizacion de parametros
+      PROFILE_SCOPE("optimizer", "step");
+      optimizer.update(parameters);
+    }
 
-    // 3. Actualizacion de parametros
-    auto params = model.getParameters();
-    auto grads = model.getGradients();
-    optimizer.update(params, grads);
+    // 4. Fin del paso: el pool libera los bloques cacheados que este lote no reutilizo.
+    getAllocator()->resetStep();
 
     std::cout << "\rEntrenando... Batch " << i + 1 << "/" << num_batches << " " << std::flush;
   }
 
+  if (communicator) {
+    // Metricas de la epoca sobre todos los procesos (todos hacen el mismo numero de batches).
+    float totals[2] = {total_loss, total_accuracy};
+    communicator->all_reduce(totals, 2);
+    const float batches = static_cast<float>(num_batches * communicator->world_size());
+    return {totals[0] / batches, totals[1] / batches};
+  }
   return {total_loss / num_batches, total_accuracy / num_batches};
 }
 
+std::pair<float, float> Trainer::accumulate_gradients(const Tensor &X_batch, const Tensor &y_batch, float grad_scale) {
+  if (pipeline) {
+    // Forward y backward de los micro-batches a traves de las etapas.
+    auto [batch_loss, logits] = pipeline->step(X_batch, y_batch, grad_scale);
+    return {batch_loss, calculate_accuracy(logits, y_batch)};
+  }
+  if (!replicas.empty()) {
+    // Forward y backward de cada parte del batch en su replica, y suma de gradientes.
+    return data_parallel_step(X_batch, y_batch, grad_scale);
+  }
+
+  // 1. Forward pass
+  Tensor logits = PROFILE_FORWARD("model", model, X_batch, true);
+  const float batch_loss = loss_fn.calculate(logits, y_batch);
+  const float batch_accuracy = calculate_accuracy(logits, y_batch);
+
+  // 2. Backward pass
+  Tensor grad = loss_fn.backward(logits, y_batch);
+  scale_gradient(grad, grad_scale);
+  PROFILE_BACKWARD("model", model, grad);
+  return {batch_loss, batch_accuracy};
+}
+
+void Trainer::queue_gradients(const std::vector<Tensor *> &grads) {
+  if (queued_buckets == gradient_buckets.size())
+    gradient_buckets.emplace_back();
+  GradientBucket &bucket = gradient_buckets[queued_buckets++];
+  bucket.grads = grads;
+  ModelUtils::pack_tensors(bucket.grads, bucket.data);
+  communicator->all_reduce_async(bucket.data.data(), bucket.data.size());
+}
+
+void Trainer::finish_gradient_sync() {
+  PROFILE_SCOPE("gradient_allreduce", "step");
+  const auto start = std::chrono::steady_clock::now();
+  communicator->wait();
+  const std::chrono::duration<double> waited = std::chrono::steady_clock::now() - start;
+  exposed_communication += waited.count();
+
+  const float scale = 1.0f / static_cast<float>(communicator->world_size());
+  for (size_t b = 0; b < queued_buckets; ++b)
+    ModelUtils::unpack_tensors(gradient_buckets[b].data, gradient_buckets[b].grads, scale);
+  queued_buckets = 0;
+}
+
+void Trainer::broadcast_parameters() {
+  communicator->broadcast(parameters.parameterData(), parameters.size() * sizeof(float), 0);
+}
+
+// Un paso de paralelismo de datos. La replica r procesa las filas [B*r/R, B*(r+1)/R) del
+// batch. El gradiente de la perdida media del batch es la suma de los de cada parte
+// ponderados por su fraccion de filas, asi que cada replica escala el gradiente de sus
+// logits antes del backward y el arbol solo tiene que sumar. Las replicas 1..R-1 parten de
+// gradientes a cero; la 0 (el modelo) acumula sobre los que ya tenga.
+std::pair<float, float> Trainer::data_parallel_step(const Tensor &X_batch, const Tensor &y_batch, float grad_scale) {
+  const size_t rows = X_batch.getShape()[0];
+  const size_t active = std::min(replicas.size() + 1, rows);
+  std::vector<float> losses(active, 0.0f);
+  std::vector<float> accuracies(active, 0.0f);
+  std::exception_ptr error;
+
+  {
+    PROFILE_SCOPE("replicas", "step");
+    // Un hilo por replica; dentro de la region las operaciones de cada replica van en serie.
+#pragma omp parallel for num_threads(active) schedule(static, 1)
+    for (size_t r = 0; r < active; ++r) {
+      try {
+        VisionTransformer &replica = r == 0 ? model : *replicas[r - 1];
+        CrossEntropy &loss = replica_losses[r];
+        const size_t begin = rows * r / active;
+        const size_t count = rows * (r + 1) / active - begin;
+        const float weight = static_cast<float>(count) / rows;
+        const Tensor X_part = X_batch.slice(0, begin, count);
+        const Tensor y_part = y_batch.slice(0, begin, count);
+
+        Tensor logits = replica.forward(X_part, true);
+        losses[r] = weight * loss.calculate(logits, y_part);
+        accuracies[r] = weight * calculate_accuracy(logits, y_part);
+
+        Tensor grad = loss.backward(logits, y_part);
+        scale_gradient(grad, weight * grad_scale);
+        if (r > 0)
+          replica.zeroGradients();
+        replica.backward(grad);
+      } catch (...) {
+#pragma omp critical(data_parallel_error)
+        if (!error)
+          error = std::current_exception();
+      }
+    }
+  }
+  if (error)
+    std::rethrow_exception(error);
+
+  {
+    PROFILE_SCOPE("gradient_reduce", "step");
+    std::vector<std::vector<Tensor *>> grads;
+    grads.push_back(model.getGradients());
+    for (size_t r = 1; r < active; ++r)
+      grads.push_back(replicas[r - 1]->getGradients());
+    tree_reduce(grads);
+  }
+
+  // Perdida y precision del batch completo, sumadas en orden fijo.
+  return {std::accumulate(losses.begin(), losses.end(), 0.0f), std::accumulate(accuracies.begin(), accuracies.end(), 0.0f)};
+}
+
 // Evalua el rendimiento del modelo, calculando perdida y precision.
-std::pair<float, float> Trainer::evaluate(const Tensor &X_test, const Tensor &y_test) {
-  size_t num_test_samples = X_test.getShape()[0];
+std::pair<float, float> Trainer::evaluate(const Dataset &test_data) {
+  // Con varios procesos cada uno evalua un tramo consecutivo del conjunto de test.
+  const size_t world = communicator ? communicator->world_size() : 1;
+  const size_t rank = communicator ? communicator->rank() : 0;
+  const size_t first_sample = test_data.size() * rank / world;
+  size_t num_test_samples = test_data.size() * (rank + 1) / world - first_sample;
   size_t num_batches = (num_test_samples + config.batch_size - 1) / config.batch_size;
 
   float total_loss = 0.0f;
   float total_accuracy = 0.0f;
 
-  for (size_t i = 0; i < num_batches; ++i) {
-    size_t start = i * config.batch_size;
-    size_t count = std::min(config.batch_size, num_test_samples - start);
-    if (count == 0)
-      continue;
+  // Orden secuencial: con TensorDataset los batches son vistas, sin copia.
+  std::vector<size_t> indices(num_test_samples);
+  std::iota(indices.begin(), indices.end(), first_sample);
+  DataLoader loader(test_data, std::move(indices), config.batch_size, config.prefetch_batches);
+  std::pair<Tensor, Tensor> batch;
 
-    Tensor X_batch = X_test.slice(0, start, count);
-    Tensor y_batch = y_test.slice(0, start, count);
+  while (loader.next(batch)) {
+    PROFILE_SCOPE("eval_step", "step");
+    const auto &[X_batch, y_batch] = batch;
 
     // Forward pass en modo inferencia (isTraining = false).
-    Tensor logits = model.forward(X_batch, false);
+    Tensor logits = PROFILE_FORWARD("model", model, X_batch, false);
 
     // Calcular perdida y precision para el batch.
     total_loss += loss_fn.calculate(logits, y_batch);
     total_accuracy += calculate_accuracy(logits, y_batch);
   }
 
+  if (communicator) {
+    float totals[3] = {total_loss, total_accuracy, static_cast<float>(num_batches)};
+    communicator->all_reduce(totals, 3);
+    return {totals[0] / totals[2], totals[1] / totals[2]};
+  }
   return {total_loss / num_batches, total_accuracy / num_batches};
 }
@@ -1,11 +1,28 @@
 #include "model/TransformerEncoderBlock.hpp"
+#include "utils/Profiler.hpp"
 
 // Constructor que inicializa todas las sub-capas del bloque.
-TransformerEncoderBlock::TransformerEncoderBlock(size_t embedding_dim, size_t num_heads, size_t mlp_hidden_dim)
-    : norm1(embedding_dim), attention(embedding_dim, num_heads), norm2(embedding_dim), ffn(embedding_dim, mlp_hidden_dim) {}
+TransformerEncoderBlock::TransformerEncoderBlock(size_t embedding_dim, size_t num_heads, size_t mlp_hidden_dim,
+                                                 bool use_flash_attention, bool fuse_qkv,
+                                                 bool checkpoint_activations)
+    : norm1(embedding_dim), attention(embedding_dim, num_heads, use_flash_attention, fuse_qkv), norm2(embedding_dim),
+      ffn(embedding_dim, mlp_hidden_dim), checkpoint_activations(checkpoint_activations) {}
 
-// Define el flujo de datos forward del bloque, incluyendo las conexiones residuales.
 Tensor TransformerEncoderBlock::forward(const Tensor &input, bool isTraining) {
+  this->pending_recompute = isTraining && this->checkpoint_activations && this->int8_mode == Int8Mode::Off;
+  if (!this->pending_recompute) {
+    return forwardSublayers(input, isTraining);
+  }
+
+  // Checkpointing: las sub-capas corren como en inferencia (no guardan nada) y solo se
+  // conserva la entrada. Lo que quedara del paso anterior se suelta ya.
+  releaseActivations();
+  this->input_skip1 = input;
+  return forwardSublayers(input, false);
+}
+
+// Define el flujo de datos forward del bloque, incluyendo las conexiones residuales.
+Tensor TransformerEncoderBlock::forwardSublayers(const Tensor &input, bool isTraining) {
   if (isTraining) {
     // Guarda la entrada para la primera conexion residual en backward.
     this->input_skip1 = input;
@@ -13,8 +30,8 @@ Tensor TransformerEncoderBlock::forward(const Tensor &input, bool isTraining) {
 
   // Sub-capa 1: Multi-Head Attention (Pre-LN).
   // output = input + Attention(LayerNorm(input))
-  Tensor x = norm1.forward(input, isTraining);
-  x = attention.forward(x, isTraining);
+  Tensor x = PROFILE_FORWARD("norm1", norm1, input, isTraining);
+  x = PROFILE_FORWARD("attention", attention, x, isTraining);
   Tensor residual1 = input + x;
 
   if (isTraining) {
@@ -24,13 +41,22 @@ Tensor TransformerEncoderBlock::forward(const Tensor &input, bool isTraining) {
 
   // Sub-capa 2: Feed-Forward Network (Pre-LN).
   // output = residual1 + FFN(LayerNorm(residual1))
-  Tensor y = norm2.forward(residual1, isTraining);
-  y = ffn.forward(y, isTraining);
+  Tensor y = PROFILE_FORWARD("norm2", norm2, residual1, isTraining);
+  y = PROFILE_FORWARD("ffn", ffn, y, isTraining);
   return residual1 + y;
 }
 
 // Define el flujo de gradientes hacia atras, manejando las conexiones residuales.
 Tensor TransformerEncoderBlock::backward(const Tensor &outputGradient) {
+  // Con checkpointing se repite el forward (mismo resultado, ahora guardando) justo antes
+  // de necesitarlo; al terminar se suelta otra vez.
+  const bool recomputed = this->pending_recompute;
+  if (recomputed) {
+    const Tensor input = this->input_skip1;
+    forwardSublayers(input, true);
+    this->pending_recompute = false;
+  }
+
   // Para una conexion residual Y = X + F(X), el gradiente de X es dL/dY + dL/d(F(X)).
   // El gradiente de la salida (dL/dY) se propaga por ambas ramas.
 
@@ -38,8 +64,8 @@ Tensor TransformerEncoderBlock::backward(const Tensor &outputGradient) {
   Tensor grad_skip2 = outputGradient;
   Tensor grad_ffn = outputGradient; // El mismo gradiente entra en la rama FFN.
 
-  grad_ffn = ffn.backward(grad_ffn);
-  grad_ffn = norm2.backward(grad_ffn);
+  grad_ffn = PROFILE_BACKWARD("ffn", ffn, grad_ffn);
+  grad_ffn = PROFILE_BACKWARD("norm2", norm2, grad_ffn);
 
   // Suma de los gradientes de la rama skip y la rama FFN.
   Tensor grad_residual1 = grad_skip2 + grad_ffn;
@@ -48,11 +74,15 @@ Tensor TransformerEncoderBlock::backward(const Tensor &outputGradient) {
   Tensor grad_skip1 = grad_residual1;
   Tensor grad_mha = grad_residual1; // El mismo gradiente entra en la rama de atencion.
 
-  grad_mha = attention.backward(grad_mha);
-  grad_mha = norm1.backward(grad_mha);
+  grad_mha = PROFILE_BACKWARD("attention", attention, grad_mha);
+  grad_mha = PROFILE_BACKWARD("norm1", norm1, grad_mha);
 
   // Suma de los gradientes para obtener el gradiente final de la entrada.
-  return grad_skip1 + grad_mha;
+  Tensor grad_input = grad_skip1 + grad_mha;
+  if (recomputed) {
+    releaseActivations();
+  }
+  return grad_input;
 }
 
 // Recolecta los parametros de todas las sub-capas.
@@ -82,3 +112,24 @@ std::vector<Tensor *> TransformerEncoderBlock::getGradients() {
   grads.insert(grads.end(), g4.begin(), g4.end());
   return grads;
 }
+
+// Las LayerNorm no tienen proyecciones lineales: siguen en float.
+void TransformerEncoderBlock::setInt8Mode(Int8Mode mode) {
+  this->int8_mode = mode;
+  attention.setInt8Mode(mode);
+  ffn.setInt8Mode(mode);
+}
+
+void TransformerEncoderBlock::releaseActivations() {
+  this->input_skip1 = Tensor();
+  this->input_skip2 = Tensor();
+  norm1.releaseActivations();
+  attention.releaseActivations();
+  norm2.releaseActivations();
+  ffn.releaseActivations();
+}
+
+double TransformerEncoderBlock::getFlops(const std::vector<size_t> &inputShape) const {
+  return norm1.getFlops(inputShape) + attention.getFlops(inputShape) + norm2.getFlops(inputShape) +
+         ffn.getFlops(inputShape) + 2.0 * countElements(inputShape);
+}
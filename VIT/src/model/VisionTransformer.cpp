@@ -1,4 +1,6 @@
 #include "model/VisionTransformer.hpp"
+#include "utils/Profiler.hpp"
+#include <stdexcept>
 
 // Constructor que inicializa todas las capas del modelo.
 VisionTransformer::VisionTransformer(const ViTConfig &config)
@@ -8,45 +10,88 @@ VisionTransformer::VisionTransformer(const ViTConfig &config)
 
   // Crea la pila de bloques codificadores.
   for (size_t i = 0; i < config.num_layers; ++i) {
-    encoder_blocks.emplace_back(config.embedding_dim, config.num_heads, config.mlp_hidden_dim);
+    encoder_blocks.emplace_back(config.embedding_dim, config.num_heads, config.mlp_hidden_dim, config.use_flash_attention,
+                                config.fuse_qkv, config.checkpoint_activations);
   }
 }
 
 // Encadena el forward pass de todo el modelo.
-Tensor VisionTransformer::forward(const Tensor &input, bool isTraining) {
-  // 1. Capa de Embeddings (parcheo, CLS token, pos. encoding).
-  Tensor x = embeddings.forward(input, isTraining);
+Tensor VisionTransformer::forward(const Tensor &input, bool isTraining) { return forwardParts(input, 0, numParts(), isTraining); }
 
-  // 2. Pila de bloques codificadores del Transformer.
-  for (auto &block : encoder_blocks) {
-    x = block.forward(x, isTraining);
+// Encadena el backward pass de todo el modelo en orden inverso.
+Tensor VisionTransformer::backward(const Tensor &outputGradient) { return backwardParts(outputGradient, 0, numParts()); }
+
+// Forward de las partes [begin, end): la entrada es la salida de la parte begin - 1.
+Tensor VisionTransformer::forwardParts(const Tensor &input, size_t begin, size_t end, bool isTraining) {
+  checkPartRange(begin, end);
+  Tensor x = input;
+  for (size_t part = begin; part < end; ++part) {
+    if (part == 0) {
+      // Capa de Embeddings (parcheo, CLS token, pos. encoding).
+      x = PROFILE_FORWARD("embeddings", embeddings, x, isTraining);
+    } else if (part <= encoder_blocks.size()) {
+      // Bloque codificador del Transformer.
+      x = PROFILE_FORWARD("encoder[" + std::to_string(part - 1) + "]", encoder_blocks[part - 1], x, isTraining);
+    } else {
+      // Cabeza de clasificacion.
+      x = forwardHead(x, isTraining);
+    }
+  }
+  return x;
+}
+
+// Backward de las partes [begin, end) en orden inverso.
+Tensor VisionTransformer::backwardParts(const Tensor &outputGradient, size_t begin, size_t end) {
+  checkPartRange(begin, end);
+  Tensor grad = outputGradient;
+  for (size_t part = end; part-- > begin;) {
+    if (part > encoder_blocks.size()) {
+      grad = backwardHead(grad);
+    } else if (part > 0) {
+      // Bloque codificador.
+      grad = PROFILE_BACKWARD("encoder[" + std::to_string(part - 1) + "]", encoder_blocks[part - 1], grad);
+      if (gradient_hook)
+        gradient_hook(encoder_blocks[part - 1].getGradients());
+    } else {
+      // Capa de embeddings.
+      grad = PROFILE_BACKWARD("embeddings", embeddings, grad);
+      if (gradient_hook)
+        gradient_hook(embeddings.getGradients());
+    }
   }
 
-  // 3. Normalizacion final.
-  x = final_norm.forward(x, isTraining);
+  // Con begin = 0 es el gradiente respecto a la imagen, aunque no suele usarse.
+  return grad;
+}
+
+// Normalizacion final y clasificacion a partir del token CLS.
+Tensor VisionTransformer::forwardHead(const Tensor &sequence, bool isTraining) {
+  // 1. Normalizacion final.
+  Tensor x = PROFILE_FORWARD("final_norm", final_norm, sequence, isTraining);
 
   if (isTraining) {
     // Guarda la salida normalizada para el backward pass.
     this->final_norm_output = x;
   }
 
-  // 4. Extrae solo el token CLS (en la posicion 0) para la clasificacion.
-  Tensor cls_token = x.slice(1, 0, 1).contiguous().reshape({input.getShape()[0], config.embedding_dim});
+  // 2. Extrae solo el token CLS (en la posicion 0) para la clasificacion.
+  Tensor cls_token = x.slice(1, 0, 1).contiguous().reshape({sequence.getShape()[0], config.embedding_dim});
 
-  // 5. Cabeza de clasificacion (MLP).
-  return mlp_head.forward(cls_token, isTraining);
+  // 3. Cabeza de clasificacion (MLP).
+  return PROFILE_FORWARD("mlp_head", mlp_head, cls_token, isTraining);
 }
 
-// Encadena el backward pass de todo el modelo en orden inverso.
-Tensor VisionTransformer::backward(const Tensor &outputGradient) {
+Tensor VisionTransformer::backwardHead(const Tensor &outputGradient) {
   // 1. Propaga hacia atras a traves de la cabeza de clasificacion.
-  Tensor grad = mlp_head.backward(outputGradient);
+  Tensor grad = PROFILE_BACKWARD("mlp_head", mlp_head, outputGradient);
+  if (gradient_hook)
+    gradient_hook(mlp_head.getGradients());
   size_t batchSize = outputGradient.getShape()[0];
 
   // 2. El gradiente esta solo para el token CLS. Hay que "re-inyectarlo"
   // en una secuencia completa de gradientes (con ceros para los otros tokens).
   size_t num_tokens = 1 + (config.image_size / config.patch_size) * (config.image_size / config.patch_size);
-  Tensor grad_seq({batchSize, num_tokens, config.embedding_dim});
+  Tensor grad_seq = Tensor::uninitialized({batchSize, num_tokens, config.embedding_dim});
   grad_seq.fill(0.0f);
 
   // Copia el gradiente del CLS a la posicion 0 de la secuencia.
@@ -61,54 +106,75 @@ Tensor VisionTransformer::backward(const Tensor &outputGradient) {
   }
 
   // 3. Propaga a traves de la normalizacion final.
-  grad = final_norm.backward(grad_seq);
-
-  // 4. Propaga a traves de los bloques codificadores en orden inverso.
-  for (int i = encoder_blocks.size() - 1; i >= 0; --i) {
-    grad = encoder_blocks[i].backward(grad);
-  }
-
-  // 5. Propaga a traves de la capa de embeddings.
-  grad = embeddings.backward(grad);
-
-  // Devuelve el gradiente final (con respecto a la imagen), aunque no suele usarse.
+  grad = PROFILE_BACKWARD("final_norm", final_norm, grad_seq);
+  if (gradient_hook)
+    gradient_hook(final_norm.getGradients());
   return grad;
 }
 
-// Recolecta los parametros de todas las capas del modelo.
-std::vector<Tensor *> VisionTransformer::getParameters() {
-  std::vector<Tensor *> params;
-  auto emb_params = embeddings.getParameters();
-  params.insert(params.end(), emb_params.begin(), emb_params.end());
+void VisionTransformer::checkPartRange(size_t begin, size_t end) const {
+  if (begin > end || end > numParts())
+    throw std::out_of_range("VisionTransformer: rango de partes [" + std::to_string(begin) + ", " + std::to_string(end) +
+                            ") fuera de [0, " + std::to_string(numParts()) + ").");
+}
 
-  for (auto &block : encoder_blocks) {
-    auto block_params = block.getParameters();
-    params.insert(params.end(), block_params.begin(), block_params.end());
+// Capas de las partes [begin, end) en el orden de getParameters.
+std::vector<Layer *> VisionTransformer::partLayers(size_t begin, size_t end) {
+  checkPartRange(begin, end);
+  std::vector<Layer *> layers;
+  for (size_t part = begin; part < end; ++part) {
+    if (part == 0) {
+      layers.push_back(&embeddings);
+    } else if (part <= encoder_blocks.size()) {
+      layers.push_back(&encoder_blocks[part - 1]);
+    } else {
+      layers.push_back(&final_norm);
+      layers.push_back(&mlp_head);
+    }
   }
+  return layers;
+}
 
-  auto norm_params = final_norm.getParameters();
-  params.insert(params.end(), norm_params.begin(), norm_params.end());
-
-  auto head_params = mlp_head.getParameters();
-  params.insert(params.end(), head_params.begin(), head_params.end());
+std::vector<Tensor *> VisionTransformer::getPartParameters(size_t begin, size_t end) {
+  std::vector<Tensor *> params;
+  for (Layer *layer : partLayers(begin, end)) {
+    auto layer_params = layer->getParameters();
+    params.insert(params.end(), layer_params.begin(), layer_params.end());
+  }
   return params;
 }
 
-// Recolecta los gradientes de todas las capas del modelo.
-std::vector<Tensor *> VisionTransformer::getGradients() {
+std::vector<Tensor *> VisionTransformer::getPartGradients(size_t begin, size_t end) {
   std::vector<Tensor *> grads;
-  auto emb_grads = embeddings.getGradients();
-  grads.insert(grads.end(), emb_grads.begin(), emb_grads.end());
-
-  for (auto &block : encoder_blocks) {
-    auto block_grads = block.getGradients();
-    grads.insert(grads.end(), block_grads.begin(), block_grads.end());
+  for (Layer *layer : partLayers(begin, end)) {
+    auto layer_grads = layer->getGradients();
+    grads.insert(grads.end(), layer_grads.begin(), layer_grads.end());
   }
+  return grads;
+}
 
-  auto norm_grads = final_norm.getGradients();
-  grads.insert(grads.end(), norm_grads.begin(), norm_grads.end());
+// Recolecta los parametros de todas las capas del modelo.
+std::vector<Tensor *> VisionTransformer::getParameters() { return getPartParameters(0, numParts()); }
 
-  auto head_grads = mlp_head.getGradients();
-  grads.insert(grads.end(), head_grads.begin(), head_grads.end());
-  return grads;
+// Recolecta los gradientes de todas las capas del modelo.
+std::vector<Tensor *> VisionTransformer::getGradients() { return getPartGradients(0, numParts()); }
+
+// Cambia el modo int8 de los embeddings, los bloques y la cabeza de clasificacion.
+void VisionTransformer::setInt8Mode(Int8Mode mode) {
+  embeddings.setInt8Mode(mode);
+  for (auto &block : encoder_blocks)
+    block.setInt8Mode(mode);
+  mlp_head.setInt8Mode(mode);
+}
+
+double VisionTransformer::getFlops(const std::vector<size_t> &inputShape) const {
+  const size_t batchSize = inputShape[0];
+  const size_t num_tokens = 1 + (config.image_size / config.patch_size) * (config.image_size / config.patch_size);
+  const std::vector<size_t> sequenceShape = {batchSize, num_tokens, config.embedding_dim};
+
+  double flops = embeddings.getFlops(inputShape);
+  for (const auto &block : encoder_blocks)
+    flops += block.getFlops(sequenceShape);
+  flops += final_norm.getFlops(sequenceShape);
+  return flops + mlp_head.getFlops({batchSize, config.embedding_dim});
 }
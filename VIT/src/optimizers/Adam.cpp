@@ -1,4 +1,5 @@
 #include "optimizers/Adam.hpp"
+#include "core/Kernels.hpp"
 #include <cmath>
 #include <stdexcept>
 
@@ -41,6 +42,37 @@ void Adam::update(std::vector<Tensor *> &parameters, const std::vector<Tensor *>
 
     const auto &shape = param->getShape();
 
+    // Camino rapido: parametro y gradiente contiguos (el caso habitual), se actualiza
+    // todo el bloque con el kernel vectorizado, repartido entre hilos.
+    if (param->isContiguous() && grad_tensor->isContiguous() && grad_tensor->getSize() == param->getSize()) {
+      const AdamStep step{learningRate, beta1, beta2, epsilon, weight_decay, 1.0f - beta1_t, 1.0f - beta2_t};
+      float *p_data = param->getData() + param->getDataOffset();
+      const float *g_data = grad_tensor->getData() + grad_tensor->getDataOffset();
+      float *m_data = m_i.getData();
+      float *v_data = v_i.getData();
+      const auto adam = kernels().adamUpdate;
+      parallelChunks(param->getSize(), [&](size_t begin, size_t count) {
+        adam(p_data + begin, g_data + begin, m_data + begin, v_data + begin, count, step);
+      });
+      continue;
+    }
+
+    // Vistas 2D con filas contiguas (p. ej. los bloques de QKVProjection): el mismo
+    // kernel fila a fila. Los momentos m y v son tensores propios y contiguos.
+    if (shape.size() == 2 && param->getStrides()[1] == 1 && grad_tensor->getShape() == shape &&
+        grad_tensor->getStrides()[1] == 1) {
+      const AdamStep step{learningRate, beta1, beta2, epsilon, weight_decay, 1.0f - beta1_t, 1.0f - beta2_t};
+      const size_t cols = shape[1];
+      const auto adam = kernels().adamUpdate;
+#pragma omp parallel for
+      for (size_t r = 0; r < shape[0]; ++r) {
+        float *p_row = param->getData() + param->getDataOffset() + r * param->getStrides()[0];
+        const float *g_row = grad_tensor->getData() + grad_tensor->getDataOffset() + r * grad_tensor->getStrides()[0];
+        adam(p_row, g_row, m_i.getData() + r * cols, v_i.getData() + r * cols, cols, step);
+      }
+      continue;
+    }
+
     // Actualizacion de parametros, con bucles especializados por dimensionalidad.
     if (shape.size() == 1 || shape.size() == 2 || shape.size() == 3) {
       if (shape.size() == 1) { // Para Bias, LayerNorm
@@ -95,3 +127,27 @@ void Adam::update(std::vector<Tensor *> &parameters, const std::vector<Tensor *>
     }
   }
 }
+
+void Adam::update(ParameterRegistry &registry) {
+  const size_t n = registry.size();
+  if (flat_m.getSize() != n) {
+    flat_m = Tensor({n});
+    flat_v = Tensor({n});
+  }
+
+  t++;
+  const float beta1_t = std::pow(beta1, t);
+  const float beta2_t = std::pow(beta2, t);
+  const AdamStep step{learningRate, beta1, beta2, epsilon, weight_decay, 1.0f - beta1_t, 1.0f - beta2_t};
+
+  // Una sola pasada por bloques de todo el buffer: los tramos de relleno tienen parametro,
+  // gradiente y momentos a cero y siguen a cero tras el paso.
+  float *p_data = registry.parameterData();
+  const float *g_data = registry.gradientData();
+  float *m_data = flat_m.getData();
+  float *v_data = flat_v.getData();
+  const auto adam = kernels().adamUpdate;
+  parallelChunks(n, [&](size_t begin, size_t count) {
+    adam(p_data + begin, g_data + begin, m_data + begin, v_data + begin, count, step);
+  });
+}
@@ -0,0 +1,211 @@
+#include "utils/CsvParser.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <ctime>
+#include <random>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// --- Funciones Auxiliares (privadas a este archivo) ---
+namespace {
+// Archivo proyectado en memoria de solo lectura (se libera al destruirse).
+class MappedFile {
+public:
+  explicit MappedFile(const std::string &path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw std::runtime_error("Error: No se pudo abrir el archivo: " + path);
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+      ::close(fd);
+      throw std::runtime_error("Error: No se pudo leer el tamano de: " + path);
+    }
+    size = static_cast<size_t>(info.st_size);
+    if (size > 0) {
+      void *mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (mapping == MAP_FAILED) {
+        ::close(fd);
+        throw std::runtime_error("Error: No se pudo proyectar en memoria: " + path);
+      }
+      ::madvise(mapping, size, MADV_SEQUENTIAL);
+      data = static_cast<const char *>(mapping);
+    }
+    ::close(fd);
+  }
+  ~MappedFile() {
+    if (data)
+      ::munmap(const_cast<char *>(data), size);
+  }
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  const char *data = nullptr;
+  size_t size = 0;
+};
+
+// Rango de lineas completas que procesa un hilo.
+struct Chunk {
+  const char *begin;
+  const char *end;
+  size_t first_row = 0;  // Indice global de su primera fila.
+  size_t row_count = 0;
+  size_t first_slot = 0; // Posicion en la salida de su primera fila seleccionada.
+  size_t kept_count = 0;
+};
+
+// Llama a visit(lineBegin, lineEnd) por cada linea del bloque (sin el '\n').
+template <typename Visitor> void for_each_line(const char *p, const char *end, Visitor visit) {
+  while (p < end) {
+    const char *newline = static_cast<const char *>(std::memchr(p, '\n', end - p));
+    const char *line_end = newline ? newline : end;
+    visit(p, line_end);
+    p = line_end + 1;
+  }
+}
+
+// Parsea "etiqueta,p0,...,pN-1" escribiendo los pixeles en out. Devuelve false si la fila
+// no tiene exactamente N pixeles enteros en [0, 255] o la etiqueta no es valida.
+bool parse_row(const char *p, const char *end, size_t num_pixels, int num_classes, int32_t &label, uint8_t *out) {
+  if (end > p && end[-1] == '\r')
+    --end;
+  int value = 0;
+  auto [ptr, ec] = std::from_chars(p, end, value);
+  if (ec != std::errc() || value < 0 || value >= num_classes)
+    return false;
+  label = value;
+  p = ptr;
+  for (size_t i = 0; i < num_pixels; ++i) {
+    if (p == end || *p != ',')
+      return false;
+    auto [next, err] = std::from_chars(p + 1, end, value);
+    if (err != std::errc() || value < 0 || value > 255)
+      return false;
+    out[i] = static_cast<uint8_t>(value);
+    p = next;
+  }
+  return p == end;
+}
+
+// Marca en keep las filas a guardar. Con random_sample usa el algoritmo de Floyd, que elige
+// un subconjunto uniforme de k filas en O(k) pasos sin barajar un vector de indices.
+std::vector<uint8_t> select_rows(size_t total_rows, float sample_fraction, bool random_sample) {
+  size_t samples_to_load = static_cast<size_t>(total_rows * static_cast<double>(sample_fraction));
+  if (samples_to_load == 0 && total_rows > 0 && sample_fraction > 0.0f)
+    samples_to_load = 1;
+  samples_to_load = std::min(samples_to_load, total_rows);
+
+  std::vector<uint8_t> keep(total_rows, 0);
+  if (samples_to_load == total_rows || !random_sample) {
+    std::fill(keep.begin(), keep.begin() + samples_to_load, 1);
+    return keep;
+  }
+  std::mt19937_64 rng(static_cast<unsigned long long>(std::time(nullptr)));
+  for (size_t j = total_rows - samples_to_load; j < total_rows; ++j) {
+    const size_t t = std::uniform_int_distribution<size_t>(0, j)(rng);
+    keep[keep[t] ? j : t] = 1;
+  }
+  return keep;
+}
+} // namespace
+
+// --- Implementacion de la Funcion Principal ---
+
+MnistCsv parse_mnist_csv(const std::string &filePath, float sample_fraction, bool random_sample,
+                         size_t pixels_per_sample, int num_classes) {
+  MappedFile file(filePath);
+  MnistCsv result;
+  result.pixels_per_sample = pixels_per_sample;
+
+  // 1. Saltar la cabecera y dividir el resto en bloques que terminan en fin de linea.
+  const char *file_end = file.data + file.size;
+  const char *header_end = file.data ? static_cast<const char *>(std::memchr(file.data, '\n', file.size)) : nullptr;
+  const char *body = header_end ? header_end + 1 : file_end;
+  const size_t body_size = static_cast<size_t>(file_end - body);
+
+  size_t num_threads = 1;
+#ifdef _OPENMP
+  num_threads = static_cast<size_t>(omp_get_max_threads());
+#endif
+  // Varios bloques por hilo para repartir mejor la carga; no menos de 64 KB por bloque.
+  const size_t num_chunks = std::max<size_t>(1, std::min(num_threads * 4, body_size / (64 * 1024)));
+  std::vector<Chunk> chunks(num_chunks);
+  const char *chunk_begin = body;
+  for (size_t c = 0; c < num_chunks; ++c) {
+    const char *chunk_end = file_end;
+    if (c + 1 < num_chunks) {
+      chunk_end = std::max(chunk_begin, body + body_size * (c + 1) / num_chunks);
+      const char *newline = static_cast<const char *>(std::memchr(chunk_end, '\n', file_end - chunk_end));
+      chunk_end = newline ? newline + 1 : file_end;
+    }
+    chunks[c].begin = chunk_begin;
+    chunks[c].end = chunk_end;
+    chunk_begin = chunk_end;
+  }
+
+  // 2. Contar las filas de cada bloque (solo se buscan los '\n').
+#pragma omp parallel for schedule(dynamic)
+  for (size_t c = 0; c < num_chunks; ++c) {
+    size_t rows = 0;
+    for_each_line(chunks[c].begin, chunks[c].end, [&](const char *, const char *) { ++rows; });
+    chunks[c].row_count = rows;
+  }
+  size_t total_rows = 0;
+  for (auto &chunk : chunks) {
+    chunk.first_row = total_rows;
+    total_rows += chunk.row_count;
+  }
+
+  // 3. Elegir las filas a guardar y reservar los buffers de salida una sola vez.
+  const std::vector<uint8_t> keep = select_rows(total_rows, sample_fraction, random_sample);
+  size_t total_kept = 0;
+  for (auto &chunk : chunks) {
+    chunk.kept_count = std::count(keep.begin() + chunk.first_row, keep.begin() + chunk.first_row + chunk.row_count, 1);
+    chunk.first_slot = total_kept;
+    total_kept += chunk.kept_count;
+  }
+  result.labels.resize(total_kept);
+  result.pixels.resize(total_kept * pixels_per_sample);
+  std::vector<uint8_t> valid(total_kept, 0);
+
+  // 4. Parsear solo las filas seleccionadas, cada una directamente en su posicion final.
+#pragma omp parallel for schedule(dynamic)
+  for (size_t c = 0; c < num_chunks; ++c) {
+    size_t row = chunks[c].first_row;
+    size_t slot = chunks[c].first_slot;
+    for_each_line(chunks[c].begin, chunks[c].end, [&](const char *line, const char *line_end) {
+      if (keep[row++]) {
+        valid[slot] = parse_row(line, line_end, pixels_per_sample, num_classes, result.labels[slot],
+                                result.pixels.data() + slot * pixels_per_sample);
+        ++slot;
+      }
+    });
+  }
+
+  // 5. Compactar si alguna fila resulto invalida.
+  size_t num_valid = 0;
+  for (size_t i = 0; i < total_kept; ++i) {
+    if (!valid[i])
+      continue;
+    if (num_valid != i) {
+      result.labels[num_valid] = result.labels[i];
+      std::memcpy(result.pixels.data() + num_valid * pixels_per_sample, result.pixels.data() + i * pixels_per_sample,
+                  pixels_per_sample);
+    }
+    ++num_valid;
+  }
+  result.labels.resize(num_valid);
+  result.pixels.resize(num_valid * pixels_per_sample);
+  result.num_samples = num_valid;
+  result.skipped_rows = total_kept - num_valid;
+  return result;
+}
@@ -0,0 +1,84 @@
+#include "utils/DataLoader.hpp"
+#include <algorithm>
+#include <chrono>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// --- Funciones Auxiliares (privadas a este archivo) ---
+namespace {
+// Espera activa corta y luego a intervalos: la espera del hilo de fondo (cola llena) dura
+// lo que tarda un paso de entrenamiento y no debe quitar CPU a los hilos de calculo.
+void backoff(size_t &attempt) {
+  if (++attempt < 64) {
+    std::this_thread::yield();
+  } else {
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+  }
+}
+} // namespace
+
+DataLoader::DataLoader(const Dataset &dataset, std::vector<size_t> order, size_t batch_size, size_t prefetch)
+    : dataset(dataset), order(std::move(order)), batch_size(std::max<size_t>(1, batch_size)),
+      total_batches((this->order.size() + this->batch_size - 1) / this->batch_size), ring(prefetch) {
+  if (prefetch > 0 && total_batches > 0) {
+    worker = std::thread(&DataLoader::produce, this);
+  }
+}
+
+DataLoader::~DataLoader() {
+  stopping.store(true, std::memory_order_relaxed);
+  if (worker.joinable())
+    worker.join();
+}
+
+std::pair<Tensor, Tensor> DataLoader::make_batch(size_t index) const {
+  const size_t start = index * batch_size;
+  const size_t count = std::min(batch_size, order.size() - start);
+  return dataset.get_batch(order.data() + start, count);
+}
+
+// Hilo de fondo: arma los batches en orden y los encola.
+void DataLoader::produce() {
+#ifdef _OPENMP
+  omp_set_num_threads(1);
+#endif
+  try {
+    for (size_t i = 0; i < total_batches; ++i) {
+      std::pair<Tensor, Tensor> batch = make_batch(i);
+      size_t attempt = 0;
+      while (!ring.try_push(batch)) {
+        if (stopping.load(std::memory_order_relaxed))
+          return;
+        backoff(attempt);
+      }
+    }
+  } catch (...) {
+    error = std::current_exception();
+    failed.store(true, std::memory_order_release);
+  }
+}
+
+bool DataLoader::next(std::pair<Tensor, Tensor> &batch) {
+  if (consumed == total_batches)
+    return false;
+  if (!worker.joinable()) {
+    batch = make_batch(consumed++);
+    return true;
+  }
+
+  size_t attempt = 0;
+  while (!ring.try_pop(batch)) {
+    // Tras ver el error se reintenta una vez: el ultimo batch encolado antes del fallo
+    // pudo llegar entre el try_pop anterior y esta lectura.
+    if (failed.load(std::memory_order_acquire)) {
+      if (ring.try_pop(batch))
+        break;
+      std::rethrow_exception(error);
+    }
+    backoff(attempt);
+  }
+  ++consumed;
+  return true;
+}
@@ -0,0 +1,241 @@
+#include "utils/Dataset.hpp"
+#include "utils/CsvParser.hpp"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// --- Formato binario (privado a este archivo) ---
+namespace {
+constexpr char kMagic[8] = {'F', 'M', 'N', 'I', 'S', 'T', 'U', '8'};
+constexpr uint32_t kVersion = 1;
+constexpr size_t kHeaderSize = 64;
+constexpr size_t kPixelAlignment = 64;
+constexpr size_t kImageSide = 28;
+constexpr uint32_t kNumClasses = 10;
+
+struct BinaryHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t num_classes;
+  uint64_t num_samples;
+  uint32_t rows;
+  uint32_t cols;
+  uint64_t labels_offset;
+  uint64_t pixels_offset;
+};
+static_assert(sizeof(BinaryHeader) <= kHeaderSize, "La cabecera debe caber en 64 bytes");
+
+size_t align_up(size_t value, size_t alignment) { return (value + alignment - 1) / alignment * alignment; }
+
+// Ruta del binario asociado a un CSV: "data/x.csv" -> "data/x.u8.bin".
+std::string binary_path_for(const std::string &csvPath) {
+  std::filesystem::path path(csvPath);
+  path.replace_extension(".u8.bin");
+  return path.string();
+}
+} // namespace
+
+// --- TensorDataset ---
+
+TensorDataset::TensorDataset(const Tensor &images, const Tensor &labels)
+    : images(images.isContiguous() ? images : images.contiguous()),
+      labels(labels.isContiguous() ? labels : labels.contiguous()) {
+  if (this->images.getShape().empty() || this->labels.getShape().size() != 2 ||
+      this->images.getShape()[0] != this->labels.getShape()[0]) {
+    throw std::invalid_argument("TensorDataset: imagenes y etiquetas deben tener el mismo numero de muestras.");
+  }
+}
+
+std::pair<Tensor, Tensor> TensorDataset::get_batch(const size_t *indices, size_t count) const {
+  const size_t num_samples = size();
+  bool consecutive = true;
+  for (size_t j = 0; j < count; ++j) {
+    if (indices[j] >= num_samples)
+      throw std::out_of_range("TensorDataset: indice de muestra fuera de rango.");
+    consecutive = consecutive && indices[j] == indices[0] + j;
+  }
+  if (consecutive && count > 0) {
+    return {images.slice(0, indices[0], count), labels.slice(0, indices[0], count)};
+  }
+
+  std::vector<size_t> x_shape = images.getShape();
+  x_shape[0] = count;
+  Tensor X = Tensor::uninitialized(x_shape);
+  Tensor y = Tensor::uninitialized({count, labels.getShape()[1]});
+
+  const size_t x_row = images.getSize() / num_samples;
+  const size_t y_row = labels.getShape()[1];
+  const float *x_src = images.getData() + images.getDataOffset();
+  const float *y_src = labels.getData() + labels.getDataOffset();
+  float *x_dst = X.getData();
+  float *y_dst = y.getData();
+#pragma omp parallel for
+  for (size_t j = 0; j < count; ++j) {
+    std::memcpy(x_dst + j * x_row, x_src + indices[j] * x_row, x_row * sizeof(float));
+    std::memcpy(y_dst + j * y_row, y_src + indices[j] * y_row, y_row * sizeof(float));
+  }
+  return {std::move(X), std::move(y)};
+}
+
+// --- MappedDataset ---
+
+MappedDataset::MappedDataset(const std::string &binPath) {
+  int fd = ::open(binPath.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Error: No se pudo abrir el archivo: " + binPath);
+  }
+  struct stat info;
+  if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < kHeaderSize) {
+    ::close(fd);
+    throw std::runtime_error("Error: Archivo binario invalido: " + binPath);
+  }
+  mapping_size = static_cast<size_t>(info.st_size);
+  mapping = ::mmap(nullptr, mapping_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd); // La proyeccion sigue valida sin el descriptor.
+  if (mapping == MAP_FAILED) {
+    mapping = nullptr;
+    throw std::runtime_error("Error: No se pudo proyectar en memoria: " + binPath);
+  }
+
+  BinaryHeader header;
+  std::memcpy(&header, mapping, sizeof(header));
+  const size_t pixel_bytes = static_cast<size_t>(header.num_samples) * header.rows * header.cols;
+  const bool valid = std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 && header.version == kVersion &&
+                     header.num_classes > 0 && header.labels_offset >= kHeaderSize &&
+                     header.labels_offset + header.num_samples * sizeof(int32_t) <= header.pixels_offset &&
+                     header.pixels_offset % kPixelAlignment == 0 && header.pixels_offset + pixel_bytes <= mapping_size;
+  if (!valid) {
+    unmap();
+    throw std::runtime_error("Error: Cabecera de dataset binario invalida: " + binPath);
+  }
+
+  num_samples = header.num_samples;
+  rows = header.rows;
+  cols = header.cols;
+  num_classes = header.num_classes;
+  const char *base = static_cast<const char *>(mapping);
+  labels = reinterpret_cast<const int32_t *>(base + header.labels_offset);
+  pixel_data = reinterpret_cast<const uint8_t *>(base + header.pixels_offset);
+}
+
+MappedDataset::~MappedDataset() { unmap(); }
+
+MappedDataset::MappedDataset(MappedDataset &&other) noexcept { *this = std::move(other); }
+
+MappedDataset &MappedDataset::operator=(MappedDataset &&other) noexcept {
+  if (this != &other) {
+    unmap();
+    mapping = other.mapping;
+    mapping_size = other.mapping_size;
+    num_samples = other.num_samples;
+    rows = other.rows;
+    cols = other.cols;
+    num_classes = other.num_classes;
+    labels = other.labels;
+    pixel_data = other.pixel_data;
+    other.mapping = nullptr;
+    other.mapping_size = 0;
+    other.num_samples = 0;
+  }
+  return *this;
+}
+
+void MappedDataset::unmap() {
+  if (mapping) {
+    ::munmap(mapping, mapping_size);
+    mapping = nullptr;
+  }
+}
+
+// Convierte los pixeles de las muestras pedidas a float en [0, 1] y arma el one-hot.
+std::pair<Tensor, Tensor> MappedDataset::get_batch(const size_t *indices, size_t count) const {
+  for (size_t j = 0; j < count; ++j) {
+    if (indices[j] >= num_samples)
+      throw std::out_of_range("MappedDataset: indice de muestra fuera de rango.");
+  }
+
+  const size_t pixels_per_sample = rows * cols;
+  Tensor X = Tensor::uninitialized({count, 1, rows, cols});
+  Tensor y({count, num_classes}); // Se inicializa a ceros.
+  float *x_dst = X.getData();
+  float *y_dst = y.getData();
+#pragma omp parallel for
+  for (size_t j = 0; j < count; ++j) {
+    const uint8_t *src = pixels(indices[j]);
+    float *dst = x_dst + j * pixels_per_sample;
+    for (size_t p = 0; p < pixels_per_sample; ++p) {
+      dst[p] = static_cast<float>(src[p]) / 255.0f;
+    }
+    const int32_t label = labels[indices[j]];
+    if (label >= 0 && static_cast<size_t>(label) < num_classes) {
+      y_dst[j * num_classes + label] = 1.0f;
+    }
+  }
+  return {std::move(X), std::move(y)};
+}
+
+// --- Conversion desde CSV ---
+
+size_t convert_csv_to_binary(const std::string &csvPath, const std::string &binPath) {
+  MnistCsv csv = parse_mnist_csv(csvPath, 1.0f, false, kImageSide * kImageSide, kNumClasses);
+  if (csv.skipped_rows > 0) {
+    std::cerr << "Advertencia: " << csv.skipped_rows << " filas invalidas en " << csvPath << ". Se ignoran." << std::endl;
+  }
+  const std::vector<int32_t> &labels = csv.labels;
+  const std::vector<uint8_t> &pixels = csv.pixels;
+
+  BinaryHeader header{};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.num_classes = kNumClasses;
+  header.num_samples = labels.size();
+  header.rows = kImageSide;
+  header.cols = kImageSide;
+  header.labels_offset = kHeaderSize;
+  header.pixels_offset = align_up(kHeaderSize + labels.size() * sizeof(int32_t), kPixelAlignment);
+
+  // Se escribe en un temporal y se renombra, para no dejar nunca un binario a medias.
+  const std::string tmp_path = binPath + ".tmp";
+  {
+    std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+      throw std::runtime_error("Error: No se pudo crear el archivo: " + tmp_path);
+    }
+    std::vector<char> padding(kHeaderSize, 0);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(padding.data(), kHeaderSize - sizeof(header));
+    out.write(reinterpret_cast<const char *>(labels.data()), labels.size() * sizeof(int32_t));
+    padding.assign(header.pixels_offset - kHeaderSize - labels.size() * sizeof(int32_t), 0);
+    out.write(padding.data(), padding.size());
+    out.write(reinterpret_cast<const char *>(pixels.data()), pixels.size());
+    if (!out) {
+      throw std::runtime_error("Error: Fallo al escribir el archivo: " + tmp_path);
+    }
+  }
+  std::filesystem::rename(tmp_path, binPath);
+  return labels.size();
+}
+
+MappedDataset open_binary_dataset(const std::string &csvPath) {
+  const std::string bin_path = binary_path_for(csvPath);
+  const bool stale = !std::filesystem::exists(bin_path) ||
+                     (std::filesystem::exists(csvPath) &&
+                      std::filesystem::last_write_time(csvPath) > std::filesystem::last_write_time(bin_path));
+  if (stale) {
+    std::cout << "Convirtiendo " << csvPath << " a formato binario: " << bin_path << std::endl;
+    const size_t samples = convert_csv_to_binary(csvPath, bin_path);
+    std::cout << "  -> " << samples << " muestras convertidas." << std::endl;
+  }
+
+  MappedDataset dataset(bin_path);
+  std::cout << "Dataset proyectado: " << bin_path << " (" << dataset.size() << " muestras)" << std::endl;
+  return dataset;
+}
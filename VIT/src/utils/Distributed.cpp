@@ -0,0 +1,537 @@
+#include "utils/Distributed.hpp"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+// --- Funciones Auxiliares (privadas a este archivo) ---
+namespace {
+// Tiempo maximo sin avances al conectar o intercambiar datos con un vecino; pasado este
+// tiempo se supone que el otro proceso ha muerto.
+constexpr std::chrono::seconds PEER_TIMEOUT(120);
+
+// Bytes de la cola circular de cada enlace de memoria compartida.
+constexpr size_t SHM_CAPACITY = size_t(1) << 22;
+// Tamano de cada segmento: la cola mas una pagina para los contadores.
+constexpr size_t SEGMENT_BYTES = SHM_CAPACITY + 4096;
+
+using Clock = std::chrono::steady_clock;
+
+[[noreturn]] void throw_errno(const std::string &what) {
+  throw std::runtime_error("Distribuido: " + what + ": " + std::strerror(errno));
+}
+
+// Espera sin avances: primero cede el procesador y luego duerme a intervalos cortos. Con
+// mas procesos que nucleos el vecino necesita la CPU para producir lo que esperamos.
+void backoff(size_t &attempt, Clock::time_point last_progress, const char *what) {
+  if (++attempt < 64) {
+    std::this_thread::yield();
+    return;
+  }
+  if (Clock::now() - last_progress > PEER_TIMEOUT)
+    throw std::runtime_error(std::string("Distribuido: tiempo de espera agotado ") + what + ".");
+  std::this_thread::sleep_for(std::chrono::microseconds(20));
+}
+
+size_t env_size(const char *name, size_t fallback) {
+  const char *value = std::getenv(name);
+  if (!value || !*value)
+    return fallback;
+  char *end = nullptr;
+  const unsigned long long parsed = std::strtoull(value, &end, 10);
+  if (*end != '\0')
+    throw std::runtime_error(std::string("Distribuido: valor no valido en ") + name + ": " + value);
+  return static_cast<size_t>(parsed);
+}
+
+std::string env_string(const char *name, const std::string &fallback) {
+  const char *value = std::getenv(name);
+  return value && *value ? std::string(value) : fallback;
+}
+
+void set_nonblocking(int fd) {
+  const int flags = fcntl(fd, F_GETFL, 0);
+  if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0)
+    throw_errno("fcntl");
+}
+
+void set_nodelay(int fd) {
+  const int one = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+sockaddr_in make_address(const std::string &address, unsigned port) {
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(static_cast<uint16_t>(port));
+  if (inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1)
+    throw std::runtime_error("Distribuido: direccion IPv4 no valida: " + address);
+  return addr;
+}
+
+// Lectura y escritura bloqueantes de un mensaje corto (el saludo al conectar).
+void write_all(int fd, const void *data, size_t bytes) {
+  const char *p = static_cast<const char *>(data);
+  while (bytes > 0) {
+    const ssize_t n = ::send(fd, p, bytes, MSG_NOSIGNAL);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      throw_errno("send");
+    }
+    p += n;
+    bytes -= static_cast<size_t>(n);
+  }
+}
+
+void read_all(int fd, void *data, size_t bytes) {
+  char *p = static_cast<char *>(data);
+  while (bytes > 0) {
+    const ssize_t n = ::recv(fd, p, bytes, 0);
+    if (n == 0)
+      throw std::runtime_error("Distribuido: el rank anterior cerro la conexion.");
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      throw_errno("recv");
+    }
+    p += n;
+    bytes -= static_cast<size_t>(n);
+  }
+}
+} // namespace
+
+// --- TcpTransport ---
+
+// Cada rank escucha en port + rank, se conecta al siguiente (reintentando hasta que este
+// escuche) y despues acepta la conexion del anterior. La conexion saliente se completa en
+// la cola de listen del vecino, asi que el orden no bloquea el anillo.
+TcpTransport::TcpTransport(size_t rank, size_t world_size, const std::string &address, unsigned port) {
+  const size_t next = (rank + 1) % world_size;
+  const uint32_t own_rank = static_cast<uint32_t>(rank);
+
+  const int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (listen_fd < 0)
+    throw_errno("socket");
+  try {
+    const int one = 1;
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    const sockaddr_in local = make_address(address, port + static_cast<unsigned>(rank));
+    if (bind(listen_fd, reinterpret_cast<const sockaddr *>(&local), sizeof(local)) < 0)
+      throw_errno("bind al puerto " + std::to_string(port + rank));
+    if (listen(listen_fd, 1) < 0)
+      throw_errno("listen");
+
+    // 1. Conexion saliente hacia el siguiente rank.
+    const sockaddr_in remote = make_address(address, port + static_cast<unsigned>(next));
+    const auto start = Clock::now();
+    while (true) {
+      send_fd = socket(AF_INET, SOCK_STREAM, 0);
+      if (send_fd < 0)
+        throw_errno("socket");
+      if (connect(send_fd, reinterpret_cast<const sockaddr *>(&remote), sizeof(remote)) == 0)
+        break;
+      close(send_fd);
+      send_fd = -1;
+      if (Clock::now() - start > PEER_TIMEOUT)
+        throw std::runtime_error("Distribuido: no se pudo conectar con el rank " + std::to_string(next) + ".");
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    write_all(send_fd, &own_rank, sizeof(own_rank));
+
+    // 2. Conexion entrante desde el anterior.
+    pollfd pending{listen_fd, POLLIN, 0};
+    const int ready = poll(&pending, 1, static_cast<int>(std::chrono::milliseconds(PEER_TIMEOUT).count()));
+    if (ready <= 0)
+      throw std::runtime_error("Distribuido: el rank anterior no se conecto.");
+    recv_fd = accept(listen_fd, nullptr, nullptr);
+    if (recv_fd < 0)
+      throw_errno("accept");
+    uint32_t peer_rank = 0;
+    read_all(recv_fd, &peer_rank, sizeof(peer_rank));
+    if (peer_rank != (rank + world_size - 1) % world_size)
+      throw std::runtime_error("Distribuido: conexion inesperada del rank " + std::to_string(peer_rank) + ".");
+  } catch (...) {
+    close(listen_fd);
+    if (send_fd >= 0)
+      close(send_fd);
+    if (recv_fd >= 0)
+      close(recv_fd);
+    throw;
+  }
+  close(listen_fd);
+
+  set_nonblocking(send_fd);
+  set_nonblocking(recv_fd);
+  set_nodelay(send_fd);
+  set_nodelay(recv_fd);
+}
+
+TcpTransport::~TcpTransport() {
+  close(send_fd);
+  close(recv_fd);
+}
+
+void TcpTransport::exchange(const void *send, size_t send_bytes, void *recv, size_t recv_bytes) {
+  const char *out = static_cast<const char *>(send);
+  char *in = static_cast<char *>(recv);
+  size_t sent = 0;
+  size_t received = 0;
+  const int timeout_ms = static_cast<int>(std::chrono::milliseconds(PEER_TIMEOUT).count());
+
+  while (sent < send_bytes || received < recv_bytes) {
+    pollfd fds[2];
+    nfds_t count = 0;
+    if (sent < send_bytes)
+      fds[count++] = {send_fd, POLLOUT, 0};
+    if (received < recv_bytes)
+      fds[count++] = {recv_fd, POLLIN, 0};
+
+    const int ready = poll(fds, count, timeout_ms);
+    if (ready < 0) {
+      if (errno == EINTR)
+        continue;
+      throw_errno("poll");
+    }
+    if (ready == 0)
+      throw std::runtime_error("Distribuido: tiempo de espera agotado en el anillo TCP.");
+
+    for (nfds_t i = 0; i < count; ++i) {
+      if (fds[i].revents == 0)
+        continue;
+      if (fds[i].fd == send_fd) {
+        const ssize_t n = ::send(send_fd, out + sent, send_bytes - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+          throw_errno("send");
+        if (n > 0)
+          sent += static_cast<size_t>(n);
+      } else {
+        const ssize_t n = ::recv(recv_fd, in + received, recv_bytes - received, 0);
+        if (n == 0)
+          throw std::runtime_error("Distribuido: el rank anterior cerro la conexion.");
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+          throw_errno("recv");
+        if (n > 0)
+          received += static_cast<size_t>(n);
+      }
+    }
+  }
+}
+
+// --- ShmTransport ---
+
+// Cola circular de bytes compartida entre dos procesos. written y read crecen sin volver a
+// cero (64 bits no desbordan); cada uno lo escribe un solo proceso y el par release/acquire
+// publica los bytes junto con el contador, igual que SpscRing entre hilos.
+struct ShmTransport::Channel {
+  static_assert(std::atomic<uint64_t>::is_always_lock_free, "Se necesitan atomicos sin locks entre procesos.");
+
+  std::atomic<uint32_t> state; // 0 = creandose, 1 = listo, 2 = abierto por el receptor.
+  alignas(64) std::atomic<uint64_t> written;
+  alignas(64) std::atomic<uint64_t> read;
+  alignas(64) unsigned char data[SHM_CAPACITY];
+};
+
+namespace {
+std::string segment_name(const std::string &job, size_t rank) { return "/vit_" + job + "_" + std::to_string(rank); }
+
+void *map_segment(int fd) {
+  void *memory = mmap(nullptr, SEGMENT_BYTES, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (memory == MAP_FAILED)
+    throw_errno("mmap");
+  return memory;
+}
+} // namespace
+
+// Primero cada rank crea su enlace de salida (no espera a nadie), despues abre el de
+// entrada que crea el anterior y por ultimo espera a que el siguiente abra el suyo para
+// borrar el nombre.
+ShmTransport::ShmTransport(size_t rank, size_t world_size, const std::string &job) {
+  static_assert(sizeof(Channel) <= SEGMENT_BYTES, "El segmento no cabe en el mapeo.");
+  const std::string out_name = segment_name(job, rank);
+  const std::string in_name = segment_name(job, (rank + world_size - 1) % world_size);
+
+  // 1. Enlace de salida.
+  shm_unlink(out_name.c_str()); // Restos de un lanzamiento anterior con el mismo nombre.
+  const int out_fd = shm_open(out_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (out_fd < 0)
+    throw_errno("shm_open " + out_name);
+  if (ftruncate(out_fd, SEGMENT_BYTES) < 0) {
+    close(out_fd);
+    shm_unlink(out_name.c_str());
+    throw_errno("ftruncate");
+  }
+  void *out_memory = map_segment(out_fd);
+  close(out_fd);
+  out = static_cast<Channel *>(out_memory);
+  out->written.store(0, std::memory_order_relaxed);
+  out->read.store(0, std::memory_order_relaxed);
+  out->state.store(1, std::memory_order_release);
+
+  try {
+    // 2. Enlace de entrada: se espera a que el anterior lo cree y le de tamano.
+    const auto start = Clock::now();
+    size_t attempt = 0;
+    int in_fd = -1;
+    while (true) {
+      in_fd = shm_open(in_name.c_str(), O_RDWR, 0600);
+      struct stat info{};
+      if (in_fd >= 0 && fstat(in_fd, &info) == 0 && static_cast<size_t>(info.st_size) >= SEGMENT_BYTES)
+        break;
+      if (in_fd >= 0)
+        close(in_fd);
+      backoff(attempt, start, "esperando el enlace del rank anterior");
+    }
+    void *in_memory = map_segment(in_fd);
+    close(in_fd);
+    in = static_cast<Channel *>(in_memory);
+    attempt = 0;
+    while (in->state.load(std::memory_order_acquire) == 0)
+      backoff(attempt, start, "esperando el enlace del rank anterior");
+    in->state.store(2, std::memory_order_release);
+
+    // 3. El siguiente rank ya tiene mapeado nuestro enlace: el nombre sobra.
+    attempt = 0;
+    while (out->state.load(std::memory_order_acquire) != 2)
+      backoff(attempt, start, "esperando al rank siguiente");
+    shm_unlink(out_name.c_str());
+  } catch (...) {
+    shm_unlink(out_name.c_str());
+    munmap(out, SEGMENT_BYTES);
+    if (in)
+      munmap(in, SEGMENT_BYTES);
+    throw;
+  }
+}
+
+ShmTransport::~ShmTransport() {
+  munmap(out, SEGMENT_BYTES);
+  munmap(in, SEGMENT_BYTES);
+}
+
+void ShmTransport::exchange(const void *send, size_t send_bytes, void *recv, size_t recv_bytes) {
+  const unsigned char *src = static_cast<const unsigned char *>(send);
+  unsigned char *dst = static_cast<unsigned char *>(recv);
+  size_t sent = 0;
+  size_t received = 0;
+  size_t attempt = 0;
+  auto last_progress = Clock::now();
+
+  while (sent < send_bytes || received < recv_bytes) {
+    bool progress = false;
+
+    if (sent < send_bytes) {
+      const uint64_t head = out->written.load(std::memory_order_relaxed);
+      const uint64_t free_bytes = SHM_CAPACITY - (head - out->read.load(std::memory_order_acquire));
+      const size_t n = std::min<size_t>(free_bytes, send_bytes - sent);
+      if (n > 0) {
+        // La zona libre puede dar la vuelta al final del buffer.
+        const size_t offset = head % SHM_CAPACITY;
+        const size_t first = std::min(n, SHM_CAPACITY - offset);
+        std::memcpy(out->data + offset, src + sent, first);
+        std::memcpy(out->data, src + sent + first, n - first);
+        out->written.store(head + n, std::memory_order_release);
+        sent += n;
+        progress = true;
+      }
+    }
+
+    if (received < recv_bytes) {
+      const uint64_t tail = in->read.load(std::memory_order_relaxed);
+      const uint64_t available = in->written.load(std::memory_order_acquire) - tail;
+      const size_t n = std::min<size_t>(available, recv_bytes - received);
+      if (n > 0) {
+        const size_t offset = tail % SHM_CAPACITY;
+        const size_t first = std::min(n, SHM_CAPACITY - offset);
+        std::memcpy(dst + received, in->data + offset, first);
+        std::memcpy(dst + received + first, in->data, n - first);
+        in->read.store(tail + n, std::memory_order_release);
+        received += n;
+        progress = true;
+      }
+    }
+
+    if (progress) {
+      attempt = 0;
+      last_progress = Clock::now();
+    } else {
+      backoff(attempt, last_progress, "en el anillo de memoria compartida");
+    }
+  }
+}
+
+// --- Communicator ---
+
+Communicator::Communicator(size_t rank, size_t world_size, std::unique_ptr<RingTransport> transport)
+    : rank_index(rank), world(world_size), transport(std::move(transport)) {
+  if (world == 0 || rank >= world)
+    throw std::invalid_argument("Distribuido: rank " + std::to_string(rank) + " fuera de rango para " +
+                                std::to_string(world) + " procesos.");
+  if (world > 1 && !this->transport)
+    throw std::invalid_argument("Distribuido: se necesita un transporte con mas de un proceso.");
+  worker = std::thread(&Communicator::run_queue, this);
+}
+
+Communicator::~Communicator() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  queue_changed.notify_all();
+  worker.join();
+}
+
+std::unique_ptr<Communicator> Communicator::from_environment() {
+  const size_t world_size = env_size("VIT_WORLD_SIZE", 1);
+  if (world_size <= 1)
+    return nullptr;
+  if (!std::getenv("VIT_RANK"))
+    throw std::runtime_error("Distribuido: VIT_WORLD_SIZE sin VIT_RANK.");
+  const size_t rank = env_size("VIT_RANK", 0);
+  if (rank >= world_size)
+    throw std::runtime_error("Distribuido: VIT_RANK fuera de rango.");
+
+  const std::string backend = env_string("VIT_DIST_BACKEND", "shm");
+  const size_t port = env_size("VIT_DIST_PORT", 29500);
+  std::unique_ptr<RingTransport> transport;
+  if (backend == "tcp") {
+    transport = std::make_unique<TcpTransport>(rank, world_size, env_string("VIT_DIST_ADDR", "127.0.0.1"),
+                                               static_cast<unsigned>(port));
+  } else if (backend == "shm") {
+    transport = std::make_unique<ShmTransport>(rank, world_size, env_string("VIT_DIST_JOB", std::to_string(port)));
+  } else {
+    throw std::runtime_error("Distribuido: VIT_DIST_BACKEND debe ser 'shm' o 'tcp', no '" + backend + "'.");
+  }
+  return std::make_unique<Communicator>(rank, world_size, std::move(transport));
+}
+
+void Communicator::all_reduce(float *data, size_t size) {
+  all_reduce_async(data, size);
+  wait();
+}
+
+void Communicator::all_reduce_async(float *data, size_t size) {
+  enqueue([this, data, size] { ring_all_reduce(data, size); });
+}
+
+void Communicator::broadcast(void *data, size_t bytes, size_t root) {
+  enqueue([this, data, bytes, root] { ring_broadcast(data, bytes, root); });
+  wait();
+}
+
+void Communicator::barrier() {
+  float token = 0.0f;
+  all_reduce(&token, 1);
+}
+
+void Communicator::wait() {
+  std::unique_lock<std::mutex> lock(mutex);
+  queue_changed.wait(lock, [this] { return (queue.empty() && running == 0) || error; });
+  if (error)
+    std::rethrow_exception(error);
+}
+
+double Communicator::communication_seconds() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return busy_seconds;
+}
+
+void Communicator::enqueue(std::function<void()> operation) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (error)
+      std::rethrow_exception(error);
+    queue.push_back(std::move(operation));
+  }
+  queue_changed.notify_all();
+}
+
+// Hilo de comunicacion: ejecuta las operaciones en el orden en que se pidieron. Tras un
+// error el anillo queda desincronizado, asi que se descarta el resto de la cola.
+void Communicator::run_queue() {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    queue_changed.wait(lock, [this] { return stopping || !queue.empty(); });
+    if (queue.empty())
+      return;
+    std::function<void()> operation = std::move(queue.front());
+    queue.pop_front();
+    ++running;
+    lock.unlock();
+
+    const auto start = Clock::now();
+    std::exception_ptr failure;
+    try {
+      operation();
+    } catch (...) {
+      failure = std::current_exception();
+    }
+    const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+    lock.lock();
+    --running;
+    busy_seconds += elapsed.count();
+    if (failure && !error) {
+      error = failure;
+      queue.clear();
+    }
+    queue_changed.notify_all();
+  }
+}
+
+// All-reduce en anillo con el buffer dividido en P trozos.
+// - Reduce-scatter: en el paso s el rank r envia el trozo r - s y suma el r - s - 1 que
+//   le llega. Tras P - 1 pasos el trozo r + 1 tiene la suma de todos los procesos.
+// - All-gather: en el paso s el rank r reenvia el trozo r + 1 - s, ya completo, y
+//   recibe el r - s.
+void Communicator::ring_all_reduce(float *data, size_t size) {
+  if (world == 1 || size == 0)
+    return;
+  auto chunk_begin = [&](size_t chunk) { return size * chunk / world; };
+  auto chunk_size = [&](size_t chunk) { return chunk_begin(chunk + 1) - chunk_begin(chunk); };
+  std::vector<float> incoming(size / world + 1);
+
+  for (size_t step = 0; step + 1 < world; ++step) {
+    const size_t send_chunk = (rank_index + world - step) % world;
+    const size_t recv_chunk = (rank_index + 2 * world - step - 1) % world;
+    const size_t count = chunk_size(recv_chunk);
+    transport->exchange(data + chunk_begin(send_chunk), chunk_size(send_chunk) * sizeof(float), incoming.data(),
+                        count * sizeof(float));
+    float *target = data + chunk_begin(recv_chunk);
+    for (size_t i = 0; i < count; ++i)
+      target[i] += incoming[i];
+  }
+
+  for (size_t step = 0; step + 1 < world; ++step) {
+    const size_t send_chunk = (rank_index + 1 + world - step) % world;
+    const size_t recv_chunk = (rank_index + world - step) % world;
+    transport->exchange(data + chunk_begin(send_chunk), chunk_size(send_chunk) * sizeof(float),
+                        data + chunk_begin(recv_chunk), chunk_size(recv_chunk) * sizeof(float));
+  }
+}
+
+// Broadcast en cadena: cada rank recibe del anterior y reenvia al siguiente, empezando
+// por root. El ultimo de la cadena solo recibe.
+void Communicator::ring_broadcast(void *data, size_t bytes, size_t root) {
+  if (world == 1 || bytes == 0)
+    return;
+  const size_t position = (rank_index + world - root) % world;
+  if (position > 0)
+    transport->exchange(nullptr, 0, data, bytes);
+  if (position + 1 < world)
+    transport->exchange(data, bytes, nullptr, 0);
+}
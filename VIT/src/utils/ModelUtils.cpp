@@ -1,6 +1,8 @@
 #include "utils/ModelUtils.hpp"
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <numeric>
 #include <stdexcept>
 
 namespace ModelUtils {
@@ -31,11 +33,16 @@ void save_weights(const VisionTransformer &model, const std::string &filePath) {
     outFile.write(reinterpret_cast<const char *>(shape.data()), rank * sizeof(size_t));
 
     // 3. Escribir los datos del tensor.
-    // Si el tensor no es contiguo, se crea una copia temporal para guardar.
+    // Si el tensor es una vista no contigua (p. ej. un bloque de QKVProjection), se
+    // escribe fila a fila, de modo que el archivo es identico al de un tensor contiguo.
     if (!tensor.isContiguous()) {
-      std::cerr << "Advertencia: Guardando un tensor no contiguo. Se creara una copia temporal." << std::endl;
-      Tensor temp = tensor.contiguous();
-      outFile.write(reinterpret_cast<const char *>(temp.getData()), num_elements * sizeof(float));
+      if (rank != 2 || tensor.getStrides()[1] != 1) {
+        throw std::runtime_error("Guardar este tensor no contiguo no esta implementado: " + tensor.shapeToString());
+      }
+      for (size_t r = 0; r < shape[0]; ++r) {
+        const float *row = tensor.getData() + tensor.getDataOffset() + r * tensor.getStrides()[0];
+        outFile.write(reinterpret_cast<const char *>(row), shape[1] * sizeof(float));
+      }
     } else {
       // Se accede a los datos considerando el offset por si es una vista.
       outFile.write(reinterpret_cast<const char *>(tensor.getData() + tensor.getDataOffset()), num_elements * sizeof(float));
@@ -71,16 +78,25 @@ void load_weights(VisionTransformer &model, const std::string &filePath) {
     }
 
     size_t num_elements = tensor.getSize();
-    // Cargar en un tensor no contiguo no esta implementado.
     if (!tensor.isContiguous()) {
-      throw std::runtime_error("Cargar pesos a un tensor no contiguo no esta implementado.");
+      // Vistas 2D con filas contiguas (bloques de QKVProjection): se leen fila a fila.
+      if (file_rank != 2 || tensor.getStrides()[1] != 1) {
+        throw std::runtime_error("Cargar pesos a este tensor no contiguo no esta implementado: " + tensor.shapeToString());
+      }
+      for (size_t r = 0; r < file_shape[0]; ++r) {
+        float *row = tensor.getData() + tensor.getDataOffset() + r * tensor.getStrides()[0];
+        inFile.read(reinterpret_cast<char *>(row), file_shape[1] * sizeof(float));
+        if (static_cast<size_t>(inFile.gcount()) != file_shape[1] * sizeof(float)) {
+          throw std::runtime_error("Error de lectura: fin de archivo inesperado o datos corruptos.");
+        }
+      }
     } else {
       // Lee los datos directamente en la memoria del tensor.
       inFile.read(reinterpret_cast<char *>(tensor.getData() + tensor.getDataOffset()), num_elements * sizeof(float));
-    }
 
-    if (static_cast<size_t>(inFile.gcount()) != num_elements * sizeof(float)) {
-      throw std::runtime_error("Error de lectura: fin de archivo inesperado o datos corruptos.");
+      if (static_cast<size_t>(inFile.gcount()) != num_elements * sizeof(float)) {
+        throw std::runtime_error("Error de lectura: fin de archivo inesperado o datos corruptos.");
+      }
     }
   }
 
@@ -88,4 +104,70 @@ void load_weights(VisionTransformer &model, const std::string &filePath) {
   std::cout << "Pesos cargados correctamente." << std::endl;
 }
 
+void quantize_int8(VisionTransformer &model, const Dataset &calibration, size_t num_samples, size_t batch_size) {
+  const size_t count = std::min(num_samples, calibration.size());
+  if (count == 0 || batch_size == 0) {
+    throw std::invalid_argument("quantize_int8 necesita al menos una muestra de calibracion.");
+  }
+
+  std::vector<size_t> indices(count);
+  std::iota(indices.begin(), indices.end(), 0);
+
+  // Con el modo Calibrate el forward sigue en float y solo registra los rangos.
+  model.setInt8Mode(Int8Mode::Calibrate);
+  for (size_t start = 0; start < count; start += batch_size) {
+    const auto batch = calibration.get_batch(indices.data() + start, std::min(batch_size, count - start));
+    model.forward(batch.first, false);
+  }
+  model.setInt8Mode(Int8Mode::Quantized);
+  std::cout << "Modelo cuantizado a int8 (calibrado con " << count << " muestras)." << std::endl;
+}
+
+namespace {
+// Tramos contiguos de un tensor: el tensor entero si es contiguo o una fila por tramo para
+// las vistas 2D con filas contiguas.
+std::vector<std::pair<float *, size_t>> contiguous_spans(Tensor &t) {
+  float *base = t.getData() + t.getDataOffset();
+  if (t.isContiguous())
+    return {{base, t.getSize()}};
+  const auto &shape = t.getShape();
+  if (shape.size() != 2 || t.getStrides()[1] != 1)
+    throw std::runtime_error("pack_tensors: tensor con un layout no soportado.");
+  std::vector<std::pair<float *, size_t>> spans;
+  for (size_t r = 0; r < shape[0]; ++r)
+    spans.push_back({base + r * t.getStrides()[0], shape[1]});
+  return spans;
+}
+} // namespace
+
+void pack_tensors(const std::vector<Tensor *> &tensors, std::vector<float> &buffer) {
+  buffer.clear();
+  for (Tensor *t : tensors)
+    for (const auto &[data, size] : contiguous_spans(*t))
+      buffer.insert(buffer.end(), data, data + size);
+}
+
+void unpack_tensors(const std::vector<float> &buffer, const std::vector<Tensor *> &tensors, float scale) {
+  const float *src = buffer.data();
+  for (Tensor *t : tensors) {
+    for (const auto &[data, size] : contiguous_spans(*t)) {
+      for (size_t i = 0; i < size; ++i)
+        data[i] = src[i] * scale;
+      src += size;
+    }
+  }
+}
+
+void share_parameters(VisionTransformer &model, VisionTransformer &replica) {
+  const std::vector<Tensor *> source = model.getParameters();
+  const std::vector<Tensor *> target = replica.getParameters();
+  if (source.size() != target.size())
+    throw std::invalid_argument("share_parameters: los modelos no tienen los mismos parametros.");
+  for (size_t i = 0; i < source.size(); ++i) {
+    if (source[i]->getShape() != target[i]->getShape())
+      throw std::invalid_argument("share_parameters: los modelos no tienen los mismos parametros.");
+    *target[i] = *source[i];
+  }
+}
+
 } // namespace ModelUtils
@@ -0,0 +1,92 @@
+// Prueba de la acumulacion de gradientes (accumulation_steps).
+// Reproduce un grupo de train_epoch con accumulation_steps = 2: dos accumulate_gradients
+// seguidos, sin poner los gradientes a cero entre ellos, cada batch pesado por su fraccion
+// de filas del grupo. Se compara esa suma con un unico backward sobre el batch combinado: perdida media y todos los
+// gradientes, con mitades iguales y desiguales, con el modelo solo, con 2 replicas y con 2
+// etapas de pipeline. Devuelve 1 si algun caso falla.
+#include "model/Trainer.hpp"
+#include "utils/ModelUtils.hpp"
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+int failures = 0;
+
+void report(const std::string &name, double worst) {
+  const bool ok = worst <= 1e-5;
+  if (!ok)
+    ++failures;
+  std::printf("%-52s %s (max diff %.2e)\n", name.c_str(), ok ? "OK" : "FALLA", worst);
+}
+
+// Diferencia maxima entre dos listas de tensores, relativa al mayor valor de la referencia.
+double relativeDiff(const std::vector<Tensor *> &got, const std::vector<Tensor *> &ref) {
+  std::vector<float> a, b;
+  ModelUtils::pack_tensors(got, a);
+  ModelUtils::pack_tensors(ref, b);
+  if (a.size() != b.size())
+    return INFINITY;
+  double worst = 0.0, magnitude = 1e-12;
+  for (size_t i = 0; i < a.size(); ++i) {
+    worst = std::max(worst, static_cast<double>(std::fabs(a[i] - b[i])));
+    magnitude = std::max(magnitude, static_cast<double>(std::fabs(b[i])));
+  }
+  return worst / magnitude;
+}
+
+void runCase(const std::string &mode, size_t replicas, size_t stages, size_t first_rows) {
+  const std::string label = mode + " " + std::to_string(first_rows) + "+";
+  ViTConfig config;
+  config.embedding_dim = 32;
+  config.num_heads = 4;
+  config.num_layers = 2;
+  config.mlp_hidden_dim = 64;
+
+  const size_t batch = 8;
+  Tensor X({batch, config.in_channels, config.image_size, config.image_size});
+  X.randomize(0.0f, 1.0f);
+  Tensor y({batch, config.num_classes});
+  for (size_t i = 0; i < batch; ++i)
+    y(i, (3 * i + 1) % config.num_classes) = 1.0f;
+
+  VisionTransformer reference(config);
+  VisionTransformer model(config);
+  std::vector<float> weights;
+  ModelUtils::pack_tensors(reference.getParameters(), weights);
+  ModelUtils::unpack_tensors(weights, model.getParameters());
+
+  TrainerConfig train_config;
+  train_config.data_parallel_replicas = replicas;
+  train_config.pipeline_stages = stages;
+  train_config.pipeline_micro_batches = 2;
+  Trainer referenceTrainer(reference, train_config);
+  Trainer trainer(model, train_config);
+
+  // Un backward sobre el batch combinado.
+  reference.zeroGradients();
+  const float referenceLoss = referenceTrainer.accumulate_gradients(X, y).first;
+
+  // Dos backward, cada uno pesado por su fraccion de filas.
+  model.zeroGradients();
+  float loss = 0.0f;
+  for (size_t begin : {size_t(0), first_rows}) {
+    const size_t rows = begin == 0 ? first_rows : batch - first_rows;
+    const float weight = static_cast<float>(rows) / batch;
+    loss += weight * trainer.accumulate_gradients(X.slice(0, begin, rows), y.slice(0, begin, rows), weight).first;
+  }
+  report(label + std::to_string(batch - first_rows) + ": perdida", std::fabs(loss - referenceLoss) / referenceLoss);
+  report(label + std::to_string(batch - first_rows) + ": gradientes",
+         relativeDiff(model.getGradients(), reference.getGradients()));
+}
+} // namespace
+
+int main() {
+  for (size_t first_rows : {4, 3}) {
+    runCase("modelo", 1, 1, first_rows);
+    runCase("2 replicas", 2, 1, first_rows);
+    runCase("2 etapas", 1, 2, first_rows);
+  }
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,111 @@
+// Prueba del PoolAllocator con listas libres por hilo.
+//  1. Un hilo: un bloque liberado se reutiliza sin pedir memoria al sistema.
+//  2. Varios hilos de OpenMP reservan y liberan a la vez, cada uno con datos propios que se
+//     comprueban antes de liberar; al terminar no queda memoria en uso.
+//  3. Bloques reservados por un hilo y liberados por otro (como los lotes del hilo de
+//     precarga) vuelven a estar disponibles para el primero a traves del pool compartido.
+//  4. Un hilo que termina devuelve su cache, y resetStep()/trim() liberan lo cacheado.
+// Devuelve 1 si algun caso falla.
+#include "core/Allocator.hpp"
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace {
+int failures = 0;
+
+void check(const std::string &name, bool ok) {
+  if (!ok)
+    ++failures;
+  std::printf("%-64s %s\n", name.c_str(), ok ? "OK" : "FALLA");
+}
+} // namespace
+
+int main() {
+  PoolAllocator pool;
+
+  // --- 1. Reutilizacion en el mismo hilo ---
+  float *first = pool.allocate(1000);
+  pool.deallocate(first, 1000);
+  const size_t systemBefore = pool.stats().systemAllocations;
+  float *again = pool.allocate(1000);
+  check("un hilo: el bloque liberado se reutiliza", again == first && pool.stats().systemAllocations == systemBefore);
+  pool.deallocate(again, 1000);
+
+  // --- 2. Reservas concurrentes ---
+  bool corrupted = false;
+#pragma omp parallel num_threads(4) reduction(|| : corrupted)
+  {
+    size_t thread = 0;
+#ifdef _OPENMP
+    thread = static_cast<size_t>(omp_get_thread_num());
+#endif
+    for (int iteration = 0; iteration < 2000; ++iteration) {
+      std::vector<std::pair<float *, size_t>> live;
+      for (size_t k = 1; k <= 8; ++k) {
+        const size_t count = k * 37 + iteration % 5;
+        float *ptr = pool.allocate(count);
+        for (size_t i = 0; i < count; ++i)
+          ptr[i] = static_cast<float>(thread * 1000 + k);
+        live.push_back({ptr, count});
+      }
+      for (auto [ptr, count] : live) {
+        const float expected = ptr[0];
+        for (size_t i = 0; i < count; ++i)
+          corrupted = corrupted || ptr[i] != expected;
+        pool.deallocate(ptr, count);
+      }
+    }
+  }
+  AllocatorStats stats = pool.stats();
+  check("varios hilos: ningun bloque compartido entre hilos", !corrupted);
+  check("varios hilos: sin memoria en uso al terminar", stats.bytesInUse == 0);
+  check("varios hilos: casi todas las reservas salen de las caches",
+        stats.systemAllocations * 100 < stats.allocations);
+
+  // --- 3. Reservar en un hilo y liberar en otro ---
+  const size_t blocks = 4096, count = 64;
+  std::vector<float *> produced(blocks);
+  for (size_t i = 0; i < blocks; ++i)
+    produced[i] = pool.allocate(count);
+  std::thread consumer([&] {
+    for (float *ptr : produced)
+      pool.deallocate(ptr, count);
+  });
+  consumer.join();
+  const size_t systemBeforeReuse = pool.stats().systemAllocations;
+  for (size_t i = 0; i < blocks; ++i)
+    produced[i] = pool.allocate(count);
+  check("entre hilos: los bloques liberados por otro hilo se reutilizan",
+        pool.stats().systemAllocations == systemBeforeReuse);
+  for (float *ptr : produced)
+    pool.deallocate(ptr, count);
+
+  // --- 4. Fin de hilo, resetStep y trim ---
+  std::thread worker([&] {
+    float *ptr = pool.allocate(333);
+    pool.deallocate(ptr, 333);
+  });
+  worker.join();
+  stats = pool.stats();
+  check("fin de hilo: sus contadores y su cache siguen en el pool",
+        stats.bytesInUse == 0 && stats.bytesCached > 0 && stats.allocations > 3 * blocks);
+  pool.resetStep();
+  pool.resetStep(); // Nada se reutilizo entre los dos: todo lo cacheado sobra.
+  check("resetStep: libera lo que no se uso durante el paso", pool.stats().bytesCached == 0);
+  float *ptr = pool.allocate(50);
+  pool.deallocate(ptr, 50);
+  pool.trim();
+  check("trim: no queda memoria cacheada", pool.stats().bytesCached == 0);
+
+  if (failures) {
+    std::printf("%d casos fallaron.\n", failures);
+    return 1;
+  }
+  std::printf("Todas las pruebas del asignador pasaron.\n");
+  return 0;
+}
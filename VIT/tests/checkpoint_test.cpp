@@ -0,0 +1,102 @@
+// Prueba del checkpointing de activaciones (checkpoint_activations).
+//  1. TransformerEncoderBlock con y sin checkpointing y los mismos pesos: salida, dL/dX y
+//     todos los gradientes, con atencion normal o fusionada y Q, K, V separadas o fusionadas.
+//  2. VisionTransformer completo con y sin checkpointing: logits, dL/dX y gradientes tras dos
+//     pasos forward/backward seguidos que acumulan sobre los mismos gradientes.
+// El backward con checkpointing repite exactamente el mismo forward, asi que los resultados
+// deben ser identicos bit a bit. Devuelve 1 si algun caso falla.
+#include "model/TransformerEncoderBlock.hpp"
+#include "model/VisionTransformer.hpp"
+#include "utils/ModelUtils.hpp"
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+int failures = 0;
+
+void report(const std::string &name, double worst) {
+  const bool ok = worst == 0.0;
+  if (!ok)
+    ++failures;
+  std::printf("%-52s %s (max diff %.2e)\n", name.c_str(), ok ? "OK" : "FALLA", worst);
+}
+
+// Diferencia maxima entre dos listas de tensores de la misma forma (admite vistas).
+double maxDiff(const std::vector<Tensor *> &got, const std::vector<Tensor *> &ref) {
+  std::vector<float> a, b;
+  ModelUtils::pack_tensors(got, a);
+  ModelUtils::pack_tensors(ref, b);
+  if (a.size() != b.size())
+    return INFINITY;
+  double worst = 0.0;
+  for (size_t i = 0; i < a.size(); ++i)
+    worst = std::max(worst, static_cast<double>(std::fabs(a[i] - b[i])));
+  return worst;
+}
+
+double maxDiff(Tensor got, Tensor ref) { return maxDiff(std::vector<Tensor *>{&got}, std::vector<Tensor *>{&ref}); }
+
+void copyParameters(Layer &from, Layer &to) {
+  std::vector<float> weights;
+  ModelUtils::pack_tensors(from.getParameters(), weights);
+  ModelUtils::unpack_tensors(weights, to.getParameters());
+}
+
+Tensor randomTensor(const std::vector<size_t> &shape) {
+  Tensor t(shape);
+  t.randomize(-1.0f, 1.0f);
+  return t;
+}
+
+void testBlock(bool flash, bool fuse_qkv) {
+  const std::string label = std::string("bloque") + (flash ? ", flash" : "") + (fuse_qkv ? ", qkv fusionada" : "");
+  const size_t B = 3, N = 17, D = 32, H = 4, hidden = 64;
+  TransformerEncoderBlock reference(D, H, hidden, flash, fuse_qkv, false);
+  TransformerEncoderBlock block(D, H, hidden, flash, fuse_qkv, true);
+  copyParameters(reference, block);
+
+  Tensor X = randomTensor({B, N, D});
+  Tensor dY = randomTensor({B, N, D});
+  report(label + ": salida", maxDiff(block.forward(X, true), reference.forward(X, true)));
+  report(label + ": dL/dX", maxDiff(block.backward(dY), reference.backward(dY)));
+  report(label + ": gradientes", maxDiff(block.getGradients(), reference.getGradients()));
+}
+
+void testModel(bool fuse_qkv) {
+  const std::string label = std::string("modelo") + (fuse_qkv ? ", qkv fusionada" : "");
+  ViTConfig config;
+  config.embedding_dim = 32;
+  config.num_heads = 4;
+  config.num_layers = 3;
+  config.mlp_hidden_dim = 64;
+  config.fuse_qkv = fuse_qkv;
+  VisionTransformer reference(config);
+  config.checkpoint_activations = true;
+  VisionTransformer model(config);
+  copyParameters(reference, model);
+
+  const size_t batch = 4;
+  double logits = 0.0, inputGrad = 0.0;
+  for (int step = 0; step < 2; ++step) {
+    Tensor X({batch, config.in_channels, config.image_size, config.image_size});
+    X.randomize(0.0f, 1.0f);
+    Tensor dY = randomTensor({batch, config.num_classes});
+    logits = std::max(logits, maxDiff(model.forward(X, true), reference.forward(X, true)));
+    inputGrad = std::max(inputGrad, maxDiff(model.backward(dY), reference.backward(dY)));
+  }
+  report(label + ": logits", logits);
+  report(label + ": dL/dX", inputGrad);
+  report(label + ": gradientes tras 2 pasos", maxDiff(model.getGradients(), reference.getGradients()));
+}
+} // namespace
+
+int main() {
+  for (bool flash : {false, true})
+    for (bool fuse_qkv : {false, true})
+      testBlock(flash, fuse_qkv);
+  testModel(false);
+  testModel(true);
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,100 @@
+// Prueba del paralelismo de datos del Trainer (data_parallel_replicas).
+// Dos modelos con los mismos pesos calculan los gradientes de un batch fijo con 1 replica y
+// con 2 o 3 (reparto desigual de filas), y se comparan la perdida y todos los gradientes.
+// Despues se cambian los pesos del modelo a traves del registro y se repite: las replicas
+// comparten los parametros, asi que deben ver los pesos nuevos sin copiarlos.
+// Devuelve 1 si algun caso falla.
+#include "model/Trainer.hpp"
+#include "utils/ModelUtils.hpp"
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+int failures = 0;
+
+void report(const std::string &name, double worst) {
+  const bool ok = worst <= 1e-5;
+  if (!ok)
+    ++failures;
+  std::printf("%-52s %s (max diff %.2e)\n", name.c_str(), ok ? "OK" : "FALLA", worst);
+}
+
+// Diferencia maxima entre dos listas de tensores, relativa al mayor valor de la referencia.
+double relativeDiff(const std::vector<Tensor *> &got, const std::vector<Tensor *> &ref) {
+  std::vector<float> a, b;
+  ModelUtils::pack_tensors(got, a);
+  ModelUtils::pack_tensors(ref, b);
+  if (a.size() != b.size())
+    return INFINITY;
+  double worst = 0.0, magnitude = 1e-12;
+  for (size_t i = 0; i < a.size(); ++i) {
+    worst = std::max(worst, static_cast<double>(std::fabs(a[i] - b[i])));
+    magnitude = std::max(magnitude, static_cast<double>(std::fabs(b[i])));
+  }
+  return worst / magnitude;
+}
+
+// Gradientes del batch con el modo configurado, partiendo de cero. Devuelve la perdida.
+float gradients(Trainer &trainer, const Tensor &X, const Tensor &y) {
+  trainer.getModel().zeroGradients();
+  return trainer.accumulate_gradients(X, y).first;
+}
+
+void runCase(size_t replicas, bool fuse_qkv) {
+  const std::string label = "R=" + std::to_string(replicas) + (fuse_qkv ? ", qkv fusionada" : "");
+  ViTConfig config;
+  config.embedding_dim = 32;
+  config.num_heads = 4;
+  config.num_layers = 2;
+  config.mlp_hidden_dim = 64;
+  config.fuse_qkv = fuse_qkv;
+
+  const size_t batch = 7;
+  Tensor X({batch, config.in_channels, config.image_size, config.image_size});
+  X.randomize(0.0f, 1.0f);
+  Tensor y({batch, config.num_classes});
+  for (size_t i = 0; i < batch; ++i)
+    y(i, (3 * i + 1) % config.num_classes) = 1.0f;
+
+  VisionTransformer reference(config);
+  VisionTransformer model(config);
+  std::vector<float> weights;
+  ModelUtils::pack_tensors(reference.getParameters(), weights);
+  ModelUtils::unpack_tensors(weights, model.getParameters());
+
+  TrainerConfig single;
+  TrainerConfig parallel;
+  parallel.data_parallel_replicas = replicas;
+  Trainer referenceTrainer(reference, single);
+  Trainer trainer(model, parallel);
+
+  float loss = gradients(trainer, X, y);
+  float referenceLoss = gradients(referenceTrainer, X, y);
+  report(label + ": perdida", std::fabs(loss - referenceLoss) / std::fabs(referenceLoss));
+  report(label + ": gradientes", relativeDiff(model.getGradients(), reference.getGradients()));
+
+  // Pesos nuevos en los dos modelos, escritos sobre las vistas del registro.
+  for (VisionTransformer *m : {&reference, &model}) {
+    std::vector<Tensor *> params = m->getParameters();
+    std::vector<float> values;
+    ModelUtils::pack_tensors(params, values);
+    for (size_t i = 0; i < values.size(); ++i)
+      values[i] += 0.05f * std::sin(0.37f * static_cast<float>(i));
+    ModelUtils::unpack_tensors(values, params);
+  }
+  loss = gradients(trainer, X, y);
+  referenceLoss = gradients(referenceTrainer, X, y);
+  report(label + ": perdida con pesos nuevos", std::fabs(loss - referenceLoss) / std::fabs(referenceLoss));
+  report(label + ": gradientes con pesos nuevos", relativeDiff(model.getGradients(), reference.getGradients()));
+}
+} // namespace
+
+int main() {
+  for (bool fuse_qkv : {false, true}) {
+    runCase(2, fuse_qkv);
+    runCase(3, fuse_qkv);
+  }
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,183 @@
+// Prueba de la atencion fusionada por bloques (core/FlashAttention) con longitudes de
+// secuencia que no son multiplo del bloque de 64 filas.
+//  1. flashAttentionForward/Backward contra una referencia en double: salida, dQ, dK y dV,
+//     con Q, K, V y los gradientes como vistas por cabezas {B, N, h, d_h}.transpose(1, 2).
+//  2. MultiHeadAttention con use_flash_attention contra la misma capa con
+//     scaledDotProductAttention y los mismos pesos: salida, dL/dX y gradientes de las
+//     proyecciones (los de Q, K y V son X^T * dQ, X^T * dK y X^T * dV).
+// Devuelve 1 si algun caso falla.
+#include "core/FlashAttention.hpp"
+#include "layers/MultiHeadAttention.hpp"
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+int failures = 0;
+
+Tensor randomTensor(const std::vector<size_t> &shape) {
+  Tensor t(shape);
+  t.randomize(-1.0f, 1.0f);
+  return t;
+}
+
+// Diferencia maxima entre dos tensores 4D de la misma forma (pueden ser vistas).
+double maxDiff4(const Tensor &got, const std::vector<double> &ref) {
+  const auto &s = got.getShape();
+  double worst = 0.0;
+  size_t idx = 0;
+  for (size_t a = 0; a < s[0]; ++a)
+    for (size_t b = 0; b < s[1]; ++b)
+      for (size_t c = 0; c < s[2]; ++c)
+        for (size_t d = 0; d < s[3]; ++d)
+          worst = std::max(worst, std::fabs(got(a, b, c, d) - ref[idx++]));
+  return worst;
+}
+
+void report(const std::string &name, double worst, double tolerance) {
+  const bool ok = worst <= tolerance;
+  if (!ok)
+    ++failures;
+  std::printf("%-52s %s (max diff %.2e)\n", name.c_str(), ok ? "OK" : "FALLA", worst);
+}
+
+// Atencion de referencia en double sobre vistas {B, h, N, d}; los resultados quedan en
+// orden {B, h, N, d} para compararlos con maxDiff4.
+void referenceAttention(const Tensor &q, const Tensor &k, const Tensor &v, const Tensor &dO, float scale,
+                        std::vector<double> &O, std::vector<double> &dQ, std::vector<double> &dK,
+                        std::vector<double> &dV) {
+  const auto &s = q.getShape();
+  const size_t B = s[0], H = s[1], N = s[2], d = s[3];
+  O.assign(B * H * N * d, 0.0);
+  dQ.assign(O.size(), 0.0);
+  dK.assign(O.size(), 0.0);
+  dV.assign(O.size(), 0.0);
+  std::vector<double> P(N * N), dP(N * N);
+  for (size_t b = 0; b < B; ++b) {
+    for (size_t h = 0; h < H; ++h) {
+      const size_t base = (b * H + h) * N * d;
+      // P = softmax(Q * K^T * scale) por filas.
+      for (size_t i = 0; i < N; ++i) {
+        double maxScore = -INFINITY;
+        for (size_t j = 0; j < N; ++j) {
+          double score = 0.0;
+          for (size_t x = 0; x < d; ++x)
+            score += static_cast<double>(q(b, h, i, x)) * k(b, h, j, x);
+          P[i * N + j] = score * scale;
+          maxScore = std::max(maxScore, P[i * N + j]);
+        }
+        double sum = 0.0;
+        for (size_t j = 0; j < N; ++j)
+          sum += P[i * N + j] = std::exp(P[i * N + j] - maxScore);
+        for (size_t j = 0; j < N; ++j)
+          P[i * N + j] /= sum;
+      }
+      // O = P * V, dV = P^T * dO, dP = dO * V^T.
+      for (size_t i = 0; i < N; ++i)
+        for (size_t j = 0; j < N; ++j) {
+          double dot = 0.0;
+          for (size_t x = 0; x < d; ++x) {
+            O[base + i * d + x] += P[i * N + j] * v(b, h, j, x);
+            dV[base + j * d + x] += P[i * N + j] * dO(b, h, i, x);
+            dot += static_cast<double>(dO(b, h, i, x)) * v(b, h, j, x);
+          }
+          dP[i * N + j] = dot;
+        }
+      // dS = P * (dP - sum_j(dP * P)); dQ = dS * K * scale, dK = dS^T * Q * scale.
+      for (size_t i = 0; i < N; ++i) {
+        double rowDot = 0.0;
+        for (size_t j = 0; j < N; ++j)
+          rowDot += dP[i * N + j] * P[i * N + j];
+        for (size_t j = 0; j < N; ++j) {
+          const double dS = P[i * N + j] * (dP[i * N + j] - rowDot) * scale;
+          for (size_t x = 0; x < d; ++x) {
+            dQ[base + i * d + x] += dS * k(b, h, j, x);
+            dK[base + j * d + x] += dS * q(b, h, i, x);
+          }
+        }
+      }
+    }
+  }
+}
+
+void testKernel(size_t B, size_t N, size_t H, size_t d) {
+  const std::string label = "flash B=" + std::to_string(B) + " N=" + std::to_string(N) + " h=" + std::to_string(H) +
+                            " d=" + std::to_string(d);
+  // Vistas por cabezas de buffers {B, N, h, d}, como en MultiHeadAttention.
+  Tensor q = randomTensor({B, N, H, d}).transpose(1, 2);
+  Tensor k = randomTensor({B, N, H, d}).transpose(1, 2);
+  Tensor v = randomTensor({B, N, H, d}).transpose(1, 2);
+  Tensor dO = randomTensor({B, N, H, d}).transpose(1, 2);
+  const float scale = 1.0f / std::sqrt(static_cast<float>(d));
+
+  Tensor lse;
+  Tensor output = flashAttentionForward(q, k, v, scale, lse);
+  Tensor dQ = Tensor({B, N, H, d}).transpose(1, 2);
+  Tensor dK = Tensor({B, N, H, d}).transpose(1, 2);
+  Tensor dV = Tensor({B, N, H, d}).transpose(1, 2);
+  flashAttentionBackward(q, k, v, output, lse, dO, scale, dQ, dK, dV);
+
+  std::vector<double> refO, refdQ, refdK, refdV;
+  referenceAttention(q, k, v, dO, scale, refO, refdQ, refdK, refdV);
+  report(label + ": salida", maxDiff4(output, refO), 1e-5);
+  report(label + ": dQ", maxDiff4(dQ, refdQ), 1e-5);
+  report(label + ": dK", maxDiff4(dK, refdK), 1e-5);
+  report(label + ": dV", maxDiff4(dV, refdV), 1e-5);
+}
+
+// Diferencia maxima relativa al mayor valor absoluto de la referencia.
+double relativeDiff(const Tensor &got, const Tensor &ref) {
+  const Tensor a = got.contiguous(), b = ref.contiguous();
+  const float *pa = a.getData() + a.getDataOffset(), *pb = b.getData() + b.getDataOffset();
+  double worst = 0.0, magnitude = 1.0;
+  for (size_t i = 0; i < a.getSize(); ++i) {
+    worst = std::max(worst, static_cast<double>(std::fabs(pa[i] - pb[i])));
+    magnitude = std::max(magnitude, static_cast<double>(std::fabs(pb[i])));
+  }
+  return worst / magnitude;
+}
+
+void testLayer(size_t B, size_t N, size_t D, size_t H) {
+  const std::string label = "MHA flash vs estandar N=" + std::to_string(N);
+  MultiHeadAttention flash(D, H, true);
+  MultiHeadAttention standard(D, H, false);
+  // Mismos pesos en las dos capas.
+  std::vector<Tensor *> from = standard.getParameters(), to = flash.getParameters();
+  for (size_t p = 0; p < from.size(); ++p)
+    *to[p] = from[p]->contiguous();
+
+  Tensor X = randomTensor({B, N, D});
+  Tensor dY = randomTensor({B, N, D});
+  Tensor outFlash = flash.forward(X, true);
+  Tensor outStandard = standard.forward(X, true);
+  report(label + ": salida", relativeDiff(outFlash, outStandard), 1e-5);
+  report(label + ": dL/dX", relativeDiff(flash.backward(dY), standard.backward(dY)), 1e-5);
+
+  const char *names[] = {"W_q", "b_q", "W_k", "b_k", "W_v", "b_v", "W_out", "b_out"};
+  std::vector<Tensor *> gradFlash = flash.getGradients(), gradStandard = standard.getGradients();
+  for (size_t p = 0; p < gradFlash.size(); ++p)
+    report(label + ": d" + names[p], relativeDiff(*gradFlash[p], *gradStandard[p]), 1e-5);
+}
+} // namespace
+
+int main() {
+  // Longitudes por debajo, justo alrededor y por encima de uno y dos bloques de 64.
+  testKernel(2, 1, 2, 8);
+  testKernel(2, 5, 3, 8);
+  testKernel(1, 17, 2, 13);
+  testKernel(2, 63, 2, 16);
+  testKernel(2, 65, 3, 8);
+  testKernel(1, 130, 2, 16);
+
+  testLayer(2, 17, 24, 3);
+  testLayer(2, 67, 24, 3);
+  testLayer(1, 129, 32, 4);
+
+  if (failures) {
+    std::printf("%d casos fallaron.\n", failures);
+    return 1;
+  }
+  std::printf("Todas las pruebas de atencion fusionada pasaron.\n");
+  return 0;
+}
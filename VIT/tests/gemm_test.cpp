@@ -0,0 +1,196 @@
+// Prueba de matrixMultiply y batchMatrixMultiply contra el bucle i-j-k original.
+// Cubre formas que no son multiplos del microkernel (6x16), ambos lados del corte del
+// bucle directo para problemas pequenos, los bloques KC/NC, vistas transpuestas y con
+// desplazamiento, entradas por lotes y el modo acumulativo. Devuelve 1 si algun caso falla.
+#include "core/Tensor.hpp"
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+namespace {
+int failures = 0;
+
+Tensor randomTensor(const std::vector<size_t> &shape) {
+  Tensor t(shape);
+  t.randomize(-1.0f, 1.0f);
+  return t;
+}
+
+// Compara un valor con la referencia. La tolerancia crece con la suma de |a_ip * b_pj|,
+// que acota el error de redondeo de cualquier orden de las sumas.
+void check(const std::string &name, float got, float ref, float magnitude, double &worst) {
+  const float diff = std::fabs(got - ref);
+  worst = std::max(worst, static_cast<double>(diff));
+  if (!(diff <= 1e-5f * magnitude + 1e-6f)) {
+    if (failures < 20)
+      std::printf("  %s: obtenido %g, esperado %g\n", name.c_str(), got, ref);
+    ++failures;
+  }
+}
+
+// C = A * B (o C += A * B) 2D, comparado elemento a elemento.
+void testMatrix(const std::string &name, const Tensor &a, const Tensor &b, bool accumulate = false) {
+  const size_t m = a.getShape()[0], k = a.getShape()[1], n = b.getShape()[1];
+  // Valor previo del destino para el modo acumulativo (out es una copia propia).
+  Tensor before = randomTensor({m, n});
+  Tensor out({m, n});
+  for (size_t i = 0; i < m; ++i)
+    for (size_t j = 0; j < n; ++j)
+      out(i, j) = before(i, j);
+
+  if (accumulate)
+    matrixMultiply(a, b, out, true);
+  else
+    out = matrixMultiply(a, b);
+
+  const int before_failures = failures;
+  double worst = 0.0;
+  for (size_t i = 0; i < m; ++i) {
+    for (size_t j = 0; j < n; ++j) {
+      float sum = 0.0f, magnitude = 0.0f;
+      for (size_t p = 0; p < k; ++p) {
+        sum += a(i, p) * b(p, j);
+        magnitude += std::fabs(a(i, p) * b(p, j));
+      }
+      if (accumulate) {
+        sum += before(i, j);
+        magnitude += std::fabs(before(i, j));
+      }
+      check(name, out(i, j), sum, magnitude, worst);
+    }
+  }
+  std::printf("%-44s %s (max diff %.2e)\n", name.c_str(), failures == before_failures ? "OK" : "FALLA", worst);
+}
+
+// Variante 4D {B, H, M, K} x {B, H, K, N}, opcionalmente acumulando sobre out.
+void testBatch4(const std::string &name, const Tensor &a, const Tensor &b, bool accumulate = false) {
+  const auto &as = a.getShape();
+  const size_t B = as[0], H = as[1], m = as[2], k = as[3], n = b.getShape()[3];
+  Tensor before = randomTensor({B, H, m, n});
+  Tensor out({B, H, m, n});
+  for (size_t x = 0; x < B; ++x)
+    for (size_t h = 0; h < H; ++h)
+      for (size_t i = 0; i < m; ++i)
+        for (size_t j = 0; j < n; ++j)
+          out(x, h, i, j) = before(x, h, i, j);
+
+  if (accumulate)
+    batchMatrixMultiply(a, b, out, true);
+  else
+    out = batchMatrixMultiply(a, b);
+
+  const int before_failures = failures;
+  double worst = 0.0;
+  for (size_t x = 0; x < B; ++x)
+    for (size_t h = 0; h < H; ++h)
+      for (size_t i = 0; i < m; ++i)
+        for (size_t j = 0; j < n; ++j) {
+          float sum = 0.0f, magnitude = 0.0f;
+          for (size_t p = 0; p < k; ++p) {
+            sum += a(x, h, i, p) * b(x, h, p, j);
+            magnitude += std::fabs(a(x, h, i, p) * b(x, h, p, j));
+          }
+          if (accumulate) {
+            sum += before(x, h, i, j);
+            magnitude += std::fabs(before(x, h, i, j));
+          }
+          check(name, out(x, h, i, j), sum, magnitude, worst);
+        }
+  std::printf("%-44s %s (max diff %.2e)\n", name.c_str(), failures == before_failures ? "OK" : "FALLA", worst);
+}
+
+// Variante 3D {B, M, K} x {B, K, N}.
+void testBatch3(const std::string &name, const Tensor &a, const Tensor &b) {
+  const size_t B = a.getShape()[0], m = a.getShape()[1], k = a.getShape()[2], n = b.getShape()[2];
+  Tensor out = batchMatrixMultiply(a, b);
+  const int before_failures = failures;
+  double worst = 0.0;
+  for (size_t x = 0; x < B; ++x)
+    for (size_t i = 0; i < m; ++i)
+      for (size_t j = 0; j < n; ++j) {
+        float sum = 0.0f, magnitude = 0.0f;
+        for (size_t p = 0; p < k; ++p) {
+          sum += a(x, i, p) * b(x, p, j);
+          magnitude += std::fabs(a(x, i, p) * b(x, p, j));
+        }
+        check(name, out(x, i, j), sum, magnitude, worst);
+      }
+  std::printf("%-44s %s (max diff %.2e)\n", name.c_str(), failures == before_failures ? "OK" : "FALLA", worst);
+}
+
+std::string shapeName(size_t m, size_t n, size_t k) {
+  return std::to_string(m) + "x" + std::to_string(n) + "x" + std::to_string(k);
+}
+} // namespace
+
+int main() {
+  // --- Formas 2D: bucle directo (m*n*k <= 16^3), justo por encima y bloques grandes ---
+  const size_t shapes[][3] = {{1, 1, 1},   {5, 7, 3},   {16, 16, 16}, {17, 16, 16}, {16, 17, 16},
+                              {37, 53, 29}, {6, 16, 64}, {73, 41, 300}, {7, 3075, 5}, {131, 97, 513}};
+  for (const auto &s : shapes) {
+    const size_t m = s[0], n = s[1], k = s[2];
+    testMatrix("matrixMultiply " + shapeName(m, n, k), randomTensor({m, k}), randomTensor({k, n}));
+  }
+
+  // --- Vistas: transpuestas y con desplazamiento (filas y columnas) ---
+  testMatrix("A^T 23x31x19", randomTensor({19, 23}).transpose(0, 1), randomTensor({19, 31}));
+  testMatrix("B^T 23x31x19", randomTensor({23, 19}), randomTensor({31, 19}).transpose(0, 1));
+  testMatrix("A^T B^T 3x5x4 (directo)", randomTensor({4, 3}).transpose(0, 1), randomTensor({5, 4}).transpose(0, 1));
+  testMatrix("A slice filas 45x29x33", randomTensor({50, 33}).slice(0, 5, 45), randomTensor({33, 29}));
+  testMatrix("B slice columnas 45x29x33", randomTensor({45, 33}), randomTensor({33, 40}).slice(1, 7, 29));
+
+  // --- Modo acumulativo (+=), tambien sobre un destino que es una vista ---
+  testMatrix("acumular 3x5x7 (directo)", randomTensor({3, 7}), randomTensor({7, 5}), true);
+  testMatrix("acumular 37x53x29", randomTensor({37, 29}), randomTensor({29, 53}), true);
+  testMatrix("acumular A^T 61x70x270", randomTensor({270, 61}).transpose(0, 1), randomTensor({270, 70}), true);
+  {
+    Tensor a = randomTensor({21, 13}), b = randomTensor({13, 18});
+    Tensor wide = randomTensor({21, 30});
+    Tensor view = wide.slice(1, 5, 18);
+    Tensor before({21, 18});
+    for (size_t i = 0; i < 21; ++i)
+      for (size_t j = 0; j < 18; ++j)
+        before(i, j) = view(i, j);
+    matrixMultiply(a, b, view, true);
+    const int before_failures = failures;
+    double worst = 0.0;
+    for (size_t i = 0; i < 21; ++i)
+      for (size_t j = 0; j < 18; ++j) {
+        float sum = before(i, j), magnitude = std::fabs(before(i, j));
+        for (size_t p = 0; p < 13; ++p) {
+          sum += a(i, p) * b(p, j);
+          magnitude += std::fabs(a(i, p) * b(p, j));
+        }
+        check("acumular en vista", view(i, j), sum, magnitude, worst);
+      }
+    std::printf("%-44s %s (max diff %.2e)\n", "acumular en vista 21x18x13", failures == before_failures ? "OK" : "FALLA",
+                worst);
+  }
+
+  // --- Por lotes ---
+  testBatch3("BMM 3D 4x(13x11x9)", randomTensor({4, 13, 9}), randomTensor({4, 9, 11}));
+  testBatch3("BMM 3D 3x(40x35x70)", randomTensor({3, 40, 70}), randomTensor({3, 70, 35}));
+  testBatch4("BMM 4D 2x3x(5x6x4) (directo)", randomTensor({2, 3, 5, 4}), randomTensor({2, 3, 4, 6}));
+  testBatch4("BMM 4D 2x3x(17x19x23)", randomTensor({2, 3, 17, 23}), randomTensor({2, 3, 23, 19}));
+  {
+    // Atencion: Q y K {B, N, h, d} vistos como {B, h, N, d}; scores = Q * K^T.
+    const size_t B = 2, N = 17, heads = 3, d = 11;
+    Tensor q = randomTensor({B, N, heads, d}).transpose(1, 2);
+    Tensor k = randomTensor({B, N, heads, d}).transpose(1, 2);
+    testBatch4("Q * K.transpose(2,3) 2x3x(17x17x11)", q, k.transpose(2, 3));
+    Tensor v = randomTensor({B, N, heads, d}).transpose(1, 2);
+    testBatch4("acumular P * V 2x3x(17x11x17)", randomTensor({B, heads, N, N}), v, true);
+  }
+  {
+    // K.transpose(1,2) sobre lotes 3D con desplazamiento.
+    Tensor k = randomTensor({3, 30, 12}).slice(1, 4, 25);
+    testBatch3("Q * K.transpose(1,2) slice 3x(25x25x12)", randomTensor({3, 25, 12}), k.transpose(1, 2));
+  }
+
+  if (failures) {
+    std::printf("%d valores fuera de tolerancia.\n", failures);
+    return 1;
+  }
+  std::printf("Todas las pruebas de GEMM pasaron.\n");
+  return 0;
+}
@@ -0,0 +1,87 @@
+// Prueba de que InferencePlan lee los pesos actuales del modelo en cada run().
+// Compila el plan, traslada los parametros a un ParameterRegistry (como hace el Trainer),
+// cambia los pesos con un paso de Adam y despues con ModelUtils::load_weights, y compara
+// run() con forward(x, false) antes de que ningun forward rehaga la matriz empaquetada de
+// QKVProjection. Tambien con int8. Devuelve 1 si algun caso falla.
+#include "core/ParameterRegistry.hpp"
+#include "model/InferencePlan.hpp"
+#include "optimizers/Adam.hpp"
+#include "utils/ModelUtils.hpp"
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+namespace {
+int failures = 0;
+
+void compare(const std::string &name, const Tensor &planned, const Tensor &reference) {
+  float worst = 0.0f;
+  const size_t rows = reference.getShape()[0], cols = reference.getShape()[1];
+  for (size_t i = 0; i < rows; ++i)
+    for (size_t j = 0; j < cols; ++j)
+      worst = std::max(worst, std::fabs(planned(i, j) - reference(i, j)));
+  const bool ok = worst <= 1e-4f;
+  if (!ok)
+    ++failures;
+  std::printf("%-52s %s (max diff %.2e)\n", name.c_str(), ok ? "OK" : "FALLA", worst);
+}
+
+void runCase(bool fuse_qkv, bool flash) {
+  const std::string label = std::string(fuse_qkv ? "qkv fusionada" : "qkv separada") + (flash ? ", flash" : "");
+  ViTConfig config;
+  config.embedding_dim = 32;
+  config.num_heads = 4;
+  config.num_layers = 2;
+  config.mlp_hidden_dim = 64;
+  config.fuse_qkv = fuse_qkv;
+  config.use_flash_attention = flash;
+
+  const size_t batch = 3;
+  Tensor X({batch, config.in_channels, config.image_size, config.image_size});
+  X.randomize(0.0f, 1.0f);
+
+  VisionTransformer model(config);
+  InferencePlan plan(model, batch);
+  compare(label + ": recien compilado", plan.run(X), model.forward(X, false));
+
+  // Pesos trasladados al registro y modificados a traves de sus vistas.
+  ParameterRegistry registry(model.getParameters(), model.getGradients());
+  for (Tensor *grad : registry.getGradients())
+    for (size_t i = 0; i < grad->getShape()[0]; ++i)
+      for (size_t j = 0; j < grad->getSize() / grad->getShape()[0]; ++j)
+        grad->getData()[grad->getDataOffset() + i * grad->getStrides()[0] + j] = std::sin(0.37f * (i * 31 + j));
+  Adam optimizer(0.05f);
+  optimizer.update(registry);
+  Tensor planned = plan.run(X);
+  compare(label + ": tras ParameterRegistry + Adam", planned, model.forward(X, false));
+
+  // Pesos cargados de otro modelo sobre las vistas del registro.
+  VisionTransformer other(config);
+  const std::string path = "inference_plan_test." + std::to_string(fuse_qkv) + std::to_string(flash) + ".weights";
+  ModelUtils::save_weights(other, path);
+  ModelUtils::load_weights(model, path);
+  std::remove(path.c_str());
+  planned = plan.run(X);
+  compare(label + ": tras load_weights", planned, model.forward(X, false));
+
+  // Int8: el plan usa la version cuantizada de los pesos actuales.
+  model.setInt8Mode(Int8Mode::Calibrate);
+  model.forward(X, false);
+  model.setInt8Mode(Int8Mode::Quantized);
+  planned = plan.run(X);
+  compare(label + ": int8", planned, model.forward(X, false));
+}
+} // namespace
+
+int main() {
+  for (bool fuse_qkv : {false, true})
+    for (bool flash : {false, true})
+      runCase(fuse_qkv, flash);
+
+  if (failures) {
+    std::printf("%d casos fallaron.\n", failures);
+    return 1;
+  }
+  std::printf("Todas las pruebas de InferencePlan pasaron.\n");
+  return 0;
+}
@@ -0,0 +1,100 @@
+// Prueba del paralelismo de pipeline del Trainer (pipeline_stages, pipeline_micro_batches).
+// Dos modelos con los mismos pesos calculan los gradientes de un batch fijo con el forward y
+// backward normales y con S etapas y M micro-batches (tambien M que no divide el batch), y
+// se comparan la perdida y todos los gradientes. Despues se cambian los pesos del modelo a
+// traves del registro y se repite: las copias de las etapas comparten los parametros, asi
+// que deben ver los pesos nuevos sin copiarlos. Devuelve 1 si algun caso falla.
+#include "model/Trainer.hpp"
+#include "utils/ModelUtils.hpp"
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+int failures = 0;
+
+void report(const std::string &name, double worst) {
+  const bool ok = worst <= 1e-5;
+  if (!ok)
+    ++failures;
+  std::printf("%-52s %s (max diff %.2e)\n", name.c_str(), ok ? "OK" : "FALLA", worst);
+}
+
+// Diferencia maxima entre dos listas de tensores, relativa al mayor valor de la referencia.
+double relativeDiff(const std::vector<Tensor *> &got, const std::vector<Tensor *> &ref) {
+  std::vector<float> a, b;
+  ModelUtils::pack_tensors(got, a);
+  ModelUtils::pack_tensors(ref, b);
+  if (a.size() != b.size())
+    return INFINITY;
+  double worst = 0.0, magnitude = 1e-12;
+  for (size_t i = 0; i < a.size(); ++i) {
+    worst = std::max(worst, static_cast<double>(std::fabs(a[i] - b[i])));
+    magnitude = std::max(magnitude, static_cast<double>(std::fabs(b[i])));
+  }
+  return worst / magnitude;
+}
+
+// Gradientes del batch con el modo configurado, partiendo de cero. Devuelve la perdida.
+float gradients(Trainer &trainer, const Tensor &X, const Tensor &y) {
+  trainer.getModel().zeroGradients();
+  return trainer.accumulate_gradients(X, y).first;
+}
+
+void runCase(size_t stages, size_t micro_batches) {
+  const std::string label = "S=" + std::to_string(stages) + " M=" + std::to_string(micro_batches);
+  ViTConfig config;
+  config.embedding_dim = 32;
+  config.num_heads = 4;
+  config.num_layers = 4;
+  config.mlp_hidden_dim = 64;
+
+  const size_t batch = 7;
+  Tensor X({batch, config.in_channels, config.image_size, config.image_size});
+  X.randomize(0.0f, 1.0f);
+  Tensor y({batch, config.num_classes});
+  for (size_t i = 0; i < batch; ++i)
+    y(i, (3 * i + 1) % config.num_classes) = 1.0f;
+
+  VisionTransformer reference(config);
+  VisionTransformer model(config);
+  std::vector<float> weights;
+  ModelUtils::pack_tensors(reference.getParameters(), weights);
+  ModelUtils::unpack_tensors(weights, model.getParameters());
+
+  TrainerConfig plain;
+  TrainerConfig piped;
+  piped.pipeline_stages = stages;
+  piped.pipeline_micro_batches = micro_batches;
+  Trainer referenceTrainer(reference, plain);
+  Trainer trainer(model, piped);
+
+  float loss = gradients(trainer, X, y);
+  float referenceLoss = gradients(referenceTrainer, X, y);
+  report(label + ": perdida", std::fabs(loss - referenceLoss) / std::fabs(referenceLoss));
+  report(label + ": gradientes", relativeDiff(model.getGradients(), reference.getGradients()));
+
+  // Pesos nuevos en los dos modelos, escritos sobre las vistas del registro.
+  for (VisionTransformer *m : {&reference, &model}) {
+    std::vector<Tensor *> params = m->getParameters();
+    std::vector<float> values;
+    ModelUtils::pack_tensors(params, values);
+    for (size_t i = 0; i < values.size(); ++i)
+      values[i] += 0.05f * std::sin(0.37f * static_cast<float>(i));
+    ModelUtils::unpack_tensors(values, params);
+  }
+  loss = gradients(trainer, X, y);
+  referenceLoss = gradients(referenceTrainer, X, y);
+  report(label + ": perdida con pesos nuevos", std::fabs(loss - referenceLoss) / std::fabs(referenceLoss));
+  report(label + ": gradientes con pesos nuevos", relativeDiff(model.getGradients(), reference.getGradients()));
+}
+} // namespace
+
+int main() {
+  runCase(2, 1);
+  runCase(2, 4);
+  runCase(3, 3);
+  runCase(4, 7);
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,127 @@
+// Prueba de la proyeccion Q, K, V fusionada {D, 3D} (QKVProjection) contra tres Dense {D, D}
+// con los mismos pesos.
+//  1. QKVProjection frente a las Dense: cada bloque de la salida {B, N, 3D}, dL/dX (suma de
+//     los tres backward) y los gradientes de W_q, b_q, W_k, b_k, W_v y b_v.
+//  2. MultiHeadAttention con fuse_qkv frente a la version separada, con y sin atencion
+//     fusionada: salida, dL/dX y todos los gradientes.
+// Devuelve 1 si algun caso falla.
+#include "layers/Dense.hpp"
+#include "layers/MultiHeadAttention.hpp"
+#include "layers/QKVProjection.hpp"
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+int failures = 0;
+
+Tensor randomTensor(const std::vector<size_t> &shape) {
+  Tensor t(shape);
+  t.randomize(-1.0f, 1.0f);
+  return t;
+}
+
+// Copia elemento a elemento entre tensores 2D de la misma forma (el destino puede ser una
+// vista del almacenamiento empaquetado, asi que no se reasigna).
+void copy2D(const Tensor &from, Tensor &to) {
+  for (size_t i = 0; i < from.getShape()[0]; ++i)
+    for (size_t j = 0; j < from.getShape()[1]; ++j)
+      to(i, j) = from(i, j);
+}
+
+// Diferencia maxima relativa al mayor valor absoluto de la referencia. Tensores 2D o 3D de
+// la misma forma, que pueden ser vistas (los 2D se leen como {1, filas, columnas}).
+double relativeDiff(const Tensor &got, const Tensor &ref) {
+  auto at = [](const Tensor &t, size_t b, size_t i, size_t j) {
+    return t.getShape().size() == 3 ? t(b, i, j) : t(i, j);
+  };
+  const auto &s = ref.getShape();
+  const size_t batches = s.size() == 3 ? s[0] : 1, rows = s[s.size() - 2], cols = s.back();
+  double worst = 0.0, magnitude = 1.0;
+  for (size_t b = 0; b < batches; ++b)
+    for (size_t i = 0; i < rows; ++i)
+      for (size_t j = 0; j < cols; ++j) {
+        worst = std::max(worst, static_cast<double>(std::fabs(at(got, b, i, j) - at(ref, b, i, j))));
+        magnitude = std::max(magnitude, static_cast<double>(std::fabs(at(ref, b, i, j))));
+      }
+  return worst / magnitude;
+}
+
+void report(const std::string &name, double worst) {
+  const bool ok = worst <= 1e-5;
+  if (!ok)
+    ++failures;
+  std::printf("%-52s %s (max diff %.2e)\n", name.c_str(), ok ? "OK" : "FALLA", worst);
+}
+
+const char *const NAMES[] = {"W_q", "b_q", "W_k", "b_k", "W_v", "b_v", "W_out", "b_out"};
+
+void testProjection(size_t B, size_t N, size_t D) {
+  const std::string label = "QKVProjection D=" + std::to_string(D) + " N=" + std::to_string(N);
+  QKVProjection fused(D);
+  Dense separate[3] = {Dense(D, D), Dense(D, D), Dense(D, D)};
+  // W_q, b_q, W_k, b_k, W_v, b_v en el mismo orden en los dos lados.
+  std::vector<Tensor *> packed = fused.getParameters();
+  for (size_t p = 0; p < 3; ++p) {
+    std::vector<Tensor *> params = separate[p].getParameters();
+    copy2D(*packed[2 * p], *params[0]);
+    copy2D(*packed[2 * p + 1], *params[1]);
+  }
+
+  Tensor X = randomTensor({B, N, D});
+  Tensor dY = randomTensor({B, N, 3 * D});
+  Tensor Y = fused.forward(X, true);
+  Tensor dX = fused.backward(dY);
+
+  Tensor dXSeparate({B, N, D});
+  const char *blocks[] = {"Q", "K", "V"};
+  for (size_t p = 0; p < 3; ++p) {
+    Tensor out = separate[p].forward(X, true);
+    report(label + ": salida " + blocks[p], relativeDiff(Y.slice(2, p * D, D), out));
+    dXSeparate = dXSeparate + separate[p].backward(dY.slice(2, p * D, D).contiguous());
+  }
+  report(label + ": dL/dX", relativeDiff(dX, dXSeparate));
+
+  std::vector<Tensor *> gradFused = fused.getGradients();
+  for (size_t p = 0; p < 3; ++p) {
+    std::vector<Tensor *> grads = separate[p].getGradients();
+    report(label + ": d" + NAMES[2 * p], relativeDiff(*gradFused[2 * p], *grads[0]));
+    report(label + ": d" + NAMES[2 * p + 1], relativeDiff(*gradFused[2 * p + 1], *grads[1]));
+  }
+}
+
+void testAttention(size_t B, size_t N, size_t D, size_t H, bool flash) {
+  const std::string label = std::string("MHA fusionada vs separada") + (flash ? ", flash" : "");
+  MultiHeadAttention fused(D, H, flash, true);
+  MultiHeadAttention separate(D, H, flash, false);
+  std::vector<Tensor *> from = separate.getParameters(), to = fused.getParameters();
+  for (size_t p = 0; p < from.size(); ++p)
+    copy2D(*from[p], *to[p]);
+
+  Tensor X = randomTensor({B, N, D});
+  Tensor dY = randomTensor({B, N, D});
+  report(label + ": salida", relativeDiff(fused.forward(X, true), separate.forward(X, true)));
+  report(label + ": dL/dX", relativeDiff(fused.backward(dY), separate.backward(dY)));
+
+  std::vector<Tensor *> gradFused = fused.getGradients(), gradSeparate = separate.getGradients();
+  for (size_t p = 0; p < gradFused.size(); ++p)
+    report(label + ": d" + NAMES[p], relativeDiff(*gradFused[p], *gradSeparate[p]));
+}
+} // namespace
+
+int main() {
+  testProjection(2, 5, 8);
+  testProjection(3, 17, 24);
+  testProjection(2, 65, 64);
+
+  for (bool flash : {false, true})
+    testAttention(2, 17, 24, 3, flash);
+
+  if (failures) {
+    std::printf("%d casos fallaron.\n", failures);
+    return 1;
+  }
+  std::printf("Todas las pruebas de QKVProjection pasaron.\n");
+  return 0;
+}